@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace-recorder.h"
+#include "ns3/abort.h"
+#include "ns3/config.h"
+#include "ns3/log.h"
+
+#include <map>
+
+/**
+ * \file
+ * \ingroup core-helpers
+ * \ingroup tracing
+ * ns3::BinaryTraceRecorder implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceRecorder");
+
+namespace {
+
+/** Container type for the sink factories, by callback name. */
+typedef std::map<std::string, BinaryTraceRecorder::SinkFactory> SignatureMap;
+
+/**
+ * Make the sink factories of the TracedValueCallback signatures.
+ * \returns The sink factories, by callback name.
+ */
+SignatureMap
+MakeTracedValueSignatures (void)
+{
+  SignatureMap signatures;
+  signatures["ns3::TracedValueCallback::Bool"] = &binarytrace::Sink<bool, bool>::Make;
+  signatures["ns3::TracedValueCallback::Int8"] = &binarytrace::Sink<int8_t, int8_t>::Make;
+  signatures["ns3::TracedValueCallback::Uint8"] = &binarytrace::Sink<uint8_t, uint8_t>::Make;
+  signatures["ns3::TracedValueCallback::Int16"] = &binarytrace::Sink<int16_t, int16_t>::Make;
+  signatures["ns3::TracedValueCallback::Uint16"] = &binarytrace::Sink<uint16_t, uint16_t>::Make;
+  signatures["ns3::TracedValueCallback::Int32"] = &binarytrace::Sink<int32_t, int32_t>::Make;
+  signatures["ns3::TracedValueCallback::Uint32"] = &binarytrace::Sink<uint32_t, uint32_t>::Make;
+  signatures["ns3::TracedValueCallback::Int64"] = &binarytrace::Sink<int64_t, int64_t>::Make;
+  signatures["ns3::TracedValueCallback::Uint64"] = &binarytrace::Sink<uint64_t, uint64_t>::Make;
+  signatures["ns3::TracedValueCallback::Double"] = &binarytrace::Sink<double, double>::Make;
+  signatures["ns3::TracedValueCallback::Time"] = &binarytrace::Sink<Time, Time>::Make;
+  signatures["ns3::TracedValueCallback::Void"] = &binarytrace::Sink<>::Make;
+  return signatures;
+}
+
+/**
+ * Get the registered trace source signatures.
+ * \returns The sink factories, by callback name.
+ */
+SignatureMap &
+GetSignatures (void)
+{
+  static SignatureMap signatures = MakeTracedValueSignatures ();
+  return signatures;
+}
+
+} // unnamed namespace
+
+
+BinaryTraceRecorder::BinaryTraceRecorder ()
+  : m_writer (Create<BinaryTraceWriter> ())
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceRecorder::~BinaryTraceRecorder ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+BinaryTraceRecorder::Open (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  m_writer->Open (filename);
+}
+
+void
+BinaryTraceRecorder::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  // The sinks refer to m_writer, so disconnect them first
+  for (std::vector<Connection>::const_iterator i = m_connections.begin ();
+       i != m_connections.end (); ++i)
+    {
+      i->accessor->DisconnectWithoutContext (PeekPointer (i->object), i->sink);
+    }
+  m_connections.clear ();
+  m_writer->Close ();
+}
+
+uint32_t
+BinaryTraceRecorder::Record (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::string::size_type slash = path.find_last_of ('/');
+  NS_ABORT_MSG_IF (slash == std::string::npos || slash + 1 == path.size (),
+                   "No trace source name in path " << path);
+  std::string name = path.substr (slash + 1);
+  Config::MatchContainer matches = Config::LookupMatches (path.substr (0, slash));
+  uint32_t connected = 0;
+  for (std::size_t i = 0; i < matches.GetN (); ++i)
+    {
+      if (Record (matches.Get (i), name, matches.GetMatchedPath (i) + name))
+        {
+          ++connected;
+        }
+    }
+  return connected;
+}
+
+bool
+BinaryTraceRecorder::Record (Ptr<Object> object, std::string name, std::string path)
+{
+  NS_LOG_FUNCTION (this << object << name << path);
+  NS_ABORT_MSG_UNLESS (m_writer->IsOpen (), "BinaryTraceRecorder is not open");
+  struct TypeId::TraceSourceInformation info;
+  Ptr<const TraceSourceAccessor> accessor =
+    object->GetInstanceTypeId ().LookupTraceSourceByName (name, &info);
+  if (accessor == 0)
+    {
+      NS_LOG_WARN ("No trace source " << name << " in " << path);
+      return false;
+    }
+  const SignatureMap &signatures = GetSignatures ();
+  SignatureMap::const_iterator factory = signatures.find (info.callback);
+  if (factory == signatures.end ())
+    {
+      NS_LOG_WARN ("No BinaryTraceSignature registered for " << info.callback
+                   << ", not recording " << path);
+      return false;
+    }
+
+  Connection connection;
+  connection.object = object;
+  connection.accessor = accessor;
+  connection.sink = factory->second (PeekPointer (m_writer),
+                                     m_writer->AddSource (path, info.callback));
+  if (!accessor->ConnectWithoutContext (PeekPointer (object), connection.sink))
+    {
+      NS_LOG_WARN ("Unable to connect to " << path);
+      return false;
+    }
+  m_connections.push_back (connection);
+  return true;
+}
+
+void
+BinaryTraceRecorder::RegisterSignature (std::string type, SinkFactory factory)
+{
+  NS_LOG_FUNCTION (type);
+  GetSignatures ()[type] = factory;
+}
+
+} // namespace ns3
@@ -0,0 +1,277 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_RECORDER_H
+#define BINARY_TRACE_RECORDER_H
+
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "ns3/binary-trace-file.h"
+#include "ns3/callback.h"
+#include "ns3/non-copyable.h"
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/trace-source-accessor.h"
+
+/**
+ * \file
+ * \ingroup core-helpers
+ * \ingroup tracing
+ * ns3::BinaryTraceRecorder and ns3::BinaryTraceSignature declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup core-helpers
+ * \ingroup tracing
+ * \brief Record trace sources into a binary trace file.
+ *
+ * The recorder connects to trace sources by Config path, or by object
+ * and trace source name, and writes each trace as a record of a
+ * BinaryTraceWriter file, with the arguments of the trace encoded by
+ * their BinaryTraceEncoder.  The trace sources are found through the
+ * TypeId of the objects, and their sinks are made from the callback
+ * name of the trace source (for example
+ * `ns3::TracedValueCallback::Double`), which must have been registered
+ * with a BinaryTraceSignature.  The TracedValueCallback signatures of
+ * the core module are registered.
+ *
+ * \code
+ *   BinaryTraceRecorder recorder;
+ *   recorder.Open ("cwnd.bin");
+ *   recorder.Record ("/NodeList/[0-9]/$ns3::TcpL4Protocol/SocketList/0/CongestionWindow");
+ *   Simulator::Run ();
+ *   recorder.Close ();
+ * \endcode
+ *
+ * The file is read back with BinaryTraceReader, where the path and
+ * callback name of each trace source are available with
+ * BinaryTraceReader::GetSource.
+ */
+class BinaryTraceRecorder : private NonCopyable
+{
+public:
+  /**
+   * Make a sink for a trace source.
+   * \param [in] writer The file to write to.
+   * \param [in] source The id of the trace source in \p writer.
+   * \returns The sink.
+   */
+  typedef CallbackBase (* SinkFactory)(BinaryTraceWriter *writer, uint32_t source);
+
+  /** Constructor. */
+  BinaryTraceRecorder ();
+  /** Destructor; closes the file. */
+  ~BinaryTraceRecorder ();
+
+  /**
+   * Create the trace file.
+   * \param [in] filename The file name.
+   */
+  void Open (std::string filename);
+  /** Disconnect from the trace sources, and close the file. */
+  void Close (void);
+
+  /**
+   * Record the trace sources matching a Config path.
+   *
+   * \param [in] path The Config path of the trace sources; the last
+   *             element is the name of the trace source.
+   * \returns The number of trace sources connected.
+   */
+  uint32_t Record (std::string path);
+  /**
+   * Record a trace source of an object.
+   *
+   * \param [in] object The object.
+   * \param [in] name The name of the trace source.
+   * \param [in] path The path of the trace source, written to the file.
+   * \returns \c true if the trace source was connected.
+   */
+  bool Record (Ptr<Object> object, std::string name, std::string path);
+
+  /**
+   * Register the sink factory of a trace source signature.
+   *
+   * \param [in] type The callback name of the trace sources.
+   * \param [in] factory The sink factory.
+   */
+  static void RegisterSignature (std::string type, SinkFactory factory);
+  /**
+   * Register a trace source signature.
+   *
+   * \tparam Ts \explicit The argument types of the trace sources.
+   * \param [in] type The callback name of the trace sources.
+   */
+  template <typename... Ts>
+  static void RegisterSignature (std::string type);
+
+private:
+  /** A connected trace source. */
+  struct Connection
+  {
+    Ptr<Object> object;                        /**< The object. */
+    Ptr<const TraceSourceAccessor> accessor;   /**< The trace source. */
+    CallbackBase sink;                         /**< The connected sink. */
+  };
+
+  /** The trace file. */
+  Ptr<BinaryTraceWriter> m_writer;
+  /** The connected trace sources. */
+  std::vector<Connection> m_connections;
+};
+
+/**
+ * \ingroup tracing
+ * \brief Register a trace source signature with BinaryTraceRecorder.
+ *
+ * Modules declare a static instance for each callback name
+ * of their trace sources to be recorded:
+ * \code
+ *   static BinaryTraceSignature<Ptr<const Packet> >
+ *     g_packetTracedCallback ("ns3::Packet::TracedCallback");
+ * \endcode
+ *
+ * \tparam Ts \explicit The argument types of the trace sources.
+ */
+template <typename... Ts>
+class BinaryTraceSignature
+{
+public:
+  /**
+   * Register the signature.
+   * \param [in] type The callback name of the trace sources.
+   */
+  BinaryTraceSignature (std::string type)
+  {
+    BinaryTraceRecorder::RegisterSignature<Ts...> (type);
+  }
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+namespace binarytrace {
+
+/**
+ * \ingroup tracing
+ * The total encoded size of some types.
+ * \tparam Ts \explicit The types.
+ */
+template <typename... Ts>
+struct EncodedSize;
+
+/** The encoded size of no type. */
+template <>
+struct EncodedSize<>
+{
+  static const uint32_t value = 0;  /**< The size. */
+};
+
+/**
+ * \ingroup tracing
+ * The total encoded size of some types.
+ * \tparam T \explicit The first type.
+ * \tparam Ts \explicit The other types.
+ */
+template <typename T, typename... Ts>
+struct EncodedSize<T, Ts...>
+{
+  /** The size. */
+  static const uint32_t value =
+    BinaryTraceEncoder<typename std::decay<T>::type>::SIZE + EncodedSize<Ts...>::value;
+};
+
+/**
+ * \ingroup tracing
+ * Encode no value.
+ */
+inline void
+Encode (uint8_t *)
+{}
+
+/**
+ * \ingroup tracing
+ * Encode values one after the other.
+ * \tparam T \deduced The type of the first value.
+ * \tparam Ts \deduced The types of the other values.
+ * \param [out] buffer The buffer to write to.
+ * \param [in] value The first value.
+ * \param [in] values The other values.
+ */
+template <typename T, typename... Ts>
+inline void
+Encode (uint8_t *buffer, const T &value, const Ts &... values)
+{
+  typedef BinaryTraceEncoder<typename std::decay<T>::type> Encoder;
+  Encoder::Write (buffer, value);
+  Encode (buffer + Encoder::SIZE, values...);
+}
+
+/**
+ * \ingroup tracing
+ * The sink of a trace source signature.
+ * \tparam Ts \explicit The argument types of the trace sources.
+ */
+template <typename... Ts>
+struct Sink
+{
+  /**
+   * Write a trace record.
+   * \param [in] writer The file to write to.
+   * \param [in] source The id of the trace source.
+   * \param [in] args The arguments of the trace.
+   */
+  static void Record (BinaryTraceWriter *writer, uint32_t source, Ts... args)
+  {
+    uint8_t *buffer = writer->Reserve (source, EncodedSize<Ts...>::value);
+    if (buffer != 0)
+      {
+        Encode (buffer, args...);
+      }
+  }
+  /**
+   * Make a sink for a trace source.
+   * \param [in] writer The file to write to.
+   * \param [in] source The id of the trace source.
+   * \returns The sink.
+   */
+  static CallbackBase Make (BinaryTraceWriter *writer, uint32_t source)
+  {
+    return MakeBoundCallback (&Sink::Record, writer, source);
+  }
+};
+
+} // namespace binarytrace
+
+template <typename... Ts>
+void
+BinaryTraceRecorder::RegisterSignature (std::string type)
+{
+  RegisterSignature (type, &binarytrace::Sink<Ts...>::Make);
+}
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_RECORDER_H */
@@ -0,0 +1,319 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace-file.h"
+#include "abort.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup tracing
+ * ns3::BinaryTraceWriter and ns3::BinaryTraceReader implementations.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+namespace binarytrace {
+
+/** The file magic number, "ns3b" in ASCII, in host byte order. */
+static const uint32_t MAGIC = 0x6e733362;
+/** The file format version. */
+static const uint32_t VERSION = 1;
+/** The initial size of the mapped file. */
+static const uint64_t INITIAL_CAPACITY = 1 << 20;
+
+/** The on-disk file header. */
+struct FileHeader
+{
+  uint32_t magic;    /**< MAGIC. */
+  uint32_t version;  /**< VERSION. */
+};
+
+} // namespace binarytrace
+
+
+BinaryTraceWriter::BinaryTraceWriter ()
+  : m_fd (-1),
+    m_data (0),
+    m_capacity (0),
+    m_size (0),
+    m_sources (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+BinaryTraceWriter::Open (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  m_fd = open (filename.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  NS_ABORT_MSG_IF (m_fd == -1, "Unable to open " << filename << ": "
+                   << std::strerror (errno));
+  m_size = 0;
+  m_sources = 0;
+  Grow (binarytrace::INITIAL_CAPACITY);
+
+  binarytrace::FileHeader header;
+  header.magic = binarytrace::MAGIC;
+  header.version = binarytrace::VERSION;
+  std::memcpy (m_data, &header, sizeof (header));
+  m_size = sizeof (header);
+}
+
+void
+BinaryTraceWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fd == -1)
+    {
+      return;
+    }
+  Unmap ();
+  if (ftruncate (m_fd, m_size) != 0)
+    {
+      NS_LOG_WARN ("Unable to truncate the trace file: " << std::strerror (errno));
+    }
+  close (m_fd);
+  m_fd = -1;
+}
+
+bool
+BinaryTraceWriter::IsOpen (void) const
+{
+  return m_fd != -1;
+}
+
+uint32_t
+BinaryTraceWriter::AddSource (std::string path, std::string type)
+{
+  NS_LOG_FUNCTION (this << path << type);
+  uint8_t *buffer = Reserve (DEFINITION, path.size () + type.size () + 2);
+  if (buffer != 0)
+    {
+      std::memcpy (buffer, path.c_str (), path.size () + 1);
+      std::memcpy (buffer + path.size () + 1, type.c_str (), type.size () + 1);
+    }
+  return m_sources++;
+}
+
+uint64_t
+BinaryTraceWriter::GetSize (void) const
+{
+  return m_size;
+}
+
+void
+BinaryTraceWriter::Grow (uint64_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  uint64_t capacity = std::max (size, 2 * m_capacity);
+  Unmap ();
+  NS_ABORT_MSG_IF (ftruncate (m_fd, capacity) != 0,
+                   "Unable to grow the trace file: " << std::strerror (errno));
+  void *data = mmap (0, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  NS_ABORT_MSG_IF (data == MAP_FAILED,
+                   "Unable to map the trace file: " << std::strerror (errno));
+  m_data = static_cast<uint8_t *> (data);
+  m_capacity = capacity;
+}
+
+void
+BinaryTraceWriter::Unmap (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+      munmap (m_data, m_capacity);
+      m_data = 0;
+      m_capacity = 0;
+    }
+}
+
+
+BinaryTraceReader::Record::Record ()
+  : m_source (0),
+    m_time (0),
+    m_data (0),
+    m_size (0),
+    m_offset (0)
+{}
+
+uint32_t
+BinaryTraceReader::Record::GetSource (void) const
+{
+  return m_source;
+}
+
+Time
+BinaryTraceReader::Record::GetTime (void) const
+{
+  return TimeStep (m_time);
+}
+
+uint32_t
+BinaryTraceReader::Record::GetSize (void) const
+{
+  return m_size;
+}
+
+const uint8_t *
+BinaryTraceReader::Record::GetData (void) const
+{
+  return m_data;
+}
+
+
+BinaryTraceReader::BinaryTraceReader ()
+  : m_data (0),
+    m_size (0),
+    m_offset (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceReader::~BinaryTraceReader ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+BinaryTraceReader::Open (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd == -1)
+    {
+      NS_LOG_WARN ("Unable to open " << filename << ": " << std::strerror (errno));
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0
+      || st.st_size < static_cast<off_t> (sizeof (binarytrace::FileHeader)))
+    {
+      NS_LOG_WARN ("Not a binary trace file: " << filename);
+      close (fd);
+      return false;
+    }
+  void *data = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Unable to map " << filename << ": " << std::strerror (errno));
+      return false;
+    }
+  m_data = static_cast<const uint8_t *> (data);
+  m_size = st.st_size;
+
+  binarytrace::FileHeader header;
+  std::memcpy (&header, m_data, sizeof (header));
+  if (header.magic != binarytrace::MAGIC || header.version != binarytrace::VERSION)
+    {
+      NS_LOG_WARN ("Not a binary trace file, or from a host of another "
+                   "byte order: " << filename);
+      Close ();
+      return false;
+    }
+  m_offset = sizeof (header);
+  return true;
+}
+
+void
+BinaryTraceReader::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+      munmap (const_cast<uint8_t *> (m_data), m_size);
+      m_data = 0;
+    }
+  m_size = 0;
+  m_offset = 0;
+  m_sources.clear ();
+}
+
+bool
+BinaryTraceReader::Next (Record &record)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_offset + sizeof (binarytrace::RecordHeader) <= m_size)
+    {
+      binarytrace::RecordHeader header;
+      std::memcpy (&header, m_data + m_offset, sizeof (header));
+      const uint8_t *payload = m_data + m_offset + sizeof (header);
+      if (m_offset + sizeof (header) + header.size > m_size)
+        {
+          NS_LOG_WARN ("Truncated record at offset " << m_offset);
+          return false;
+        }
+      m_offset += sizeof (header) + header.size;
+
+      if (header.source == BinaryTraceWriter::DEFINITION)
+        {
+          const char *strings = reinterpret_cast<const char *> (payload);
+          const char *end = strings + header.size;
+          const char *split = std::find (strings, end, '\0');
+          Source source;
+          source.path.assign (strings, split);
+          if (split != end)
+            {
+              source.type.assign (split + 1, std::find (split + 1, end, '\0'));
+            }
+          m_sources.push_back (source);
+          continue;
+        }
+
+      record.m_source = header.source;
+      record.m_time = header.time;
+      record.m_data = payload;
+      record.m_size = header.size;
+      record.m_offset = 0;
+      return true;
+    }
+  return false;
+}
+
+uint32_t
+BinaryTraceReader::GetNSources (void) const
+{
+  return m_sources.size ();
+}
+
+const BinaryTraceReader::Source &
+BinaryTraceReader::GetSource (uint32_t id) const
+{
+  NS_ASSERT_MSG (id < m_sources.size (), "Unknown source " << id);
+  return m_sources[id];
+}
+
+} // namespace ns3
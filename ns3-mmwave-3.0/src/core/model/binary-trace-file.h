@@ -0,0 +1,399 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <stdint.h>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "simple-ref-count.h"
+#include "simulator.h"
+#include "nstime.h"
+#include "assert.h"
+#include "likely.h"
+
+/**
+ * \file
+ * \ingroup tracing
+ * ns3::BinaryTraceWriter, ns3::BinaryTraceReader and
+ * ns3::BinaryTraceEncoder declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup tracing
+ * \brief Encode a trace argument into a binary trace record.
+ *
+ * Each specialization encodes a type in a fixed number of bytes,
+ * and provides
+ * \code
+ *   static const uint32_t SIZE;
+ *   static void Write (uint8_t *buffer, const T &value);
+ * \endcode
+ * Specializations which can be decoded by BinaryTraceReader::Record::Read
+ * also provide
+ * \code
+ *   static T Read (const uint8_t *buffer);
+ * \endcode
+ * Arithmetic and enum types are copied as they are in memory;
+ * Time is encoded as its int64_t time step.
+ *
+ * \tparam T \explicit The type to encode.
+ * \tparam Enable \internal SFINAE helper.
+ */
+template <typename T, typename Enable = void>
+struct BinaryTraceEncoder;
+
+/**
+ * \ingroup tracing
+ * BinaryTraceEncoder for arithmetic and enum types.
+ * \tparam T \explicit The type to encode.
+ */
+template <typename T>
+struct BinaryTraceEncoder<T, typename std::enable_if<std::is_arithmetic<T>::value
+                                                     || std::is_enum<T>::value>::type>
+{
+  /** The size of an encoded value. */
+  static const uint32_t SIZE = sizeof (T);
+  /**
+   * Encode a value.
+   * \param [out] buffer The SIZE bytes to write to.
+   * \param [in] value The value.
+   */
+  static void Write (uint8_t *buffer, T value)
+  {
+    std::memcpy (buffer, &value, sizeof (T));
+  }
+  /**
+   * Decode a value.
+   * \param [in] buffer The SIZE bytes to read from.
+   * \returns The value.
+   */
+  static T Read (const uint8_t *buffer)
+  {
+    T value;
+    std::memcpy (&value, buffer, sizeof (T));
+    return value;
+  }
+};
+
+/**
+ * \ingroup tracing
+ * BinaryTraceEncoder for Time, encoded as its time step.
+ */
+template <>
+struct BinaryTraceEncoder<Time>
+{
+  /** The size of an encoded value. */
+  static const uint32_t SIZE = sizeof (int64_t);
+  /**
+   * Encode a value.
+   * \param [out] buffer The SIZE bytes to write to.
+   * \param [in] value The value.
+   */
+  static void Write (uint8_t *buffer, const Time &value)
+  {
+    BinaryTraceEncoder<int64_t>::Write (buffer, value.GetTimeStep ());
+  }
+  /**
+   * Decode a value.
+   * \param [in] buffer The SIZE bytes to read from.
+   * \returns The value.
+   */
+  static Time Read (const uint8_t *buffer)
+  {
+    return TimeStep (BinaryTraceEncoder<int64_t>::Read (buffer));
+  }
+};
+
+
+/**
+ * \ingroup tracing
+ * \brief Write binary trace records to a memory-mapped file.
+ *
+ * The file starts with a header holding a magic number and a version,
+ * followed by records.  Each record has a fixed header, holding the size
+ * of its payload, the source which emitted it and the simulation time step,
+ * followed by the payload.  The payload of a trace record is the
+ * concatenation of the arguments of the trace, each encoded by its
+ * BinaryTraceEncoder.  Sources are described by definition records,
+ * written by AddSource.  All values are in the byte order of the host.
+ *
+ * Writing a record costs a bounds check and copying the arguments;
+ * the file is grown, by doubling its size, when full, and truncated to
+ * its contents by Close.
+ */
+class BinaryTraceWriter : public SimpleRefCount<BinaryTraceWriter>
+{
+public:
+  /** The source id marking a source definition record. */
+  static const uint32_t DEFINITION = 0xffffffff;
+
+  /** Constructor. */
+  BinaryTraceWriter ();
+  /** Destructor; closes the file. */
+  ~BinaryTraceWriter ();
+
+  /**
+   * Create a file and write its header.  Aborts if the file
+   * cannot be created or mapped.
+   *
+   * \param [in] filename The file name.
+   */
+  void Open (std::string filename);
+  /**
+   * Truncate the file to its records and close it.
+   * Records reserved after Close are discarded.
+   */
+  void Close (void);
+  /**
+   * Check if the file is open.
+   * \returns \c true if the file is open.
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * Define a new source, and write its definition record.
+   *
+   * \param [in] path The path of the source, for example
+   *             the Config path of a trace source.
+   * \param [in] type The name of the signature of the source, for example
+   *             the callback name of a trace source.
+   * \returns The id of the new source, for Reserve.
+   */
+  uint32_t AddSource (std::string path, std::string type);
+
+  /**
+   * Start a record, stamped with the current simulation time.
+   *
+   * \param [in] source The id of the source, from AddSource.
+   * \param [in] size The size of the payload.
+   * \returns The \p size bytes of the payload to fill in,
+   *          or 0 if the file is closed.
+   */
+  uint8_t * Reserve (uint32_t source, uint32_t size);
+
+  /**
+   * Get the size of the records written so far, including the file header.
+   * \returns The size in bytes.
+   */
+  uint64_t GetSize (void) const;
+
+private:
+  /**
+   * Grow the file to hold at least \p size bytes.
+   * \param [in] size The needed size in bytes.
+   */
+  void Grow (uint64_t size);
+  /** Unmap the file. */
+  void Unmap (void);
+
+  /** The file descriptor, or -1 when closed. */
+  int m_fd;
+  /** The mapped file, or 0 when closed. */
+  uint8_t *m_data;
+  /** The size of the mapped file. */
+  uint64_t m_capacity;
+  /** The size of the records written. */
+  uint64_t m_size;
+  /** The number of sources defined. */
+  uint32_t m_sources;
+};
+
+
+/**
+ * \ingroup tracing
+ * \brief Read the records of a file written by BinaryTraceWriter.
+ *
+ * The file is mapped read-only; records are read in order with Next,
+ * and the source definitions are collected as they are met.
+ * \code
+ *   BinaryTraceReader reader;
+ *   reader.Open ("trace.bin");
+ *   BinaryTraceReader::Record record;
+ *   while (reader.Next (record))
+ *     {
+ *       const BinaryTraceReader::Source &source = reader.GetSource (record.GetSource ());
+ *       double oldValue = record.Read<double> ();
+ *       double newValue = record.Read<double> ();
+ *       ...
+ *     }
+ * \endcode
+ */
+class BinaryTraceReader
+{
+public:
+  /** The description of a source. */
+  struct Source
+  {
+    std::string path;  /**< The path of the source. */
+    std::string type;  /**< The name of the signature of the source. */
+  };
+
+  /** A trace record. */
+  class Record
+  {
+  public:
+    /** Constructor. */
+    Record ();
+    /**
+     * Get the source of this record.
+     * \returns The source id.
+     */
+    uint32_t GetSource (void) const;
+    /**
+     * Get the simulation time of this record.
+     * \returns The time.
+     */
+    Time GetTime (void) const;
+    /**
+     * Get the size of the payload of this record.
+     * \returns The size in bytes.
+     */
+    uint32_t GetSize (void) const;
+    /**
+     * Get the payload of this record.
+     * \returns The payload.
+     */
+    const uint8_t * GetData (void) const;
+    /**
+     * Decode the next value of the payload.
+     * \tparam T \deduced The type of the value.
+     * \returns The value.
+     */
+    template <typename T>
+    T Read (void);
+
+  private:
+    friend class BinaryTraceReader;
+    uint32_t m_source;       /**< The source id. */
+    int64_t m_time;          /**< The time step. */
+    const uint8_t *m_data;   /**< The payload. */
+    uint32_t m_size;         /**< The payload size. */
+    uint32_t m_offset;       /**< The read position in the payload. */
+  };
+
+  /** Constructor. */
+  BinaryTraceReader ();
+  /** Destructor; closes the file. */
+  ~BinaryTraceReader ();
+
+  /**
+   * Open a file.
+   * \param [in] filename The file name.
+   * \returns \c true if the file could be mapped and has a valid header.
+   */
+  bool Open (std::string filename);
+  /** Close the file. */
+  void Close (void);
+
+  /**
+   * Read the next trace record.
+   *
+   * The record refers to the mapped file, and is valid until Close.
+   *
+   * \param [out] record The record.
+   * \returns \c false at the end of the file, or on a truncated record.
+   */
+  bool Next (Record &record);
+
+  /**
+   * Get the number of sources defined so far.
+   * \returns The number of sources.
+   */
+  uint32_t GetNSources (void) const;
+  /**
+   * Get a source definition.
+   * \param [in] id The source id.
+   * \returns The source.
+   */
+  const Source & GetSource (uint32_t id) const;
+
+private:
+  /** The mapped file, or 0 when closed. */
+  const uint8_t *m_data;
+  /** The size of the file. */
+  uint64_t m_size;
+  /** The read position. */
+  uint64_t m_offset;
+  /** The sources, by id. */
+  std::vector<Source> m_sources;
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+namespace binarytrace {
+
+/**
+ * \ingroup tracing
+ * The on-disk record header.
+ */
+struct RecordHeader
+{
+  uint32_t size;    /**< The payload size. */
+  uint32_t source;  /**< The source id, or BinaryTraceWriter::DEFINITION. */
+  int64_t time;     /**< The simulation time step. */
+};
+
+} // namespace binarytrace
+
+inline uint8_t *
+BinaryTraceWriter::Reserve (uint32_t source, uint32_t size)
+{
+  uint64_t end = m_size + sizeof (binarytrace::RecordHeader) + size;
+  if (NS_UNLIKELY (end > m_capacity))
+    {
+      if (m_data == 0)
+        {
+          return 0;
+        }
+      Grow (end);
+    }
+  binarytrace::RecordHeader header;
+  header.size = size;
+  header.source = source;
+  header.time = Simulator::Now ().GetTimeStep ();
+  uint8_t *record = m_data + m_size;
+  std::memcpy (record, &header, sizeof (header));
+  m_size = end;
+  return record + sizeof (header);
+}
+
+template <typename T>
+T
+BinaryTraceReader::Record::Read (void)
+{
+  NS_ASSERT_MSG (m_offset + BinaryTraceEncoder<T>::SIZE <= m_size,
+                 "Read past the end of the record");
+  T value = BinaryTraceEncoder<T>::Read (m_data + m_offset);
+  m_offset += BinaryTraceEncoder<T>::SIZE;
+  return value;
+}
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
@@ -26,7 +26,10 @@
 #include "pointer.h"
 #include "log.h"
 
+#include <limits>
+#include <map>
 #include <sstream>
+#include <utility>
 
 /**
  * \file
@@ -182,6 +185,8 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, into a list of index ranges.
  */
 class ArrayMatcher
 {
@@ -201,6 +206,12 @@ public:
   bool Matches (std::size_t i) const;
 
 private:
+  /**
+   * Parse a Config path specification into index ranges.
+   *
+   * \param [in] element The Config path specification.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -211,6 +222,8 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** The inclusive ranges of indices matching the element. */
+  std::vector<std::pair<std::size_t, std::size_t> > m_ranges;
 
 };  // class ArrayMatcher
 
@@ -219,66 +232,59 @@ ArrayMatcher::ArrayMatcher (std::string element)
   : m_element (element)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (std::size_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array " << i << " matches *");
-      return true;
+      m_ranges.push_back (std::make_pair (0, std::numeric_limits<std::size_t>::max ()));
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp - 0);
-      std::string right = m_element.substr (tmp + 1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
-      return false;
+      Parse (element.substr (0, tmp - 0));
+      Parse (element.substr (tmp + 1, element.size () - (tmp + 1)));
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1
       && dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min)
-          && StringToUint32 (upperBound, &max)
-          && i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
-          return true;
-        }
-      else
+          && StringToUint32 (upperBound, &max))
         {
-          NS_LOG_DEBUG ("Array " << i << " does not " << m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value)
-      && i == value)
+  if (StringToUint32 (element, &value))
     {
-      NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
-      return true;
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  for (std::size_t j = 0; j < m_ranges.size (); ++j)
+    {
+      if (i >= m_ranges[j].first && i <= m_ranges[j].second)
+        {
+          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
+          return true;
+        }
     }
   NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
   return false;
@@ -294,6 +300,243 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * \ingroup config-impl
+ * One element of a parsed Config path.
+ */
+class PathElement
+{
+public:
+  /**
+   * An attribute matching the element, which leads to more objects.
+   */
+  struct Attribute
+  {
+    /** The attribute name. */
+    std::string name;
+    /** The attribute accessor, or null to use ObjectBase::GetAttribute. */
+    Ptr<const AttributeAccessor> accessor;
+    /** \c true for a PointerValue attribute. */
+    bool isPointer;
+    /** \c true for an ObjectPtrContainerValue attribute. */
+    bool isContainer;
+  };
+  /** A list of attributes. */
+  typedef std::vector<Attribute> Attributes;
+
+  /**
+   * Parse an element.
+   *
+   * \param [in] item The element, between two slashes of the path.
+   */
+  PathElement (std::string item);
+
+  /**
+   * Get the attributes of an object matching this element.
+   *
+   * The attributes are looked up once for each TypeId.
+   *
+   * \param [in] objectTid The TypeId of the object.
+   * \returns The matching attributes, from the most derived type.
+   */
+  const Attributes & GetAttributes (TypeId objectTid);
+
+  /** The element. */
+  std::string item;
+  /** For a \c $TypeId element, \c true if the TypeId was found. */
+  bool hasTid;
+  /** For a \c $TypeId element, the TypeId. */
+  TypeId tid;
+  /** The element as an array index. */
+  ArrayMatcher matcher;
+
+private:
+  /** The matching attributes, by TypeId uid. */
+  std::map<uint16_t, Attributes> m_attributes;
+};
+
+PathElement::PathElement (std::string item)
+  : item (item),
+    hasTid (false),
+    matcher (item)
+{
+  NS_LOG_FUNCTION (this << item);
+  if (item.find ("$") == 0)
+    {
+      hasTid = TypeId::LookupByNameFailSafe (item.substr (1, item.size () - 1), &tid);
+    }
+}
+
+const PathElement::Attributes &
+PathElement::GetAttributes (TypeId objectTid)
+{
+  NS_LOG_FUNCTION (this << objectTid);
+  std::map<uint16_t, Attributes>::const_iterator found = m_attributes.find (objectTid.GetUid ());
+  if (found != m_attributes.end ())
+    {
+      return found->second;
+    }
+
+  Attributes &attributes = m_attributes[objectTid.GetUid ()];
+  TypeId current;
+  TypeId nextTid = objectTid;
+  do
+    {
+      current = nextTid;
+
+      for (uint32_t i = 0; i < current.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info;
+          info = current.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          Attribute attribute;
+          attribute.name = info.name;
+          attribute.isPointer =
+            dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0;
+          attribute.isContainer =
+            dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0;
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+          if (!attribute.isPointer && !attribute.isContainer)
+            {
+              continue;
+            }
+          // ObjectBase::GetAttribute looks the name up from the most derived type.
+          struct TypeId::AttributeInformation resolved;
+          if (objectTid.LookupAttributeByName (info.name, &resolved)
+              && (resolved.flags & TypeId::ATTR_GET)
+              && resolved.accessor->HasGetter ())
+            {
+              attribute.accessor = resolved.accessor;
+            }
+          attributes.push_back (attribute);
+        }
+
+      nextTid = current.GetParent ();
+    }
+  while (nextTid != current);
+  return attributes;
+}
+
+/**
+ * \ingroup config-impl
+ * A parsed Config path.
+ */
+class PathImpl : public SimpleRefCount<PathImpl>
+{
+public:
+  /** A list of path elements. */
+  typedef std::vector<PathElement> Elements;
+
+  /**
+   * Parse a Config path.
+   *
+   * \param [in] path The Config path.
+   */
+  PathImpl (std::string path);
+
+  /**
+   * Split a Config path into its elements.
+   *
+   * The path is made to start and end with a '/' first.
+   *
+   * \param [in] path The Config path.
+   * \returns The elements.
+   */
+  static Elements Split (std::string path);
+
+  /** The Config path. */
+  std::string path;
+  /** The leading part of \c path, up to the final slash. */
+  std::string root;
+  /** The trailing part of \c path, after the final slash. */
+  std::string leaf;
+  /** The elements of \c path. */
+  Elements pathElements;
+  /** The elements of \c root. */
+  Elements rootElements;
+};
+
+PathImpl::PathImpl (std::string path)
+  : path (path)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::string::size_type slash = path.find_last_of ("/");
+  if (slash != std::string::npos)
+    {
+      root = path.substr (0, slash);
+      leaf = path.substr (slash + 1, path.size () - (slash + 1));
+    }
+  else
+    {
+      leaf = path;
+    }
+  pathElements = Split (path);
+  rootElements = Split (root);
+}
+
+PathImpl::Elements
+PathImpl::Split (std::string path)
+{
+  NS_LOG_FUNCTION (path);
+
+  // ensure that we start and end with a '/'
+  std::string::size_type tmp = path.find ("/");
+  if (tmp != 0)
+    {
+      // no slash at start
+      path = "/" + path;
+    }
+  tmp = path.find_last_of ("/");
+  if (tmp != (path.size () - 1))
+    {
+      // no slash at end
+      path = path + "/";
+    }
+
+  Elements elements;
+  std::string::size_type start = 0;
+  std::string::size_type next = path.find ("/", 1);
+  while (next != std::string::npos)
+    {
+      elements.push_back (PathElement (path.substr (start + 1, next - (start + 1))));
+      start = next;
+      next = path.find ("/", start + 1);
+    }
+  return elements;
+}
+
+Path::Path (std::string path)
+  : m_impl (Create<PathImpl> (path))
+{
+  NS_LOG_FUNCTION (this << path);
+}
+Path::Path (const Path &o)
+  : m_impl (o.m_impl)
+{
+  NS_LOG_FUNCTION (this << &o);
+}
+Path &
+Path::operator = (const Path &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  m_impl = o.m_impl;
+  return *this;
+}
+Path::~Path ()
+{
+  NS_LOG_FUNCTION (this);
+}
+std::string
+Path::GetPath (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_impl->path;
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
@@ -302,11 +545,11 @@ class Resolver
 {
 public:
   /**
-   * Construct from a base Config path.
+   * Construct from the elements of a Config path.
    *
-   * \param [in] path The Config path.
+   * \param [in] elements The elements of the Config path.
    */
-  Resolver (std::string path);
+  Resolver (PathImpl::Elements &elements);
   /** Destructor. */
   virtual ~Resolver ();
 
@@ -320,23 +563,30 @@ public:
   void Resolve (Ptr<Object> root);
 
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] i The index of the next element of the Config path.
    * \param [in] root The object corresponding to the current position
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t i, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
+   * \param [in] i The index of the next element of the Config path.
    * \param [in,out] vector The resulting list of matching objects.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::size_t i, const ObjectPtrContainerValue &vector);
+  /**
+   * Get the value of an attribute on the Config path.
+   *
+   * \param [in] object The object.
+   * \param [in] attribute The attribute.
+   * \param [out] value The attribute value.
+   */
+  void GetAttribute (Ptr<Object> object, const PathElement::Attribute &attribute,
+                     AttributeValue &value) const;
   /**
    * Handle one object found on the path.
    *
@@ -359,47 +609,27 @@ private:
 
   /** Current list of path tokens. */
   std::vector<std::string> m_workStack;
-  /** The Config path. */
-  std::string m_path;
+  /** The elements of the Config path. */
+  PathImpl::Elements &m_elements;
 
 };  // class Resolver
 
-Resolver::Resolver (std::string path)
-  : m_path (path)
+Resolver::Resolver (PathImpl::Elements &elements)
+  : m_elements (elements)
 {
-  NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
+  NS_LOG_FUNCTION (this << &elements);
 }
 Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
 }
-void
-Resolver::Canonicalize (void)
-{
-  NS_LOG_FUNCTION (this);
-
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
-    {
-      // no slash at start
-      m_path = "/" + m_path;
-    }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
-    {
-      // no slash at end
-      m_path = m_path + "/";
-    }
-}
 
 void
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -425,13 +655,23 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::GetAttribute (Ptr<Object> object, const PathElement::Attribute &attribute,
+                        AttributeValue &value) const
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << object << attribute.name << &value);
+  if (attribute.accessor == 0
+      || !attribute.accessor->Get (PeekPointer (object), value))
+    {
+      object->GetAttribute (attribute.name, value);
+    }
+}
 
-  if (next == std::string::npos)
+void
+Resolver::DoResolve (std::size_t i, Ptr<Object> root)
+{
+  NS_LOG_FUNCTION (this << i << root);
+
+  if (i == m_elements.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name
@@ -447,8 +687,8 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  PathElement &element = m_elements[i];
+  const std::string &item = element.item;
 
   //
   // If root is zero, we're beginning to see if we can use the object name
@@ -459,11 +699,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.compare (0, 5, "Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (i + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -480,7 +719,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (i + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -502,7 +741,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
       // This is a call to GetObject
       std::string tidString = item.substr (1, item.size () - 1);
       NS_LOG_DEBUG ("GetObject=" << tidString << " on path=" << GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      TypeId tid = element.hasTid ? element.tid : TypeId::LookupByName (tidString);
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
@@ -510,68 +749,46 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (i + 1, object);
       m_workStack.pop_back ();
     }
   else
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      const PathElement::Attributes &attributes = element.GetAttributes (root->GetInstanceTypeId ());
       bool foundMatch = false;
 
-      do
+      for (PathElement::Attributes::const_iterator info = attributes.begin (); info != attributes.end (); ++info)
         {
-          tid = nextTid;
-
-          for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+          if (info->isPointer)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute (i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)=" << info->name << " on path=" << GetResolvedPath ());
+              PointerValue pValue;
+              GetAttribute (root, *info, pValue);
+              Ptr<Object> object = pValue.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\"" << item <<
+                                "\" exists on path=\"" << GetResolvedPath () << "\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (pChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)=" << info.name << " on path=" << GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\"" << item <<
-                                    "\" exists on path=\"" << GetResolvedPath () << "\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker =
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)=" << info.name << " on path=" << GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              m_workStack.push_back (info->name);
+              DoResolve (i + 1, object);
+              m_workStack.pop_back ();
+            }
+          if (info->isContainer)
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)=" << info->name << " on path=" << GetResolvedPath ());
+              foundMatch = true;
+              ObjectPtrContainerValue vector;
+              GetAttribute (root, *info, vector);
+              m_workStack.push_back (info->name);
+              DoArrayResolve (i + 1, vector);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
         }
-      while (nextTid != tid);
 
       if (!foundMatch)
         {
@@ -582,20 +799,15 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (std::size_t i, const ObjectPtrContainerValue &container)
 {
-  NS_LOG_FUNCTION (this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << i << &container);
+  if (i == m_elements.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  const ArrayMatcher &matcher = m_elements[i].matcher;
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
@@ -604,7 +816,7 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (i + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
@@ -619,20 +831,20 @@ class ConfigImpl : public Singleton<ConfigImpl>
 public:
   // Keep Set and SetFailSafe since their errors are triggered
   // by the underlying ObjecBase functions.
-  /** \copydoc Config::Set() */
-  void Set (std::string path, const AttributeValue &value);
-  /** \copydoc Config::SetFailSafe() */
-  bool SetFailSafe (std::string path, const AttributeValue &value);
-  /** \copydoc Config::ConnectWithoutContextFailSafe() */
-  bool ConnectWithoutContextFailSafe (std::string path, const CallbackBase &cb);
-  /** \copydoc Config::ConnectFailSafe() */
-  bool ConnectFailSafe (std::string path, const CallbackBase &cb);
-  /** \copydoc Config::DisconnectWithoutContext() */
-  void DisconnectWithoutContext (std::string path, const CallbackBase &cb);
-  /** \copydoc Config::Disconnect() */
-  void Disconnect (std::string path, const CallbackBase &cb);
-  /** \copydoc Config::LookupMatches() */
-  MatchContainer LookupMatches (std::string path);
+  /** \copydoc Config::Set(const Path&,const AttributeValue&) */
+  void Set (const Path &path, const AttributeValue &value);
+  /** \copydoc Config::SetFailSafe(const Path&,const AttributeValue&) */
+  bool SetFailSafe (const Path &path, const AttributeValue &value);
+  /** \copydoc Config::ConnectWithoutContextFailSafe(const Path&,const CallbackBase&) */
+  bool ConnectWithoutContextFailSafe (const Path &path, const CallbackBase &cb);
+  /** \copydoc Config::ConnectFailSafe(const Path&,const CallbackBase&) */
+  bool ConnectFailSafe (const Path &path, const CallbackBase &cb);
+  /** \copydoc Config::DisconnectWithoutContext(const Path&,const CallbackBase&) */
+  void DisconnectWithoutContext (const Path &path, const CallbackBase &cb);
+  /** \copydoc Config::Disconnect(const Path&,const CallbackBase&) */
+  void Disconnect (const Path &path, const CallbackBase &cb);
+  /** \copydoc Config::LookupMatches(const Path&) */
+  MatchContainer LookupMatches (const Path &path);
 
   /** \copydoc Config::RegisterRootNamespaceObject() */
   void RegisterRootNamespaceObject (Ptr<Object> obj);
@@ -646,13 +858,27 @@ public:
 
 private:
   /**
-   * Break a Config path into the leading path and the last leaf token.
+   * Find the objects matching the elements of a Config path.
+   *
+   * \param [in] elements The elements of the Config path.
+   * \param [in] path The Config path.
+   * \returns The matching objects.
+   */
+  MatchContainer DoLookupMatches (PathImpl::Elements &elements, std::string path);
+  /**
+   * Find the objects matching the leading part of a Config path,
+   * up to the final slash.
+   *
+   * \param [in] path The Config path.
+   * \returns The matching objects.
+   */
+  MatchContainer LookupRootMatches (const Path &path);
+  /**
+   * Warn that a Disconnect matched no object.
+   *
    * \param [in] path The Config path.
-   * \param [in,out] root The leading part of the \pname{path},
-   *   up to the final slash.
-   * \param [in,out] leaf The trailing part of the \pname{path}.
    */
-  void ParsePath (std::string path, std::string *root, std::string *leaf) const;
+  void WarnNoMatch (const Path &path) const;
 
   /** Container type to hold the root Config path tokens. */
   typedef std::vector<Ptr<Object> > Roots;
@@ -662,100 +888,97 @@ private:
 
 };  // class ConfigImpl
 
-void
-ConfigImpl::ParsePath (std::string path, std::string *root, std::string *leaf) const
+MatchContainer
+ConfigImpl::LookupRootMatches (const Path &path)
 {
-  NS_LOG_FUNCTION (this << path << root << leaf);
+  NS_LOG_FUNCTION (this << path.GetPath ());
+  PathImpl *impl = PeekPointer (path.m_impl);
+  return DoLookupMatches (impl->rootElements, impl->root);
+}
 
-  std::string::size_type slash = path.find_last_of ("/");
-  NS_ASSERT (slash != std::string::npos);
-  *root = path.substr (0, slash);
-  *leaf = path.substr (slash + 1, path.size () - (slash + 1));
-  NS_LOG_FUNCTION (path << *root << *leaf);
+void
+ConfigImpl::WarnNoMatch (const Path &path) const
+{
+  NS_LOG_FUNCTION (this << path.GetPath ());
+  const std::string &root = path.m_impl->root;
+  std::size_t lastFwdSlash = root.rfind ("/");
+  NS_LOG_WARN ("Failed to disconnect " << path.m_impl->leaf
+                                       << ", the Requested object name = " << root.substr (lastFwdSlash + 1)
+                                       << " does not exits on path " << root.substr (0, lastFwdSlash));
 }
 
 void
-ConfigImpl::Set (std::string path, const AttributeValue &value)
+ConfigImpl::Set (const Path &path, const AttributeValue &value)
 {
-  NS_LOG_FUNCTION (this << path << &value);
+  NS_LOG_FUNCTION (this << path.GetPath () << &value);
 
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
-  container.Set (leaf, value);
+  MatchContainer container = LookupRootMatches (path);
+  container.Set (path.m_impl->leaf, value);
 }
 bool
-ConfigImpl::SetFailSafe (std::string path, const AttributeValue &value)
+ConfigImpl::SetFailSafe (const Path &path, const AttributeValue &value)
 {
-  NS_LOG_FUNCTION (this << path << &value);
+  NS_LOG_FUNCTION (this << path.GetPath () << &value);
 
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
-  return container.SetFailSafe (leaf, value);
+  MatchContainer container = LookupRootMatches (path);
+  return container.SetFailSafe (path.m_impl->leaf, value);
 }
 bool
-ConfigImpl::ConnectWithoutContextFailSafe (std::string path, const CallbackBase &cb)
+ConfigImpl::ConnectWithoutContextFailSafe (const Path &path, const CallbackBase &cb)
 {
-  NS_LOG_FUNCTION (this << path << &cb);
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
-  return container.ConnectWithoutContextFailSafe (leaf, cb);
+  NS_LOG_FUNCTION (this << path.GetPath () << &cb);
+  MatchContainer container = LookupRootMatches (path);
+  return container.ConnectWithoutContextFailSafe (path.m_impl->leaf, cb);
 }
 void
-ConfigImpl::DisconnectWithoutContext (std::string path, const CallbackBase &cb)
+ConfigImpl::DisconnectWithoutContext (const Path &path, const CallbackBase &cb)
 {
-  NS_LOG_FUNCTION (this << path << &cb);
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
+  NS_LOG_FUNCTION (this << path.GetPath () << &cb);
+  MatchContainer container = LookupRootMatches (path);
   if (container.GetN () == 0)
     {
-      std::size_t lastFwdSlash = root.rfind ("/");
-      NS_LOG_WARN ("Failed to disconnect " << leaf
-                                           << ", the Requested object name = " << root.substr (lastFwdSlash + 1)
-                                           << " does not exits on path " << root.substr (0, lastFwdSlash));
+      WarnNoMatch (path);
     }
-  container.DisconnectWithoutContext (leaf, cb);
+  container.DisconnectWithoutContext (path.m_impl->leaf, cb);
 }
 bool
-ConfigImpl::ConnectFailSafe (std::string path, const CallbackBase &cb)
+ConfigImpl::ConnectFailSafe (const Path &path, const CallbackBase &cb)
 {
-  NS_LOG_FUNCTION (this << path << &cb);
+  NS_LOG_FUNCTION (this << path.GetPath () << &cb);
 
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
-  return container.ConnectFailSafe (leaf, cb);
+  MatchContainer container = LookupRootMatches (path);
+  return container.ConnectFailSafe (path.m_impl->leaf, cb);
 }
 void
-ConfigImpl::Disconnect (std::string path, const CallbackBase &cb)
+ConfigImpl::Disconnect (const Path &path, const CallbackBase &cb)
 {
-  NS_LOG_FUNCTION (this << path << &cb);
+  NS_LOG_FUNCTION (this << path.GetPath () << &cb);
 
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  MatchContainer container = LookupMatches (root);
+  MatchContainer container = LookupRootMatches (path);
   if (container.GetN () == 0)
     {
-      std::size_t lastFwdSlash = root.rfind ("/");
-      NS_LOG_WARN ("Failed to disconnect " << leaf
-                                           << ", the Requested object name = " << root.substr (lastFwdSlash + 1)
-                                           << " does not exits on path " << root.substr (0, lastFwdSlash));
+      WarnNoMatch (path);
     }
-  container.Disconnect (leaf, cb);
+  container.Disconnect (path.m_impl->leaf, cb);
 }
 
 MatchContainer
-ConfigImpl::LookupMatches (std::string path)
+ConfigImpl::LookupMatches (const Path &path)
 {
-  NS_LOG_FUNCTION (this << path);
+  NS_LOG_FUNCTION (this << path.GetPath ());
+  PathImpl *impl = PeekPointer (path.m_impl);
+  return DoLookupMatches (impl->pathElements, impl->path);
+}
+
+MatchContainer
+ConfigImpl::DoLookupMatches (PathImpl::Elements &elements, std::string path)
+{
+  NS_LOG_FUNCTION (this << &elements << path);
   class LookupMatchesResolver : public Resolver
   {
 public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
+    LookupMatchesResolver (PathImpl::Elements &elements)
+      : Resolver (elements)
     {
     }
     virtual void DoOne (Ptr<Object> object, std::string path)
@@ -765,7 +988,7 @@ public:
     }
     std::vector<Ptr<Object> > m_objects;
     std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  } resolver = LookupMatchesResolver (elements);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -839,11 +1062,21 @@ void Reset (void)
 void Set (std::string path, const AttributeValue &value)
 {
   NS_LOG_FUNCTION (path << &value);
-  ConfigImpl::Get ()->Set (path, value);
+  ConfigImpl::Get ()->Set (Path (path), value);
 }
 bool SetFailSafe (std::string path, const AttributeValue &value)
 {
   NS_LOG_FUNCTION (path << &value);
+  return ConfigImpl::Get ()->SetFailSafe (Path (path), value);
+}
+void Set (const Path &path, const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (path.GetPath () << &value);
+  ConfigImpl::Get ()->Set (path, value);
+}
+bool SetFailSafe (const Path &path, const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (path.GetPath () << &value);
   return ConfigImpl::Get ()->SetFailSafe (path, value);
 }
 void SetDefault (std::string name, const AttributeValue &value)
@@ -904,11 +1137,26 @@ void ConnectWithoutContext (std::string path, const CallbackBase &cb)
 bool ConnectWithoutContextFailSafe (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
-  return ConfigImpl::Get ()->ConnectWithoutContextFailSafe (path, cb);
+  return ConfigImpl::Get ()->ConnectWithoutContextFailSafe (Path (path), cb);
 }
 void DisconnectWithoutContext (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
+  ConfigImpl::Get ()->DisconnectWithoutContext (Path (path), cb);
+}
+void ConnectWithoutContext (const Path &path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (path.GetPath () << &cb);
+  ConnectWithoutContextFailSafe (path, cb);
+}
+bool ConnectWithoutContextFailSafe (const Path &path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (path.GetPath () << &cb);
+  return ConfigImpl::Get ()->ConnectWithoutContextFailSafe (path, cb);
+}
+void DisconnectWithoutContext (const Path &path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (path.GetPath () << &cb);
   ConfigImpl::Get ()->DisconnectWithoutContext (path, cb);
 }
 void
@@ -924,17 +1172,43 @@ bool
 ConnectFailSafe (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
-  return ConfigImpl::Get ()->ConnectFailSafe (path, cb);
+  return ConfigImpl::Get ()->ConnectFailSafe (Path (path), cb);
 }
 void
 Disconnect (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
+  ConfigImpl::Get ()->Disconnect (Path (path), cb);
+}
+void
+Connect (const Path &path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (path.GetPath () << &cb);
+  if (!ConnectFailSafe (path, cb))
+    {
+      NS_LOG_WARN ("Could not connect callback to " << path.GetPath ());
+    }
+}
+bool
+ConnectFailSafe (const Path &path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (path.GetPath () << &cb);
+  return ConfigImpl::Get ()->ConnectFailSafe (path, cb);
+}
+void
+Disconnect (const Path &path, const CallbackBase &cb)
+{
+  NS_LOG_FUNCTION (path.GetPath () << &cb);
   ConfigImpl::Get ()->Disconnect (path, cb);
 }
 MatchContainer LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (path);
+  return ConfigImpl::Get ()->LookupMatches (Path (path));
+}
+MatchContainer LookupMatches (const Path &path)
+{
+  NS_LOG_FUNCTION (path.GetPath ());
   return ConfigImpl::Get ()->LookupMatches (path);
 }
 
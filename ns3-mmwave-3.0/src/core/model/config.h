@@ -55,6 +55,67 @@ namespace Config {
  */
 void Reset (void);
 
+class PathImpl;
+
+/**
+ * \ingroup config
+ * \brief A Config path, parsed once for repeated use.
+ *
+ * The Config functions taking a path string parse it on every call.
+ * A Path is parsed when it is constructed: the path is split into
+ * its elements, the \c $TypeId elements are looked up and the array
+ * index elements are turned into ranges.  The attributes matching each
+ * element are then indexed by the TypeId of the objects met on the
+ * path, so that a wildcard path walks the same types only once.
+ *
+ * A Path can be passed to the Config functions instead of the string,
+ * and reused as many times as needed:
+ *
+ * \code
+ *   Config::Path path ("/NodeList/[0-99]/DeviceList/0/$ns3::CsmaNetDevice/MacTx");
+ *   Config::Connect (path, MakeCallback (&MacTxTrace));
+ *   Config::Connect (path, MakeCallback (&CountTrace));
+ * \endcode
+ */
+class Path
+{
+public:
+  /**
+   * Parse a Config path.
+   *
+   * \param [in] path The Config path.
+   */
+  explicit Path (std::string path);
+  /**
+   * Copy constructor.  The copies share the parsed path.
+   *
+   * \param [in] o The Path to copy.
+   */
+  Path (const Path &o);
+  /**
+   * Assignment operator.  The copies share the parsed path.
+   *
+   * \param [in] o The Path to copy.
+   * \returns This Path.
+   */
+  Path & operator = (const Path &o);
+  /** Destructor. */
+  ~Path ();
+
+  /**
+   * Get the Config path string.
+   *
+   * \returns The Config path.
+   */
+  std::string GetPath (void) const;
+
+private:
+  /** The Config implementation needs access to the parsed path. */
+  friend class ConfigImpl;
+  /** The parsed path. */
+  Ptr<PathImpl> m_impl;
+};
+
 /**
  * \ingroup config
  * \param [in] path A path to match attributes.
@@ -70,6 +131,10 @@ void Set (std::string path, const AttributeValue &value);
  * \return \c true if any matching attributes could be set.
  */
 bool SetFailSafe (std::string path, const AttributeValue &value);
+/** \copydoc Set(std::string,const AttributeValue&) */
+void Set (const Path &path, const AttributeValue &value);
+/** \copydoc SetFailSafe(std::string,const AttributeValue&) */
+bool SetFailSafe (const Path &path, const AttributeValue &value);
 /**
  * \ingroup config
  * \param [in] name The full name of the attribute
@@ -122,6 +187,10 @@ void ConnectWithoutContext (std::string path, const CallbackBase &cb);
  * \returns \c true if any trace sources could be connected.
  */
 bool ConnectWithoutContextFailSafe (std::string path, const CallbackBase &cb);
+/** \copydoc ConnectWithoutContext(std::string,const CallbackBase&) */
+void ConnectWithoutContext (const Path &path, const CallbackBase &cb);
+/** \copydoc ConnectWithoutContextFailSafe(std::string,const CallbackBase&) */
+bool ConnectWithoutContextFailSafe (const Path &path, const CallbackBase &cb);
 /**
  * \ingroup config
  * \param [in] path A path to match trace sources.
@@ -130,6 +199,8 @@ bool ConnectWithoutContextFailSafe (std::string path, const CallbackBase &cb);
  * This function undoes the work of Config::Connect.
  */
 void DisconnectWithoutContext (std::string path, const CallbackBase &cb);
+/** \copydoc DisconnectWithoutContext(std::string,const CallbackBase&) */
+void DisconnectWithoutContext (const Path &path, const CallbackBase &cb);
 /**
  * \ingroup config
  * \param [in] path A path to match trace sources.
@@ -146,6 +217,10 @@ void Connect (std::string path, const CallbackBase &cb);
  * \returns \c true if any trace sources could be connected.
  */
 bool ConnectFailSafe (std::string path, const CallbackBase &cb);
+/** \copydoc Connect(std::string,const CallbackBase&) */
+void Connect (const Path &path, const CallbackBase &cb);
+/** \copydoc ConnectFailSafe(std::string,const CallbackBase&) */
+bool ConnectFailSafe (const Path &path, const CallbackBase &cb);
 /**
  * \ingroup config
  * \param [in] path A path to match trace sources.
@@ -154,6 +229,8 @@ bool ConnectFailSafe (std::string path, const CallbackBase &cb);
  * This function undoes the work of Config::ConnectWithContext.
  */
 void Disconnect (std::string path, const CallbackBase &cb);
+/** \copydoc Disconnect(std::string,const CallbackBase&) */
+void Disconnect (const Path &path, const CallbackBase &cb);
 
 /**
  * \ingroup config
@@ -287,6 +364,8 @@ private:
  *          path.
  */
 MatchContainer LookupMatches (std::string path);
+/** \copydoc LookupMatches(std::string) */
+MatchContainer LookupMatches (const Path &path);
 
 /**
  * \ingroup config
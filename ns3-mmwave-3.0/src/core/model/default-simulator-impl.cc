@@ -22,13 +22,19 @@
 #include "default-simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 
 #include "ptr.h"
 #include "pointer.h"
+#include "boolean.h"
+#include "string.h"
+#include "enum.h"
 #include "assert.h"
 #include "log.h"
 
 #include <cmath>
+#include <fstream>
+#include <iostream>
 
 
 /**
@@ -53,6 +59,24 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("Profile",
+                   "Profile the wall-clock time of the event handlers, "
+                   "writing the profile at Simulator::Destroy.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::m_profile),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ProfileFile",
+                   "The file to write the event profile to, "
+                   "or the empty string for std::clog.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::m_profileFile),
+                   MakeStringChecker ())
+    .AddAttribute ("ProfileFormat",
+                   "The format of the event profile.",
+                   EnumValue (DefaultSimulatorImpl::PROFILE_TABLE),
+                   MakeEnumAccessor (&DefaultSimulatorImpl::m_profileFormat),
+                   MakeEnumChecker (DefaultSimulatorImpl::PROFILE_TABLE, "Table",
+                                    DefaultSimulatorImpl::PROFILE_FOLDED, "Folded"))
   ;
   return tid;
 }
@@ -65,6 +89,7 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   // uid 0 is "invalid" events
   // uid 1 is "now" events
   // uid 2 is "destroy" events
+  // uid 3 is "periodic" series, see Simulator::SchedulePeriodic
   m_uid = 4;
   // before ::Run is entered, the m_currentUid will be zero
   m_currentUid = 0;
@@ -74,11 +99,15 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_eventCount = 0;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self ();
+  m_profile = false;
+  m_profileFormat = PROFILE_TABLE;
+  m_profiler = 0;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
+  delete m_profiler;
 }
 
 void
@@ -109,6 +138,37 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  WriteProfile ();
+}
+
+void
+DefaultSimulatorImpl::WriteProfile (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_profiler == 0)
+    {
+      return;
+    }
+  std::ofstream file;
+  if (!m_profileFile.empty ())
+    {
+      file.open (m_profileFile.c_str ());
+      if (!file.is_open ())
+        {
+          NS_LOG_WARN ("Could not open " << m_profileFile << ", using std::clog");
+        }
+    }
+  std::ostream &os = file.is_open () ? file : std::clog;
+  if (m_profileFormat == PROFILE_FOLDED)
+    {
+      m_profiler->ReportFolded (os);
+    }
+  else
+    {
+      m_profiler->Report (os);
+    }
+  delete m_profiler;
+  m_profiler = 0;
 }
 
 void
@@ -148,7 +208,14 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_profiler == 0)
+    {
+      next.impl->Invoke ();
+    }
+  else
+    {
+      m_profiler->Invoke (next.impl);
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -198,6 +265,10 @@ DefaultSimulatorImpl::Run (void)
   m_main = SystemThread::Self ();
   ProcessEventsWithContext ();
   m_stop = false;
+  if (m_profile && m_profiler == 0)
+    {
+      m_profiler = new EventProfiler ();
+    }
 
   while (!m_events->IsEmpty () && !m_stop)
     {
@@ -246,6 +317,36 @@ DefaultSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
+std::vector<EventId>
+DefaultSimulatorImpl::ScheduleBatch (const std::vector<std::pair<Time, EventImpl *> > &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::ScheduleBatch Thread-unsafe invocation!");
+
+  std::vector<Scheduler::Event> batch;
+  std::vector<EventId> ids;
+  batch.reserve (events.size ());
+  ids.reserve (events.size ());
+  uint32_t context = GetContext ();
+  for (std::vector<std::pair<Time, EventImpl *> >::const_iterator i = events.begin ();
+       i != events.end (); ++i)
+    {
+      NS_ASSERT_MSG (i->first.IsPositive (), "DefaultSimulatorImpl::ScheduleBatch(): Negative delay");
+      Time tAbsolute = i->first + TimeStep (m_currentTs);
+      Scheduler::Event ev;
+      ev.impl = i->second;
+      ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+      ev.key.m_context = context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      batch.push_back (ev);
+      ids.push_back (EventId (ev.impl, ev.key.m_ts, ev.key.m_context, ev.key.m_uid));
+    }
+  m_unscheduledEvents += batch.size ();
+  m_events->InsertBatch (batch);
+  return ids;
+}
+
 void
 DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
 {
@@ -30,6 +30,7 @@
 #include "ptr.h"
 
 #include <list>
+#include <string>
 
 /**
  * \file
@@ -39,14 +40,29 @@
 
 namespace ns3 {
 
+class EventProfiler;
+
 /**
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * When the Profile attribute is set, the wall-clock time of every
+ * event handler is accounted by an EventProfiler, and the resulting
+ * profile is written by Simulator::Destroy, either as a table of the
+ * handlers ranked by time or as folded stacks for `flamegraph.pl`.
+ * Profiling is off by default, and then costs a single test per event.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
 public:
+  /** Output format of the event profile. */
+  enum ProfileFormat
+  {
+    PROFILE_TABLE,   /**< Handlers ranked by wall-clock time. */
+    PROFILE_FOLDED   /**< Folded stacks, for flame graphs. */
+  };
+
   /**
    *  Register this type.
    *  \return The object TypeId.
@@ -67,6 +83,7 @@ public:
   virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
   virtual EventId ScheduleNow (EventImpl *event);
   virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual std::vector<EventId> ScheduleBatch (const std::vector<std::pair<Time, EventImpl *> > &events);
   virtual void Remove (const EventId &id);
   virtual void Cancel (const EventId &id);
   virtual bool IsExpired (const EventId &id) const;
@@ -86,6 +103,8 @@ private:
   void ProcessOneEvent (void);
   /** Move events from a different context into the main event queue. */
   void ProcessEventsWithContext (void);
+  /** Write the event profile, if any, and delete the profiler. */
+  void WriteProfile (void);
 
   /** Wrap an event with its execution context. */
   struct EventWithContext
@@ -136,6 +155,15 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** Profile the wall-clock time of the event handlers. */
+  bool m_profile;
+  /** File for the event profile; empty for std::clog. */
+  std::string m_profileFile;
+  /** Format of the event profile. */
+  enum ProfileFormat m_profileFormat;
+  /** The event profiler, when profiling. */
+  EventProfiler *m_profiler;
 };
 
 } // namespace ns3
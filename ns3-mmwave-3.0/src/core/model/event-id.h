@@ -53,6 +53,16 @@ class EventImpl;
 class EventId
 {
 public:
+  /** Special values of the event unique id. */
+  enum UID
+  {
+    INVALID = 0,   /**< The default, invalid EventId. */
+    NOW = 1,       /**< ScheduleNow() events, in some implementations. */
+    DESTROY = 2,   /**< ScheduleDestroy() events. */
+    PERIODIC = 3,  /**< Series of events from Simulator::SchedulePeriodic(). */
+    VALID = 4      /**< The first uid of ordinary events. */
+  };
+
   /** Default constructor. This EventId does nothing. */
   EventId ();
   /**
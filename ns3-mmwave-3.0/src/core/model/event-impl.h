@@ -65,6 +65,13 @@ public:
    * Checked by the simulation engine before calling Invoke().
    */
   bool IsCancelled (void);
+  /**
+   * Get the address of the code of the function or method called by
+   * this event, for profiling.
+   *
+   * \returns The address of the handler, or 0 if it is not known.
+   */
+  virtual const void * GetHandlerCode (void) const;
 
 protected:
   /**
@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "event-impl.h"
+#include "log.h"
+#include "ns3/core-config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+#ifdef HAVE_DLFCN_H
+#include <dlfcn.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+namespace {
+
+/**
+ * \ingroup simulator
+ * Demangle a C++ type or symbol name, when the compiler supports it.
+ *
+ * \param [in] mangled The mangled name.
+ * \returns The demangled name, or \pname{mangled} on failure.
+ */
+std::string
+DemangleTypeName (const char *mangled)
+{
+  std::string ret = mangled;
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, NULL, NULL, &status);
+  if (status == 0 && demangled != 0)
+    {
+      ret = demangled;
+    }
+  std::free (demangled);
+#endif
+  return ret;
+}
+
+/** A handler label with its accounting, for sorting. */
+typedef std::pair<std::string, std::pair<uint64_t, uint64_t> > LabelEntry;
+
+/**
+ * \ingroup simulator
+ * Order handlers by decreasing wall-clock time.
+ *
+ * \param [in] a The first handler.
+ * \param [in] b The second handler.
+ * \returns \c true if \pname{a} took more time than \pname{b}.
+ */
+bool
+CompareTime (const LabelEntry &a, const LabelEntry &b)
+{
+  if (a.second.second != b.second.second)
+    {
+      return a.second.second > b.second.second;
+    }
+  return a.first < b.first;
+}
+
+} // unnamed namespace
+
+EventProfiler::EventProfiler ()
+  : m_eventCount (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+EventProfiler::Invoke (EventImpl *event)
+{
+  // The handler may release the objects the event refers to
+  Key key (std::type_index (typeid (*event)), event->GetHandlerCode ());
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  event->Invoke ();
+  std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now () - start;
+
+  Entry &entry = m_entries[key];
+  entry.count++;
+  entry.ns += std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count ();
+  m_eventCount++;
+}
+
+uint64_t
+EventProfiler::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
+std::string
+EventProfiler::GetLabel (const std::type_index &type)
+{
+  std::string name = DemangleTypeName (type.name ());
+  // The events made by MakeEvent are local classes of a function
+  // template, whose first argument is the handler.
+  std::string prefix = "ns3::MakeEvent";
+  if (name.compare (0, prefix.size (), prefix) != 0
+      || name.size () <= prefix.size ()
+      || (name[prefix.size ()] != '<' && name[prefix.size ()] != '('))
+    {
+      return name;
+    }
+  std::string::size_type start = prefix.size () + 1;
+  int depth = 0;
+  for (std::string::size_type i = start; i < name.size (); ++i)
+    {
+      char c = name[i];
+      if (depth == 0 && (c == ',' || c == '>' || c == ')'))
+        {
+          return name.substr (start, i - start);
+        }
+      if (c == '<' || c == '(')
+        {
+          depth++;
+        }
+      else if (c == '>' || c == ')')
+        {
+          depth--;
+        }
+    }
+  return name;
+}
+
+std::string
+EventProfiler::GetLabel (const std::type_index &type, const void *code)
+{
+  if (code == 0)
+    {
+      return GetLabel (type);
+    }
+#ifdef HAVE_DLFCN_H
+  Dl_info info;
+  // Only an exact match: the nearest symbol of a static function
+  // is another function
+  if (dladdr (code, &info) != 0 && info.dli_sname != 0 && info.dli_saddr == code)
+    {
+      return DemangleTypeName (info.dli_sname);
+    }
+#endif
+  std::ostringstream oss;
+  oss << GetLabel (type) << " at " << code;
+  return oss.str ();
+}
+
+void
+EventProfiler::Report (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  std::vector<LabelEntry> labels;
+  uint64_t total = 0;
+  for (Entries::const_iterator i = m_entries.begin (); i != m_entries.end (); ++i)
+    {
+      labels.push_back (std::make_pair (GetLabel (i->first.type, i->first.code),
+                                        std::make_pair (i->second.count, i->second.ns)));
+      total += i->second.ns;
+    }
+  std::sort (labels.begin (), labels.end (), &CompareTime);
+
+  std::ios_base::fmtflags flags = os.flags ();
+  os << "Event handler profile: " << m_eventCount << " events, "
+     << std::fixed << std::setprecision (6) << total * 1e-9 << " s" << std::endl;
+  os << std::setw (5) << "Rank" << std::setw (13) << "Events"
+     << std::setw (13) << "Time (s)" << std::setw (8) << "%"
+     << std::setw (12) << "ns/event" << "  Handler" << std::endl;
+  for (std::size_t i = 0; i < labels.size (); ++i)
+    {
+      uint64_t count = labels[i].second.first;
+      uint64_t ns = labels[i].second.second;
+      os << std::setw (5) << i + 1
+         << std::setw (13) << count
+         << std::setw (13) << std::setprecision (6) << ns * 1e-9
+         << std::setw (8) << std::setprecision (2) << (total ? 100.0 * ns / total : 0.0)
+         << std::setw (12) << std::setprecision (0) << (count ? double (ns) / count : 0.0)
+         << "  " << labels[i].first << std::endl;
+    }
+  os.flags (flags);
+}
+
+void
+EventProfiler::ReportFolded (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  for (Entries::const_iterator i = m_entries.begin (); i != m_entries.end (); ++i)
+    {
+      std::string label = GetLabel (i->first.type, i->first.code);
+      // ';' separates the frames of a folded stack
+      std::replace (label.begin (), label.end (), ';', ',');
+      os << "ns3::Simulator::Run;" << label << " " << i->second.ns / 1000 << std::endl;
+    }
+}
+
+} // namespace ns3
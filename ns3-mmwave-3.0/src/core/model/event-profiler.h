@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ * \brief Attribute the wall-clock time spent in event handlers
+ * to the type of the handler.
+ *
+ * Each event is timed around EventImpl::Invoke.  Events are grouped by
+ * their handler: the function or method called by the events created by
+ * Simulator::Schedule and MakeEvent, given by EventImpl::GetHandlerCode.
+ * A virtual method is resolved to the override called.  The handlers
+ * are named in the reports by their symbol, found with `dladdr`, for
+ * example `ns3::MmWaveEnbPhy::StartSubFrame()`.  The handlers without
+ * an exported symbol (static functions, or programs not linked with
+ * `-rdynamic`) are named by the type of their event, which is
+ * parameterized by the signature of the handler, for example
+ * `void (*)(int)`, followed by their address.  The events of other
+ * EventImpl subclasses are grouped by type.  Grouping costs a hash
+ * lookup per event and no memory in the events themselves.
+ *
+ * The profiler is used by the DefaultSimulatorImpl when its Profile
+ * attribute is set; the report is written by Simulator::Destroy.
+ */
+class EventProfiler
+{
+public:
+  /** Constructor. */
+  EventProfiler ();
+
+  /**
+   * Invoke an event, accounting its wall-clock time.
+   *
+   * \param [in] event The event to invoke.
+   */
+  void Invoke (EventImpl *event);
+
+  /**
+   * Write a report of the handlers, ranked by decreasing wall-clock time.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void Report (std::ostream &os) const;
+  /**
+   * Write the handlers in the folded stack format used by the
+   * FlameGraph tools (`flamegraph.pl`), one line per handler with
+   * its wall-clock time in microseconds.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void ReportFolded (std::ostream &os) const;
+
+  /**
+   * Get the number of events profiled.
+   *
+   * \returns The number of events.
+   */
+  uint64_t GetEventCount (void) const;
+
+  /**
+   * Get a readable label for the type of an event.
+   *
+   * \param [in] type The dynamic type of an EventImpl.
+   * \returns The label.
+   */
+  static std::string GetLabel (const std::type_index &type);
+  /**
+   * Get a readable label for the handler of an event.
+   *
+   * \param [in] type The dynamic type of an EventImpl.
+   * \param [in] code The address of the handler, or 0 if it is not known.
+   * \returns The symbol of the handler, or a label made of its type.
+   */
+  static std::string GetLabel (const std::type_index &type, const void *code);
+
+private:
+  /** The identity of a handler. */
+  struct Key
+  {
+    /**
+     * Constructor.
+     * \param [in] t The dynamic type of the event.
+     * \param [in] c The address of the handler, or 0.
+     */
+    Key (const std::type_index &t, const void *c)
+      : type (t),
+        code (c)
+    {}
+    std::type_index type;  /**< Dynamic type of the event. */
+    const void *code;      /**< Address of the handler, or 0. */
+    /**
+     * Equality operator.
+     * \param [in] other The other key.
+     * \returns \c true if the keys are equal.
+     */
+    bool operator == (const Key &other) const
+    {
+      return code == other.code && type == other.type;
+    }
+  };
+  /** Hash functor of the handler keys. */
+  struct KeyHash
+  {
+    /**
+     * Hash a key.
+     * \param [in] key The key.
+     * \returns The hash.
+     */
+    std::size_t operator () (const Key &key) const
+    {
+      return key.type.hash_code () ^ std::hash<const void *> () (key.code);
+    }
+  };
+  /** Accounting of one handler. */
+  struct Entry
+  {
+    uint64_t count;        /**< Number of events. */
+    uint64_t ns;           /**< Wall-clock time, in ns. */
+  };
+  /** Container type for the accounting. */
+  typedef std::unordered_map<Key, Entry, KeyHash> Entries;
+
+  /** The accounting, by handler. */
+  Entries m_entries;
+  /** The number of events profiled. */
+  uint64_t m_eventCount;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -25,6 +25,8 @@
 #include "assert.h"
 #include "log.h"
 
+#include <algorithm>
+
 /**
  * \file
  * \ingroup scheduler
@@ -51,11 +53,6 @@ HeapScheduler::GetTypeId (void)
 HeapScheduler::HeapScheduler ()
 {
   NS_LOG_FUNCTION (this);
-  // we purposely waste an item at the start of
-  // the array to make sure the indexes in the
-  // array start at one.
-  Scheduler::Event empty = { 0,{ 0,0}};
-  m_heap.push_back (empty);
 }
 
 HeapScheduler::~HeapScheduler ()
@@ -66,160 +63,139 @@ HeapScheduler::~HeapScheduler ()
 std::size_t
 HeapScheduler::Parent (std::size_t id) const
 {
-  NS_LOG_FUNCTION (this << id);
-  return id / 2;
-}
-std::size_t
-HeapScheduler::Sibling (std::size_t id) const
-{
-  NS_LOG_FUNCTION (this << id);
-  return id + 1;
-}
-std::size_t
-HeapScheduler::LeftChild (std::size_t id) const
-{
-  NS_LOG_FUNCTION (this << id);
-  return id * 2;
+  return (id - 1) / ARITY;
 }
+
 std::size_t
-HeapScheduler::RightChild (std::size_t id) const
+HeapScheduler::FirstChild (std::size_t id) const
 {
-  NS_LOG_FUNCTION (this << id);
-  return id * 2 + 1;
+  return id * ARITY + 1;
 }
 
 std::size_t
-HeapScheduler::Root (void) const
+HeapScheduler::SmallestChild (std::size_t id) const
 {
-  NS_LOG_FUNCTION (this);
-  return 1;
+  std::size_t first = FirstChild (id);
+  std::size_t last = std::min (first + ARITY, m_keys.size ());
+  std::size_t smallest = first;
+  for (std::size_t i = first + 1; i < last; i++)
+    {
+      // branch-free select, the comparison is unpredictable
+      std::size_t less = m_keys[i] < m_keys[smallest];
+      smallest = smallest + less * (i - smallest);
+    }
+  return smallest;
 }
 
 bool
-HeapScheduler::IsRoot (std::size_t id) const
-{
-  NS_LOG_FUNCTION (this << id);
-  return (id == Root ()) ? true : false;
-}
-
-std::size_t
-HeapScheduler::Last (void) const
+HeapScheduler::IsEmpty (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_heap.size () - 1;
+  return m_keys.empty ();
 }
 
-
-bool
-HeapScheduler::IsBottom (std::size_t id) const
+void
+HeapScheduler::BottomUp (std::size_t id, const PackedKey &key, EventImpl *impl)
 {
   NS_LOG_FUNCTION (this << id);
-  return (id >= m_heap.size ()) ? true : false;
+  while (id > 0)
+    {
+      std::size_t parent = Parent (id);
+      if (!(key < m_keys[parent]))
+        {
+          break;
+        }
+      m_keys[id] = m_keys[parent];
+      m_impls[id] = m_impls[parent];
+      id = parent;
+    }
+  m_keys[id] = key;
+  m_impls[id] = impl;
 }
 
 void
-HeapScheduler::Exch (std::size_t a, std::size_t b)
-{
-  NS_LOG_FUNCTION (this << a << b);
-  NS_ASSERT (b < m_heap.size () && a < m_heap.size ());
-  NS_LOG_DEBUG ("Exch " << a << ", " << b);
-  Event tmp (m_heap[a]);
-  m_heap[a] = m_heap[b];
-  m_heap[b] = tmp;
-}
-
-bool
-HeapScheduler::IsLessStrictly (std::size_t a, std::size_t b) const
+HeapScheduler::TopDown (std::size_t id, const PackedKey &key, EventImpl *impl)
 {
-  NS_LOG_FUNCTION (this << a << b);
-  return m_heap[a] < m_heap[b];
-}
-
-std::size_t
-HeapScheduler::Smallest (std::size_t a, std::size_t b) const
-{
-  NS_LOG_FUNCTION (this << a << b);
-  return IsLessStrictly (a,b) ? a : b;
+  NS_LOG_FUNCTION (this << id);
+  std::size_t size = m_keys.size ();
+  while (FirstChild (id) < size)
+    {
+      std::size_t child = SmallestChild (id);
+      if (!(m_keys[child] < key))
+        {
+          break;
+        }
+      m_keys[id] = m_keys[child];
+      m_impls[id] = m_impls[child];
+      id = child;
+    }
+  m_keys[id] = key;
+  m_impls[id] = impl;
 }
 
-bool
-HeapScheduler::IsEmpty (void) const
-{
-  NS_LOG_FUNCTION (this);
-  return (m_heap.size () == 1) ? true : false;
-}
 
 void
-HeapScheduler::BottomUp (void)
+HeapScheduler::Insert (const Event &ev)
 {
-  NS_LOG_FUNCTION (this);
-  std::size_t index = Last ();
-  while (!IsRoot (index)
-         && IsLessStrictly (index, Parent (index)))
-    {
-      Exch (index, Parent (index));
-      index = Parent (index);
-    }
+  NS_LOG_FUNCTION (this << &ev);
+  PackedKey key = Pack (ev.key);
+  m_keys.push_back (key);
+  m_impls.push_back (ev.impl);
+  BottomUp (m_keys.size () - 1, key, ev.impl);
 }
 
 void
-HeapScheduler::TopDown (std::size_t start)
+HeapScheduler::InsertBatch (const std::vector<Event> &events)
 {
-  NS_LOG_FUNCTION (this << start);
-  std::size_t index = start;
-  std::size_t right = RightChild (index);
-  while (!IsBottom (right))
+  NS_LOG_FUNCTION (this << events.size ());
+  // Inserting m events one at a time costs O(m log(n + m)), rebuilding
+  // the whole heap bottom-up costs O(n + m): rebuild when the batch is
+  // at least as large as the heap.
+  if (events.size () < m_keys.size ())
     {
-      std::size_t left = LeftChild (index);
-      std::size_t tmp = Smallest (left, right);
-      if (IsLessStrictly (index, tmp))
-        {
-          return;
-        }
-      Exch (index, tmp);
-      index = tmp;
-      right = RightChild (index);
+      Scheduler::InsertBatch (events);
+      return;
     }
-  if (IsBottom (index))
+  m_keys.reserve (m_keys.size () + events.size ());
+  m_impls.reserve (m_impls.size () + events.size ());
+  for (std::vector<Event>::const_iterator i = events.begin (); i != events.end (); ++i)
     {
-      return;
+      m_keys.push_back (Pack (i->key));
+      m_impls.push_back (i->impl);
     }
-  NS_ASSERT (!IsBottom (index));
-  std::size_t left = LeftChild (index);
-  if (IsBottom (left))
+  if (m_keys.size () < 2)
     {
       return;
     }
-  if (IsLessStrictly (index, left))
+  for (std::size_t id = Parent (m_keys.size () - 1) + 1; id-- > 0; )
     {
-      return;
+      PackedKey key = m_keys[id];
+      TopDown (id, key, m_impls[id]);
     }
-  Exch (index, left);
-}
-
-
-void
-HeapScheduler::Insert (const Event &ev)
-{
-  NS_LOG_FUNCTION (this << &ev);
-  m_heap.push_back (ev);
-  BottomUp ();
 }
 
 Scheduler::Event
 HeapScheduler::PeekNext (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_heap[Root ()];
+  Event next;
+  next.impl = m_impls.front ();
+  next.key = Unpack (m_keys.front ());
+  return next;
 }
 Scheduler::Event
 HeapScheduler::RemoveNext (void)
 {
   NS_LOG_FUNCTION (this);
-  Event next = m_heap[Root ()];
-  Exch (Root (), Last ());
-  m_heap.pop_back ();
-  TopDown (Root ());
+  Event next = PeekNext ();
+  PackedKey lastKey = m_keys.back ();
+  EventImpl *lastImpl = m_impls.back ();
+  m_keys.pop_back ();
+  m_impls.pop_back ();
+  if (!m_keys.empty ())
+    {
+      TopDown (0, lastKey, lastImpl);
+    }
   return next;
 }
 
@@ -228,15 +204,29 @@ void
 HeapScheduler::Remove (const Event &ev)
 {
   NS_LOG_FUNCTION (this << &ev);
-  std::size_t uid = ev.key.m_uid;
-  for (std::size_t i = 1; i < m_heap.size (); i++)
+  uint64_t uidContext = Pack (ev.key).m_uidContext;
+  for (std::size_t i = 0; i < m_keys.size (); i++)
     {
-      if (uid == m_heap[i].key.m_uid)
+      if (uidContext == m_keys[i].m_uidContext)
         {
-          NS_ASSERT (m_heap[i].impl == ev.impl);
-          Exch (i, Last ());
-          m_heap.pop_back ();
-          TopDown (i);
+          NS_ASSERT (m_impls[i] == ev.impl);
+          PackedKey lastKey = m_keys.back ();
+          EventImpl *lastImpl = m_impls.back ();
+          m_keys.pop_back ();
+          m_impls.pop_back ();
+          if (i == m_keys.size ())
+            {
+              return;
+            }
+          // The last entry may belong above or below the removed one.
+          if (i > 0 && lastKey < m_keys[Parent (i)])
+            {
+              BottomUp (i, lastKey, lastImpl);
+            }
+          else
+            {
+              TopDown (i, lastKey, lastImpl);
+            }
           return;
         }
     }
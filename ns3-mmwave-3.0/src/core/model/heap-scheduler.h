@@ -35,38 +35,38 @@ namespace ns3 {
 
 /**
  * \ingroup scheduler
- * \brief a binary heap event scheduler
+ * \brief a 4-ary heap event scheduler
  *
  * This code started as a c++ translation of a Java-based code written in 2005
- * to implement a heap sort. So, this binary heap is really a pretty
- * straightforward implementation of the classic data structure,
- * implemented on a `std::vector`.  This implementation does not make use
- * of any of the heap functions from the STL.  Not much to say
- * about it.
+ * to implement a heap sort.  It is now a 4-ary implicit heap: each
+ * node has four children, so the heap is half as deep as a binary heap
+ * and the children of a node are adjacent in memory.  This implementation
+ * does not make use of any of the heap functions from the STL.
  *
  * What is smart about this code ?
- *  - it does not use the index 0 in the array to avoid having to convert
- *    C-style array indexes (which start at zero) and heap-style indexes
- *    (which start at 1). This is why _all_ indexes start at 1, and that
- *    the index of the root is 1.
- *  - It uses a slightly non-standard while loop for top-down heapify
- *    to move one if statement out of the loop.
+ *  - the keys are stored as Scheduler::PackedKey in their own `std::vector`,
+ *    apart from the event implementations, so the four children
+ *    compared at each level of TopDown are adjacent 16 byte keys
+ *    (64 bytes in total), compared without branches;
+ *  - the percolations move a hole instead of swapping entries, so each
+ *    level costs one copy instead of three.
  *
  * \par Time Complexity
  *
  * Operation    | Amortized %Time | Reason
  * :----------- | :-------------- | :-----
  * Insert()     | Logarithmic     | Heapify
+ * InsertBatch()| Linear          | Rebuild the heap, for large batches
  * IsEmpty()    | Constant        | Explicit queue size
  * PeekNext()   | Constant        | Heap kept sorted
- * Remove()     | Logarithmic     | Search, heapify
+ * Remove()     | Linear          | Search, heapify
  * RemoveNext() | Logarithmic     | Heapify
  *
  * \par Memory Complexity
  *
  * Category  | Memory                           | Reason
  * :-------- | :------------------------------- | :-----
- * Overhead  | 3 x `sizeof (*)`<br/>(24 bytes)  | `std::vector`
+ * Overhead  | 6 x `sizeof (*)`<br/>(48 bytes)  | Two `std::vector`
  * Per Event | 0                                | Events stored in `std::vector` directly
  */
 class HeapScheduler : public Scheduler
@@ -85,14 +85,15 @@ public:
 
   // Inherited
   virtual void Insert (const Scheduler::Event &ev);
+  virtual void InsertBatch (const std::vector<Scheduler::Event> &events);
   virtual bool IsEmpty (void) const;
   virtual Scheduler::Event PeekNext (void) const;
   virtual Scheduler::Event RemoveNext (void);
   virtual void Remove (const Scheduler::Event &ev);
 
 private:
-  /** Event list type:  vector of Events, managed as a heap. */
-  typedef std::vector<Scheduler::Event> BinaryHeap;
+  /** The number of children of each node. */
+  static const std::size_t ARITY = 4;
 
   /**
    * Get the parent index of a given entry.
@@ -102,85 +103,40 @@ private:
    */
   inline std::size_t Parent (std::size_t id) const;
   /**
-   * Get the next sibling of a given entry.
-   *
-   * \param [in] id The starting index.
-   * \returns The next sibling of \pname{id}.
-   */
-  std::size_t Sibling (std::size_t id) const;
-  /**
-   * Get the left child of a given entry.
+   * Get the first child of a given entry.
    *
    * \param [in] id The parent index.
-   * \returns The index of the left (first) child.
-   */
-  inline std::size_t LeftChild (std::size_t id) const;
-  /**
-   * Get the right child index of a given entry.
-   *
-   * \param [in] id The parent index.
-   * \returns The index of the right (second) child.
-   */
-  inline std::size_t RightChild (std::size_t id) const;
-  /**
-   * Get the root index of the heap.
-   *
-   * \returns The root index.
-   */
-  inline std::size_t Root (void) const;
-  /**
-   * Return the index of the last element.
-   * \returns The last index.
-   */
-  std::size_t Last (void) const;
-  /**
-   * Test if an index is the root.
-   *
-   * \param [in] id The index to test.
-   * \returns \c true if the \pname{id} is the root.
-   */
-  inline bool IsRoot (std::size_t id) const;
-  /**
-   * Test if an index is at the bottom of the heap.
-   *
-   * \param [in] id The index to test.
-   * \returns \c true if the index is at the bottom.
-   */
-  inline bool IsBottom (std::size_t id) const;
-  /**
-   * Compare (less than) two items.
-   *
-   * \param [in] a The first item.
-   * \param [in] b The second item.
-   * \returns \c true if \c a < \c b
+   * \returns The index of the first child.
    */
-  inline bool IsLessStrictly (std::size_t a, std::size_t b) const;
+  inline std::size_t FirstChild (std::size_t id) const;
   /**
-   * Minimum of two items.
+   * Get the smallest child of a given entry.
    *
-   * \param [in] a The first item.
-   * \param [in] b The second item.
-   * \returns The smaller of the two items.
+   * \param [in] id The parent index, which must have a child.
+   * \returns The index of the smallest child.
    */
-  inline std::size_t Smallest (std::size_t a, std::size_t b) const;
+  inline std::size_t SmallestChild (std::size_t id) const;
   /**
-   * Swap two items.
+   * Move an entry up to its proper position.
    *
-   * \param [in] a The first item.
-   * \param [in] b The second item.
+   * \param [in] id The index of the hole to start from.
+   * \param [in] key The key of the entry.
+   * \param [in] impl The event implementation of the entry.
    */
-  inline void Exch (std::size_t a, std::size_t b);
-  /** Percolate a newly inserted Last item to its proper position. */
-  void BottomUp (void);
+  void BottomUp (std::size_t id, const Scheduler::PackedKey &key, EventImpl *impl);
   /**
-   * Percolate a deletion bubble down the heap.
+   * Move an entry down to its proper position.
    *
-   * \param [in] start Starting entry.
+   * \param [in] id The index of the hole to start from.
+   * \param [in] key The key of the entry.
+   * \param [in] impl The event implementation of the entry.
    */
-  void TopDown (std::size_t start);
+  void TopDown (std::size_t id, const Scheduler::PackedKey &key, EventImpl *impl);
 
-  /** The event list. */
-  BinaryHeap m_heap;
+  /** The heap of event keys. */
+  std::vector<Scheduler::PackedKey> m_keys;
+  /** The event implementations, at the same index as their key. */
+  std::vector<EventImpl *> m_impls;
 };
 
 } // namespace ns3
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "hybrid-synchronizer.h"
+#include "integer.h"
+#include "log.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/**
+ * \file
+ * \ingroup realtime
+ * ns3::HybridSynchronizer implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("HybridSynchronizer");
+
+NS_OBJECT_ENSURE_REGISTERED (HybridSynchronizer);
+
+TypeId
+HybridSynchronizer::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HybridSynchronizer")
+    .SetParent<WallClockSynchronizer> ()
+    .SetGroupName ("Core")
+    .AddConstructor<HybridSynchronizer> ()
+    .AddAttribute ("SpinThreshold",
+                   "Busy-wait instead of sleeping for the last part of every wait.",
+                   TimeValue (MicroSeconds (100)),
+                   MakeTimeAccessor (&HybridSynchronizer::m_spinThreshold),
+                   MakeTimeChecker (Time (0)))
+    .AddAttribute ("CpuAffinity",
+                   "The CPU to pin the simulation thread to, or -1 not to pin it "
+                   "(only supported on Linux).",
+                   IntegerValue (-1),
+                   MakeIntegerAccessor (&HybridSynchronizer::m_cpu),
+                   MakeIntegerChecker<int32_t> (-1))
+  ;
+  return tid;
+}
+
+HybridSynchronizer::HybridSynchronizer ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+HybridSynchronizer::~HybridSynchronizer ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+HybridSynchronizer::DoSetOrigin (uint64_t ns)
+{
+  NS_LOG_FUNCTION (this << ns);
+  // The origin is set by RealtimeSimulatorImpl::Run, from the
+  // simulation thread.
+  SetAffinity ();
+  WallClockSynchronizer::DoSetOrigin (ns);
+}
+
+void
+HybridSynchronizer::SetAffinity (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_cpu < 0)
+    {
+      return;
+    }
+#ifdef __linux__
+  cpu_set_t cpus;
+  CPU_ZERO (&cpus);
+  CPU_SET (m_cpu, &cpus);
+  int rc = pthread_setaffinity_np (pthread_self (), sizeof (cpus), &cpus);
+  if (rc != 0)
+    {
+      NS_LOG_WARN ("Could not pin the simulation thread to CPU " << m_cpu
+                   << ", error " << rc);
+    }
+#else
+  NS_LOG_WARN ("CpuAffinity is not supported on this platform");
+#endif
+}
+
+bool
+HybridSynchronizer::DoSynchronize (uint64_t nsCurrent, uint64_t nsDelay)
+{
+  NS_LOG_FUNCTION (this << nsCurrent << nsDelay);
+  // nsCurrent was read from the real time clock by the caller, so the
+  // target is absolute, and whatever happened since then is accounted
+  // without the drift correction of the WallClockSynchronizer.
+  uint64_t nsTarget = nsCurrent + nsDelay;
+  uint64_t nsSpin = m_spinThreshold.GetNanoSeconds ();
+  uint64_t nsNow = GetNormalizedRealtime ();
+  if (nsTarget > nsNow + nsSpin)
+    {
+      NS_LOG_INFO ("SleepWait for " << nsTarget - nsSpin - nsNow << " ns");
+      if (!SleepWait (nsTarget - nsSpin - nsNow))
+        {
+          NS_LOG_INFO ("SleepWait interrupted");
+          return false;
+        }
+    }
+  NS_LOG_INFO ("SpinWait until " << nsTarget);
+  return SpinWait (nsTarget);
+}
+
+} // namespace ns3
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HYBRID_SYNCHRONIZER_H
+#define HYBRID_SYNCHRONIZER_H
+
+#include "wall-clock-synchronizer.h"
+#include "nstime.h"
+
+/**
+ * @file
+ * @ingroup realtime
+ * ns3::HybridSynchronizer declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * @ingroup realtime
+ * @brief A wall clock synchronizer which sleeps for long waits and
+ * busy-waits the last part of every wait.
+ *
+ * The WallClockSynchronizer decides between sleeping and spinning from
+ * the resolution of the system clock, which modern kernels report
+ * as one nanosecond: it then sleeps for almost all of every wait, and
+ * the wake-up latency of the kernel, typically tens of microseconds to
+ * a millisecond, shows up as lateness of the events.
+ *
+ * This synchronizer sleeps until @c SpinThreshold before the target
+ * time, then spins until the target time, so the lateness is bounded by
+ * the wake-up latency only when it exceeds the threshold.  Waits shorter
+ * than the threshold are spun entirely.  A larger threshold gives more
+ * accuracy for more CPU time.
+ *
+ * For the best accuracy, the simulation thread can be pinned to a CPU
+ * with the @c CpuAffinity attribute, preferably a CPU isolated from the
+ * rest of the system.
+ *
+ * Select this synchronizer with
+ * @code
+ *   Config::SetDefault ("ns3::RealtimeSimulatorImpl::SynchronizerType",
+ *                       TypeIdValue (HybridSynchronizer::GetTypeId ()));
+ * @endcode
+ * and check the resulting lateness with
+ * RealtimeSimulatorImpl::GetLatenessHistogram.
+ */
+class HybridSynchronizer : public WallClockSynchronizer
+{
+public:
+  /**
+   * Get the registered TypeId for this class.
+   * @returns The TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  HybridSynchronizer ();
+  /** Destructor. */
+  virtual ~HybridSynchronizer ();
+
+protected:
+  // Inherited from WallClockSynchronizer
+  virtual void DoSetOrigin (uint64_t ns);
+  virtual bool DoSynchronize (uint64_t nsCurrent, uint64_t nsDelay);
+
+private:
+  /** Pin the calling thread to m_cpu, if set. */
+  void SetAffinity (void);
+
+  /** The time to spin before each target time. */
+  Time m_spinThreshold;
+  /** The CPU to run the simulation on, or -1. */
+  int32_t m_cpu;
+};
+
+} // namespace ns3
+
+#endif /* HYBRID_SYNCHRONIZER_H */
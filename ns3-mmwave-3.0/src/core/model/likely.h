@@ -0,0 +1,48 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_LIKELY_H
+#define NS3_LIKELY_H
+
+/**
+ * \file
+ * \ingroup core
+ * NS_LIKELY and NS_UNLIKELY macro definitions.
+ */
+
+/**
+ * \ingroup core
+ * \def NS_LIKELY()
+ * Hint to the compiler that a condition is usually true.
+ *
+ * \param [in] x The condition.
+ */
+/**
+ * \ingroup core
+ * \def NS_UNLIKELY()
+ * Hint to the compiler that a condition is usually false.
+ *
+ * \param [in] x The condition.
+ */
+#if defined(__GNUC__)
+# define NS_LIKELY(x)   (__builtin_expect (!!(x), 1))
+# define NS_UNLIKELY(x) (__builtin_expect (!!(x), 0))
+#else
+# define NS_LIKELY(x)   (!!(x))
+# define NS_UNLIKELY(x) (!!(x))
+#endif
+
+#endif /* NS3_LIKELY_H */
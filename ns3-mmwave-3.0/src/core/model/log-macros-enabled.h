@@ -152,7 +152,8 @@
 #define NS_LOG(level, msg)                                      \
   NS_LOG_CONDITION                                              \
   do {                                                          \
-      if (g_log.IsEnabled (level))                              \
+      if (NS_LOG_COMPILED (level)                               \
+          && NS_UNLIKELY (g_log.IsEnabled (level)))             \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -174,7 +175,8 @@
 #define NS_LOG_FUNCTION_NOARGS()                                \
   NS_LOG_CONDITION                                              \
   do {                                                          \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (NS_LOG_COMPILED (ns3::LOG_FUNCTION)                   \
+          && NS_UNLIKELY (g_log.IsEnabled (ns3::LOG_FUNCTION))) \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -210,7 +212,8 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (NS_LOG_COMPILED (ns3::LOG_FUNCTION)                   \
+          && NS_UNLIKELY (g_log.IsEnabled (ns3::LOG_FUNCTION))) \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
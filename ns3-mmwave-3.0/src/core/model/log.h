@@ -29,6 +29,7 @@
 
 #include "node-printer.h"
 #include "time-printer.h"
+#include "likely.h"
 #include "log-macros-enabled.h"
 #include "log-macros-disabled.h"
 
@@ -122,6 +123,48 @@ enum LogLevel
   LOG_PREFIX_ALL     = 0xf0000000  //!< All prefixes.
 };
 
+/**
+ * \ingroup logging
+ * \def NS_LOG_CEILING
+ * The LogLevels compiled into the log component of this file.
+ *
+ * Logging statements at levels outside the ceiling are removed
+ * at compile time, and cannot be enabled at run time.  The default
+ * keeps every level.  waf sets the ceiling for whole modules with
+ * \c --log-level-ceiling, as in
+ * \code
+ *   $ ./waf configure --enable-logs --log-level-ceiling=mmwave=warn,lte=info
+ * \endcode
+ * A single file can also set its own ceiling by defining this macro
+ * before including any ns-3 header:
+ * \code
+ *   #define NS_LOG_CEILING ns3::LOG_LEVEL_WARN
+ * \endcode
+ *
+ * The ceiling is carried by the type of the component defined by
+ * NS_LOG_COMPONENT_DEFINE, so it only applies to the statements using
+ * that component, in the functions of the file.  The inline and template
+ * code of headers, which logs through the component references of
+ * NS_LOG_TEMPLATE_DECLARE and NS_LOG_STATIC_TEMPLATE_DEFINE, keeps every
+ * level: it must compile to the same code in every module.
+ */
+#ifndef NS_LOG_CEILING
+#define NS_LOG_CEILING ns3::LOG_LEVEL_ALL
+#endif
+
+/**
+ * \ingroup logging
+ * Check if \p level is compiled in for the log component \c g_log
+ * in scope, under its \ref NS_LOG_CEILING.
+ *
+ * This is a constant expression when \p level is, so statements
+ * guarded by it are dropped by the compiler.
+ *
+ * \param [in] level The LogLevel to check.
+ */
+#define NS_LOG_COMPILED(level) \
+  (((level) & ns3::LogComponentCeiling<decltype (g_log)>::value) != 0)
+
 /**
  * Enable the logging output associated with that log component.
  *
@@ -203,7 +246,7 @@ void LogComponentDisableAll (enum LogLevel level);
  * \param [in] name The log component name.
  */
 #define NS_LOG_COMPONENT_DEFINE(name)                           \
-  static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__)
+  static ns3::FileLogComponent<NS_LOG_CEILING> g_log (name, __FILE__)
 
 /**
  * Define a logging component with a mask.
@@ -214,7 +257,7 @@ void LogComponentDisableAll (enum LogLevel level);
  * \param [in] mask The default mask.
  */
 #define NS_LOG_COMPONENT_DEFINE_MASK(name, mask)                \
-  static ns3::LogComponent g_log = ns3::LogComponent (name, __FILE__, mask)
+  static ns3::FileLogComponent<NS_LOG_CEILING> g_log (name, __FILE__, mask)
 
 /**
  * Declare a reference to a Log component.
@@ -434,6 +477,66 @@ private:
 
 };  // class LogComponent
 
+inline bool
+LogComponent::IsEnabled (const enum LogLevel level) const
+{
+  //  LogComponentEnableEnvVar ();
+  return (level & m_levels) ? 1 : 0;
+}
+
+/**
+ * \ingroup logging
+ * The LogComponent defined by NS_LOG_COMPONENT_DEFINE, whose type
+ * carries the \ref NS_LOG_CEILING of its file.
+ *
+ * \tparam CEILING \explicit The LogLevels compiled in.
+ */
+template <int CEILING>
+class FileLogComponent : public LogComponent
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] name The user-visible name for this component.
+   * \param [in] file The source code file which defined this LogComponent.
+   * \param [in] mask LogLevels blocked for this LogComponent.
+   */
+  FileLogComponent (const std::string & name,
+                    const std::string & file,
+                    const enum LogLevel mask = LOG_NONE)
+    : LogComponent (name, file, mask)
+  {}
+};
+
+/**
+ * \ingroup logging
+ * The LogLevels compiled in for a type of log component: every level,
+ * except for the components defined by NS_LOG_COMPONENT_DEFINE.
+ *
+ * \tparam T \explicit The type of the log component.
+ */
+template <typename T>
+struct LogComponentCeiling
+{
+  /** The LogLevels compiled in. */
+  static const int value = LOG_LEVEL_ALL;
+};
+
+/**
+ * \ingroup logging
+ * The LogLevels compiled in for the components defined by
+ * NS_LOG_COMPONENT_DEFINE: their \ref NS_LOG_CEILING.
+ *
+ * \tparam CEILING \deduced The LogLevels compiled in.
+ */
+template <int CEILING>
+struct LogComponentCeiling<FileLogComponent<CEILING> >
+{
+  /** The LogLevels compiled in. */
+  static const int value = CEILING;
+};
+
 /**
  * Get the LogComponent registered with the given name.
  *
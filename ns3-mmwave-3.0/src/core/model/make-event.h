@@ -316,6 +316,8 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5,U6), T1 a1, T2 a2, T3 a3, T4 a4,
 
 #include "event-impl.h"
 #include "type-traits.h"
+#include <cstring>
+#include <stdint.h>
 
 namespace ns3 {
 
@@ -355,6 +357,109 @@ struct EventMemberImplObjTraits<T *>
   }
 };
 
+/**
+ * \ingroup makeeventmemptr
+ * Get the address of the code called through a member function pointer,
+ * for profiling.
+ *
+ * This decodes the member function pointers of the Itanium C++ ABI,
+ * used by GCC and Clang: a virtual method is looked up in the vtable
+ * of \pname{obj}, so that overrides are told apart.
+ *
+ * \param [in] mem The member function pointer.
+ * \param [in] obj The object the method is called on, converted to
+ *             the class of \pname{mem}.
+ * \returns The address of the code, or 0 on other ABIs.
+ */
+template <typename MEM>
+const void * DecodeMemberFunction (MEM mem, const void *obj)
+{
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__) || defined (__arm__) || defined (__aarch64__))
+  struct
+  {
+    uintptr_t ptr;
+    ptrdiff_t adj;
+  } rep;
+  if (sizeof (mem) != sizeof (rep))
+    {
+      return 0;
+    }
+  std::memcpy (&rep, &mem, sizeof (rep));
+#if defined (__arm__) || defined (__aarch64__)
+  // The virtual flag is the low bit of the adjustment
+  bool isVirtual = (rep.adj & 1) != 0;
+  ptrdiff_t adj = rep.adj >> 1;
+  uintptr_t offset = rep.ptr;
+#else
+  // The virtual flag is the low bit of the vtable offset
+  bool isVirtual = (rep.ptr & 1) != 0;
+  ptrdiff_t adj = rep.adj;
+  uintptr_t offset = rep.ptr - 1;
+#endif
+  if (!isVirtual)
+    {
+      return reinterpret_cast<const void *> (rep.ptr);
+    }
+  const char *self = static_cast<const char *> (obj) + adj;
+  const char *vtable = *reinterpret_cast<const char * const *> (self);
+  return *reinterpret_cast<const void * const *> (vtable + offset);
+#else
+  return 0;
+#endif
+}
+
+/**
+ * \ingroup makeeventmemptr
+ * Get the address of the code called through a member function pointer.
+ *
+ * \tparam MEM \deduced The member function pointer type.
+ * \tparam T \deduced The object type.
+ * \returns 0, for the member function pointer types not decoded.
+ */
+template <typename MEM, typename T>
+const void * GetMemberFunctionCode (MEM, T *)
+{
+  return 0;
+}
+
+/**
+ * \ingroup makeeventmemptr
+ * Get the address of the code called through a member function pointer.
+ *
+ * \tparam C \deduced The class of the method.
+ * \tparam R \deduced The return type of the method.
+ * \tparam A \deduced The argument types of the method.
+ * \tparam T \deduced The object type.
+ * \param [in] mem The member function pointer.
+ * \param [in] obj The object the method is called on.
+ * \returns The address of the code, or 0 if it is not known.
+ */
+template <typename C, typename R, typename... A, typename T>
+const void * GetMemberFunctionCode (R (C::*mem)(A...), T *obj)
+{
+  const C *self = obj;
+  return DecodeMemberFunction (mem, self);
+}
+
+/**
+ * \ingroup makeeventmemptr
+ * Get the address of the code called through a const member function pointer.
+ *
+ * \tparam C \deduced The class of the method.
+ * \tparam R \deduced The return type of the method.
+ * \tparam A \deduced The argument types of the method.
+ * \tparam T \deduced The object type.
+ * \param [in] mem The member function pointer.
+ * \param [in] obj The object the method is called on.
+ * \returns The address of the code, or 0 if it is not known.
+ */
+template <typename C, typename R, typename... A, typename T>
+const void * GetMemberFunctionCode (R (C::*mem)(A...) const, T *obj)
+{
+  const C *self = obj;
+  return DecodeMemberFunction (mem, self);
+}
+
 template <typename MEM, typename OBJ>
 EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
 {
@@ -374,6 +479,10 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)();
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return GetMemberFunctionCode (m_function, &EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
   } *ev = new EventMemberImpl0 (obj, mem_ptr);
@@ -404,6 +513,10 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return GetMemberFunctionCode (m_function, &EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -435,6 +548,10 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return GetMemberFunctionCode (m_function, &EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -468,6 +585,10 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return GetMemberFunctionCode (m_function, &EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -503,6 +624,10 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return GetMemberFunctionCode (m_function, &EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -541,6 +666,10 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj,
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return GetMemberFunctionCode (m_function, &EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -581,6 +710,10 @@ EventImpl * MakeEvent (MEM mem_ptr, OBJ obj,
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return GetMemberFunctionCode (m_function, &EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -616,6 +749,10 @@ EventImpl * MakeEvent (void (*f)(U1), T1 a1)
     {
       (*m_function)(m_a1);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return reinterpret_cast<const void *> (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
   } *ev = new EventFunctionImpl1 (f, a1);
@@ -646,6 +783,10 @@ EventImpl * MakeEvent (void (*f)(U1,U2), T1 a1, T2 a2)
     {
       (*m_function)(m_a1, m_a2);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return reinterpret_cast<const void *> (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -679,6 +820,10 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3), T1 a1, T2 a2, T3 a3)
     {
       (*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return reinterpret_cast<const void *> (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -714,6 +859,10 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4), T1 a1, T2 a2, T3 a3, T4 a4)
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return reinterpret_cast<const void *> (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -751,6 +900,10 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return reinterpret_cast<const void *> (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -790,6 +943,10 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5,U6), T1 a1, T2 a2, T3 a3, T4 a4,
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual const void * GetHandlerCode (void) const
+    {
+      return reinterpret_cast<const void *> (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -461,6 +461,23 @@ public:
   }
   inline static Time FromDouble (double value, enum Unit unit)
   {
+    struct Information *info = PeekInformation (unit);
+    if (info->fromMul && HasFastDouble (info, value))
+      {
+        // From truncates the exact product of value and factor;
+        // the product and its rounding error are both doubles.
+        const double product = value * info->dFactor;
+        if (std::fabs (product) < FAST_DOUBLE_MAX)
+          {
+            double result = std::floor (product);
+            if (result == product
+                && std::fma (value, info->dFactor, -product) < 0)
+              {
+                result -= 1;
+              }
+            return Time (static_cast<int64_t> (result));
+          }
+      }
     return From (int64x64_t (value), unit);
   }
   inline static Time From (const int64x64_t & value, enum Unit unit)
@@ -510,6 +527,15 @@ public:
   }
   inline double ToDouble (enum Unit unit) const
   {
+    struct Information *info = PeekInformation (unit);
+    if (info->dFactor != 0
+        && m_data <= FAST_INTEGER_MAX && m_data >= -FAST_INTEGER_MAX)
+      {
+        // m_data and factor are exact doubles, so this is the
+        // correctly rounded value.
+        const double value = static_cast<double> (m_data);
+        return info->toMul ? value * info->dFactor : value / info->dFactor;
+      }
     return To (unit).GetDouble ();
   }
   inline int64x64_t To (enum Unit unit) const
@@ -559,6 +585,7 @@ private:
     int64_t factor;                 //!< Ratio of this unit / current unit
     int64x64_t timeTo;              //!< Multiplier to convert to this unit
     int64x64_t timeFrom;            //!< Multiplier to convert from this unit
+    double dFactor;                 //!< factor, or 0 if it is not an exact double
   };
   /** Current time unit, and conversion info. */
   struct Resolution
@@ -588,6 +615,39 @@ private:
     return &(PeekResolution ()->info[timeUnit]);
   }
 
+  /**
+   * \name Fast double conversions.
+   * FromDouble and ToDouble compute with doubles, rather than
+   * int64x64_t, when this gives the same result.
+   * @{
+   */
+  /** Largest integer below which all integers are exact doubles, \f$2^{53}\f$. */
+  static const int64_t FAST_INTEGER_MAX = 9007199254740992LL;
+  /** Bound on the products truncated by FromDouble, \f$2^{52}\f$. */
+  static constexpr double FAST_DOUBLE_MAX = 4503599627370496.0;
+  /**
+   * Smallest magnitude converted exactly to int64x64_t, \f$2^{-11}\f$:
+   * smaller doubles have bits below the int64x64_t resolution.
+   */
+  static constexpr double FAST_DOUBLE_MIN = 1.0 / 2048;
+  /**
+   * Check if FromDouble can convert \pname{value} with doubles.
+   *
+   * The long double int64x64_t implementation rounds the products
+   * itself, so it always takes the int64x64_t path.
+   *
+   * \param [in] info The Information of the unit of \pname{value}.
+   * \param [in] value The value to convert.
+   * \return \c true if \pname{value} can be converted with doubles.
+   */
+  static inline bool HasFastDouble (const struct Information *info, double value)
+  {
+    return int64x64_t::implementation != int64x64_t::ld_impl
+           && info->dFactor != 0
+           && std::fabs (value) >= FAST_DOUBLE_MIN;
+  }
+  /**@}*/
+
   /**
    *  Set the default resolution
    *
@@ -26,6 +26,8 @@
 
 #include <cstdlib>  // getenv
 #include <cstring>  // strlen
+#include <utility>
+#include <vector>
 
 /**
  * \file
@@ -81,6 +83,29 @@ ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
 {
   // loop over the inheritance tree back to the Object base class.
   NS_LOG_FUNCTION (this << &attributes);
+
+  // Parse the env var once for all the attributes.
+  std::vector<std::pair<std::string, std::string> > envDefaults;
+  const char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+  if (envVar != 0 && std::strlen (envVar) > 0)
+    {
+      std::string env = envVar;
+      std::string::size_type cur = 0;
+      std::string::size_type next = 0;
+      while (next != std::string::npos)
+        {
+          next = env.find (";", cur);
+          std::string tmp = std::string (env, cur, next - cur);
+          std::string::size_type equal = tmp.find ("=");
+          if (equal != std::string::npos)
+            {
+              envDefaults.push_back (std::make_pair (tmp.substr (0, equal),
+                                                     tmp.substr (equal + 1, tmp.size () - equal - 1)));
+            }
+          cur = next + 1;
+        }
+    }
+
   TypeId tid = GetInstanceTypeId ();
   do
     {
@@ -126,32 +151,16 @@ ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
             }
 
           // No matching attribute value so we try to look at the env var.
-          const char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
-          if (envVar != 0 && std::strlen (envVar) > 0)
+          for (std::size_t k = 0; k < envDefaults.size (); k++)
             {
-              std::string env = envVar;
-              std::string::size_type cur = 0;
-              std::string::size_type next = 0;
-              while (next != std::string::npos)
+              if (envDefaults[k].first == tid.GetAttributeFullName (i))
                 {
-                  next = env.find (";", cur);
-                  std::string tmp = std::string (env, cur, next - cur);
-                  std::string::size_type equal = tmp.find ("=");
-                  if (equal != std::string::npos)
+                  if (DoSet (info.accessor, info.checker, StringValue (envDefaults[k].second)))
                     {
-                      std::string name = tmp.substr (0, equal);
-                      std::string envval = tmp.substr (equal + 1, tmp.size () - equal - 1);
-                      if (name == tid.GetAttributeFullName (i))
-                        {
-                          if (DoSet (info.accessor, info.checker, StringValue (envval)))
-                            {
-                              NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
-                                            info.name << "\" from env var");
-                              break;
-                            }
-                        }
+                      NS_LOG_DEBUG ("construct \"" << tid.GetName () << "::" <<
+                                    info.name << "\" from env var");
+                      break;
                     }
-                  cur = next + 1;
                 }
             }
 
@@ -46,6 +46,20 @@ NS_LOG_COMPONENT_DEFINE ("Object");
 
 NS_OBJECT_ENSURE_REGISTERED (Object);
 
+/**
+ * A direct-mapped cache of the results of Object::DoGetObject, indexed
+ * by TypeId uid.  Failed lookups are cached too, as a null Object.
+ */
+struct Object::LookupCache
+{
+  /** The number of entries, a power of 2. */
+  static const uint16_t SIZE = 16;
+  /** The TypeId uid of each entry, 0 if the entry is empty. */
+  uint16_t tids[SIZE];
+  /** The Object found for each entry. */
+  Object *objects[SIZE];
+};
+
 Object::AggregateIterator::AggregateIterator ()
   : m_object (0),
     m_current (0)
@@ -97,11 +111,9 @@ Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates (NewAggregates (1))
 {
   NS_LOG_FUNCTION (this);
-  m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object ()
@@ -121,10 +133,16 @@ Object::~Object ()
         }
     }
   // finally, if all objects have been removed from the list,
-  // delete the aggregate list
+  // delete the aggregate list; otherwise, forget the lookups which
+  // could have returned this object.
   if (m_aggregates->n == 0)
     {
-      std::free (m_aggregates);
+      FreeAggregates (m_aggregates);
+    }
+  else
+    {
+      delete m_aggregates->cache;
+      m_aggregates->cache = 0;
     }
   m_aggregates = 0;
 }
@@ -132,10 +150,8 @@ Object::Object (const Object &o)
   : m_tid (o.m_tid),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates (NewAggregates (1))
 {
-  m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
 }
 void
@@ -145,12 +161,40 @@ Object::Construct (const AttributeConstructionList &attributes)
   ConstructSelf (attributes);
 }
 
+struct Object::Aggregates *
+Object::NewAggregates (uint32_t n)
+{
+  NS_LOG_FUNCTION (n);
+  struct Aggregates *aggregates =
+    (struct Aggregates *)std::malloc (sizeof(struct Aggregates) + (n - 1) * sizeof(Object*));
+  aggregates->cache = 0;
+  aggregates->n = n;
+  return aggregates;
+}
+
+void
+Object::FreeAggregates (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  delete aggregates->cache;
+  std::free (aggregates);
+}
+
 Ptr<Object>
 Object::DoGetObject (TypeId tid) const
 {
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  struct LookupCache *cache = m_aggregates->cache;
+  uint16_t uid = tid.GetUid ();
+  uint16_t slot = uid & (LookupCache::SIZE - 1);
+  if (cache != 0 && cache->tids[slot] == uid)
+    {
+      return cache->objects[slot];
+    }
+
+  Object *found = 0;
   uint32_t n = m_aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
@@ -163,21 +207,22 @@ Object::DoGetObject (TypeId tid) const
         }
       if (cur == tid)
         {
-          // This is an attempt to 'cache' the result of this lookup.
-          // the idea is that if we perform a lookup for a TypeId on this object,
-          // we are likely to perform the same lookup later so, we make sure
-          // that the aggregate array is sorted by the number of accesses
-          // to each object.
-
-          // first, increment the access count
-          current->m_getObjectCount++;
-          // then, update the sort
-          UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
-          return const_cast<Object *> (current);
+          found = current;
+          break;
         }
     }
-  return 0;
+
+  // The aggregates change only in AggregateObject, which makes a new
+  // list, and in the destructor, which drops the cache.
+  if (cache == 0)
+    {
+      cache = new LookupCache;
+      std::memset (cache->tids, 0, sizeof (cache->tids));
+      m_aggregates->cache = cache;
+    }
+  cache->tids[slot] = uid;
+  cache->objects[slot] = found;
+  return found;
 }
 void
 Object::Initialize (void)
@@ -185,9 +230,8 @@ Object::Initialize (void)
   /**
    * Note: the code here is a bit tricky because we need to protect ourselves from
    * modifications in the aggregate array while DoInitialize is called. The user's
-   * implementation of the DoInitialize method could call GetObject (which could
-   * reorder the array) and it could call AggregateObject which would add an
-   * object at the end of the array. To be safe, we restart iteration over the
+   * implementation of the DoInitialize method could call AggregateObject which
+   * would add an object at the end of the array. To be safe, we restart iteration over the
    * array whenever we call some user code, just in case.
    */
   NS_LOG_FUNCTION (this);
@@ -216,8 +260,8 @@ Object::Dispose (void)
   /**
    * Note: the code here is a bit tricky because we need to protect ourselves from
    * modifications in the aggregate array while DoDispose is called. The user's
-   * DoDispose implementation could call GetObject (which could reorder the array)
-   * and it could call AggregateObject which would add an object at the end of the array.
+   * DoDispose implementation could call AggregateObject which would add an object
+   * at the end of the array.
    * So, to be safe, we restart the iteration over the array whenever we call some
    * user code.
    */
@@ -236,19 +280,6 @@ restart:
     }
 }
 void
-Object::UpdateSortedArray (struct Aggregates *aggregates, uint32_t j) const
-{
-  NS_LOG_FUNCTION (this << aggregates << j);
-  while (j > 0
-         && aggregates->buffer[j]->m_getObjectCount > aggregates->buffer[j - 1]->m_getObjectCount)
-    {
-      Object *tmp = aggregates->buffer[j - 1];
-      aggregates->buffer[j - 1] = aggregates->buffer[j];
-      aggregates->buffer[j] = tmp;
-      j--;
-    }
-}
-void
 Object::AggregateObject (Ptr<Object> o)
 {
   NS_LOG_FUNCTION (this << o);
@@ -260,9 +291,7 @@ Object::AggregateObject (Ptr<Object> o)
   Object *other = PeekPointer (o);
   // first create the new aggregate buffer.
   uint32_t total = m_aggregates->n + other->m_aggregates->n;
-  struct Aggregates *aggregates =
-    (struct Aggregates *)std::malloc (sizeof(struct Aggregates) + (total - 1) * sizeof(Object*));
-  aggregates->n = total;
+  struct Aggregates *aggregates = NewAggregates (total);
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0],
@@ -281,7 +310,6 @@ Object::AggregateObject (Ptr<Object> o)
                           other->GetInstanceTypeId () <<
                           " on objects of type " << typeId);
         }
-      UpdateSortedArray (aggregates, m_aggregates->n + i);
     }
 
   // keep track of the old aggregate buffers for the iteration
@@ -314,8 +342,8 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
-  std::free (a);
-  std::free (b);
+  FreeAggregates (a);
+  FreeAggregates (b);
 }
 /**
  * This function must be implemented in the stack that needs to notify
@@ -330,6 +330,8 @@ private:
   friend struct ObjectDeleter;
   /**@}*/
 
+  /** The cache of DoGetObject results of a list of aggregates. */
+  struct LookupCache;
   /**
    * The list of Objects aggregated to this one.
    *
@@ -341,9 +343,15 @@ private:
    * chunk of memory than the struct to allow space for a larger
    * variable sized buffer whose size is indicated by the element
    * \c n
+   *
+   * The aggregates also share a cache of the results of DoGetObject,
+   * allocated on the first lookup and dropped with the list when
+   * an Object is aggregated.
    */
   struct Aggregates
   {
+    /** The DoGetObject cache, or null before the first lookup. */
+    struct LookupCache *cache;
     /** The number of entries in \c buffer. */
     uint32_t n;
     /** The array of Objects. */
@@ -398,12 +406,18 @@ private:
   void Construct (const AttributeConstructionList &attributes);
 
   /**
-   * Keep the list of aggregates in most-recently-used order
+   * Allocate a list of aggregates, with an empty cache.
+   *
+   * \param [in] n The number of entries in the list.
+   * \returns The new list.
+   */
+  static struct Aggregates * NewAggregates (uint32_t n);
+  /**
+   * Free a list of aggregates and its cache.
    *
-   * \param [in,out] aggregates The list of aggregated Objects.
-   * \param [in] i The most recently used entry in the list.
+   * \param [in] aggregates The list to free.
    */
-  void UpdateSortedArray (struct Aggregates *aggregates, uint32_t i) const;
+  static void FreeAggregates (struct Aggregates *aggregates);
   /**
    * Attempt to delete this Object.
    *
@@ -435,14 +449,6 @@ private:
    * so the size of the array is indirectly a reference count.
    */
   struct Aggregates * m_aggregates;
-  /**
-   * The number of times the Object was accessed with a
-   * call to GetObject().
-   *
-   * This integer is used to implement a heuristic to sort
-   * the array of aggregates in most-frequently accessed order.
-   */
-  uint32_t m_getObjectCount;
 };
 
 template <typename T>
@@ -37,6 +37,7 @@
 #include <cmath>
 #include <iostream>
 #include <algorithm>    // upper_bound
+#include <unordered_set>
 
 /**
  * \file
@@ -73,17 +74,63 @@ RandomVariableStream::GetTypeId (void)
   return tid;
 }
 
+/**
+ * \ingroup randomvariable
+ * Get the existing streams, for RandomVariableStream::Reseed.
+ *
+ * The set is never deleted, as streams may be destroyed
+ * after the static destructors have run.
+ *
+ * \returns The existing streams.
+ */
+static std::unordered_set<RandomVariableStream *> &
+GetStreams (void)
+{
+  static std::unordered_set<RandomVariableStream *> *streams =
+    new std::unordered_set<RandomVariableStream *> ();
+  return *streams;
+}
+
 RandomVariableStream::RandomVariableStream ()
-  : m_rng (0)
+  : m_rng (0),
+    m_rngStream (0)
 {
   NS_LOG_FUNCTION (this);
+  GetStreams ().insert (this);
 }
 RandomVariableStream::~RandomVariableStream ()
 {
   NS_LOG_FUNCTION (this);
+  GetStreams ().erase (this);
   delete m_rng;
 }
 
+void
+RandomVariableStream::Reseed (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  const std::unordered_set<RandomVariableStream *> &streams = GetStreams ();
+  for (std::unordered_set<RandomVariableStream *>::const_iterator i = streams.begin ();
+       i != streams.end (); ++i)
+    {
+      RandomVariableStream *stream = *i;
+      if (stream->m_rng != 0)
+        {
+          delete stream->m_rng;
+          stream->m_rng = new RngStream (RngSeedManager::GetSeed (),
+                                         stream->m_rngStream,
+                                         RngSeedManager::GetRun ());
+          stream->ResetState ();
+        }
+    }
+}
+
+void
+RandomVariableStream::ResetState (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
 void
 RandomVariableStream::SetAntithetic (bool isAntithetic)
 {
@@ -109,6 +156,7 @@ RandomVariableStream::SetStream (int64_t stream)
       // number assignment.
       uint64_t nextStream = RngSeedManager::GetNextStreamIndex ();
       NS_ASSERT (nextStream <= ((1ULL) << 63));
+      m_rngStream = nextStream;
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              nextStream,
                              RngSeedManager::GetRun ());
@@ -119,6 +167,7 @@ RandomVariableStream::SetStream (int64_t stream)
       // number assignment.
       uint64_t base = ((1ULL) << 63);
       uint64_t target = base + stream;
+      m_rngStream = target;
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              target,
                              RngSeedManager::GetRun ());
@@ -132,6 +181,16 @@ RandomVariableStream::GetStream (void) const
   return m_stream;
 }
 
+void
+RandomVariableStream::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      values[i] = GetValue ();
+    }
+}
+
 RngStream *
 RandomVariableStream::Peek (void) const
 {
@@ -209,6 +268,23 @@ UniformRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_min, m_max + 1);
 }
+void
+UniformRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  Peek ()->RandU01 (values, n);
+  bool antithetic = IsAntithetic ();
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      // Same arithmetic as GetValue (min, max)
+      double v = m_min + values[i] * (m_max - m_min);
+      if (antithetic)
+        {
+          v = m_min + (m_max - v);
+        }
+      values[i] = v;
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED (ConstantRandomVariable);
 
@@ -264,6 +340,12 @@ ConstantRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_constant);
 }
+void
+ConstantRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  std::fill (values, values + n, m_constant);
+}
 
 NS_OBJECT_ENSURE_REGISTERED (SequentialRandomVariable);
 
@@ -445,6 +527,32 @@ ExponentialRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_mean, m_bound);
 }
+void
+ExponentialRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  if (m_bound != 0)
+    {
+      // Rejection consumes a variable number of uniforms per value.
+      for (std::size_t i = 0; i < n; ++i)
+        {
+          values[i] = GetValue (m_mean, m_bound);
+        }
+      return;
+    }
+  Peek ()->RandU01 (values, n);
+  bool antithetic = IsAntithetic ();
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      // Same arithmetic as GetValue (mean, bound)
+      double v = values[i];
+      if (antithetic)
+        {
+          v = (1 - v);
+        }
+      values[i] = -m_mean * std::log (v);
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED (ParetoRandomVariable);
 
@@ -679,6 +787,13 @@ NormalRandomVariable::NormalRandomVariable ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+NormalRandomVariable::ResetState (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_nextValid = false;
+}
+
 double
 NormalRandomVariable::GetMean (void) const
 {
@@ -763,6 +878,17 @@ NormalRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_mean, m_variance, m_bound);
 }
+void
+NormalRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  // Rejection consumes a variable number of uniforms per value, but
+  // this still saves the virtual call.
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      values[i] = GetValue (m_mean, m_variance, m_bound);
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED (LogNormalRandomVariable);
 
@@ -913,6 +1039,13 @@ GammaRandomVariable::GammaRandomVariable ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+GammaRandomVariable::ResetState (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_nextValid = false;
+}
+
 double
 GammaRandomVariable::GetAlpha (void) const
 {
@@ -30,6 +30,7 @@
 #include "object.h"
 #include "attribute-helper.h"
 #include <stdint.h>
+#include <cstddef>
 
 /**
  * \file
@@ -149,6 +150,32 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Get the next \pname{n} random values drawn from the distribution.
+   *
+   * The values, and the state of the stream afterwards, are the same,
+   * bit for bit, as \pname{n} calls to GetValue (void).  Subclasses
+   * override this to draw their uniforms with RngStream::RandU01
+   * (double *, std::size_t) and to avoid a virtual call per value.
+   *
+   * \param [out] values The array to fill.
+   * \param [in] n The number of values.
+   */
+  virtual void GetValues (double *values, std::size_t n);
+
+  /**
+   * \brief Restart all the existing streams from the current seed
+   * and run number.
+   *
+   * Streams draw from the seed and run number current when their
+   * stream number is set, usually when they are created.  After
+   * changing them with RngSeedManager::SetSeed or RngSeedManager::SetRun,
+   * this restarts every existing stream, with its stream number, at the
+   * start of its substream for the new seed and run.  This lets
+   * independent replications reuse a topology built once.
+   */
+  static void Reseed (void);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RngStream.
@@ -156,6 +183,15 @@ protected:
    */
   RngStream * Peek (void) const;
 
+  /**
+   * \brief Drop the values drawn from the previous RngStream.
+   *
+   * Reseed calls this after restarting the RngStream.  Subclasses
+   * which keep values for the next calls override this to forget
+   * them, so the draws after Reseed depend only on the new stream.
+   */
+  virtual void ResetState (void);
+
 private:
   /**
    * Copy constructor.  These objects are not copyable.
@@ -187,6 +223,9 @@ private:
   /** The stream number for the RngStream. */
   int64_t m_stream;
 
+  /** The index of the RngStream, including the automatic stream numbers. */
+  uint64_t m_rngStream;
+
 };  // class RandomVariableStream
 
 
@@ -294,6 +333,7 @@ public:
    * \note The upper limit is included in the output range.
    */
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The lower bound on values that can be returned by this RNG stream. */
@@ -353,6 +393,7 @@ public:
   virtual double GetValue (void);
   /* \note This RNG always returns the same value. */
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The constant value returned by this RNG stream. */
@@ -586,6 +627,7 @@ public:
   // Inherited from RandomVariableStream
   virtual double GetValue (void);
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The mean value of the unbounded exponential distribution. */
@@ -1226,6 +1268,11 @@ public:
    * which now involves the distances \f$u1\f$ and \f$u2\f$ are from 1.
    */
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
+
+protected:
+  /** Forget the cached second value of the pair. */
+  virtual void ResetState (void);
 
 private:
   /** The mean value for the normal distribution returned by this RNG stream. */
@@ -1586,6 +1633,10 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+protected:
+  /** Forget the cached second value of the pair. */
+  virtual void ResetState (void);
+
 private:
   /**
    * \brief Returns a random double from a normal distribution with the specified mean, variance, and bound.
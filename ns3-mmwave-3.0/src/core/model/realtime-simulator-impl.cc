@@ -31,9 +31,15 @@
 #include "system-mutex.h"
 #include "boolean.h"
 #include "enum.h"
+#include "object-factory.h"
+#include "trace-source-accessor.h"
 
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
 
 
 /**
@@ -51,6 +57,33 @@ NS_LOG_COMPONENT_DEFINE ("RealtimeSimulatorImpl");
 
 NS_OBJECT_ENSURE_REGISTERED (RealtimeSimulatorImpl);
 
+namespace {
+
+/**
+ * \ingroup realtime
+ * Count the significant bits of a value.
+ *
+ * \param [in] value The value.
+ * \returns The position of the highest bit set, from 1, or 0 if
+ *          \pname{value} is 0.
+ */
+std::size_t
+SignificantBits (uint64_t value)
+{
+  std::size_t bits = 0;
+  for (std::size_t shift = 32; shift > 0; shift /= 2)
+    {
+      if (value >> shift)
+        {
+          value >>= shift;
+          bits += shift;
+        }
+    }
+  return bits + (value != 0);
+}
+
+} // unnamed namespace
+
 TypeId
 RealtimeSimulatorImpl::GetTypeId (void)
 {
@@ -69,6 +102,18 @@ RealtimeSimulatorImpl::GetTypeId (void)
                    TimeValue (Seconds (0.1)),
                    MakeTimeAccessor (&RealtimeSimulatorImpl::m_hardLimit),
                    MakeTimeChecker ())
+    .AddAttribute ("SynchronizerType",
+                   "The type of the Synchronizer keeping the simulation "
+                   "in step with real time.",
+                   TypeIdValue (WallClockSynchronizer::GetTypeId ()),
+                   MakeTypeIdAccessor (&RealtimeSimulatorImpl::SetSynchronizerType,
+                                       &RealtimeSimulatorImpl::GetSynchronizerType),
+                   MakeTypeIdChecker ())
+    .AddTraceSource ("Lateness",
+                     "The real time at which each event started, "
+                     "minus its timestamp.",
+                     MakeTraceSourceAccessor (&RealtimeSimulatorImpl::m_latenessTrace),
+                     "ns3::RealtimeSimulatorImpl::LatenessTracedCallback")
   ;
   return tid;
 }
@@ -84,6 +129,7 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
   // uid 0 is "invalid" events
   // uid 1 is "now" events
   // uid 2 is "destroy" events
+  // uid 3 is "periodic" series, see Simulator::SchedulePeriodic
   m_uid = 4;
   // before ::Run is entered, the m_currentUid will be zero
   m_currentUid = 0;
@@ -97,6 +143,9 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
   // Be very careful not to do anything that would cause a change or assignment
   // of the underlying reference counts of m_synchronizer or you will be sorry.
   m_synchronizer = CreateObject<WallClockSynchronizer> ();
+
+  std::memset (m_lateness, 0, sizeof (m_lateness));
+  m_maxLateness = 0;
 }
 
 RealtimeSimulatorImpl::~RealtimeSimulatorImpl ()
@@ -317,6 +366,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
   // whatever event is at the head of this list if the list is in time order.
   //
   Scheduler::Event next;
+  int64_t lateness;
 
   {
     CriticalSection cs (m_mutex);
@@ -361,9 +411,22 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     // We check the simulation time against the current real time to make this
     // judgement.
     //
+    uint64_t tsFinal = m_synchronizer->GetCurrentRealtime ();
+    lateness = (int64_t)(tsFinal - m_currentTs);
+    if (lateness > 0)
+      {
+        // the bucket is the number of significant bits
+        std::size_t bucket = SignificantBits (lateness);
+        m_lateness[std::min (bucket, LATENESS_BUCKETS - 1)]++;
+        m_maxLateness = std::max (m_maxLateness, lateness);
+      }
+    else
+      {
+        m_lateness[0]++;
+      }
+
     if (m_synchronizationMode == SYNC_HARD_LIMIT)
       {
-        uint64_t tsFinal = m_synchronizer->GetCurrentRealtime ();
         uint64_t tsJitter;
 
         if (tsFinal >= m_currentTs)
@@ -386,7 +449,10 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
   //
   // We have got the event we're about to execute completely disentangled from the
   // event list so we can execute it outside a critical section without fear of someone
-  // changing things out from under us.
+  // changing things out from under us.  The lateness sinks are also called
+  // outside the critical section, since they may use the simulator.
+  //
+  m_latenessTrace (TimeStep (lateness));
 
   EventImpl *event = next.impl;
   m_synchronizer->EventStart ();
@@ -853,4 +919,65 @@ RealtimeSimulatorImpl::GetHardLimit (void) const
   return m_hardLimit;
 }
 
+void
+RealtimeSimulatorImpl::SetSynchronizerType (TypeId tid)
+{
+  NS_LOG_FUNCTION (this << tid.GetName ());
+  NS_ASSERT_MSG (!m_running, "Cannot change the synchronizer of a running simulation");
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  m_synchronizer = factory.Create<Synchronizer> ();
+}
+
+TypeId
+RealtimeSimulatorImpl::GetSynchronizerType (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_synchronizer->GetInstanceTypeId ();
+}
+
+std::vector<uint64_t>
+RealtimeSimulatorImpl::GetLatenessHistogram (void) const
+{
+  NS_LOG_FUNCTION (this);
+  CriticalSection cs (m_mutex);
+  std::size_t size = LATENESS_BUCKETS;
+  while (size > 0 && m_lateness[size - 1] == 0)
+    {
+      size--;
+    }
+  return std::vector<uint64_t> (m_lateness, m_lateness + size);
+}
+
+Time
+RealtimeSimulatorImpl::GetMaxLateness (void) const
+{
+  NS_LOG_FUNCTION (this);
+  CriticalSection cs (m_mutex);
+  return TimeStep (m_maxLateness);
+}
+
+void
+RealtimeSimulatorImpl::PrintLatenessHistogram (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  std::vector<uint64_t> histogram = GetLatenessHistogram ();
+  os << std::setw (24) << "Lateness (ns)" << std::setw (14) << "Events" << std::endl;
+  for (std::size_t i = 0; i < histogram.size (); ++i)
+    {
+      if (i == 0)
+        {
+          os << std::setw (24) << "<= 0";
+        }
+      else
+        {
+          std::ostringstream range;
+          range << (uint64_t (1) << (i - 1)) << " - " << (uint64_t (1) << (i - 1)) * 2 - 1;
+          os << std::setw (24) << range.str ();
+        }
+      os << std::setw (14) << histogram[i] << std::endl;
+    }
+  os << "Maximum lateness: " << GetMaxLateness ().GetNanoSeconds () << " ns" << std::endl;
+}
+
 } // namespace ns3
@@ -30,8 +30,12 @@
 #include "assert.h"
 #include "log.h"
 #include "system-mutex.h"
+#include "traced-callback.h"
+#include "type-id.h"
 
 #include <list>
+#include <ostream>
+#include <vector>
 
 /**
  * \file
@@ -156,6 +160,52 @@ public:
    */
   Time GetHardLimit (void) const;
 
+  /**
+   * Set the type of the Synchronizer, replacing the current one.
+   *
+   * This can only be done before the simulation runs.
+   *
+   * \param [in] tid The TypeId of a Synchronizer.
+   */
+  void SetSynchronizerType (TypeId tid);
+  /**
+   * Get the type of the Synchronizer.
+   * \returns The TypeId of the Synchronizer.
+   */
+  TypeId GetSynchronizerType (void) const;
+
+  /**
+   * Get the histogram of the lateness of the events: the real time
+   * at which each event started, minus its timestamp.
+   *
+   * Bucket 0 counts the events started on time or early; bucket
+   * \f$ i > 0 \f$ counts the events started between
+   * \f$ 2^{i-1} \f$ and \f$ 2^i - 1 \f$ ns late.
+   * Trailing empty buckets are omitted.
+   *
+   * \returns The number of events in each bucket.
+   */
+  std::vector<uint64_t> GetLatenessHistogram (void) const;
+  /**
+   * Get the maximum lateness of the events.
+   * \returns The maximum lateness.
+   */
+  Time GetMaxLateness (void) const;
+  /**
+   * Print the lateness histogram, one line per bucket.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void PrintLatenessHistogram (std::ostream &os) const;
+
+  /**
+   * TracedCallback signature for the lateness of an event.
+   *
+   * \param [in] lateness The real time at which the event started,
+   *            minus its timestamp; negative when early.
+   */
+  typedef void (* LatenessTracedCallback)(Time lateness);
+
 private:
   /**
    * Is the simulator running?
@@ -222,6 +272,15 @@ private:
 
   /** Main SystemThread. */
   SystemThread::ThreadId m_main;
+
+  /** Number of buckets of the lateness histogram. */
+  static const std::size_t LATENESS_BUCKETS = 64;
+  /** The lateness histogram, see GetLatenessHistogram. */
+  uint64_t m_lateness[LATENESS_BUCKETS];
+  /** The maximum lateness, in ns. */
+  int64_t m_maxLateness;
+  /** Trace of the lateness of every event. */
+  TracedCallback<Time> m_latenessTrace;
 };
 
 } // namespace ns3
@@ -323,43 +323,40 @@ void PowerOfTwoMatrix (int n, Matrix a1p, Matrix a2p)
     }
 }
 
-} // namespace MRG32k3a
-
-// *NS_CHECK_STYLE_ON*
-
-
-namespace ns3 {
-
-using namespace MRG32k3a;
-
-double RngStream::RandU01 ()
+/**
+ * Advance the generator state by one step.
+ *
+ * \param [in,out] s The generator state.
+ * \returns The next value in (0,1).
+ */
+inline double Step (double s[6])
 {
   int32_t k;
   double p1, p2, u;
 
   /* Component 1 */
-  p1 = a12 * m_currentState[1] - a13n * m_currentState[0];
+  p1 = a12 * s[1] - a13n * s[0];
   k = static_cast<int32_t> (p1 / m1);
   p1 -= k * m1;
   if (p1 < 0.0)
     {
       p1 += m1;
     }
-  m_currentState[0] = m_currentState[1];
-  m_currentState[1] = m_currentState[2];
-  m_currentState[2] = p1;
+  s[0] = s[1];
+  s[1] = s[2];
+  s[2] = p1;
 
   /* Component 2 */
-  p2 = a21 * m_currentState[5] - a23n * m_currentState[3];
+  p2 = a21 * s[5] - a23n * s[3];
   k = static_cast<int32_t> (p2 / m2);
   p2 -= k * m2;
   if (p2 < 0.0)
     {
       p2 += m2;
     }
-  m_currentState[3] = m_currentState[4];
-  m_currentState[4] = m_currentState[5];
-  m_currentState[5] = p2;
+  s[3] = s[4];
+  s[4] = s[5];
+  s[5] = p2;
 
   /* Combination */
   u = ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
@@ -367,6 +364,39 @@ double RngStream::RandU01 ()
   return u;
 }
 
+} // namespace MRG32k3a
+
+// *NS_CHECK_STYLE_ON*
+
+
+namespace ns3 {
+
+using namespace MRG32k3a;
+
+double RngStream::RandU01 ()
+{
+  return Step (m_currentState);
+}
+
+void
+RngStream::RandU01 (double *values, std::size_t n)
+{
+  // A local copy of the state can stay in registers across the loop.
+  double s[6];
+  for (int i = 0; i < 6; ++i)
+    {
+      s[i] = m_currentState[i];
+    }
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      values[i] = Step (s);
+    }
+  for (int i = 0; i < 6; ++i)
+    {
+      m_currentState[i] = s[i];
+    }
+}
+
 RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
 {
   if (seedNumber >= m1 || seedNumber >= m2 || seedNumber == 0)
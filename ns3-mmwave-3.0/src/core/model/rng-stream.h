@@ -19,6 +19,7 @@
 
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
+#include <cstddef>
 #include <string>
 #include <stdint.h>
 
@@ -70,6 +71,16 @@ public:
    * \returns The next random.
    */
   double RandU01 (void);
+  /**
+   * Generate the next \pname{n} random numbers for this stream.
+   *
+   * The values are the same, bit for bit, as \pname{n} calls to
+   * RandU01 (void), and leave the stream in the same state.
+   *
+   * \param [out] values The array to fill.
+   * \param [in] n The number of values.
+   */
+  void RandU01 (double *values, std::size_t n);
 
 private:
   /**
@@ -22,6 +22,7 @@
 #define SCHEDULER_H
 
 #include <stdint.h>
+#include <vector>
 #include "object.h"
 
 /**
@@ -103,10 +104,10 @@ class EventImpl;
  * </tr>
  * <tr class="markdownTableBody">
  *      <td class="markdownTableBodyLeft"> HeapScheduler </td>
- *      <td class="markdownTableBodyLeft"> Heap on `std::vector` </td>
+ *      <td class="markdownTableBodyLeft"> 4-ary heap on `std::vector` </td>
  *      <td class="markdownTableBodyLeft"> Logarithmic  </td>
  *      <td class="markdownTableBodyLeft"> Logarithmic </td>
- *      <td class="markdownTableBodyLeft"> 24 bytes </td>
+ *      <td class="markdownTableBodyLeft"> 48 bytes </td>
  *      <td class="markdownTableBodyLeft"> 0 </td>
  * </tr>
  * <tr class="markdownTableBody">
@@ -183,6 +184,34 @@ public:
     EventImpl *impl;       /**< Pointer to the event implementation. */
     EventKey key;          /**< Key for sorting and ordering Events. */
   };
+  /**
+   * \ingroup events
+   * Compact form of an EventKey, for schedulers which compare keys often.
+   *
+   * The uid and the context are packed in a single word, the uid
+   * in the high bits.  Since uids are unique the word orders like
+   * the uid, so two words compare keys without a branch.
+   */
+  struct PackedKey
+  {
+    uint64_t m_ts;         /**< Event time stamp. */
+    uint64_t m_uidContext; /**< Event unique id (high) and context (low). */
+  };
+
+  /**
+   * Pack an EventKey.
+   *
+   * \param [in] key The key.
+   * \returns The packed key.
+   */
+  static PackedKey Pack (const EventKey &key);
+  /**
+   * Unpack an EventKey.
+   *
+   * \param [in] packed The packed key.
+   * \returns The key.
+   */
+  static EventKey Unpack (const PackedKey &packed);
 
   /** Destructor. */
   virtual ~Scheduler () = 0;
@@ -193,6 +222,15 @@ public:
    * \param [in] ev Event to store in the event list
    */
   virtual void Insert (const Event &ev) = 0;
+  /**
+   * Insert several new Events in the schedule.
+   *
+   * The default implementation inserts the events one at a time;
+   * schedulers which can build their structure in bulk override it.
+   *
+   * \param [in] events The events to store in the event list.
+   */
+  virtual void InsertBatch (const std::vector<Event> &events);
   /**
    * Test if the schedule is empty.
    *
@@ -270,19 +308,11 @@ inline bool operator != (const Scheduler::EventKey &a,
 inline bool operator < (const Scheduler::EventKey &a,
                         const Scheduler::EventKey &b)
 {
-  if (a.m_ts < b.m_ts)
-    {
-      return true;
-    }
-  else if (a.m_ts == b.m_ts
-           && a.m_uid < b.m_uid)
-    {
-      return true;
-    }
-  else
-    {
-      return false;
-    }
+  // Evaluate both tests to avoid a hard-to-predict branch.
+  int tsLess = a.m_ts < b.m_ts;
+  int tsEqual = a.m_ts == b.m_ts;
+  int uidLess = a.m_uid < b.m_uid;
+  return (tsLess | (tsEqual & uidLess)) != 0;
 }
 
 /**
@@ -295,19 +325,10 @@ inline bool operator < (const Scheduler::EventKey &a,
 inline bool operator > (const Scheduler::EventKey &a,
                         const Scheduler::EventKey &b)
 {
-  if (a.m_ts > b.m_ts)
-    {
-      return true;
-    }
-  else if (a.m_ts == b.m_ts
-           && a.m_uid > b.m_uid)
-    {
-      return true;
-    }
-  else
-    {
-      return false;
-    }
+  int tsGreater = a.m_ts > b.m_ts;
+  int tsEqual = a.m_ts == b.m_ts;
+  int uidGreater = a.m_uid > b.m_uid;
+  return (tsGreater | (tsEqual & uidGreater)) != 0;
 }
 
 /**
@@ -362,6 +383,40 @@ inline bool operator > (const Scheduler::Event &a,
   return a.key > b.key;
 }
 
+inline Scheduler::PackedKey
+Scheduler::Pack (const Scheduler::EventKey &key)
+{
+  PackedKey packed;
+  packed.m_ts = key.m_ts;
+  packed.m_uidContext = (static_cast<uint64_t> (key.m_uid) << 32) | key.m_context;
+  return packed;
+}
+
+inline Scheduler::EventKey
+Scheduler::Unpack (const Scheduler::PackedKey &packed)
+{
+  EventKey key;
+  key.m_ts = packed.m_ts;
+  key.m_uid = static_cast<uint32_t> (packed.m_uidContext >> 32);
+  key.m_context = static_cast<uint32_t> (packed.m_uidContext);
+  return key;
+}
+
+/**
+ * Compare (less than) two packed keys.
+ *
+ * \param [in] a The first key.
+ * \param [in] b The second key.
+ * \returns \c true if \c a < \c b
+ */
+inline bool operator < (const Scheduler::PackedKey &a,
+                        const Scheduler::PackedKey &b)
+{
+  int tsLess = a.m_ts < b.m_ts;
+  int tsEqual = a.m_ts == b.m_ts;
+  int uidLess = a.m_uidContext < b.m_uidContext;
+  return (tsLess | (tsEqual & uidLess)) != 0;
+}
 
 } // namespace ns3
 
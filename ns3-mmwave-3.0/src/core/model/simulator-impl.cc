@@ -42,4 +42,18 @@ SimulatorImpl::GetTypeId (void)
   return tid;
 }
 
+std::vector<EventId>
+SimulatorImpl::ScheduleBatch (const std::vector<std::pair<Time, EventImpl *> > &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  std::vector<EventId> ids;
+  ids.reserve (events.size ());
+  for (std::vector<std::pair<Time, EventImpl *> >::const_iterator i = events.begin ();
+       i != events.end (); ++i)
+    {
+      ids.push_back (Schedule (i->first, i->second));
+    }
+  return ids;
+}
+
 } // namespace ns3
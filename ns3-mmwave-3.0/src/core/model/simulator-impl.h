@@ -28,6 +28,9 @@
 #include "object-factory.h"
 #include "ptr.h"
 
+#include <utility>
+#include <vector>
+
 /**
  * \file
  * \ingroup simulator
@@ -71,6 +74,12 @@ public:
   virtual EventId ScheduleNow (EventImpl *event) = 0;
   /** \copydoc Simulator::ScheduleDestroy(const Ptr<EventImpl>&) */
   virtual EventId ScheduleDestroy (EventImpl *event) = 0;
+  /**
+   * \copydoc Simulator::ScheduleBatch(const std::vector<std::pair<Time,Ptr<EventImpl> > >&)
+   *
+   * The default implementation schedules the events one at a time.
+   */
+  virtual std::vector<EventId> ScheduleBatch (const std::vector<std::pair<Time, EventImpl *> > &events);
   /** \copydoc Simulator::Remove */
   virtual void Remove (const EventId &id) = 0;
   /** \copydoc Simulator::Cancel */
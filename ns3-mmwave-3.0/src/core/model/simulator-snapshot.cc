@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator-snapshot.h"
+#include "simulator.h"
+#include "abort.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorSnapshot implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SimulatorSnapshot");
+
+bool SimulatorSnapshot::m_isBranch = false;
+uint32_t SimulatorSnapshot::m_nFailures = 0;
+
+namespace {
+
+/**
+ * Reap a branch, if it exited.
+ *
+ * \param [in] pid The branch.
+ * \param [in] options The options of waitpid, 0 to block until it exits.
+ * \param [out] success \c true if the branch exited successfully.
+ * \returns \c true if the branch exited.
+ */
+bool
+ReapBranch (pid_t pid, int options, bool &success)
+{
+  int status;
+  pid_t reaped;
+  do
+    {
+      reaped = waitpid (pid, &status, options);
+    }
+  while (reaped == -1 && errno == EINTR);
+  NS_ABORT_MSG_IF (reaped == -1, "Unable to wait for branch " << pid << ": "
+                   << std::strerror (errno));
+  if (reaped == 0)
+    {
+      return false;
+    }
+  success = WIFEXITED (status) && WEXITSTATUS (status) == 0;
+  if (!success)
+    {
+      NS_LOG_WARN ("Branch " << pid << " failed, with status " << status);
+    }
+  return true;
+}
+
+/**
+ * Wait for one of the branches to exit.
+ *
+ * Only the branches are waited for, so that the other children of the
+ * process, e.g. those of the program, are left to it.
+ *
+ * \param [in,out] pids The running branches; the exited one is removed.
+ * \returns \c true if the branch exited successfully.
+ */
+bool
+WaitBranch (std::vector<pid_t> &pids)
+{
+  bool success = false;
+  for (std::vector<pid_t>::iterator i = pids.begin (); i != pids.end (); ++i)
+    {
+      if (ReapBranch (*i, WNOHANG, success))
+        {
+          pids.erase (i);
+          return success;
+        }
+    }
+  // None has exited yet: wait for any child to exit, leaving it waitable
+  siginfo_t info;
+  int result;
+  do
+    {
+      info.si_pid = 0;
+      result = waitid (P_ALL, 0, &info, WEXITED | WNOWAIT);
+    }
+  while (result == -1 && errno == EINTR);
+  NS_ABORT_MSG_IF (result == -1, "Unable to wait for the branches: "
+                   << std::strerror (errno));
+  std::vector<pid_t>::iterator exited = std::find (pids.begin (), pids.end (), info.si_pid);
+  if (exited == pids.end ())
+    {
+      // Another child of the program, which stays waitable: wait for
+      // the oldest branch instead
+      exited = pids.begin ();
+    }
+  ReapBranch (*exited, 0, success);
+  pids.erase (exited);
+  return success;
+}
+
+/**
+ * Count the threads of the process.
+ * \returns The number of threads, or 0 if it is unknown.
+ */
+uint32_t
+CountThreads (void)
+{
+  DIR *dir = opendir ("/proc/self/task");
+  if (dir == 0)
+    {
+      return 0;
+    }
+  uint32_t n = 0;
+  for (struct dirent *entry = readdir (dir); entry != 0; entry = readdir (dir))
+    {
+      if (entry->d_name[0] != '.')
+        {
+          ++n;
+        }
+    }
+  closedir (dir);
+  return n;
+}
+
+} // unnamed namespace
+
+uint32_t
+SimulatorSnapshot::Branch (uint32_t n, uint32_t jobs)
+{
+  NS_LOG_FUNCTION (n << jobs);
+  NS_ABORT_MSG_IF (jobs == 0, "SimulatorSnapshot::Branch needs at least one job");
+  // The branches would only have the calling thread: the others, e.g. the
+  // workers of WindowedSimulatorImpl or of an asynchronous file writer,
+  // would be missing, with the locks they held never released
+  uint32_t nThreads = CountThreads ();
+  if (nThreads > 1)
+    {
+      NS_FATAL_ERROR ("SimulatorSnapshot::Branch cannot fork a process with "
+                      << nThreads << " threads");
+    }
+
+  // Buffered output would be written by every branch
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (0);
+
+  std::vector<pid_t> pids;
+  m_nFailures = 0;
+  for (uint32_t branch = 0; branch < n; ++branch)
+    {
+      if (pids.size () == jobs && !WaitBranch (pids))
+        {
+          ++m_nFailures;
+        }
+      pid_t pid = fork ();
+      NS_ABORT_MSG_IF (pid == -1, "Unable to fork branch " << branch << ": "
+                       << std::strerror (errno));
+      if (pid == 0)
+        {
+          m_isBranch = true;
+          NS_LOG_LOGIC ("Running branch " << branch);
+          return branch;
+        }
+      NS_LOG_LOGIC ("Forked branch " << branch << " as " << pid);
+      pids.push_back (pid);
+    }
+  while (!pids.empty ())
+    {
+      if (!WaitBranch (pids))
+        {
+          ++m_nFailures;
+        }
+    }
+  // Outside of Simulator::Run, the next Run forgets this: the caller
+  // must not run the simulation when Branch returns n
+  Simulator::Stop ();
+  return n;
+}
+
+bool
+SimulatorSnapshot::IsBranch (void)
+{
+  return m_isBranch;
+}
+
+uint32_t
+SimulatorSnapshot::GetNFailures (void)
+{
+  return m_nFailures;
+}
+
+} // namespace ns3
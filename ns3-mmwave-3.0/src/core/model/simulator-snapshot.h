@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIMULATOR_SNAPSHOT_H
+#define SIMULATOR_SNAPSHOT_H
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorSnapshot declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Snapshot a running simulation, and restore it several times.
+ *
+ * The state of a simulation is spread over the scheduler queue, whose
+ * events hold arbitrary functions and pointers, the objects, their
+ * attributes, the random number streams and the state of every module,
+ * so it cannot be written to a file in general.  Instead, Branch takes
+ * the snapshot with fork(): the calling process is the snapshot, and
+ * each branch is a copy-on-write copy of it, which resumes the simulation
+ * from the point of the snapshot.  Only the memory a branch writes to
+ * is copied.
+ *
+ * This lets parameter sweeps run a common warm-up once:
+ * \code
+ *   void
+ *   WarmUpDone (std::vector<double> loads)
+ *   {
+ *     uint32_t branch = SimulatorSnapshot::Branch (loads.size (), 4);
+ *     if (branch == loads.size ())
+ *       {
+ *         // The snapshot: all the branches have run, and
+ *         // Simulator::Run returns after this event.
+ *         return;
+ *       }
+ *     SetLoad (loads[branch]);
+ *   }
+ *
+ *   Simulator::Schedule (Seconds (20), &WarmUpDone, loads);
+ *   Simulator::Run ();
+ * \endcode
+ *
+ * Each branch runs the rest of the program, including the code after
+ * Simulator::Run, and exits when it does; it should write its results
+ * to files of its own.
+ *
+ * Only the calling thread is copied, so the process must have no other
+ * thread: this does not support the real time and distributed simulator
+ * implementations, nor WindowedSimulatorImpl with more than one thread,
+ * and the asynchronous writers of pcap files, which run a thread, must be
+ * closed before branching.  Branch aborts, on systems where it can count
+ * the threads, when there are others.
+ */
+class SimulatorSnapshot
+{
+public:
+  /**
+   * Branch the simulation at the current point.
+   *
+   * The calling process forks \p n branches, running at most \p jobs
+   * of them at once, and waits for all of them.  It then stops the
+   * simulator, when this is called from an event, during Simulator::Run.
+   *
+   * When called outside of Simulator::Run, e.g. after building the
+   * topology, each branch runs the simulation itself, and the calling
+   * process must not run it when this returns \p n: Simulator::Run
+   * forgets the stops requested before it, so the calling process would
+   * run the whole simulation once more.  ReplicationRunner branches
+   * this way.
+   *
+   * \param [in] n The number of branches.
+   * \param [in] jobs The number of branches to run at once.
+   * \returns The index of the branch, in [0, \p n), in each branch,
+   *          or \p n in the calling process, after all the branches
+   *          have exited.
+   */
+  static uint32_t Branch (uint32_t n, uint32_t jobs = 1);
+
+  /**
+   * Check if this process is a branch.
+   * \returns \c true if this process was forked by Branch.
+   */
+  static bool IsBranch (void);
+
+  /**
+   * Get the number of branches of the last Branch which did not exit
+   * successfully, i.e. which were killed or exited with a non-zero status.
+   * \returns The number of failed branches.
+   */
+  static uint32_t GetNFailures (void);
+
+private:
+  /** \c true in the processes forked by Branch. */
+  static bool m_isBranch;
+  /** The number of failed branches of the last Branch. */
+  static uint32_t m_nFailures;
+};
+
+} // namespace ns3
+
+#endif /* SIMULATOR_SNAPSHOT_H */
@@ -132,6 +132,88 @@ static SimulatorImpl * GetImpl (void)
   return *pimpl;
 }
 
+namespace {
+
+/**
+ * \ingroup simulator
+ * The event of a Simulator::SchedulePeriodic series.
+ *
+ * The same instance is rescheduled every period, before invoking the
+ * periodic event, and remembers the key of its next expiration.  The
+ * series stops when this instance is cancelled.
+ */
+class PeriodicEventImpl : public EventImpl
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] period The period.
+   * \param [in] event The event to invoke every period; this takes
+   *            over the caller's reference.
+   */
+  PeriodicEventImpl (const Time &period, EventImpl *event)
+    : m_period (period),
+      m_event (event, false),
+      m_ts (0),
+      m_context (0),
+      m_uid (0)
+  {}
+  /** Schedule the next expiration, one period from now. */
+  void ScheduleNext (void)
+  {
+#ifdef ENABLE_DES_METRICS
+    DesMetrics::Get ()->Trace (Simulator::Now (), m_period);
+#endif
+    // the simulator takes over a reference
+    Ref ();
+    EventId next = GetImpl ()->Schedule (m_period, this);
+    // not an EventId member, which would reference this instance
+    m_ts = next.GetTs ();
+    m_context = next.GetContext ();
+    m_uid = next.GetUid ();
+  }
+  /**
+   * Get the id of the next expiration.
+   * \returns The EventId.
+   */
+  EventId GetNext (void)
+  {
+    return EventId (Ptr<EventImpl> (this), m_ts, m_context, m_uid);
+  }
+  virtual const void * GetHandlerCode (void) const
+  {
+    return m_event->GetHandlerCode ();
+  }
+
+private:
+  virtual void Notify (void)
+  {
+    ScheduleNext ();
+    m_event->Invoke ();
+  }
+
+  Time m_period;                        //!< The period.
+  Ptr<EventImpl> m_event;               //!< The periodic event.
+  uint64_t m_ts;                        //!< The next expiration time.
+  uint32_t m_context;                   //!< The context of the next expiration.
+  uint32_t m_uid;                       //!< The uid of the next expiration.
+};
+
+/**
+ * \ingroup simulator
+ * Get the id of the next expiration of a periodic series.
+ *
+ * \param [in] id The EventId of the series.
+ * \returns The EventId of the next expiration.
+ */
+EventId
+GetNextPeriodic (const EventId &id)
+{
+  return static_cast<PeriodicEventImpl *> (id.PeekEventImpl ())->GetNext ();
+}
+
+} // unnamed namespace
+
 void
 Simulator::Destroy (void)
 {
@@ -204,6 +286,10 @@ Time
 Simulator::GetDelayLeft (const EventId &id)
 {
   NS_LOG_FUNCTION (&id);
+  if (id.GetUid () == EventId::PERIODIC)
+    {
+      return GetImpl ()->GetDelayLeft (GetNextPeriodic (id));
+    }
   return GetImpl ()->GetDelayLeft (id);
 }
 
@@ -254,6 +340,49 @@ Simulator::DoScheduleDestroy (EventImpl *impl)
 }
 
 
+std::vector<EventId>
+Simulator::ScheduleBatch (const std::vector<std::pair<Time, Ptr<EventImpl> > > &events)
+{
+  std::vector<std::pair<Time, EventImpl *> > impls;
+  impls.reserve (events.size ());
+  for (std::vector<std::pair<Time, Ptr<EventImpl> > >::const_iterator i = events.begin ();
+       i != events.end (); ++i)
+    {
+      impls.push_back (std::make_pair (i->first, GetPointer (i->second)));
+    }
+  return DoScheduleBatch (impls);
+}
+
+EventId
+Simulator::SchedulePeriodic (const Time &period, const Ptr<EventImpl> &event)
+{
+  return DoSchedulePeriodic (period, GetPointer (event));
+}
+
+std::vector<EventId>
+Simulator::DoScheduleBatch (const std::vector<std::pair<Time, EventImpl *> > &events)
+{
+#ifdef ENABLE_DES_METRICS
+  for (std::vector<std::pair<Time, EventImpl *> >::const_iterator i = events.begin ();
+       i != events.end (); ++i)
+    {
+      DesMetrics::Get ()->Trace (Now (), i->first);
+    }
+#endif
+  return GetImpl ()->ScheduleBatch (events);
+}
+
+EventId
+Simulator::DoSchedulePeriodic (const Time &period, EventImpl *event)
+{
+  NS_ASSERT_MSG (period.IsStrictlyPositive (),
+                 "Simulator::SchedulePeriodic(): the period must be strictly positive");
+  Ptr<PeriodicEventImpl> periodic = Create<PeriodicEventImpl> (period, event);
+  periodic->ScheduleNext ();
+  EventId next = periodic->GetNext ();
+  return EventId (periodic, next.GetTs (), next.GetContext (), EventId::PERIODIC);
+}
+
 void
 Simulator::Remove (const EventId &id)
 {
@@ -261,6 +390,10 @@ Simulator::Remove (const EventId &id)
     {
       return;
     }
+  if (id.GetUid () == EventId::PERIODIC)
+    {
+      return GetImpl ()->Remove (GetNextPeriodic (id));
+    }
   return GetImpl ()->Remove (id);
 }
 
@@ -271,6 +404,10 @@ Simulator::Cancel (const EventId &id)
     {
       return;
     }
+  if (id.GetUid () == EventId::PERIODIC)
+    {
+      return GetImpl ()->Cancel (GetNextPeriodic (id));
+    }
   return GetImpl ()->Cancel (id);
 }
 
@@ -281,6 +418,10 @@ Simulator::IsExpired (const EventId &id)
     {
       return true;
     }
+  if (id.GetUid () == EventId::PERIODIC)
+    {
+      return GetImpl ()->IsExpired (GetNextPeriodic (id));
+    }
   return GetImpl ()->IsExpired (id);
 }
 
@@ -30,6 +30,8 @@
 
 #include <stdint.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 /**
  * @file
@@ -376,6 +378,86 @@ public:
 
   /** @} */  // Schedule events to run when Simulator:Destroy() is called.
 
+  /**
+   * @name Schedule batches of events and periodic events.
+   *
+   * A batch is handed to the scheduler in one call, which lets it
+   * build its structure in bulk (see Scheduler::InsertBatch) instead
+   * of paying the full insertion cost for each event.
+   * A periodic event reuses the same EventImpl for every period.
+   */
+  /** @{ */
+  /**
+   * Schedule the same event to expire after each of the @p delays,
+   * in the current context.
+   *
+   * @tparam FUNC @deduced Template type for the function to invoke.
+   * @tparam Ts @deduced Argument types.
+   * @param [in] delays The relative expiration times of the events.
+   * @param [in] f The function to invoke.
+   * @param [in] args Arguments to pass to MakeEvent.
+   * @returns The ids of the scheduled events, in the order of @p delays.
+   */
+  template <typename FUNC,
+            typename std::enable_if<!std::is_convertible<FUNC, Ptr<EventImpl>>::value,int>::type = 0,
+            typename std::enable_if<!std::is_function<typename std::remove_pointer<FUNC>::type>::value,int>::type = 0,
+            typename... Ts>
+  static std::vector<EventId> ScheduleBatch (const std::vector<Time> &delays, FUNC f, Ts&&... args);
+
+  /**
+   * Schedule the same event to expire after each of the @p delays,
+   * in the current context.
+   *
+   * @tparam Us @deduced Formal function argument types.
+   * @tparam Ts @deduced Actual function argument types.
+   * @param [in] delays The relative expiration times of the events.
+   * @param [in] f The function to invoke.
+   * @param [in] args Arguments to pass to the invoked function.
+   * @returns The ids of the scheduled events, in the order of @p delays.
+   */
+  template <typename... Us, typename... Ts>
+  static std::vector<EventId> ScheduleBatch (const std::vector<Time> &delays, void (*f)(Us...), Ts&&... args);
+
+  /**
+   * Schedule an event to expire every @p period, in the current
+   * context, starting one @p period from now.
+   *
+   * The returned EventId identifies the whole series: Cancel() or
+   * Remove() stop it, IsExpired() is \c true once it is stopped, and
+   * GetDelayLeft() gives the delay to the next expiration.  They can
+   * also be called from the periodic handler itself.
+   *
+   * @tparam FUNC @deduced Template type for the function to invoke.
+   * @tparam Ts @deduced Argument types.
+   * @param [in] period The period, which must be strictly positive.
+   * @param [in] f The function to invoke.
+   * @param [in] args Arguments to pass to MakeEvent.
+   * @returns The id of the series.
+   */
+  template <typename FUNC,
+            typename std::enable_if<!std::is_convertible<FUNC, Ptr<EventImpl>>::value,int>::type = 0,
+            typename std::enable_if<!std::is_function<typename std::remove_pointer<FUNC>::type>::value,int>::type = 0,
+            typename... Ts>
+  static EventId SchedulePeriodic (Time const &period, FUNC f, Ts&&... args);
+
+  /**
+   * Schedule an event to expire every @p period, in the current
+   * context, starting one @p period from now.
+   *
+   * The returned EventId identifies the whole series, as for the
+   * other SchedulePeriodic overload.
+   *
+   * @tparam Us @deduced Formal function argument types.
+   * @tparam Ts @deduced Actual function argument types.
+   * @param [in] period The period, which must be strictly positive.
+   * @param [in] f The function to invoke.
+   * @param [in] args Arguments to pass to the invoked function.
+   * @returns The id of the series.
+   */
+  template <typename... Us, typename... Ts>
+  static EventId SchedulePeriodic (Time const &period, void (*f)(Us...), Ts&&... args);
+  /** @} */  // Schedule batches of events and periodic events.
+
   /**
    * Remove an event from the event list.
    *
@@ -485,6 +567,24 @@ public:
    */
   static EventId ScheduleNow (const Ptr<EventImpl> &event);
 
+  /**
+   * Schedule a batch of future event executions (in the same context).
+   *
+   * @param [in] events The events to schedule, with their delays.
+   * @returns The unique identifiers of the newly-scheduled events,
+   *          in the order of @p events.
+   */
+  static std::vector<EventId> ScheduleBatch (const std::vector<std::pair<Time, Ptr<EventImpl> > > &events);
+
+  /**
+   * Schedule an event to expire every @p period (in the same context).
+   *
+   * @param [in] period The period, which must be strictly positive.
+   * @param [in] event The event to invoke at every period.
+   * @returns The id of the series.
+   */
+  static EventId SchedulePeriodic (const Time &period, const Ptr<EventImpl> &event);
+
   /**
    * Get the system id of this simulator.
    *
@@ -519,6 +619,19 @@ private:
    * @return The EventId.
    */
   static EventId DoScheduleDestroy (EventImpl *event);
+  /**
+   * Implementation of the various ScheduleBatch methods.
+   * @param [in] events The events to execute, with their delays.
+   * @return The EventIds.
+   */
+  static std::vector<EventId> DoScheduleBatch (const std::vector<std::pair<Time, EventImpl *> > &events);
+  /**
+   * Implementation of the various SchedulePeriodic methods.
+   * @param [in] period The period of the event.
+   * @param [in] event The event to execute.
+   * @return The EventId of the series.
+   */
+  static EventId DoSchedulePeriodic (const Time &period, EventImpl *event);
 
 };  // class Simulator
 
@@ -615,6 +728,52 @@ Simulator::ScheduleDestroy (void (*f)(Us...), Ts&&... args)
   return DoScheduleDestroy (MakeEvent (f, std::forward<Ts> (args)...));
 }
 
+template <typename FUNC,
+          typename std::enable_if<!std::is_convertible<FUNC, Ptr<EventImpl>>::value,int>::type,
+          typename std::enable_if<!std::is_function<typename std::remove_pointer<FUNC>::type>::value,int>::type,
+          typename... Ts>
+std::vector<EventId>
+Simulator::ScheduleBatch (const std::vector<Time> &delays, FUNC f, Ts&&... args)
+{
+  std::vector<std::pair<Time, EventImpl *> > events;
+  events.reserve (delays.size ());
+  for (std::vector<Time>::const_iterator i = delays.begin (); i != delays.end (); ++i)
+    {
+      events.push_back (std::make_pair (*i, MakeEvent (f, args...)));
+    }
+  return DoScheduleBatch (events);
+}
+
+template <typename... Us, typename... Ts>
+std::vector<EventId>
+Simulator::ScheduleBatch (const std::vector<Time> &delays, void (*f)(Us...), Ts&&... args)
+{
+  std::vector<std::pair<Time, EventImpl *> > events;
+  events.reserve (delays.size ());
+  for (std::vector<Time>::const_iterator i = delays.begin (); i != delays.end (); ++i)
+    {
+      events.push_back (std::make_pair (*i, MakeEvent (f, args...)));
+    }
+  return DoScheduleBatch (events);
+}
+
+template <typename FUNC,
+          typename std::enable_if<!std::is_convertible<FUNC, Ptr<EventImpl>>::value,int>::type,
+          typename std::enable_if<!std::is_function<typename std::remove_pointer<FUNC>::type>::value,int>::type,
+          typename... Ts>
+EventId
+Simulator::SchedulePeriodic (Time const &period, FUNC f, Ts&&... args)
+{
+  return DoSchedulePeriodic (period, MakeEvent (f, std::forward<Ts> (args)...));
+}
+
+template <typename... Us, typename... Ts>
+EventId
+Simulator::SchedulePeriodic (Time const &period, void (*f)(Us...), Ts&&... args)
+{
+  return DoSchedulePeriodic (period, MakeEvent (f, std::forward<Ts> (args)...));
+}
+
 } // namespace ns3
 
 #endif /* SIMULATOR_H */
@@ -42,6 +42,11 @@ NS_LOG_COMPONENT_DEFINE_MASK ("Time", ns3::LOG_PREFIX_TIME);
 // static
 Time::MarkedTimes * Time::g_markingTimes = 0;
 
+// static
+const int64_t Time::FAST_INTEGER_MAX;
+constexpr double Time::FAST_DOUBLE_MAX;
+constexpr double Time::FAST_DOUBLE_MIN;
+
 /**
  * \internal
  * Get mutex for critical sections around modification of Time::g_markingTimes
@@ -223,6 +228,12 @@ Time::SetResolution (enum Unit unit, struct Resolution *resolution,
       NS_LOG_DEBUG ("SetResolution factor " << factor << " real factor " << realFactor);
       struct Information *info = &resolution->info[i];
       info->factor = factor;
+      info->dFactor = 0;
+      if (static_cast<int64_t> (static_cast<double> (factor)) == factor
+          && factor < Time::FAST_INTEGER_MAX)
+        {
+          info->dFactor = static_cast<double> (factor);
+        }
       // here we could equivalently check for realFactor == 1.0 but it's better
       // to avoid checking equality of doubles
       if (shift == 0 && quotient == 1)
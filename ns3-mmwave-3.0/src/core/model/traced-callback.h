@@ -21,8 +21,9 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
 #include "callback.h"
+#include "likely.h"
 
 /**
  * \file
@@ -46,6 +47,11 @@ namespace ns3 {
  * calling the \c operator() form with the appropriate
  * number of arguments.
  *
+ * Most trace sources have no Callback connected, or a single one,
+ * so the first Callback of the chain is stored inline, and the
+ * others in a vector: invoking a trace source without Callbacks
+ * costs a single test.
+ *
  * \tparam Ts \explicit Types of the functor arguments.
  */
 template<typename... Ts>
@@ -89,6 +95,15 @@ public:
    * \param [in] args The arguments to the functor
    */
   void operator() (Ts... args) const;
+  /**
+   * Check if no Callback is connected.
+   *
+   * Trace sources with expensive arguments can skip
+   * preparing them when this is \c true.
+   *
+   * \returns \c true if the chain of Callbacks is empty.
+   */
+  bool IsEmpty (void) const;
 
   /**
    *  TracedCallback signature for POD.
@@ -103,12 +118,22 @@ public:
 
 private:
   /**
-   * Container type for holding the chain of Callbacks.
+   * Append a Callback to the chain.
+   *
+   * \param [in] callback Callback to add to chain.
+   */
+  void Append (const Callback<void,Ts...> & callback);
+
+  /**
+   * Container type for holding the chain of Callbacks
+   * after the first one.
    *
    * \tparam Ts \deduced Types of the functor arguments.
    */
-  typedef std::list<Callback<void,Ts...> > CallbackList;
-  /** The chain of Callbacks. */
+  typedef std::vector<Callback<void,Ts...> > CallbackList;
+  /** The first Callback of the chain, null if the chain is empty. */
+  Callback<void,Ts...> m_first;
+  /** The rest of the chain of Callbacks. */
   CallbackList m_callbackList;
 };
 
@@ -123,7 +148,8 @@ namespace ns3 {
 
 template<typename... Ts>
 TracedCallback<Ts...>::TracedCallback ()
-  : m_callbackList ()
+  : m_first (),
+    m_callbackList ()
 {}
 template<typename... Ts>
 void
@@ -134,7 +160,7 @@ TracedCallback<Ts...>::ConnectWithoutContext (const CallbackBase & callback)
     {
       NS_FATAL_ERROR_NO_MSG ();
     }
-  m_callbackList.push_back (cb);
+  Append (cb);
 }
 template<typename... Ts>
 void
@@ -146,7 +172,20 @@ TracedCallback<Ts...>::Connect (const CallbackBase & callback, std::string path)
       NS_FATAL_ERROR ("when connecting to " << path);
     }
   Callback<void,Ts...> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  Append (realCb);
+}
+template<typename... Ts>
+void
+TracedCallback<Ts...>::Append (const Callback<void,Ts...> & callback)
+{
+  if (m_first.IsNull ())
+    {
+      m_first = callback;
+    }
+  else
+    {
+      m_callbackList.push_back (callback);
+    }
 }
 template<typename... Ts>
 void
@@ -164,6 +203,18 @@ TracedCallback<Ts...>::DisconnectWithoutContext (const CallbackBase & callback)
           i++;
         }
     }
+  if (!m_first.IsNull () && m_first.IsEqual (callback))
+    {
+      if (m_callbackList.empty ())
+        {
+          m_first = Callback<void,Ts...> ();
+        }
+      else
+        {
+          m_first = m_callbackList.front ();
+          m_callbackList.erase (m_callbackList.begin ());
+        }
+    }
 }
 template<typename... Ts>
 void
@@ -181,12 +232,23 @@ template<typename... Ts>
 void
 TracedCallback<Ts...>::operator() (Ts... args) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (NS_LIKELY (m_first.IsNull ()))
+    {
+      return;
+    }
+  m_first (args...);
+  // By index, as a Callback may connect another one to this chain
+  for (std::size_t i = 0; i < m_callbackList.size (); ++i)
     {
-      (*i)(args...);
+      m_callbackList[i] (args...);
     }
 }
+template<typename... Ts>
+bool
+TracedCallback<Ts...>::IsEmpty (void) const
+{
+  return m_first.IsNull ();
+}
 
 } // namespace ns3
 
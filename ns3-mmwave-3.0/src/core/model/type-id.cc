@@ -23,7 +23,8 @@
 #include "singleton.h"
 #include "trace-source-accessor.h"
 
-#include <map>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <sstream>
 #include <iomanip>
@@ -78,6 +79,8 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
 class IidManager : public Singleton<IidManager>
 {
 public:
+  /** Constructor. */
+  IidManager ();
   /**
    * Create a new unique type id.
    * \param [in] name The name of this type id.
@@ -264,6 +267,22 @@ public:
    * \returns Detailed information about the requested trace source.
    */
   struct TypeId::TraceSourceInformation GetTraceSource (uint16_t uid, std::size_t i) const;
+  /**
+   * Find an Attribute of a type id or of its parents, by name.
+   * \param [in] uid The id.
+   * \param [in] name The Attribute name.
+   * \returns The Attribute declared by the most derived type,
+   *          or null if there is none.
+   */
+  const struct TypeId::AttributeInformation * FindAttribute (uint16_t uid, const std::string &name);
+  /**
+   * Find a TraceSource of a type id or of its parents, by name.
+   * \param [in] uid The id.
+   * \param [in] name The TraceSource name.
+   * \returns The TraceSource declared by the most derived type,
+   *          or null if there is none.
+   */
+  const struct TypeId::TraceSourceInformation * FindTraceSource (uint16_t uid, const std::string &name);
   /**
    * Check if this TypeId should not be listed in documentation.
    * \param [in] uid The id.
@@ -293,6 +312,12 @@ private:
    */
   static TypeId::hash_t Hasher (const std::string name);
 
+  /**
+   * Type of the flattened name indexes: the id of the type declaring
+   * a name, and the index of the name in this type.
+   */
+  typedef std::unordered_map<std::string, std::pair<uint16_t, std::size_t> > nameindex_t;
+
   /** The information record about a single type id. */
   struct IidInformation
   {
@@ -320,6 +345,12 @@ private:
     TypeId::SupportLevel supportLevel;
     /** Support message. */
     std::string supportMsg;
+    /** The Attributes of this type and its parents, by name. */
+    nameindex_t attributeIndex;
+    /** The TraceSources of this type and its parents, by name. */
+    nameindex_t traceSourceIndex;
+    /** The value of m_generation when the indexes were built, 0 if never. */
+    uint32_t indexGeneration;
   };
   /** Iterator type. */
   typedef std::vector<struct IidInformation>::const_iterator Iterator;
@@ -330,20 +361,32 @@ private:
    * \returns The information record.
    */
   struct IidManager::IidInformation * LookupInformation (uint16_t uid) const;
+  /**
+   * Get a type id record with its name indexes up to date.
+   * \param [in] uid The id.
+   * \returns The information record.
+   */
+  struct IidManager::IidInformation * LookupIndexedInformation (uint16_t uid);
 
   /** The container of all type id records. */
   std::vector<struct IidInformation> m_information;
 
   /** Type of the by-name index. */
-  typedef std::map<std::string, uint16_t> namemap_t;
+  typedef std::unordered_map<std::string, uint16_t> namemap_t;
   /** The by-name index. */
   namemap_t m_namemap;
 
   /** Type of the by-hash index. */
-  typedef std::map<TypeId::hash_t, uint16_t> hashmap_t;
+  typedef std::unordered_map<TypeId::hash_t, uint16_t> hashmap_t;
   /** The by-hash index. */
   hashmap_t m_hashmap;
 
+  /**
+   * Incremented by every change to a type id which could change the
+   * name indexes, to rebuild them lazily.
+   */
+  uint32_t m_generation;
+
 
   /** IidManager constants. */
   enum
@@ -380,6 +423,12 @@ IidManager::Hasher (const std::string name)
  */
 #define IIDL IID << ": "
 
+IidManager::IidManager ()
+  : m_generation (1)
+{
+  NS_LOG_FUNCTION (IID);
+}
+
 uint16_t
 IidManager::AllocateUid (std::string name)
 {
@@ -443,6 +492,7 @@ IidManager::AllocateUid (std::string name)
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
   information.supportLevel = TypeId::SUPPORTED;
+  information.indexGeneration = 0;
   m_information.push_back (information);
   std::size_t tuid = m_information.size ();
   NS_ASSERT (tuid <= 0xffff);
@@ -471,6 +521,7 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  m_generation++;
 }
 void
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -681,6 +732,7 @@ IidManager::AddAttribute (uint16_t uid,
   info.supportLevel = supportLevel;
   info.supportMsg = supportMsg;
   information->attributes.push_back (info);
+  m_generation++;
   NS_LOG_LOGIC (IIDL << information->attributes.size () - 1);
 }
 void
@@ -773,8 +825,73 @@ IidManager::AddTraceSource (uint16_t uid,
   source.supportLevel = supportLevel;
   source.supportMsg = supportMsg;
   information->traceSources.push_back (source);
+  m_generation++;
   NS_LOG_LOGIC (IIDL << information->traceSources.size () - 1);
 }
+
+struct IidManager::IidInformation *
+IidManager::LookupIndexedInformation (uint16_t uid)
+{
+  NS_LOG_FUNCTION (IID << uid);
+  struct IidInformation *information = LookupInformation (uid);
+  if (information->indexGeneration == m_generation)
+    {
+      return information;
+    }
+  // Walk up from the type itself, so that a name declared again by a
+  // derived type hides the name of the parent, as in a linear search.
+  information->attributeIndex.clear ();
+  information->traceSourceIndex.clear ();
+  uint16_t current = uid;
+  while (true)
+    {
+      struct IidInformation *tinfo = LookupInformation (current);
+      for (std::size_t i = 0; i < tinfo->attributes.size (); ++i)
+        {
+          information->attributeIndex.insert (std::make_pair (tinfo->attributes[i].name,
+                                                              std::make_pair (current, i)));
+        }
+      for (std::size_t i = 0; i < tinfo->traceSources.size (); ++i)
+        {
+          information->traceSourceIndex.insert (std::make_pair (tinfo->traceSources[i].name,
+                                                                std::make_pair (current, i)));
+        }
+      if (tinfo->parent == current || tinfo->parent == 0)
+        {
+          // top of inheritance tree
+          break;
+        }
+      current = tinfo->parent;
+    }
+  information->indexGeneration = m_generation;
+  return information;
+}
+
+const struct TypeId::AttributeInformation *
+IidManager::FindAttribute (uint16_t uid, const std::string &name)
+{
+  NS_LOG_FUNCTION (IID << uid << name);
+  struct IidInformation *information = LookupIndexedInformation (uid);
+  nameindex_t::const_iterator it = information->attributeIndex.find (name);
+  if (it == information->attributeIndex.end ())
+    {
+      return 0;
+    }
+  return &LookupInformation (it->second.first)->attributes[it->second.second];
+}
+
+const struct TypeId::TraceSourceInformation *
+IidManager::FindTraceSource (uint16_t uid, const std::string &name)
+{
+  NS_LOG_FUNCTION (IID << uid << name);
+  struct IidInformation *information = LookupIndexedInformation (uid);
+  nameindex_t::const_iterator it = information->traceSourceIndex.find (name);
+  if (it == information->traceSourceIndex.end ())
+    {
+      return 0;
+    }
+  return &LookupInformation (it->second.first)->traceSources[it->second.second];
+}
 std::size_t
 IidManager::GetTraceSourceN (uint16_t uid) const
 {
@@ -883,40 +1000,25 @@ bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
   NS_LOG_FUNCTION (this << name << info);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do
+  const struct TypeId::AttributeInformation *tmp =
+    IidManager::Get ()->FindAttribute (m_tid, name);
+  if (tmp == 0)
     {
-      tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
-        {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute (i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "Attribute '" << name << "' is deprecated: "
-                            << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("Attribute '" << name <<
-                                  "' is obsolete, with no fallback: " <<
-                                  tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
+      return false;
     }
-  while (nextTid != tid);
-  return false;
+  if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "Attribute '" << name << "' is deprecated: "
+                << tmp->supportMsg << std::endl;
+    }
+  else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("Attribute '" << name <<
+                      "' is obsolete, with no fallback: " <<
+                      tmp->supportMsg);
+    }
+  *info = *tmp;
+  return true;
 }
 
 TypeId
@@ -1137,41 +1239,25 @@ TypeId::LookupTraceSourceByName (std::string name,
                                  struct TraceSourceInformation *info) const
 {
   NS_LOG_FUNCTION (this << name);
-  TypeId tid;
-  TypeId nextTid = *this;
-  struct TypeId::TraceSourceInformation tmp;
-  do
+  const struct TypeId::TraceSourceInformation *tmp =
+    IidManager::Get ()->FindTraceSource (m_tid, name);
+  if (tmp == 0)
     {
-      tid = nextTid;
-      for (std::size_t i = 0; i < tid.GetTraceSourceN (); i++)
-        {
-          tmp = tid.GetTraceSource (i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                  return tmp.accessor;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "TraceSource '" << name << "' is deprecated: "
-                            << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return tmp.accessor;
-                }
-              else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("TraceSource '" << name <<
-                                  "' is obsolete, with no fallback: " <<
-                                  tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
+      return 0;
+    }
+  if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "TraceSource '" << name << "' is deprecated: "
+                << tmp->supportMsg << std::endl;
+    }
+  else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("TraceSource '" << name <<
+                      "' is obsolete, with no fallback: " <<
+                      tmp->supportMsg);
     }
-  while (nextTid != tid);
-  return 0;
+  *info = *tmp;
+  return tmp->accessor;
 }
 
 Ptr<const TraceSourceAccessor>
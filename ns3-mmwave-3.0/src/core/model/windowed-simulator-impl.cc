@@ -0,0 +1,800 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator.h"
+#include "windowed-simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+
+#include "ptr.h"
+#include "pointer.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::WindowedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("WindowedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (WindowedSimulatorImpl);
+
+namespace {
+
+/**
+ * \ingroup simulator
+ * Order the events of a window by context, keeping the key order
+ * of the events within each context.
+ *
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if \pname{a} belongs to a smaller context.
+ */
+bool
+CompareContext (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return a.key.m_context < b.key.m_context;
+}
+
+} // unnamed namespace
+
+thread_local WindowedSimulatorImpl::ThreadState *
+WindowedSimulatorImpl::g_threadState = 0;
+
+TypeId
+WindowedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WindowedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<WindowedSimulatorImpl> ()
+    .AddAttribute ("Threads",
+                   "The number of threads executing a window, "
+                   "including the main thread.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&WindowedSimulatorImpl::m_nThreads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MinWindowSize",
+                   "The minimum number of events in a window for it to be "
+                   "executed concurrently; smaller windows are executed "
+                   "on the main thread.",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&WindowedSimulatorImpl::m_minWindowSize),
+                   MakeUintegerChecker<uint32_t> (2))
+  ;
+  return tid;
+}
+
+WindowedSimulatorImpl::WindowedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = false;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  // uid 3 is "periodic" series, see Simulator::SchedulePeriodic
+  m_uid = 4;
+  // before ::Run is entered, the m_currentUid will be zero
+  m_currentUid = 0;
+  m_currentTs = 0;
+  m_currentContext = Simulator::NO_CONTEXT;
+  m_unscheduledEvents = 0;
+  m_eventCount = 0;
+  m_eventsWithContextEmpty = true;
+  m_nextGroup = 0;
+  m_dependentWindow = false;
+  m_inWindow = false;
+  m_nThreads = 1;
+  m_minWindowSize = 2;
+  m_generation = 0;
+  m_busyWorkers = 0;
+  m_shutdown = false;
+  m_windowCount = 0;
+  m_parallelWindowCount = 0;
+  m_dependencyCount = 0;
+  m_main = SystemThread::Self ();
+}
+
+WindowedSimulatorImpl::~WindowedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+WindowedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  StopWorkers ();
+  ProcessEventsWithContext ();
+
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.impl->Unref ();
+    }
+  m_events = 0;
+  SimulatorImpl::DoDispose ();
+}
+
+void
+WindowedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+WindowedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+WindowedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+void
+WindowedSimulatorImpl::StartWorkers (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_states.size () == m_nThreads)
+    {
+      return;
+    }
+  StopWorkers ();
+  m_states.resize (m_nThreads);
+  m_shutdown = false;
+  // The new workers wait for the generation after 0
+  m_generation = 0;
+  for (uint32_t i = 1; i < m_nThreads; ++i)
+    {
+      Ptr<SystemThread> thread =
+        Create<SystemThread> (MakeBoundCallback (&WindowedSimulatorImpl::WorkerThread,
+                                                 std::make_pair (this, i)));
+      thread->Start ();
+      m_workers.push_back (thread);
+    }
+}
+
+void
+WindowedSimulatorImpl::StopWorkers (void)
+{
+  NS_LOG_FUNCTION (this);
+  {
+    std::lock_guard<std::mutex> lock (m_workerMutex);
+    m_shutdown = true;
+  }
+  m_windowReady.notify_all ();
+  for (std::vector<Ptr<SystemThread> >::iterator i = m_workers.begin ();
+       i != m_workers.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  m_workers.clear ();
+  m_states.clear ();
+}
+
+void
+WindowedSimulatorImpl::WorkerThread (std::pair<WindowedSimulatorImpl *, uint32_t> worker)
+{
+  worker.first->WorkerLoop (worker.second);
+}
+
+void
+WindowedSimulatorImpl::WorkerLoop (uint32_t index)
+{
+  ThreadState *state = &m_states[index];
+  // Everything a worker schedules is part of a parallel window.
+  g_threadState = state;
+  uint64_t generation = 0;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_workerMutex);
+        while (!m_shutdown && m_generation == generation)
+          {
+            m_windowReady.wait (lock);
+          }
+        if (m_shutdown)
+          {
+            break;
+          }
+        generation = m_generation;
+      }
+      ProcessGroups (state);
+      {
+        std::lock_guard<std::mutex> lock (m_workerMutex);
+        NS_ASSERT_MSG (m_busyWorkers > 0, "Worker " << index << " ran without a window");
+        if (--m_busyWorkers == 0)
+          {
+            m_windowDone.notify_one ();
+          }
+      }
+    }
+  g_threadState = 0;
+}
+
+bool
+WindowedSimulatorImpl::IsParallelWindow (void)
+{
+  if (m_nThreads <= 1 || m_window.size () < m_minWindowSize)
+    {
+      return false;
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = m_window.begin ();
+       i != m_window.end (); ++i)
+    {
+      if (i->key.m_context == Simulator::NO_CONTEXT)
+        {
+          // Global events may touch any context.
+          return false;
+        }
+    }
+  std::stable_sort (m_window.begin (), m_window.end (), &CompareContext);
+  m_groups.clear ();
+  std::size_t start = 0;
+  for (std::size_t i = 1; i <= m_window.size (); ++i)
+    {
+      if (i == m_window.size ()
+          || m_window[i].key.m_context != m_window[start].key.m_context)
+        {
+          m_groups.push_back (std::make_pair (start, i));
+          start = i;
+        }
+    }
+  // A single context keeps the key order after the stable sort.
+  return m_groups.size () > 1;
+}
+
+void
+WindowedSimulatorImpl::ProcessOneWindow (void)
+{
+  uint64_t ts = m_events->PeekNext ().key.m_ts;
+  NS_ASSERT (ts >= m_currentTs);
+  bool dependent = m_dependentWindow && ts == m_currentTs;
+  m_dependentWindow = false;
+
+  NS_LOG_LOGIC ("window " << ts);
+  m_currentTs = ts;
+  m_window.clear ();
+  while (!m_events->IsEmpty () && m_events->PeekNext ().key.m_ts == ts)
+    {
+      m_window.push_back (m_events->RemoveNext ());
+    }
+  m_windowCount++;
+  m_inWindow = true;
+
+  if (!dependent && IsParallelWindow ())
+    {
+      ProcessWindowInParallel ();
+    }
+  else
+    {
+      ProcessWindowSerially ();
+    }
+
+  m_inWindow = false;
+  ReinsertWindow ();
+  ProcessEventsWithContext ();
+}
+
+void
+WindowedSimulatorImpl::ProcessWindowSerially (void)
+{
+  // Events scheduled meanwhile at the current time get a larger uid
+  // than any event of the window, so the key order is preserved.
+  for (std::vector<Scheduler::Event>::iterator i = m_window.begin ();
+       i != m_window.end () && !m_stop; ++i)
+    {
+      m_unscheduledEvents--;
+      m_eventCount++;
+      m_currentContext = i->key.m_context;
+      m_currentUid = i->key.m_uid;
+      i->impl->Invoke ();
+      i->impl->Unref ();
+      i->impl = 0;
+
+      ProcessEventsWithContext ();
+    }
+}
+
+void
+WindowedSimulatorImpl::ProcessWindowInParallel (void)
+{
+  m_nextGroup = 0;
+  {
+    std::lock_guard<std::mutex> lock (m_workerMutex);
+    m_generation++;
+    m_busyWorkers = m_workers.size ();
+  }
+  m_windowReady.notify_all ();
+
+  ThreadState *state = &m_states[0];
+  g_threadState = state;
+  ProcessGroups (state);
+  g_threadState = 0;
+
+  {
+    std::unique_lock<std::mutex> lock (m_workerMutex);
+    while (m_busyWorkers != 0)
+      {
+        m_windowDone.wait (lock);
+      }
+  }
+
+  // Merge in thread order; the uids already give the key order.
+  for (std::vector<ThreadState>::iterator i = m_states.begin ();
+       i != m_states.end (); ++i)
+    {
+      MergeThreadState (&(*i));
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = m_window.begin ();
+       i != m_window.end (); ++i)
+    {
+      if (i->impl == 0 && i->key.m_uid > m_currentUid)
+        {
+          m_currentUid = i->key.m_uid;
+          m_currentContext = i->key.m_context;
+        }
+    }
+  m_parallelWindowCount++;
+}
+
+void
+WindowedSimulatorImpl::ProcessGroups (ThreadState *state)
+{
+  while (true)
+    {
+      std::size_t group = m_nextGroup++;
+      if (group >= m_groups.size ())
+        {
+          return;
+        }
+      for (std::size_t i = m_groups[group].first;
+           i < m_groups[group].second && !m_stop; ++i)
+        {
+          Scheduler::Event &next = m_window[i];
+          state->context = next.key.m_context;
+          state->uid = next.key.m_uid;
+          state->eventCount++;
+          next.impl->Invoke ();
+          next.impl->Unref ();
+          next.impl = 0;
+        }
+    }
+}
+
+void
+WindowedSimulatorImpl::MergeThreadState (ThreadState *state)
+{
+  for (std::vector<Scheduler::Event>::const_iterator i = state->scheduled.begin ();
+       i != state->scheduled.end (); ++i)
+    {
+      m_unscheduledEvents++;
+      m_events->Insert (*i);
+    }
+  m_destroyEvents.insert (m_destroyEvents.end (),
+                          state->destroy.begin (), state->destroy.end ());
+  m_dependentWindow = m_dependentWindow || state->dependent;
+  m_unscheduledEvents -= state->eventCount;
+  m_eventCount += state->eventCount;
+
+  state->scheduled.clear ();
+  state->destroy.clear ();
+  state->eventCount = 0;
+  state->dependent = false;
+}
+
+void
+WindowedSimulatorImpl::ReinsertWindow (void)
+{
+  for (std::vector<Scheduler::Event>::const_iterator i = m_window.begin ();
+       i != m_window.end (); ++i)
+    {
+      if (i->impl != 0)
+        {
+          m_events->Insert (*i);
+        }
+    }
+  m_window.clear ();
+}
+
+bool
+WindowedSimulatorImpl::IsFinished (void) const
+{
+  return m_events->IsEmpty () || m_stop;
+}
+
+uint32_t
+WindowedSimulatorImpl::AllocateUid (void)
+{
+  if (g_threadState != 0)
+    {
+      return m_uid++;
+    }
+  // Only the main thread allocates uids outside of parallel windows.
+  uint32_t uid = m_uid.load (std::memory_order_relaxed);
+  m_uid.store (uid + 1, std::memory_order_relaxed);
+  return uid;
+}
+
+void
+WindowedSimulatorImpl::InsertEvent (const Scheduler::Event &ev)
+{
+  if (g_threadState != 0)
+    {
+      g_threadState->scheduled.push_back (ev);
+      return;
+    }
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+}
+
+void
+WindowedSimulatorImpl::ProcessEventsWithContext (void)
+{
+  if (m_eventsWithContextEmpty)
+    {
+      return;
+    }
+
+  // swap queues
+  EventsWithContext eventsWithContext;
+  {
+    CriticalSection cs (m_eventsWithContextMutex);
+    m_eventsWithContext.swap (eventsWithContext);
+    m_eventsWithContextEmpty = true;
+  }
+  while (!eventsWithContext.empty ())
+    {
+      EventWithContext event = eventsWithContext.front ();
+      eventsWithContext.pop_front ();
+      Scheduler::Event ev;
+      ev.impl = event.event;
+      ev.key.m_ts = m_currentTs + event.timestamp;
+      ev.key.m_context = event.context;
+      ev.key.m_uid = AllocateUid ();
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+}
+
+void
+WindowedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Set the current threadId as the main threadId
+  m_main = SystemThread::Self ();
+  ProcessEventsWithContext ();
+  StartWorkers ();
+  m_stop = false;
+
+  while (!m_events->IsEmpty () && !m_stop)
+    {
+      ProcessOneWindow ();
+    }
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
+}
+
+void
+WindowedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = true;
+}
+
+void
+WindowedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Simulator::Schedule (delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+WindowedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (g_threadState != 0 || SystemThread::Equals (m_main),
+                 "Simulator::Schedule Thread-unsafe invocation!");
+
+  NS_ASSERT_MSG (delay.IsPositive (), "WindowedSimulatorImpl::Schedule(): Negative delay");
+  Time tAbsolute = delay + TimeStep (m_currentTs);
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = GetContext ();
+  ev.key.m_uid = AllocateUid ();
+  InsertEvent (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+WindowedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+
+  if (g_threadState != 0 || SystemThread::Equals (m_main))
+    {
+      Time tAbsolute = delay + TimeStep (m_currentTs);
+      Scheduler::Event ev;
+      ev.impl = event;
+      ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+      ev.key.m_context = context;
+      ev.key.m_uid = AllocateUid ();
+      if (g_threadState != 0
+          && ev.key.m_ts == m_currentTs
+          && context != g_threadState->context)
+        {
+          // Another context must see this event at the current time.
+          g_threadState->dependent = true;
+          m_dependencyCount++;
+        }
+      InsertEvent (ev);
+    }
+  else
+    {
+      EventWithContext ev;
+      ev.context = context;
+      // Current time added in ProcessEventsWithContext()
+      ev.timestamp = delay.GetTimeStep ();
+      ev.event = event;
+      {
+        CriticalSection cs (m_eventsWithContextMutex);
+        m_eventsWithContext.push_back (ev);
+        m_eventsWithContextEmpty = false;
+      }
+    }
+}
+
+EventId
+WindowedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  NS_ASSERT_MSG (g_threadState != 0 || SystemThread::Equals (m_main),
+                 "Simulator::ScheduleNow Thread-unsafe invocation!");
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = m_currentTs;
+  ev.key.m_context = GetContext ();
+  ev.key.m_uid = AllocateUid ();
+  InsertEvent (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+EventId
+WindowedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  NS_ASSERT_MSG (g_threadState != 0 || SystemThread::Equals (m_main),
+                 "Simulator::ScheduleDestroy Thread-unsafe invocation!");
+
+  EventId id (Ptr<EventImpl> (event, false), m_currentTs, 0xffffffff, 2);
+  AllocateUid ();
+  if (g_threadState != 0)
+    {
+      g_threadState->destroy.push_back (id);
+    }
+  else
+    {
+      m_destroyEvents.push_back (id);
+    }
+  return id;
+}
+
+Time
+WindowedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (m_currentTs);
+}
+
+Time
+WindowedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - m_currentTs);
+    }
+}
+
+void
+WindowedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      if (g_threadState != 0)
+        {
+          // The destroy list is shared by all the workers.
+          Cancel (id);
+          return;
+        }
+      // destroy events.
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  if (g_threadState != 0
+      || (m_inWindow && id.GetTs () == m_currentTs))
+    {
+      // The event may already have been taken off the event list as
+      // part of the current window, or the event list may be in use by
+      // another thread: cancel it instead, it is dropped when reached.
+      id.PeekEventImpl ()->Cancel ();
+      return;
+    }
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  m_events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  m_unscheduledEvents--;
+}
+
+void
+WindowedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+WindowedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      if (g_threadState != 0)
+        {
+          for (std::vector<EventId>::const_iterator i = g_threadState->destroy.begin ();
+               i != g_threadState->destroy.end (); i++)
+            {
+              if (*i == id)
+                {
+                  return false;
+                }
+            }
+        }
+      return true;
+    }
+  uint32_t currentUid = g_threadState != 0 ? g_threadState->uid : m_currentUid;
+  if (id.PeekEventImpl () == 0
+      || id.GetTs () < m_currentTs
+      || (id.GetTs () == m_currentTs && id.GetUid () <= currentUid)
+      || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+WindowedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+WindowedSimulatorImpl::GetContext (void) const
+{
+  if (g_threadState != 0)
+    {
+      return g_threadState->context;
+    }
+  return m_currentContext;
+}
+
+uint64_t
+WindowedSimulatorImpl::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
+uint64_t
+WindowedSimulatorImpl::GetWindowCount (void) const
+{
+  return m_windowCount;
+}
+
+uint64_t
+WindowedSimulatorImpl::GetParallelWindowCount (void) const
+{
+  return m_parallelWindowCount;
+}
+
+uint64_t
+WindowedSimulatorImpl::GetDependencyCount (void) const
+{
+  return m_dependencyCount;
+}
+
+} // namespace ns3
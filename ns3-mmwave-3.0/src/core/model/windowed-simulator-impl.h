@@ -0,0 +1,300 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WINDOWED_SIMULATOR_IMPL_H
+#define WINDOWED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-thread.h"
+#include "system-mutex.h"
+
+#include "ptr.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::WindowedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * A single process simulator implementation which executes the events
+ * of different contexts concurrently, one time window at a time.
+ *
+ * Wireless channels provide essentially no lookahead, so the
+ * conservative distributed engines cannot split wireless nodes across
+ * processes.  This implementation instead exploits the events which
+ * are due at the same simulation time: a window is the set of events
+ * sharing the earliest pending timestamp (for example, all the slot
+ * indications of the mmWave PHYs of every cell).  The window is split
+ * by event context (usually the node id) and each context is processed
+ * by one worker thread, in the usual timestamp and uid order.
+ *
+ * Because every event in a window has the same timestamp, an event can
+ * only affect another context at the same or at a later time.  Events
+ * scheduled during a window are buffered per worker and merged into the
+ * event list once the window completes, so no rollback is ever needed:
+ *
+ * - events scheduled with a positive delay simply land in a later window;
+ * - events scheduled with a zero delay for a different context are
+ *   cross-context dependencies; they form a follow-up window at the same
+ *   timestamp, which is executed serially;
+ * - windows containing events without a context
+ *   (Simulator::NO_CONTEXT), windows with a single context and windows
+ *   smaller than the MinWindowSize attribute are executed serially as well.
+ *
+ * With the default of a single thread, the event order is the same as
+ * the one of the DefaultSimulatorImpl.
+ *
+ * \warning Event handlers of different contexts run concurrently and must
+ * not share mutable state.  In particular, Ptr reference counting and the
+ * Packet buffer pools are not thread safe; models must be audited before
+ * enabling more than one thread.  The ordering of simultaneous events
+ * scheduled by different contexts within the same window depends on
+ * thread timing, so runs with more than one thread are reproducible only
+ * up to that ordering.
+ */
+class WindowedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  WindowedSimulatorImpl ();
+  /** Destructor. */
+  ~WindowedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+  /**
+   * Get the number of windows executed so far.
+   * \returns The number of windows.
+   */
+  uint64_t GetWindowCount (void) const;
+  /**
+   * Get the number of windows which were executed concurrently.
+   * \returns The number of parallel windows.
+   */
+  uint64_t GetParallelWindowCount (void) const;
+  /**
+   * Get the number of events scheduled with a zero delay for a
+   * different context from within a parallel window.
+   * \returns The number of cross-context dependencies detected.
+   */
+  uint64_t GetDependencyCount (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** Per thread execution state during a parallel window. */
+  struct ThreadState
+  {
+    /** Execution context of the current event. */
+    uint32_t context;
+    /** Unique id of the current event. */
+    uint32_t uid;
+    /** Number of events executed. */
+    uint64_t eventCount;
+    /** Flag \c true if a cross-context dependency was detected. */
+    bool dependent;
+    /** Events scheduled during the window, merged when it completes. */
+    std::vector<Scheduler::Event> scheduled;
+    /** Destroy events scheduled during the window. */
+    std::vector<EventId> destroy;
+  };
+
+  /** Execute all the events at the earliest pending timestamp. */
+  void ProcessOneWindow (void);
+  /**
+   * Test if the current window can be executed concurrently.
+   * \returns \c true if the window should be split among the workers.
+   */
+  bool IsParallelWindow (void);
+  /** Execute the current window on the main thread, in key order. */
+  void ProcessWindowSerially (void);
+  /** Execute the current window on all the worker threads. */
+  void ProcessWindowInParallel (void);
+  /**
+   * Execute context groups of the current window until none is left.
+   * \param [in] state The state of the calling thread.
+   */
+  void ProcessGroups (ThreadState *state);
+  /**
+   * Merge the events scheduled by a thread during a parallel window.
+   * \param [in] state The state of the thread.
+   */
+  void MergeThreadState (ThreadState *state);
+  /** Reinsert the window events left over by Simulator::Stop. */
+  void ReinsertWindow (void);
+  /**
+   * Body of the worker threads.
+   * \param [in] index The worker index.
+   */
+  void WorkerLoop (uint32_t index);
+  /**
+   * Entry point of the worker threads.
+   * \param [in] worker The simulator and the worker index.
+   */
+  static void WorkerThread (std::pair<WindowedSimulatorImpl *, uint32_t> worker);
+  /** Start the worker threads, if needed. */
+  void StartWorkers (void);
+  /** Stop and join the worker threads. */
+  void StopWorkers (void);
+  /**
+   * Allocate a new event uid.
+   * \returns The uid.
+   */
+  uint32_t AllocateUid (void);
+  /**
+   * Insert a new event, either in the event list or, during a parallel
+   * window, in the buffer of the calling thread.
+   * \param [in] ev The event.
+   */
+  void InsertEvent (const Scheduler::Event &ev);
+  /** Move events from a different context into the main event queue. */
+  void ProcessEventsWithContext (void);
+
+  /** Wrap an event with its execution context. */
+  struct EventWithContext
+  {
+    /** The event context. */
+    uint32_t context;
+    /** Event timestamp. */
+    uint64_t timestamp;
+    /** The event implementation. */
+    EventImpl *event;
+  };
+  /** Container type for the events from a different context. */
+  typedef std::list<struct EventWithContext> EventsWithContext;
+  /** The container of events from a different context. */
+  EventsWithContext m_eventsWithContext;
+  /**
+   * Flag \c true if all events with context have been moved to the
+   * primary event queue.
+   */
+  bool m_eventsWithContextEmpty;
+  /** Mutex to control access to the list of events with context. */
+  SystemMutex m_eventsWithContextMutex;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Flag calling for the end of the simulation. */
+  std::atomic<bool> m_stop;
+  /** The event priority queue. */
+  Ptr<Scheduler> m_events;
+
+  /** Next event unique id. */
+  std::atomic<uint32_t> m_uid;
+  /** Unique id of the current event. */
+  uint32_t m_currentUid;
+  /** Timestamp of the current event. */
+  uint64_t m_currentTs;
+  /** Execution context of the current event. */
+  uint32_t m_currentContext;
+  /** The event count. */
+  uint64_t m_eventCount;
+  /**
+   * Number of events that have been inserted but not yet scheduled,
+   *  not counting the Destroy events; this is used for validation
+   */
+  int m_unscheduledEvents;
+
+  /** The events of the current window, sorted by context. */
+  std::vector<Scheduler::Event> m_window;
+  /** Half-open ranges of m_window holding the events of one context. */
+  std::vector<std::pair<std::size_t, std::size_t> > m_groups;
+  /** Index of the next group to be claimed by a thread. */
+  std::atomic<std::size_t> m_nextGroup;
+  /** Flag \c true if the next window holds cross-context events. */
+  bool m_dependentWindow;
+  /** Flag \c true while a window is being executed. */
+  bool m_inWindow;
+
+  /** Number of threads, including the main thread. */
+  uint32_t m_nThreads;
+  /** Minimum number of events for a window to run in parallel. */
+  uint32_t m_minWindowSize;
+  /** Per thread states; index 0 is the main thread. */
+  std::vector<ThreadState> m_states;
+  /** The worker threads. */
+  std::vector<Ptr<SystemThread> > m_workers;
+  /** Mutex protecting the worker synchronization below. */
+  std::mutex m_workerMutex;
+  /** Wakes up the workers when a window is ready. */
+  std::condition_variable m_windowReady;
+  /** Wakes up the main thread when the workers are done. */
+  std::condition_variable m_windowDone;
+  /** Generation number of the current parallel window. */
+  uint64_t m_generation;
+  /** Number of workers still busy with the current window. */
+  uint32_t m_busyWorkers;
+  /** Flag \c true when the workers must exit. */
+  bool m_shutdown;
+
+  /** Number of windows executed. */
+  uint64_t m_windowCount;
+  /** Number of windows executed concurrently. */
+  uint64_t m_parallelWindowCount;
+  /** Number of cross-context dependencies detected. */
+  std::atomic<uint64_t> m_dependencyCount;
+
+  /** State of the current thread, null outside of parallel windows. */
+  static thread_local ThreadState *g_threadState;
+
+  /** Main execution thread. */
+  SystemThread::ThreadId m_main;
+};
+
+} // namespace ns3
+
+#endif /* WINDOWED_SIMULATOR_IMPL_H */
@@ -0,0 +1,334 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/binary-trace-recorder.h"
+#include "ns3/config.h"
+#include "ns3/nstime.h"
+#include "ns3/object-vector.h"
+#include "ns3/simulator.h"
+#include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
+
+#include <fstream>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup tracing
+ * BinaryTraceWriter, BinaryTraceReader and BinaryTraceRecorder test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup core-tests
+ * An object with trace sources to record.
+ */
+class BinaryTraceTestObject : public Object
+{
+public:
+  /**
+   * Signature of the Custom trace source.
+   * \param [in] count A count.
+   * \param [in] ratio A ratio.
+   * \param [in] delay A delay.
+   */
+  typedef void (* CustomCallback)(uint32_t count, double ratio, Time delay);
+  /**
+   * Signature of the Unregistered trace source.
+   * \param [in] count A count.
+   * \param [in] other Another count.
+   */
+  typedef void (* UnregisteredCallback)(uint32_t count, uint16_t other);
+
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::tests::BinaryTraceTestObject")
+      .SetParent<Object> ()
+      .SetGroupName ("Core")
+      .AddConstructor<BinaryTraceTestObject> ()
+      .AddAttribute ("Children", "The children of this object.",
+                     ObjectVectorValue (),
+                     MakeObjectVectorAccessor (&BinaryTraceTestObject::m_children),
+                     MakeObjectVectorChecker<BinaryTraceTestObject> ())
+      .AddTraceSource ("Value", "A traced value.",
+                       MakeTraceSourceAccessor (&BinaryTraceTestObject::m_value),
+                       "ns3::TracedValueCallback::Double")
+      .AddTraceSource ("Delay", "A traced time.",
+                       MakeTraceSourceAccessor (&BinaryTraceTestObject::m_delay),
+                       "ns3::TracedValueCallback::Time")
+      .AddTraceSource ("Custom", "A trace with a registered signature.",
+                       MakeTraceSourceAccessor (&BinaryTraceTestObject::m_custom),
+                       "ns3::tests::BinaryTraceTestObject::CustomCallback")
+      .AddTraceSource ("Unregistered", "A trace with an unregistered signature.",
+                       MakeTraceSourceAccessor (&BinaryTraceTestObject::m_unregistered),
+                       "ns3::tests::BinaryTraceTestObject::UnregisteredCallback")
+    ;
+    return tid;
+  }
+
+  /** The children of this object. */
+  std::vector<Ptr<BinaryTraceTestObject> > m_children;
+  /** The Value trace source. */
+  TracedValue<double> m_value;
+  /** The Delay trace source. */
+  TracedValue<Time> m_delay;
+  /** The Custom trace source. */
+  TracedCallback<uint32_t, double, Time> m_custom;
+  /** The Unregistered trace source. */
+  TracedCallback<uint32_t, uint16_t> m_unregistered;
+
+  /**
+   * Set the Value trace source.
+   * \param [in] value The new value.
+   */
+  void SetValue (double value)
+  {
+    m_value = value;
+  }
+  /**
+   * Set the Delay trace source.
+   * \param [in] delay The new value.
+   */
+  void SetDelay (Time delay)
+  {
+    m_delay = delay;
+  }
+  /**
+   * Fire the Custom trace source.
+   * \param [in] count A count.
+   * \param [in] ratio A ratio.
+   * \param [in] delay A delay.
+   */
+  void FireCustom (uint32_t count, double ratio, Time delay)
+  {
+    m_custom (count, ratio, delay);
+  }
+};
+
+/** Register the signature of the Custom trace source. */
+static BinaryTraceSignature<uint32_t, double, Time>
+  g_binaryTraceTestCustomSignature ("ns3::tests::BinaryTraceTestObject::CustomCallback");
+
+
+/**
+ * \ingroup core-tests
+ * Write records with BinaryTraceWriter and read them back.
+ */
+class BinaryTraceFileTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  BinaryTraceFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceFileTestCase::BinaryTraceFileTestCase ()
+  : TestCase ("Write and read back a binary trace file")
+{}
+
+void
+BinaryTraceFileTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace-file.bin");
+
+  // Enough records to grow the file a few times
+  const uint32_t n = 100000;
+  Ptr<BinaryTraceWriter> writer = Create<BinaryTraceWriter> ();
+  writer->Open (filename);
+  uint32_t first = writer->AddSource ("first", "ns3::TracedValueCallback::Uint32");
+  uint32_t second = writer->AddSource ("second", "");
+  NS_TEST_ASSERT_MSG_EQ (first, 0, "First source id");
+  NS_TEST_ASSERT_MSG_EQ (second, 1, "Second source id");
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      uint8_t *buffer = writer->Reserve (i % 2, 2 * sizeof (uint32_t));
+      BinaryTraceEncoder<uint32_t>::Write (buffer, i);
+      BinaryTraceEncoder<uint32_t>::Write (buffer + sizeof (uint32_t), n - i);
+    }
+  writer->Close ();
+  NS_TEST_ASSERT_MSG_EQ (writer->Reserve (first, 4), 0, "Reserved a record after Close");
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to open the trace file");
+  BinaryTraceReader::Record record;
+  uint32_t count = 0;
+  while (reader.Next (record))
+    {
+      NS_TEST_ASSERT_MSG_EQ (record.GetSource (), count % 2, "Record " << count << " source");
+      NS_TEST_ASSERT_MSG_EQ (record.GetTime (), Seconds (0), "Record " << count << " time");
+      NS_TEST_ASSERT_MSG_EQ (record.GetSize (), 2 * sizeof (uint32_t),
+                             "Record " << count << " size");
+      NS_TEST_ASSERT_MSG_EQ (record.Read<uint32_t> (), count, "Record " << count << " value");
+      NS_TEST_ASSERT_MSG_EQ (record.Read<uint32_t> (), n - count, "Record " << count << " value");
+      ++count;
+    }
+  NS_TEST_ASSERT_MSG_EQ (count, n, "Number of records");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNSources (), 2, "Number of sources");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetSource (first).path, "first", "First source path");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetSource (first).type, "ns3::TracedValueCallback::Uint32",
+                         "First source type");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetSource (second).path, "second", "Second source path");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetSource (second).type, "", "Second source type");
+  reader.Close ();
+
+  // Not a trace file
+  std::string other = CreateTempDirFilename ("not-a-binary-trace.bin");
+  std::ofstream os (other.c_str ());
+  os << "not a binary trace file" << std::endl;
+  os.close ();
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (other), false, "Opened a text file");
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (CreateTempDirFilename ("missing.bin")), false,
+                         "Opened a missing file");
+}
+
+
+/**
+ * \ingroup core-tests
+ * Record trace sources with BinaryTraceRecorder.
+ */
+class BinaryTraceRecorderTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  BinaryTraceRecorderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceRecorderTestCase::BinaryTraceRecorderTestCase ()
+  : TestCase ("Record trace sources by path and by object")
+{}
+
+void
+BinaryTraceRecorderTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace-recorder.bin");
+
+  Ptr<BinaryTraceTestObject> root = CreateObject<BinaryTraceTestObject> ();
+  Ptr<BinaryTraceTestObject> a = CreateObject<BinaryTraceTestObject> ();
+  Ptr<BinaryTraceTestObject> b = CreateObject<BinaryTraceTestObject> ();
+  root->m_children.push_back (a);
+  root->m_children.push_back (b);
+  Config::RegisterRootNamespaceObject (root);
+
+  BinaryTraceRecorder recorder;
+  recorder.Open (filename);
+  NS_TEST_ASSERT_MSG_EQ (recorder.Record ("/Children/*/Value"), 2, "Recorded Value");
+  NS_TEST_ASSERT_MSG_EQ (recorder.Record ("/Children/1/Custom"), 1, "Recorded Custom");
+  NS_TEST_ASSERT_MSG_EQ (recorder.Record ("/Children/*/Unregistered"), 0,
+                         "Recorded a trace source without a registered signature");
+  NS_TEST_ASSERT_MSG_EQ (recorder.Record ("/Children/*/Missing"), 0,
+                         "Recorded a missing trace source");
+  NS_TEST_ASSERT_MSG_EQ (recorder.Record (root, "Delay", "root/Delay"), true,
+                         "Recorded Delay");
+
+  Simulator::Schedule (Seconds (1), &BinaryTraceTestObject::SetValue, a, 1.5);
+  Simulator::Schedule (Seconds (2), &BinaryTraceTestObject::SetValue, b, 2.5);
+  Simulator::Schedule (Seconds (3), &BinaryTraceTestObject::FireCustom, b,
+                       7, 0.25, MilliSeconds (3));
+  Simulator::Schedule (Seconds (4), &BinaryTraceTestObject::SetDelay, root, Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  recorder.Close ();
+  // Disconnected by Close
+  a->SetValue (3.5);
+  Config::UnregisterRootNamespaceObject (root);
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to open the trace file");
+  BinaryTraceReader::Record record;
+
+  NS_TEST_ASSERT_MSG_EQ (reader.Next (record), true, "Missing the first record");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetNSources (), 4, "Number of sources");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetSource (0).path, "/Children/0/Value", "Source 0 path");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetSource (0).type, "ns3::TracedValueCallback::Double",
+                         "Source 0 type");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetSource (1).path, "/Children/1/Value", "Source 1 path");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetSource (2).path, "/Children/1/Custom", "Source 2 path");
+  NS_TEST_ASSERT_MSG_EQ (reader.GetSource (3).path, "root/Delay", "Source 3 path");
+
+  NS_TEST_ASSERT_MSG_EQ (record.GetSource (), 0, "First record source");
+  NS_TEST_ASSERT_MSG_EQ (record.GetTime (), Seconds (1), "First record time");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<double> (), 0.0, "First record old value");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<double> (), 1.5, "First record new value");
+
+  NS_TEST_ASSERT_MSG_EQ (reader.Next (record), true, "Missing the second record");
+  NS_TEST_ASSERT_MSG_EQ (record.GetSource (), 1, "Second record source");
+  NS_TEST_ASSERT_MSG_EQ (record.GetTime (), Seconds (2), "Second record time");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<double> (), 0.0, "Second record old value");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<double> (), 2.5, "Second record new value");
+
+  NS_TEST_ASSERT_MSG_EQ (reader.Next (record), true, "Missing the third record");
+  NS_TEST_ASSERT_MSG_EQ (record.GetSource (), 2, "Third record source");
+  NS_TEST_ASSERT_MSG_EQ (record.GetTime (), Seconds (3), "Third record time");
+  NS_TEST_ASSERT_MSG_EQ (record.GetSize (), sizeof (uint32_t) + sizeof (double) + sizeof (int64_t),
+                         "Third record size");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<uint32_t> (), 7, "Third record count");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<double> (), 0.25, "Third record ratio");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<Time> (), MilliSeconds (3), "Third record delay");
+
+  NS_TEST_ASSERT_MSG_EQ (reader.Next (record), true, "Missing the fourth record");
+  NS_TEST_ASSERT_MSG_EQ (record.GetSource (), 3, "Fourth record source");
+  NS_TEST_ASSERT_MSG_EQ (record.GetTime (), Seconds (4), "Fourth record time");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<Time> (), Seconds (0), "Fourth record old value");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<Time> (), Seconds (2), "Fourth record new value");
+
+  NS_TEST_ASSERT_MSG_EQ (reader.Next (record), false, "Unexpected record");
+}
+
+
+/**
+ * \ingroup core-tests
+ * Binary trace test suite.
+ */
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  BinaryTraceTestSuite ();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite ()
+  : TestSuite ("binary-trace", UNIT)
+{
+  AddTestCase (new BinaryTraceFileTestCase);
+  AddTestCase (new BinaryTraceRecorderTestCase);
+}
+
+/**
+ * \ingroup core-tests
+ * BinaryTraceTestSuite instance variable.
+ */
+static BinaryTraceTestSuite g_binaryTraceTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
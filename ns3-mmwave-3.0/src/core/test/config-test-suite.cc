@@ -840,6 +840,105 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * Test that a parsed Config::Path behaves as its path string.
+ */
+class CompiledPathConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  CompiledPathConfigTestCase ();
+  /** Destructor. */
+  virtual ~CompiledPathConfigTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+
+};
+
+CompiledPathConfigTestCase::CompiledPathConfigTestCase ()
+  : TestCase ("Check that a Config::Path can be reused and matches as its string")
+{}
+
+void
+CompiledPathConfigTestCase::DoRun (void)
+{
+  IntegerValue iv;
+
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+
+  //
+  // Four objects in a vector, whose NodeB attributes point to objects of
+  // two different types.
+  //
+  std::vector<Ptr<ConfigTestObject> > nodes;
+  for (int i = 0; i < 4; i++)
+    {
+      Ptr<ConfigTestObject> node = CreateObject<ConfigTestObject> ();
+      if (i % 2 == 0)
+        {
+          node->SetNodeB (CreateObject<ConfigTestObject> ());
+        }
+      else
+        {
+          node->SetNodeB (CreateObject<DerivedConfigTestObject> ());
+        }
+      root->AddNodeA (node);
+      nodes.push_back (node);
+    }
+
+  //
+  // The same Path used several times.
+  //
+  Config::Path path ("/NodesA/[1-2]|3/A");
+  NS_TEST_ASSERT_MSG_EQ (path.GetPath (), "/NodesA/[1-2]|3/A", "Path string not kept");
+  for (int8_t value = 1; value <= 3; value++)
+    {
+      Config::Set (path, IntegerValue (value));
+      for (int i = 0; i < 4; i++)
+        {
+          nodes[i]->GetAttribute ("A", iv);
+          NS_TEST_ASSERT_MSG_EQ (iv.Get (), (i == 0 ? 10 : value), "Object Attribute \"A\" of node " << i << " not as expected");
+        }
+    }
+
+  //
+  // A Path matches the same objects, with the same contexts, as its string,
+  // through objects of different types.
+  //
+  std::string pathString = "/NodesA/*/NodeB";
+  Config::MatchContainer fromString = Config::LookupMatches (pathString);
+  Config::Path compiled (pathString);
+  Config::Path copy = compiled;
+  for (int j = 0; j < 2; j++)
+    {
+      Config::MatchContainer fromPath = Config::LookupMatches (copy);
+      NS_TEST_ASSERT_MSG_EQ (fromPath.GetN (), 4, "Wrong number of matches");
+      NS_TEST_ASSERT_MSG_EQ (fromPath.GetN (), fromString.GetN (), "Path and string match differently");
+      NS_TEST_ASSERT_MSG_EQ (fromPath.GetPath (), pathString, "Wrong matched path");
+      for (uint32_t i = 0; i < fromPath.GetN (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (fromPath.Get (i), fromString.Get (i), "Match " << i << " differs");
+          NS_TEST_ASSERT_MSG_EQ (fromPath.GetMatchedPath (i), fromString.GetMatchedPath (i), "Context " << i << " differs");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (fromString.GetMatchedPath (3), "/NodesA/3/NodeB/", "Wrong context");
+
+  Config::Set (Config::Path ("/NodesA/*/NodeB/B"), IntegerValue (-5));
+  for (int i = 0; i < 4; i++)
+    {
+      PointerValue ptr;
+      nodes[i]->GetAttribute ("NodeB", ptr);
+      ptr.Get<ConfigTestObject> ()->GetAttribute ("B", iv);
+      NS_TEST_ASSERT_MSG_EQ (iv.Get (), -5, "Object Attribute \"B\" under node " << i << " not set");
+    }
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -858,6 +957,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new CompiledPathConfigTestCase);
 }
 
 /**
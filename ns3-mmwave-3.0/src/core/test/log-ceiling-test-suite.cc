@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// The ceiling of this file, replacing the one of the module if any
+#undef NS_LOG_CEILING
+#define NS_LOG_CEILING ns3::LOG_LEVEL_WARN
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+
+#include <iostream>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup logging-tests
+ * Compile-time log level ceiling test suite.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LogCeilingTest");
+
+namespace tests {
+
+/**
+ * \ingroup logging-tests
+ * A class template logging through its own component, like the
+ * templates of headers.
+ */
+class LogCeilingTemplate
+{
+public:
+  LogCeilingTemplate ()
+    : NS_LOG_TEMPLATE_DEFINE ("LogCeilingTest")
+  {}
+  /**
+   * Log at the debug level.
+   * \param [in,out] evaluated Incremented if the message is evaluated.
+   */
+  void Debug (int &evaluated)
+  {
+    NS_LOG_DEBUG ("template " << ++evaluated);
+  }
+  /**
+   * \returns The LogLevels compiled in for the component of the template.
+   */
+  int GetCeiling (void) const
+  {
+    return LogComponentCeiling<decltype (g_log)>::value;
+  }
+
+private:
+  NS_LOG_TEMPLATE_DECLARE;  //!< The log component.
+};
+
+/**
+ * \ingroup logging-tests
+ * Check that the statements above the ceiling of a file are compiled
+ * out, and that the others, and those of templates, are kept.
+ */
+class LogCeilingTestCase : public TestCase
+{
+public:
+  LogCeilingTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LogCeilingTestCase::LogCeilingTestCase ()
+  : TestCase ("Check the compile-time log level ceiling")
+{}
+
+void
+LogCeilingTestCase::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (LogComponentCeiling<decltype (g_log)>::value, LOG_LEVEL_WARN,
+                         "Wrong ceiling for the component of the file");
+  NS_TEST_EXPECT_MSG_EQ (NS_LOG_COMPILED (LOG_WARN), true, "Warnings should be compiled in");
+  NS_TEST_EXPECT_MSG_EQ (NS_LOG_COMPILED (LOG_DEBUG), false, "Debug should be compiled out");
+  LogCeilingTemplate logTemplate;
+  NS_TEST_EXPECT_MSG_EQ (logTemplate.GetCeiling (), LOG_LEVEL_ALL,
+                         "Templates should keep every level");
+
+  // Enabled at run time, the statements compiled out still do nothing
+  std::ostringstream os;
+  std::streambuf *clog = std::clog.rdbuf (os.rdbuf ());
+  LogComponentEnable ("LogCeilingTest", LOG_LEVEL_ALL);
+  int debug = 0;
+  int warn = 0;
+  int templateDebug = 0;
+  NS_LOG_DEBUG ("debug " << ++debug);
+  NS_LOG_FUNCTION (this << ++debug);
+  NS_LOG_WARN ("warn " << ++warn);
+  logTemplate.Debug (templateDebug);
+  LogComponentDisable ("LogCeilingTest", LOG_LEVEL_ALL);
+  std::clog.rdbuf (clog);
+
+  NS_TEST_EXPECT_MSG_EQ (debug, 0, "Statements above the ceiling should not be evaluated");
+#ifdef NS3_LOG_ENABLE
+  NS_TEST_EXPECT_MSG_EQ (warn, 1, "Statements below the ceiling should be evaluated");
+  NS_TEST_EXPECT_MSG_EQ (templateDebug, 1, "Statements of templates should be evaluated");
+  NS_TEST_EXPECT_MSG_EQ (os.str ().find ("debug"), std::string::npos, "Debug message logged");
+  NS_TEST_EXPECT_MSG_NE (os.str ().find ("warn 1"), std::string::npos, "Warning not logged");
+#endif
+}
+
+/**
+ * \ingroup logging-tests
+ * Compile-time log level ceiling test suite.
+ */
+class LogCeilingTestSuite : public TestSuite
+{
+public:
+  LogCeilingTestSuite ();
+};
+
+LogCeilingTestSuite::LogCeilingTestSuite ()
+  : TestSuite ("log-ceiling", UNIT)
+{
+  AddTestCase (new LogCeilingTestCase, TestCase::QUICK);
+}
+
+/**
+ * \ingroup logging-tests
+ * LogCeilingTestSuite instance variable.
+ */
+static LogCeilingTestSuite g_logCeilingTestSuite;
+
+}  // namespace tests
+
+}  // namespace ns3
@@ -402,6 +402,66 @@ AggregateObjectTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
 }
 
+/**
+ * \ingroup object-tests
+ * Test the GetObject lookups stay correct across aggregations.
+ */
+class CachedGetObjectTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  CachedGetObjectTestCase ();
+  /** Destructor. */
+  virtual ~CachedGetObjectTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedGetObjectTestCase::CachedGetObjectTestCase ()
+  : TestCase ("Check cached GetObject lookups")
+{}
+
+CachedGetObjectTestCase::~CachedGetObjectTestCase ()
+{}
+
+void
+CachedGetObjectTestCase::DoRun (void)
+{
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+
+  //
+  // A failed lookup must not hide an Object aggregated later.
+  //
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a BaseB through baseA");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a BaseB through baseA twice");
+  baseA->AggregateObject (derivedB);
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Cannot GetObject (through baseA) for BaseB Object");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), derivedB, "Cannot GetObject (through baseA) for DerivedB Object");
+
+  //
+  // Repeated lookups return the same Object, and the lookups through
+  // any member of the aggregation agree.
+  //
+  for (int i = 0; i < 3; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Repeated GetObject for BaseB differs");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), baseA, "Repeated GetObject for BaseA differs");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<DerivedA> (), 0, "Unexpectedly found a DerivedA through derivedB");
+    }
+
+  //
+  // Lookups no longer reorder the aggregates.
+  //
+  Object::AggregateIterator iterator = baseA->GetAggregateIterator ();
+  NS_TEST_ASSERT_MSG_EQ (iterator.HasNext (), true, "Missing first aggregate");
+  NS_TEST_ASSERT_MSG_EQ (iterator.Next (), baseA, "Aggregates reordered");
+  NS_TEST_ASSERT_MSG_EQ (iterator.HasNext (), true, "Missing second aggregate");
+  NS_TEST_ASSERT_MSG_EQ (iterator.Next (), derivedB, "Aggregates reordered");
+  NS_TEST_ASSERT_MSG_EQ (iterator.HasNext (), false, "Unexpected third aggregate");
+}
+
 /**
  * \ingroup object-tests
  * Test an Object factory can create Objects
@@ -491,6 +551,7 @@ ObjectTestSuite::ObjectTestSuite ()
 {
   AddTestCase (new CreateObjectTestCase);
   AddTestCase (new AggregateObjectTestCase);
+  AddTestCase (new CachedGetObjectTestCase);
   AddTestCase (new ObjectFactoryTestCase);
 }
 
@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-stream.h"
+#include <cstring>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup randomvariable-tests
+ * Tests for the bulk GetValues APIs.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Check that RngStream::RandU01 (double *, std::size_t) reproduces
+ * repeated calls to RngStream::RandU01 (void).
+ */
+class RngStreamBulkTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  RngStreamBulkTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+RngStreamBulkTestCase::RngStreamBulkTestCase ()
+  : TestCase ("Bulk RngStream::RandU01 matches the scalar sequence")
+{}
+
+void
+RngStreamBulkTestCase::DoRun (void)
+{
+  RngStream scalar (12345, 7, 3);
+  RngStream bulk (scalar);
+
+  const std::size_t n = 1000;
+  std::vector<double> values (n);
+  bulk.RandU01 (&values[0], n);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      double expected = scalar.RandU01 ();
+      NS_TEST_ASSERT_MSG_EQ (std::memcmp (&expected, &values[i], sizeof (double)), 0,
+                             "Bulk value " << i << " differs");
+    }
+  // An empty request leaves the stream alone
+  bulk.RandU01 (&values[0], 0);
+  NS_TEST_ASSERT_MSG_EQ (bulk.RandU01 (), scalar.RandU01 (),
+                         "Bulk and scalar streams out of step");
+}
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Check that RandomVariableStream::GetValues reproduces repeated calls
+ * to RandomVariableStream::GetValue for a distribution.
+ */
+class GetValuesTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] name The test name.
+   * \param [in] factory The factory of the random variables to compare.
+   */
+  GetValuesTestCase (std::string name, ObjectFactory factory);
+
+private:
+  virtual void DoRun (void);
+  /** The factory of the random variables to compare. */
+  ObjectFactory m_factory;
+};
+
+GetValuesTestCase::GetValuesTestCase (std::string name, ObjectFactory factory)
+  : TestCase ("GetValues matches GetValue for " + name),
+    m_factory (factory)
+{}
+
+void
+GetValuesTestCase::DoRun (void)
+{
+  Ptr<RandomVariableStream> scalar = m_factory.Create<RandomVariableStream> ();
+  Ptr<RandomVariableStream> bulk = m_factory.Create<RandomVariableStream> ();
+  scalar->SetStream (42);
+  bulk->SetStream (42);
+
+  // Odd sizes, to catch any state carried between calls
+  const std::size_t sizes[] = { 1, 7, 64, 501 };
+  for (std::size_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); ++s)
+    {
+      std::vector<double> values (sizes[s]);
+      bulk->GetValues (&values[0], values.size ());
+      for (std::size_t i = 0; i < values.size (); ++i)
+        {
+          double expected = scalar->GetValue ();
+          NS_TEST_ASSERT_MSG_EQ (std::memcmp (&expected, &values[i], sizeof (double)), 0,
+                                 "Value " << i << " of batch " << s << " differs");
+        }
+      NS_TEST_ASSERT_MSG_EQ (bulk->GetValue (), scalar->GetValue (),
+                             "Streams out of step after batch " << s);
+    }
+}
+
+
+/**
+ * \ingroup randomvariable-tests
+ * Test suite for the bulk GetValues APIs.
+ */
+class RandomVariableStreamGetValuesTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  RandomVariableStreamGetValuesTestSuite ();
+};
+
+RandomVariableStreamGetValuesTestSuite::RandomVariableStreamGetValuesTestSuite ()
+  : TestSuite ("random-variable-stream-get-values", UNIT)
+{
+  AddTestCase (new RngStreamBulkTestCase);
+
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::UniformRandomVariable");
+  factory.Set ("Min", DoubleValue (-3.0));
+  factory.Set ("Max", DoubleValue (5.0));
+  AddTestCase (new GetValuesTestCase ("uniform", factory));
+  factory.Set ("Antithetic", BooleanValue (true));
+  AddTestCase (new GetValuesTestCase ("antithetic uniform", factory));
+
+  factory = ObjectFactory ();
+  factory.SetTypeId ("ns3::ConstantRandomVariable");
+  factory.Set ("Constant", DoubleValue (2.5));
+  AddTestCase (new GetValuesTestCase ("constant", factory));
+
+  factory = ObjectFactory ();
+  factory.SetTypeId ("ns3::ExponentialRandomVariable");
+  factory.Set ("Mean", DoubleValue (3.0));
+  AddTestCase (new GetValuesTestCase ("exponential", factory));
+  factory.Set ("Antithetic", BooleanValue (true));
+  AddTestCase (new GetValuesTestCase ("antithetic exponential", factory));
+  factory.Set ("Bound", DoubleValue (4.0));
+  AddTestCase (new GetValuesTestCase ("bounded exponential", factory));
+
+  factory = ObjectFactory ();
+  factory.SetTypeId ("ns3::NormalRandomVariable");
+  factory.Set ("Mean", DoubleValue (1.0));
+  factory.Set ("Variance", DoubleValue (2.0));
+  AddTestCase (new GetValuesTestCase ("normal", factory));
+  factory.Set ("Bound", DoubleValue (1.5));
+  AddTestCase (new GetValuesTestCase ("bounded normal", factory));
+
+  // Uses the default implementation
+  factory = ObjectFactory ();
+  factory.SetTypeId ("ns3::WeibullRandomVariable");
+  AddTestCase (new GetValuesTestCase ("weibull", factory));
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * RandomVariableStreamGetValuesTestSuite instance variable.
+ */
+static RandomVariableStreamGetValuesTestSuite g_randomVariableStreamGetValuesTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
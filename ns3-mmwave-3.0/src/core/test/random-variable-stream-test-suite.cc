@@ -2855,6 +2855,67 @@ RandomVariableStreamEmpiricalAntitheticTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (valueMean, expectedMean, TOLERANCE, "Wrong mean value.");
 }
 
+// ===========================================================================
+// Test case for restarting random variable streams
+// ===========================================================================
+class RandomVariableStreamReseedTestCase : public TestCase
+{
+public:
+  static const uint32_t N_DRAWS = 3;
+
+  RandomVariableStreamReseedTestCase ();
+  virtual ~RandomVariableStreamReseedTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check that the values drawn after Reseed are the first ones again.
+   * \param [in] x The random variable, drawn from the start of its stream.
+   * \param [in] name The name of the distribution.
+   */
+  void CheckReseed (Ptr<RandomVariableStream> x, std::string name);
+};
+
+RandomVariableStreamReseedTestCase::RandomVariableStreamReseedTestCase ()
+  : TestCase ("Reseed of Random Variable Streams")
+{}
+
+RandomVariableStreamReseedTestCase::~RandomVariableStreamReseedTestCase ()
+{}
+
+void
+RandomVariableStreamReseedTestCase::CheckReseed (Ptr<RandomVariableStream> x, std::string name)
+{
+  // An odd number of draws leaves the second value of a pair cached
+  double values[N_DRAWS];
+  for (uint32_t i = 0; i < N_DRAWS; ++i)
+    {
+      values[i] = x->GetValue ();
+    }
+  RandomVariableStream::Reseed ();
+  for (uint32_t i = 0; i < N_DRAWS; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (x->GetValue (), values[i], "Wrong " << name << " value " << i << " after Reseed");
+    }
+}
+
+void
+RandomVariableStreamReseedTestCase::DoRun (void)
+{
+  SetTestSuiteSeed ();
+
+  Ptr<NormalRandomVariable> normal = CreateObject<NormalRandomVariable> ();
+  normal->SetAttribute ("Mean", DoubleValue (5.0));
+  normal->SetAttribute ("Variance", DoubleValue (2.0));
+  CheckReseed (normal, "normal");
+
+  Ptr<GammaRandomVariable> gamma = CreateObject<GammaRandomVariable> ();
+  gamma->SetAttribute ("Alpha", DoubleValue (5.0));
+  gamma->SetAttribute ("Beta", DoubleValue (2.0));
+  CheckReseed (gamma, "gamma");
+}
+
 class RandomVariableStreamTestSuite : public TestSuite
 {
 public:
@@ -2899,6 +2960,7 @@ RandomVariableStreamTestSuite::RandomVariableStreamTestSuite ()
   AddTestCase (new RandomVariableStreamDeterministicTestCase);
   AddTestCase (new RandomVariableStreamEmpiricalTestCase);
   AddTestCase (new RandomVariableStreamEmpiricalAntitheticTestCase);
+  AddTestCase (new RandomVariableStreamReseedTestCase);
 }
 
 static RandomVariableStreamTestSuite randomVariableStreamTestSuite;
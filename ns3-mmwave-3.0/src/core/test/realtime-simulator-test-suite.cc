@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/realtime-simulator-impl.h"
+#include "ns3/hybrid-synchronizer.h"
+#include "ns3/wall-clock-synchronizer.h"
+#include "ns3/object-factory.h"
+#include "ns3/type-id.h"
+
+#include <numeric>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Check that the realtime simulator runs its events in step with the
+ * wall clock, and accounts their lateness, with each synchronizer.
+ */
+class RealtimeSimulatorLatenessTestCase : public TestCase
+{
+public:
+  RealtimeSimulatorLatenessTestCase (TypeId synchronizer);
+  /** A periodic event. */
+  void Tick (void);
+  /**
+   * Trace sink for the lateness of the events.
+   * \param [in] lateness The lateness.
+   */
+  void Lateness (Time lateness);
+
+private:
+  virtual void DoRun (void);
+
+  TypeId m_synchronizer;
+  uint32_t m_ticks;
+  uint32_t m_traced;
+};
+
+static const uint32_t N_TICKS = 20;
+
+RealtimeSimulatorLatenessTestCase::RealtimeSimulatorLatenessTestCase (TypeId synchronizer)
+  : TestCase ("Check the event lateness with " + synchronizer.GetName ()),
+    m_synchronizer (synchronizer)
+{}
+
+void
+RealtimeSimulatorLatenessTestCase::Tick (void)
+{
+  if (++m_ticks < N_TICKS)
+    {
+      Simulator::Schedule (MilliSeconds (1), &RealtimeSimulatorLatenessTestCase::Tick, this);
+    }
+}
+
+void
+RealtimeSimulatorLatenessTestCase::Lateness (Time lateness)
+{
+  m_traced++;
+}
+
+void
+RealtimeSimulatorLatenessTestCase::DoRun (void)
+{
+  m_ticks = 0;
+  m_traced = 0;
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::RealtimeSimulatorImpl");
+  factory.Set ("SynchronizerType", TypeIdValue (m_synchronizer));
+  Ptr<RealtimeSimulatorImpl> impl = factory.Create<RealtimeSimulatorImpl> ();
+  NS_TEST_ASSERT_MSG_EQ (impl->GetSynchronizerType (), m_synchronizer, "Synchronizer not set");
+  impl->TraceConnectWithoutContext ("Lateness",
+                                    MakeCallback (&RealtimeSimulatorLatenessTestCase::Lateness,
+                                                  this));
+  Simulator::SetImplementation (impl);
+
+  Simulator::Schedule (MilliSeconds (1), &RealtimeSimulatorLatenessTestCase::Tick, this);
+  // the realtime simulator does not stop when it runs out of events
+  Simulator::Stop (MilliSeconds (N_TICKS + 1));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_ticks, N_TICKS, "Missing events");
+  NS_TEST_EXPECT_MSG_EQ (m_traced, N_TICKS + 1, "Missing lateness traces");
+  std::vector<uint64_t> histogram = impl->GetLatenessHistogram ();
+  uint64_t total = std::accumulate (histogram.begin (), histogram.end (), uint64_t (0));
+  NS_TEST_EXPECT_MSG_EQ (total, N_TICKS + 1, "Events missing from the histogram");
+  // very loose, for loaded machines
+  NS_TEST_EXPECT_MSG_LT (impl->GetMaxLateness (), MilliSeconds (100), "Events far too late");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (impl->RealtimeNow (), MilliSeconds (N_TICKS + 1),
+                               "Events ran ahead of real time");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that the lateness sinks can use the simulator: they are
+ * called outside the critical section of the realtime simulator.
+ */
+class RealtimeSimulatorLatenessSinkTestCase : public TestCase
+{
+public:
+  RealtimeSimulatorLatenessSinkTestCase ();
+  /** An event scheduled by the lateness sink. */
+  void Scheduled (void);
+  /**
+   * Trace sink for the lateness of the events, which schedules an
+   * event and reads the lateness statistics.
+   * \param [in] lateness The lateness.
+   */
+  void Lateness (Time lateness);
+
+private:
+  virtual void DoRun (void);
+
+  Ptr<RealtimeSimulatorImpl> m_impl;
+  uint32_t m_traced;
+  uint32_t m_scheduled;
+  bool m_maxBelowLateness;
+};
+
+RealtimeSimulatorLatenessSinkTestCase::RealtimeSimulatorLatenessSinkTestCase ()
+  : TestCase ("Check that the lateness sinks can use the simulator")
+{}
+
+void
+RealtimeSimulatorLatenessSinkTestCase::Scheduled (void)
+{
+  m_scheduled++;
+}
+
+void
+RealtimeSimulatorLatenessSinkTestCase::Lateness (Time lateness)
+{
+  if (m_traced++ < 3)
+    {
+      Simulator::Schedule (MilliSeconds (1), &RealtimeSimulatorLatenessSinkTestCase::Scheduled, this);
+    }
+  // the statistics include the event traced
+  m_maxBelowLateness |= m_impl->GetMaxLateness () < lateness;
+  m_impl->GetLatenessHistogram ();
+  Simulator::Now ();
+}
+
+void
+RealtimeSimulatorLatenessSinkTestCase::DoRun (void)
+{
+  m_traced = 0;
+  m_scheduled = 0;
+  m_maxBelowLateness = false;
+  m_impl = CreateObject<RealtimeSimulatorImpl> ();
+  m_impl->TraceConnectWithoutContext ("Lateness",
+                                      MakeCallback (&RealtimeSimulatorLatenessSinkTestCase::Lateness,
+                                                    this));
+  Simulator::SetImplementation (m_impl);
+
+  Simulator::Schedule (MilliSeconds (1), &RealtimeSimulatorLatenessSinkTestCase::Scheduled, this);
+  Simulator::Stop (MilliSeconds (10));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_scheduled, 4, "Events scheduled by the sink not run");
+  NS_TEST_EXPECT_MSG_EQ (m_traced, 5, "Missing lateness traces");
+  NS_TEST_EXPECT_MSG_EQ (m_maxBelowLateness, false, "Maximum lateness not updated before the trace");
+
+  Simulator::Destroy ();
+  m_impl = 0;
+}
+
+class RealtimeSimulatorTestSuite : public TestSuite
+{
+public:
+  RealtimeSimulatorTestSuite ()
+    : TestSuite ("realtime-simulator")
+  {
+    AddTestCase (new RealtimeSimulatorLatenessTestCase (WallClockSynchronizer::GetTypeId ()),
+                 TestCase::QUICK);
+    AddTestCase (new RealtimeSimulatorLatenessTestCase (HybridSynchronizer::GetTypeId ()),
+                 TestCase::QUICK);
+    AddTestCase (new RealtimeSimulatorLatenessSinkTestCase (), TestCase::QUICK);
+  }
+} g_realtimeSimulatorTestSuite;
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-snapshot.h"
+#include "ns3/nstime.h"
+
+#include <chrono>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+class SimulatorSnapshotTestCase : public TestCase
+{
+public:
+  SimulatorSnapshotTestCase (uint32_t jobs);
+
+private:
+  virtual void DoRun (void);
+
+  void Snapshot (void);
+  void Later (void);
+
+  uint32_t m_jobs;
+  uint32_t m_branch;
+  uint32_t m_nLater;
+  Time m_snapshotTime;
+};
+
+// Branches exit with a failure when their index is odd.
+static const uint32_t N_BRANCHES = 5;
+
+SimulatorSnapshotTestCase::SimulatorSnapshotTestCase (uint32_t jobs)
+  : TestCase ("Check SimulatorSnapshot::Branch with jobs=" + std::to_string (jobs)),
+    m_jobs (jobs)
+{}
+
+void
+SimulatorSnapshotTestCase::Snapshot (void)
+{
+  m_snapshotTime = Simulator::Now ();
+  m_branch = SimulatorSnapshot::Branch (N_BRANCHES, m_jobs);
+}
+
+void
+SimulatorSnapshotTestCase::Later (void)
+{
+  ++m_nLater;
+}
+
+void
+SimulatorSnapshotTestCase::DoRun (void)
+{
+  m_branch = N_BRANCHES + 1;
+  m_nLater = 0;
+  // A child of the program, which Branch must not reap
+  pid_t other = fork ();
+  NS_TEST_ASSERT_MSG_NE (other, -1, "Unable to fork");
+  if (other == 0)
+    {
+      _exit (7);
+    }
+  Simulator::Schedule (Seconds (1), &SimulatorSnapshotTestCase::Snapshot, this);
+  Simulator::Schedule (Seconds (2), &SimulatorSnapshotTestCase::Later, this);
+  Simulator::Run ();
+
+  if (SimulatorSnapshot::IsBranch ())
+    {
+      // Each branch resumes the simulation after the snapshot
+      bool ok = m_branch < N_BRANCHES
+        && m_nLater == 1
+        && Simulator::Now () == Seconds (2)
+        && m_snapshotTime == Seconds (1);
+      Simulator::Destroy ();
+      _exit (ok ? (m_branch % 2) : 2);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (m_branch, N_BRANCHES, "Wrong Branch return in the snapshot");
+  NS_TEST_ASSERT_MSG_EQ (m_nLater, 0, "The snapshot ran past the Branch");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (1), "The snapshot did not stop");
+  NS_TEST_ASSERT_MSG_EQ (SimulatorSnapshot::GetNFailures (), N_BRANCHES / 2,
+                         "Wrong number of failed branches");
+  int status;
+  NS_TEST_ASSERT_MSG_EQ (waitpid (other, &status, 0), other, "Branch reaped another child");
+  NS_TEST_ASSERT_MSG_EQ (WIFEXITED (status) && WEXITSTATUS (status) == 7, true,
+                         "Wrong status for the other child");
+  Simulator::Destroy ();
+}
+
+class SimulatorSnapshotBeforeRunTestCase : public TestCase
+{
+public:
+  SimulatorSnapshotBeforeRunTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  void Later (void);
+
+  uint32_t m_nLater;
+};
+
+SimulatorSnapshotBeforeRunTestCase::SimulatorSnapshotBeforeRunTestCase ()
+  : TestCase ("Check SimulatorSnapshot::Branch before Simulator::Run")
+{}
+
+void
+SimulatorSnapshotBeforeRunTestCase::Later (void)
+{
+  ++m_nLater;
+}
+
+void
+SimulatorSnapshotBeforeRunTestCase::DoRun (void)
+{
+  m_nLater = 0;
+  Simulator::Schedule (Seconds (2), &SimulatorSnapshotBeforeRunTestCase::Later, this);
+  uint32_t branch = SimulatorSnapshot::Branch (N_BRANCHES, 2);
+  if (branch < N_BRANCHES)
+    {
+      // Each branch runs the whole simulation
+      Simulator::Run ();
+      bool ok = m_nLater == 1 && Simulator::Now () == Seconds (2);
+      Simulator::Destroy ();
+      _exit (ok ? 0 : 2);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (branch, N_BRANCHES, "Wrong Branch return in the snapshot");
+  NS_TEST_ASSERT_MSG_EQ (SimulatorSnapshot::GetNFailures (), 0, "No branch should fail");
+  NS_TEST_ASSERT_MSG_EQ (m_nLater, 0, "The snapshot should not have run");
+  Simulator::Destroy ();
+}
+
+class SimulatorSnapshotJobsTestCase : public TestCase
+{
+public:
+  SimulatorSnapshotJobsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+// The even branches are slow.
+static const uint32_t SLOW_BRANCH_MS = 400;
+
+SimulatorSnapshotJobsTestCase::SimulatorSnapshotJobsTestCase ()
+  : TestCase ("Check that SimulatorSnapshot::Branch refills a job as soon as a branch exits")
+{}
+
+void
+SimulatorSnapshotJobsTestCase::DoRun (void)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  uint32_t branch = SimulatorSnapshot::Branch (4, 2);
+  if (branch < 4)
+    {
+      if (branch % 2 == 0)
+        {
+          usleep (SLOW_BRANCH_MS * 1000);
+        }
+      _exit (0);
+    }
+
+  // Waiting for the oldest branch would run the slow ones one after the other
+  int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>
+    (std::chrono::steady_clock::now () - start).count ();
+  NS_TEST_ASSERT_MSG_EQ (SimulatorSnapshot::GetNFailures (), 0, "No branch should fail");
+  NS_TEST_ASSERT_MSG_LT (elapsed, SLOW_BRANCH_MS * 3 / 2, "The slow branches did not overlap");
+  Simulator::Destroy ();
+}
+
+class SimulatorSnapshotTestSuite : public TestSuite
+{
+public:
+  SimulatorSnapshotTestSuite ();
+};
+
+SimulatorSnapshotTestSuite::SimulatorSnapshotTestSuite ()
+  : TestSuite ("simulator-snapshot", UNIT)
+{
+  AddTestCase (new SimulatorSnapshotTestCase (1), TestCase::QUICK);
+  AddTestCase (new SimulatorSnapshotTestCase (3), TestCase::QUICK);
+  AddTestCase (new SimulatorSnapshotBeforeRunTestCase, TestCase::QUICK);
+  AddTestCase (new SimulatorSnapshotJobsTestCase, TestCase::QUICK);
+}
+
+static SimulatorSnapshotTestSuite simulatorSnapshotTestSuite;
@@ -24,6 +24,14 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/event-profiler.h"
+#include "ns3/make-event.h"
+#include "ns3/random-variable-stream.h"
+
+#include <sstream>
+#include <typeindex>
+#include <vector>
 
 using namespace ns3;
 
@@ -170,6 +178,357 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+/**
+ * Check that a Scheduler returns random events in key order,
+ * including events with the same timestamp and removed events.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+
+private:
+  virtual void DoRun (void);
+
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that events are ordered by key with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{}
+
+static void SchedulerOrderNoop (void)
+{}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+
+  const uint32_t N = 1000;
+  std::vector<Ptr<EventImpl> > impls;
+  std::vector<Scheduler::Event> events;
+  for (uint32_t uid = 0; uid < N; ++uid)
+    {
+      Ptr<EventImpl> impl = MakeEvent (&SchedulerOrderNoop);
+      impls.push_back (impl);
+      Scheduler::Event ev;
+      ev.impl = PeekPointer (impl);
+      // a small range of timestamps, to get many ties
+      ev.key.m_ts = rng->GetInteger (0, 100);
+      ev.key.m_uid = uid;
+      ev.key.m_context = rng->GetInteger (0, 10);
+      scheduler->Insert (ev);
+      events.push_back (ev);
+    }
+  // remove one event out of three
+  uint32_t removed = 0;
+  for (uint32_t i = 0; i < N; i += 3)
+    {
+      scheduler->Remove (events[i]);
+      ++removed;
+    }
+
+  Scheduler::Event previous = scheduler->RemoveNext ();
+  NS_TEST_EXPECT_MSG_NE (previous.key.m_uid % 3, 0, "Removed event returned");
+  uint32_t count = 1;
+  while (!scheduler->IsEmpty ())
+    {
+      Scheduler::Event next = scheduler->RemoveNext ();
+      NS_TEST_EXPECT_MSG_EQ ((previous < next), true, "Events out of order");
+      NS_TEST_EXPECT_MSG_NE (next.key.m_uid % 3, 0, "Removed event returned");
+      const Scheduler::Event &original = events[next.key.m_uid];
+      NS_TEST_EXPECT_MSG_EQ (next.key.m_ts, original.key.m_ts, "Timestamp altered");
+      NS_TEST_EXPECT_MSG_EQ (next.key.m_context, original.key.m_context, "Context altered");
+      NS_TEST_EXPECT_MSG_EQ (next.impl, original.impl, "Event altered");
+      previous = next;
+      ++count;
+    }
+  NS_TEST_EXPECT_MSG_EQ (count + removed, N, "Events lost");
+}
+
+/**
+ * A base class with a virtual event handler, for the EventProfiler test.
+ */
+class EventProfilerBase
+{
+public:
+  virtual ~EventProfilerBase ()
+  {}
+  /**
+   * A virtual event handler.
+   * \param [in] value An argument.
+   */
+  virtual void Run (int value);
+};
+
+void
+EventProfilerBase::Run (int value)
+{}
+
+/**
+ * A derived class overriding the event handler, for the EventProfiler test.
+ */
+class EventProfilerDerived : public EventProfilerBase
+{
+public:
+  virtual void Run (int value);
+};
+
+void
+EventProfilerDerived::Run (int value)
+{}
+
+/**
+ * Check that the EventProfiler accounts the events by handler.
+ */
+class EventProfilerTestCase : public TestCase
+{
+public:
+  EventProfilerTestCase ();
+  /**
+   * A member event handler.
+   * \param [in] value An argument.
+   */
+  void Handler (int value);
+  /**
+   * Another member event handler, with the same signature.
+   * \param [in] value An argument.
+   */
+  void OtherHandler (int value);
+
+private:
+  virtual void DoRun (void);
+
+  int m_sum;
+};
+
+EventProfilerTestCase::EventProfilerTestCase ()
+  : TestCase ("Check the accounting of the event profiler")
+{}
+
+void
+EventProfilerTestCase::Handler (int value)
+{
+  m_sum += value;
+}
+
+void
+EventProfilerTestCase::OtherHandler (int value)
+{
+  m_sum += 10 * value;
+}
+
+void
+EventProfilerTestCase::DoRun (void)
+{
+  m_sum = 0;
+  EventProfiler profiler;
+  for (int i = 0; i < 3; ++i)
+    {
+      Ptr<EventImpl> ev = MakeEvent (&EventProfilerTestCase::Handler, this, i);
+      profiler.Invoke (PeekPointer (ev));
+    }
+  Ptr<EventImpl> other = MakeEvent (&EventProfilerTestCase::OtherHandler, this, 1);
+  profiler.Invoke (PeekPointer (other));
+  EventProfilerDerived derived;
+  Ptr<EventImpl> run = MakeEvent (&EventProfilerBase::Run, &derived, 1);
+  profiler.Invoke (PeekPointer (run));
+  Ptr<EventImpl> noop = MakeEvent (&SchedulerOrderNoop);
+  profiler.Invoke (PeekPointer (noop));
+  NS_TEST_EXPECT_MSG_EQ (m_sum, 13, "Events not invoked");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetEventCount (), 6, "Wrong event count");
+
+  std::string label = EventProfiler::GetLabel (std::type_index (typeid (*noop)));
+  NS_TEST_EXPECT_MSG_EQ (label, "void (*)()", "Wrong label for a function");
+  // A static function has no exported symbol
+  label = EventProfiler::GetLabel (std::type_index (typeid (*noop)), noop->GetHandlerCode ());
+  NS_TEST_EXPECT_MSG_EQ (label.find ("void (*)() at "), 0, "Wrong label for a static function");
+
+  std::ostringstream folded;
+  profiler.ReportFolded (folded);
+  std::istringstream lines (folded.str ());
+  std::string line;
+  uint32_t count = 0;
+  std::string handler;
+  bool otherHandler = false;
+  bool override = false;
+  while (std::getline (lines, line))
+    {
+      NS_TEST_EXPECT_MSG_EQ (line.find ("ns3::Simulator::Run;"), 0, "Bad folded stack " << line);
+      if (line.find ("EventProfilerTestCase::Handler(int)") != std::string::npos)
+        {
+          handler = line;
+        }
+      otherHandler |= line.find ("EventProfilerTestCase::OtherHandler(int)") != std::string::npos;
+      override |= line.find ("EventProfilerDerived::Run(int)") != std::string::npos;
+      ++count;
+    }
+  NS_TEST_EXPECT_MSG_EQ (count, 4, "Events not grouped by handler");
+  NS_TEST_EXPECT_MSG_NE (handler, "", "Member handler not reported");
+  NS_TEST_EXPECT_MSG_EQ (otherHandler, true, "Handlers with the same signature not told apart");
+  NS_TEST_EXPECT_MSG_EQ (override, true, "Virtual handler not resolved to its override");
+
+  std::ostringstream report;
+  profiler.Report (report);
+  NS_TEST_EXPECT_MSG_NE (report.str ().find ("EventProfilerTestCase::Handler(int)"), std::string::npos,
+                         "Member handler not in the report");
+}
+
+/**
+ * Check Simulator::ScheduleBatch, with batches larger and smaller
+ * than the scheduled event population.
+ */
+class ScheduleBatchTestCase : public TestCase
+{
+public:
+  ScheduleBatchTestCase (ObjectFactory schedulerFactory);
+  /**
+   * A batched event.
+   * \param [in] value The expected timestamp, in ns.
+   */
+  void Event (uint64_t value);
+
+private:
+  virtual void DoRun (void);
+
+  ObjectFactory m_schedulerFactory;
+  std::vector<uint64_t> m_times;
+  bool m_ok;
+};
+
+ScheduleBatchTestCase::ScheduleBatchTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check ScheduleBatch with " + schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{}
+
+void
+ScheduleBatchTestCase::Event (uint64_t value)
+{
+  m_ok &= Simulator::Now ().GetNanoSeconds () == (int64_t)value;
+  m_times.push_back (value);
+}
+
+void
+ScheduleBatchTestCase::DoRun (void)
+{
+  m_ok = true;
+  Simulator::SetScheduler (m_schedulerFactory);
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (2);
+
+  // a first batch into the empty scheduler, a second, smaller, one
+  std::vector<std::pair<Time, Ptr<EventImpl> > > events;
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      uint64_t ns = rng->GetInteger (1, 1000);
+      events.push_back (std::make_pair (NanoSeconds (ns),
+                                        MakeEvent (&ScheduleBatchTestCase::Event, this, ns)));
+    }
+  std::vector<EventId> ids = Simulator::ScheduleBatch (events);
+  NS_TEST_ASSERT_MSG_EQ (ids.size (), events.size (), "Wrong number of ids");
+  std::vector<Time> delays;
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      delays.push_back (NanoSeconds (500 + i));
+    }
+  std::vector<EventId> more = Simulator::ScheduleBatch (delays, &ScheduleBatchTestCase::Event,
+                                                        this, 0);
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetDelayLeft (more[3]), NanoSeconds (503), "Wrong event id");
+  for (uint32_t i = 0; i < more.size (); ++i)
+    {
+      Simulator::Remove (more[i]);
+    }
+  Simulator::Cancel (ids[0]);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_ok, true, "Events executed at the wrong time");
+  NS_TEST_EXPECT_MSG_EQ (m_times.size (), events.size () - 1, "Wrong number of events");
+  for (uint32_t i = 1; i < m_times.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((m_times[i - 1] <= m_times[i]), true, "Events out of order");
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * Check Simulator::SchedulePeriodic, and stopping the series
+ * from outside and from inside the periodic handler.
+ */
+class SchedulePeriodicTestCase : public TestCase
+{
+public:
+  SchedulePeriodicTestCase ();
+  /** The periodic handler of the first series. */
+  void Tick (void);
+  /**
+   * The periodic handler of the second series, stopping it.
+   * \param [in] limit The number of periods to run.
+   */
+  void Stopping (uint32_t limit);
+
+private:
+  virtual void DoRun (void);
+
+  EventId m_stopping;
+  uint32_t m_ticks;
+  uint32_t m_stops;
+  bool m_ok;
+};
+
+SchedulePeriodicTestCase::SchedulePeriodicTestCase ()
+  : TestCase ("Check SchedulePeriodic")
+{}
+
+void
+SchedulePeriodicTestCase::Tick (void)
+{
+  m_ticks++;
+  m_ok &= Simulator::Now () == MicroSeconds (10 * m_ticks);
+}
+
+void
+SchedulePeriodicTestCase::Stopping (uint32_t limit)
+{
+  m_stops++;
+  m_ok &= Simulator::GetDelayLeft (m_stopping) == MicroSeconds (7);
+  if (m_stops == limit)
+    {
+      m_stopping.Cancel ();
+    }
+}
+
+void
+SchedulePeriodicTestCase::DoRun (void)
+{
+  m_ticks = 0;
+  m_stops = 0;
+  m_ok = true;
+  EventId tick = Simulator::SchedulePeriodic (MicroSeconds (10), &SchedulePeriodicTestCase::Tick,
+                                              this);
+  m_stopping = Simulator::SchedulePeriodic (MicroSeconds (7),
+                                            &SchedulePeriodicTestCase::Stopping, this, 5);
+  NS_TEST_EXPECT_MSG_EQ (tick.IsRunning (), true, "Series not running");
+  Simulator::Stop (MicroSeconds (105));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_ok, true, "Periodic events at the wrong time");
+  NS_TEST_EXPECT_MSG_EQ (m_ticks, 10, "Wrong number of periods");
+  NS_TEST_EXPECT_MSG_EQ (m_stops, 5, "Series not stopped by its handler");
+  NS_TEST_EXPECT_MSG_EQ (m_stopping.IsExpired (), true, "Stopped series not expired");
+  NS_TEST_EXPECT_MSG_EQ (tick.IsRunning (), true, "Series not running");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetDelayLeft (tick), MicroSeconds (5), "Wrong delay left");
+
+  tick.Remove ();
+  NS_TEST_EXPECT_MSG_EQ (tick.IsExpired (), true, "Removed series not expired");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_ticks, 10, "Removed series still running");
+  Simulator::Destroy ();
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -483,5 +842,24 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (ListScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new ScheduleBatchTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new ScheduleBatchTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SchedulePeriodicTestCase (), TestCase::QUICK);
+
+    AddTestCase (new EventProfilerTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -24,6 +24,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <cmath>
 
 #include "ns3/nstime.h"
 #include "ns3/int64x64.h"
@@ -226,6 +227,62 @@ TimeInputOutputTestCase::DoRun (void)
   std::cout << std::endl;
 }
 
+class TimeFastDoubleTestCase : public TestCase
+{
+public:
+  TimeFastDoubleTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Check (double value, enum Time::Unit unit);
+};
+
+TimeFastDoubleTestCase::TimeFastDoubleTestCase ()
+  : TestCase ("Double conversions match the int64x64_t conversions")
+{}
+
+void
+TimeFastDoubleTestCase::Check (double value, enum Time::Unit unit)
+{
+  Time fast = Time::FromDouble (value, unit);
+  Time slow = Time::From (int64x64_t (value), unit);
+  NS_TEST_ASSERT_MSG_EQ (fast.GetTimeStep (), slow.GetTimeStep (),
+                         "FromDouble (" << value << ", " << unit << ")");
+
+  // To has an absolute resolution of 2^-64, and ToDouble a relative one
+  double fastValue = fast.ToDouble (unit);
+  double slowValue = fast.To (unit).GetDouble ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (fastValue, slowValue, std::fabs (slowValue) * 1e-15 + 1e-18,
+                             "ToDouble (" << fast << ", " << unit << ")");
+}
+
+void
+TimeFastDoubleTestCase::DoRun (void)
+{
+  const double values[] = {
+    0, 1, -1, 0.3, -0.3, 1.1, -1.1, 0.1, 2.5e-9, 1e-9, 1.0 / 2048,
+    123456.789, -987654.321, 4503599.627370496, 0.999999999, 1e6 + 0.5e-9
+  };
+  const enum Time::Unit units[] = {
+    Time::D, Time::H, Time::MIN, Time::S, Time::MS, Time::US, Time::NS, Time::PS
+  };
+  for (std::size_t u = 0; u < sizeof (units) / sizeof (units[0]); ++u)
+    {
+      for (std::size_t v = 0; v < sizeof (values) / sizeof (values[0]); ++v)
+        {
+          Check (values[v], units[u]);
+        }
+      // Fractions with all their mantissa bits set
+      uint64_t state = 12345;
+      for (int i = 0; i < 1000; ++i)
+        {
+          state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+          double value = static_cast<double> (state >> 11) / (1ULL << 53) * 1000 - 500;
+          Check (value, units[u]);
+        }
+    }
+}
+
 static class TimeTestSuite : public TestSuite
 {
 public:
@@ -234,6 +291,7 @@ public:
   {
     AddTestCase (new TimeWithSignTestCase (), TestCase::QUICK);
     AddTestCase (new TimeInputOutputTestCase (), TestCase::QUICK);
+    AddTestCase (new TimeFastDoubleTestCase (), TestCase::QUICK);
     // This should be last, since it changes the resolution
     AddTestCase (new TimeSimpleTestCase (), TestCase::QUICK);
   }
@@ -20,6 +20,8 @@
 #include "ns3/traced-callback.h"
 #include "ns3/unused.h"
 
+#include <vector>
+
 using namespace ns3;
 
 class BasicTracedCallbackTestCase : public TestCase
@@ -113,6 +115,90 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ChainTracedCallbackTestCase : public TestCase
+{
+public:
+  ChainTracedCallbackTestCase ();
+  virtual ~ChainTracedCallbackTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+
+  static void Cb (std::vector<int> *calls, int id, int value);
+  void CbConnect (int value);
+
+  TracedCallback<int> m_trace;
+  std::vector<int> m_calls;
+};
+
+ChainTracedCallbackTestCase::ChainTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback chain order and changes")
+{}
+
+void
+ChainTracedCallbackTestCase::Cb (std::vector<int> *calls, int id, int value)
+{
+  NS_UNUSED (value);
+  calls->push_back (id);
+}
+
+void
+ChainTracedCallbackTestCase::CbConnect (int value)
+{
+  NS_UNUSED (value);
+  m_calls.push_back (0);
+  m_trace.ConnectWithoutContext (MakeBoundCallback (&ChainTracedCallbackTestCase::Cb, &m_calls, 9));
+}
+
+void
+ChainTracedCallbackTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New chain not empty");
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls.size (), 0, "Empty chain called something");
+
+  //
+  // Callbacks are called in the order they were connected.
+  //
+  for (int id = 1; id <= 4; ++id)
+    {
+      m_trace.ConnectWithoutContext (MakeBoundCallback (&Cb, &m_calls, id));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "Chain empty after Connect");
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls.size (), 4, "Wrong number of calls");
+  for (int id = 1; id <= 4; ++id)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_calls[id - 1], id, "Wrong call order");
+    }
+
+  //
+  // Disconnecting the first Callback keeps the order of the others.
+  //
+  m_trace.DisconnectWithoutContext (MakeBoundCallback (&Cb, &m_calls, 1));
+  m_trace.DisconnectWithoutContext (MakeBoundCallback (&Cb, &m_calls, 3));
+  m_calls.clear ();
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls.size (), 2, "Wrong number of calls after Disconnect");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[0], 2, "Wrong first call after Disconnect");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[1], 4, "Wrong second call after Disconnect");
+
+  m_trace.DisconnectWithoutContext (MakeBoundCallback (&Cb, &m_calls, 2));
+  m_trace.DisconnectWithoutContext (MakeBoundCallback (&Cb, &m_calls, 4));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "Chain not empty after Disconnect");
+
+  //
+  // A Callback connected by a Callback is called by the same invocation.
+  //
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbConnect, this));
+  m_calls.clear ();
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls.size (), 2, "Wrong number of calls with Connect");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[0], 0, "Connecting Callback not called");
+  NS_TEST_ASSERT_MSG_EQ (m_calls[1], 9, "Connected Callback not called");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -123,6 +209,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ChainTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
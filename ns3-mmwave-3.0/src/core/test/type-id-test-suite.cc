@@ -334,6 +334,86 @@ DeprecatedAttributeTestCase::DoRun (void)
 }
 
 
+//----------------------------
+//
+// Indexed lookup test
+
+class IndexedLookupTestCase : public TestCase
+{
+public:
+  IndexedLookupTestCase ();
+  virtual ~IndexedLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+};
+
+IndexedLookupTestCase::IndexedLookupTestCase ()
+  : TestCase ("Check name lookups through the flattened attribute tables")
+{}
+
+IndexedLookupTestCase::~IndexedLookupTestCase ()
+{}
+
+void
+IndexedLookupTestCase::DoRun (void)
+{
+  TypeId parent = DeprecatedAttribute::GetTypeId ();
+  TypeId tid = TypeId ("IndexedLookupDerived")
+    .SetParent (parent)
+    .AddAttribute ("derivedAttribute",
+                   "an attribute of the derived type",
+                   EmptyAttributeValue (),
+                   MakeEmptyAttributeAccessor (),
+                   MakeEmptyAttributeChecker ());
+
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByName ("IndexedLookupDerived"), tid,
+                         "lookup by name");
+  TypeId found;
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByNameFailSafe ("IndexedLookupMissing", &found),
+                         false, "lookup of an unknown name");
+
+  struct TypeId::AttributeInformation ainfo;
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("derivedAttribute", &ainfo), true,
+                         "lookup own attribute");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.name, "derivedAttribute", "own attribute name");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("attribute", &ainfo), true,
+                         "lookup inherited attribute");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.name, "attribute", "inherited attribute name");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("lateAttribute", &ainfo), false,
+                         "lookup of an unknown attribute");
+  NS_TEST_ASSERT_MSG_EQ (parent.LookupAttributeByName ("derivedAttribute", &ainfo),
+                         false, "derived attribute is not visible from the parent");
+
+  struct TypeId::TraceSourceInformation tinfo;
+  NS_TEST_ASSERT_MSG_NE (tid.LookupTraceSourceByName ("trace", &tinfo), 0,
+                         "lookup inherited trace source");
+  NS_TEST_ASSERT_MSG_EQ (tinfo.name, "trace", "inherited trace source name");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupTraceSourceByName ("lateTrace"), 0,
+                         "lookup of an unknown trace source");
+
+  // Tables built by the lookups above must see later additions
+  tid.AddAttribute ("lateAttribute",
+                    "an attribute added after a lookup",
+                    EmptyAttributeValue (),
+                    MakeEmptyAttributeAccessor (),
+                    MakeEmptyAttributeChecker ());
+  tid.AddTraceSource ("lateTrace",
+                      "a trace source added after a lookup",
+                      MakeEmptyTraceSourceAccessor (),
+                      "ns3::TracedValueCallback::Void");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("lateAttribute", &ainfo), true,
+                         "lookup of an attribute added after a lookup");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.name, "lateAttribute", "late attribute name");
+  // The empty accessor is null, so check the returned information instead
+  tinfo.name = "";
+  tid.LookupTraceSourceByName ("lateTrace", &tinfo);
+  NS_TEST_ASSERT_MSG_EQ (tinfo.name, "lateTrace",
+                         "lookup of a trace source added after a lookup");
+}
+
+
 //----------------------------
 //
 // Performance test
@@ -447,6 +527,7 @@ TypeIdTestSuite::TypeIdTestSuite ()
   AddTestCase (new UniqueTypeIdTestCase, QUICK);
   AddTestCase (new CollisionTestCase, QUICK);
   AddTestCase (new DeprecatedAttributeTestCase, QUICK);
+  AddTestCase (new IndexedLookupTestCase, QUICK);
 }
 
 static TypeIdTestSuite g_TypeIdTestSuite;
@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/windowed-simulator-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Check that the windowed simulator executes, for every context,
+ * the same events at the same times, whatever the number of threads.
+ * Every context only writes to its own slot of the result vectors.
+ */
+class WindowedSimulatorEventsTestCase : public TestCase
+{
+public:
+  WindowedSimulatorEventsTestCase (uint32_t threads);
+  /**
+   * A periodic event of one context.
+   * \param [in] step The step number.
+   */
+  void Tick (uint32_t step);
+  /**
+   * An event scheduled at the current time by Tick.
+   * \param [in] ts The expected timestamp.
+   */
+  void SameContext (uint64_t ts);
+  /**
+   * An event scheduled at the current time by a neighbour context.
+   * \param [in] ts The expected timestamp.
+   */
+  void Neighbour (uint64_t ts);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_threads;
+  std::vector<uint32_t> m_ticks;
+  std::vector<uint32_t> m_nows;
+  std::vector<uint32_t> m_neighbours;
+  std::vector<int> m_ok;  // not vector<bool>, written concurrently
+};
+
+static const uint32_t N_CONTEXTS = 16;
+static const uint32_t N_STEPS = 100;
+
+WindowedSimulatorEventsTestCase::WindowedSimulatorEventsTestCase (uint32_t threads)
+  : TestCase ("Check windowed event handling with " +
+              std::to_string (threads) + " threads"),
+    m_threads (threads)
+{}
+
+void
+WindowedSimulatorEventsTestCase::Tick (uint32_t step)
+{
+  uint32_t context = Simulator::GetContext ();
+  uint64_t ts = Simulator::Now ().GetMicroSeconds ();
+  if (ts != step * 10 || m_ticks[context] != step)
+    {
+      m_ok[context] = 0;
+    }
+  m_ticks[context]++;
+  Simulator::ScheduleNow (&WindowedSimulatorEventsTestCase::SameContext, this,
+                          Simulator::Now ().GetTimeStep ());
+  Simulator::ScheduleWithContext ((context + 1) % N_CONTEXTS, Seconds (0),
+                                  &WindowedSimulatorEventsTestCase::Neighbour, this,
+                                  Simulator::Now ().GetTimeStep ());
+  if (step + 1 < N_STEPS)
+    {
+      Simulator::Schedule (MicroSeconds (10), &WindowedSimulatorEventsTestCase::Tick,
+                           this, step + 1);
+    }
+}
+
+void
+WindowedSimulatorEventsTestCase::SameContext (uint64_t ts)
+{
+  uint32_t context = Simulator::GetContext ();
+  if (Simulator::Now ().GetTimeStep () != (int64_t)ts)
+    {
+      m_ok[context] = 0;
+    }
+  m_nows[context]++;
+}
+
+void
+WindowedSimulatorEventsTestCase::Neighbour (uint64_t ts)
+{
+  uint32_t context = Simulator::GetContext ();
+  if (Simulator::Now ().GetTimeStep () != (int64_t)ts)
+    {
+      m_ok[context] = 0;
+    }
+  m_neighbours[context]++;
+}
+
+void
+WindowedSimulatorEventsTestCase::DoRun (void)
+{
+  m_ticks.assign (N_CONTEXTS, 0);
+  m_nows.assign (N_CONTEXTS, 0);
+  m_neighbours.assign (N_CONTEXTS, 0);
+  m_ok.assign (N_CONTEXTS, 1);
+
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::WindowedSimulatorImpl");
+  factory.Set ("Threads", UintegerValue (m_threads));
+  Ptr<WindowedSimulatorImpl> impl = factory.Create<WindowedSimulatorImpl> ();
+  Simulator::SetImplementation (impl);
+
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      Simulator::ScheduleWithContext (i, Seconds (0),
+                                      &WindowedSimulatorEventsTestCase::Tick, this, 0);
+    }
+  Simulator::Run ();
+
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_ok[i], 1, "Bad event time or order in context " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_ticks[i], N_STEPS, "Missing periodic events");
+      NS_TEST_EXPECT_MSG_EQ (m_nows[i], N_STEPS, "Missing same-context events");
+      NS_TEST_EXPECT_MSG_EQ (m_neighbours[i], N_STEPS, "Missing cross-context events");
+    }
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventCount (), 3 * N_STEPS * N_CONTEXTS,
+                         "Wrong event count");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetWindowCount (), 2 * N_STEPS, "Wrong window count");
+  if (m_threads > 1)
+    {
+      NS_TEST_EXPECT_MSG_EQ (impl->GetParallelWindowCount (), N_STEPS,
+                             "Only the dependent windows should be serialized");
+      NS_TEST_EXPECT_MSG_EQ (impl->GetDependencyCount (), N_STEPS * N_CONTEXTS,
+                             "Wrong number of cross-context dependencies");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (impl->GetParallelWindowCount (), 0u,
+                             "A single thread should never run windows in parallel");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that Simulator::Stop leaves the rest of the window in the
+ * event list, and that a later Run resumes it.
+ */
+class WindowedSimulatorStopTestCase : public TestCase
+{
+public:
+  WindowedSimulatorStopTestCase ();
+  /** Count an event, stopping the simulator on the first one. */
+  void Event (void);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_count;
+};
+
+WindowedSimulatorStopTestCase::WindowedSimulatorStopTestCase ()
+  : TestCase ("Check Simulator::Stop in the middle of a window")
+{}
+
+void
+WindowedSimulatorStopTestCase::Event (void)
+{
+  if (m_count++ == 0)
+    {
+      Simulator::Stop ();
+    }
+}
+
+void
+WindowedSimulatorStopTestCase::DoRun (void)
+{
+  m_count = 0;
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::WindowedSimulatorImpl");
+  Simulator::SetImplementation (factory.Create<WindowedSimulatorImpl> ());
+
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      Simulator::Schedule (MicroSeconds (1), &WindowedSimulatorStopTestCase::Event, this);
+    }
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_count, 1, "Stop did not interrupt the window");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsFinished (), true, "Simulator should be stopped");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_count, 4, "The window was not resumed");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MicroSeconds (1), "Bad resume time");
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that a second Run uses the worker threads again, or restarts
+ * them when the number of threads changed.
+ */
+class WindowedSimulatorRestartTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] threads The number of threads of the first Run.
+   * \param [in] restartThreads The number of threads of the second Run.
+   */
+  WindowedSimulatorRestartTestCase (uint32_t threads, uint32_t restartThreads);
+  /** Count an event of the current context. */
+  void Event (void);
+  /** Let the worker threads start before the first parallel window. */
+  void Pause (void);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_threads;
+  uint32_t m_restartThreads;
+  std::vector<uint32_t> m_counts;
+};
+
+WindowedSimulatorRestartTestCase::WindowedSimulatorRestartTestCase (uint32_t threads,
+                                                                    uint32_t restartThreads)
+  : TestCase ("Check a second Run with " + std::to_string (threads) + " then " +
+              std::to_string (restartThreads) + " threads"),
+    m_threads (threads),
+    m_restartThreads (restartThreads)
+{}
+
+void
+WindowedSimulatorRestartTestCase::Event (void)
+{
+  m_counts[Simulator::GetContext ()]++;
+}
+
+void
+WindowedSimulatorRestartTestCase::Pause (void)
+{
+  std::this_thread::sleep_for (std::chrono::milliseconds (20));
+}
+
+void
+WindowedSimulatorRestartTestCase::DoRun (void)
+{
+  m_counts.assign (N_CONTEXTS, 0);
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::WindowedSimulatorImpl");
+  factory.Set ("Threads", UintegerValue (m_threads));
+  Ptr<WindowedSimulatorImpl> impl = factory.Create<WindowedSimulatorImpl> ();
+  Simulator::SetImplementation (impl);
+
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      for (uint32_t step = 1; step <= N_STEPS; ++step)
+        {
+          Simulator::ScheduleWithContext (i, MicroSeconds (step),
+                                          &WindowedSimulatorRestartTestCase::Event, this);
+        }
+    }
+  Simulator::Stop (NanoSeconds (N_STEPS / 2 * 1000 + 500));
+  Simulator::Run ();
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_counts[i], N_STEPS / 2, "Wrong events before the stop in context " << i);
+    }
+  uint64_t parallelWindows = impl->GetParallelWindowCount ();
+
+  impl->SetAttribute ("Threads", UintegerValue (m_restartThreads));
+  // A serial window, before the parallel ones
+  Simulator::Schedule (NanoSeconds (100), &WindowedSimulatorRestartTestCase::Pause, this);
+  Simulator::Run ();
+  for (uint32_t i = 0; i < N_CONTEXTS; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_counts[i], N_STEPS, "Wrong events after the restart in context " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (impl->GetParallelWindowCount (), parallelWindows + N_STEPS / 2,
+                         "The second Run should run its windows in parallel");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventCount (), N_STEPS * N_CONTEXTS + 2,
+                         "Wrong event count");
+  Simulator::Destroy ();
+}
+
+class WindowedSimulatorTestSuite : public TestSuite
+{
+public:
+  WindowedSimulatorTestSuite ()
+    : TestSuite ("windowed-simulator")
+  {
+    AddTestCase (new WindowedSimulatorEventsTestCase (1), TestCase::QUICK);
+    AddTestCase (new WindowedSimulatorEventsTestCase (2), TestCase::QUICK);
+    AddTestCase (new WindowedSimulatorEventsTestCase (4), TestCase::QUICK);
+    AddTestCase (new WindowedSimulatorStopTestCase (), TestCase::QUICK);
+    AddTestCase (new WindowedSimulatorRestartTestCase (2, 2), TestCase::QUICK);
+    AddTestCase (new WindowedSimulatorRestartTestCase (2, 4), TestCase::QUICK);
+  }
+} g_windowedSimulatorTestSuite;
@@ -1031,7 +1031,7 @@ LteSpectrumPhy::EndRxData ()
     for (std::list<Ptr<PacketBurst> >::const_iterator i = m_rxPacketBurstList.begin ();
     i != m_rxPacketBurstList.end (); ++i)
       {
-        for (std::list<Ptr<Packet> >::const_iterator j = (*i)->Begin (); j != (*i)->End (); ++j)
+        for (PacketBurst::Iterator j = (*i)->Begin (); j != (*i)->End (); ++j)
           {
             // retrieve TB info of this packet
             LteRadioBearerTag tag;
@@ -793,7 +793,7 @@ LteUeMac::DoReceiveLteControlMessage (Ptr<LteControlMessage> msg)
           // HARQ retransmission -> retrieve data from HARQ buffer
           NS_LOG_DEBUG (this << " UE MAC RETX HARQ " << (uint16_t)m_harqProcessId);
           Ptr<PacketBurst> pb = m_miUlHarqProcessesPacket.at (m_harqProcessId);
-          for (std::list<Ptr<Packet> >::const_iterator j = pb->Begin (); j != pb->End (); ++j)
+          for (PacketBurst::Iterator j = pb->Begin (); j != pb->End (); ++j)
             {
               Ptr<Packet> pkt = (*j)->Copy ();
               m_uePhySapProvider->SendMacPdu (pkt);
@@ -997,7 +997,7 @@ MmWaveEnbMac::DoSchedConfigIndication (MmWaveMacSchedSapUser::SchedConfigIndPara
                       std::map <uint16_t, MmWaveDlHarqProcessesBuffer_t>::iterator it = m_miDlHarqProcessesPackets.find (rnti);
                       NS_ASSERT (it != m_miDlHarqProcessesPackets.end ());
                       Ptr<PacketBurst> pb = it->second.at (tbUid).m_pktBurst;
-                      for (std::list<Ptr<Packet> >::const_iterator j = pb->Begin (); j != pb->End (); ++j)
+                      for (PacketBurst::Iterator j = pb->Begin (); j != pb->End (); ++j)
                         {
                           Ptr<Packet> pkt = (*j)->Copy ();
                           MmWaveMacPduTag tag;                                                                          // update PDU tag for retransmission
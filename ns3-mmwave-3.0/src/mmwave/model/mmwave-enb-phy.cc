@@ -1035,7 +1035,7 @@ MmWaveEnbPhy::StartTti (void)
       Ptr<PacketBurst> pktBurst = GetPacketBurst (SfnSf (m_frameNum, m_sfNum, m_slotNum, currTti.m_dci.m_symStart));
       if (pktBurst && pktBurst->GetNPackets () > 0)
         {
-          std::list< Ptr<Packet> > pkts = pktBurst->GetPackets ();
+          const std::vector<Ptr<Packet> > &pkts = pktBurst->GetPackets ();
           MmWaveMacPduTag macTag;
           pkts.front ()->PeekPacketTag (macTag);
           NS_ASSERT ((macTag.GetSfn ().m_frameNum == m_frameNum) && (macTag.GetSfn ().m_sfNum == m_sfNum)
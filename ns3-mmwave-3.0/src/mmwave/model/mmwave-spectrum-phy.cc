@@ -602,7 +602,7 @@ MmWaveSpectrumPhy::EndRxData ()
   std::map <uint16_t, DlHarqInfo> harqDlInfoMap;
   for (std::list<Ptr<PacketBurst> >::const_iterator i = m_rxPacketBurstList.begin (); i != m_rxPacketBurstList.end (); ++i)
     {
-      for (std::list<Ptr<Packet> >::const_iterator j = (*i)->Begin (); j != (*i)->End (); ++j)
+      for (PacketBurst::Iterator j = (*i)->Begin (); j != (*i)->End (); ++j)
         {
           if ((*j)->GetSize () == 0)
             {
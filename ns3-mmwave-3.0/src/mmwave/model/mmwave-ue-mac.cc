@@ -878,7 +878,7 @@ MmWaveUeMac::DoReceiveControlMessage  (Ptr<MmWaveControlMessage> msg)
                 // HARQ retransmission -> retrieve data from HARQ buffer
                 NS_LOG_DEBUG (this << " UE MAC RETX HARQ " << (unsigned)dciInfoElem.m_harqProcess);
                 Ptr<PacketBurst> pb = m_miUlHarqProcessesPacket.at (dciInfoElem.m_harqProcess).m_pktBurst;
-                for (std::list<Ptr<Packet> >::const_iterator j = pb->Begin (); j != pb->End (); ++j)
+                for (PacketBurst::Iterator j = pb->Begin (); j != pb->End (); ++j)
                   {
                     Ptr<Packet> pkt = (*j)->Copy ();
                     // update packet tag
@@ -585,7 +585,7 @@ MmWaveUePhy::StartTti ()
       Ptr<PacketBurst> pktBurst = GetPacketBurst (SfnSf (m_frameNum, m_sfNum, m_slotNum, currTti.m_dci.m_symStart));
       if (pktBurst && pktBurst->GetNPackets () > 0)
         {
-          std::list< Ptr<Packet> > pkts = pktBurst->GetPackets ();
+          const std::vector<Ptr<Packet> > &pkts = pktBurst->GetPackets ();
           MmWaveMacPduTag tag;
           pkts.front ()->PeekPacketTag (tag);
           NS_ASSERT ((tag.GetSfn ().m_frameNum == m_frameNum) && (tag.GetSfn ().m_sfNum == m_sfNum)
@@ -103,6 +103,7 @@ DistributedSimulatorImpl::DistributedSimulatorImpl ()
   // uid 0 is "invalid" events
   // uid 1 is "now" events
   // uid 2 is "destroy" events
+  // uid 3 is "periodic" series, see Simulator::SchedulePeriodic
   m_uid = 4;
   // before ::Run is entered, the m_currentUid will be zero
   m_currentUid = 0;
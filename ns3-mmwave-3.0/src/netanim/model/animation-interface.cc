@@ -1112,9 +1112,8 @@ AnimationInterface::LteSpectrumPhyTxStart (std::string context, Ptr<const Packet
   NS_ASSERT (ndev);
   UpdatePosition (ndev);
 
-  std::list <Ptr <Packet> > pbList = pb->GetPackets ();
-  for (std::list <Ptr <Packet> >::iterator i  = pbList.begin ();
-       i != pbList.end ();
+  for (PacketBurst::Iterator i = pb->Begin ();
+       i != pb->End ();
        ++i)
     {
       Ptr <Packet> p = *i;
@@ -1142,9 +1141,8 @@ AnimationInterface::LteSpectrumPhyRxStart (std::string context, Ptr<const Packet
   NS_ASSERT (ndev);
   UpdatePosition (ndev);
 
-  std::list <Ptr <Packet> > pbList = pb->GetPackets ();
-  for (std::list <Ptr <Packet> >::iterator i  = pbList.begin ();
-       i != pbList.end ();
+  for (PacketBurst::Iterator i = pb->Begin ();
+       i != pb->End ();
        ++i)
     {
       Ptr <Packet> p = *i;
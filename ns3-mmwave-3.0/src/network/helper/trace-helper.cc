@@ -28,6 +28,7 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/pointer.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +36,16 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+//
+// The devices create their trace files in their EnablePcapInternal and
+// EnableAsciiInternal, with CreateFile and CreateFileStream.  These are
+// the filters of the helper enabling the traces, set by
+// PcapHelperForDevice::EnablePcap and AsciiTraceHelperForDevice::EnableAsciiImpl
+// around these calls, to attach to the files created.
+//
+static Ptr<TraceFilter> g_pcapFilter;   //!< Filter of the pcap files being created
+static Ptr<TraceFilter> g_asciiFilter;  //!< Filter of the ascii files being created
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -62,6 +73,11 @@ PcapHelper::CreateFile (
   file->Init (dataLinkType, snapLen, tzCorrection);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Init " << filename);
 
+  if (g_pcapFilter != 0)
+    {
+      file->SetAttribute ("Filter", PointerValue (g_pcapFilter));
+    }
+
   //
   // Note that the pcap helper promptly forgets all about the pcap file.  We
   // rely on the reference count of the file object which will soon be owned
@@ -193,6 +209,7 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
   NS_LOG_FUNCTION (filename << filemode);
 
   Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper> (filename, filemode);
+  StreamWrapper->SetFilter (g_asciiFilter);
 
   //
   // Note that the ascii trace helper promptly forgets all about the trace file.
@@ -310,6 +327,10 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (stream->GetFilter () != 0 && !stream->GetFilter ()->Accept (p))
+    {
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -317,6 +338,10 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (stream->GetFilter () != 0 && !stream->GetFilter ()->Accept (p))
+    {
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -336,6 +361,10 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (stream->GetFilter () != 0 && !stream->GetFilter ()->Accept (p))
+    {
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -343,6 +372,10 @@ void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (stream->GetFilter () != 0 && !stream->GetFilter ()->Accept (p))
+    {
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -363,6 +396,10 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (stream->GetFilter () != 0 && !stream->GetFilter ()->Accept (p))
+    {
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -370,6 +407,10 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (stream->GetFilter () != 0 && !stream->GetFilter ()->Accept (p))
+    {
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -387,6 +428,10 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (stream->GetFilter () != 0 && !stream->GetFilter ()->Accept (p))
+    {
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -394,13 +439,25 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (stream->GetFilter () != 0 && !stream->GetFilter ()->Accept (p))
+    {
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
 void 
 PcapHelperForDevice::EnablePcap (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
 {
+  g_pcapFilter = m_traceFilter;
   EnablePcapInternal (prefix, nd, promiscuous, explicitFilename);
+  g_pcapFilter = 0;
+}
+
+void
+PcapHelperForDevice::SetPcapFilter (Ptr<TraceFilter> filter)
+{
+  m_traceFilter = filter;
 }
 
 void 
@@ -468,7 +525,7 @@ PcapHelperForDevice::EnablePcap (std::string prefix, uint32_t nodeid, uint32_t d
 void 
 AsciiTraceHelperForDevice::EnableAscii (std::string prefix, Ptr<NetDevice> nd, bool explicitFilename)
 {
-  EnableAsciiInternal (Ptr<OutputStreamWrapper> (), prefix, nd, explicitFilename);
+  EnableAsciiImpl (Ptr<OutputStreamWrapper> (), prefix, nd, explicitFilename);
 }
 
 //
@@ -477,7 +534,7 @@ AsciiTraceHelperForDevice::EnableAscii (std::string prefix, Ptr<NetDevice> nd, b
 void 
 AsciiTraceHelperForDevice::EnableAscii (Ptr<OutputStreamWrapper> stream, Ptr<NetDevice> nd)
 {
-  EnableAsciiInternal (stream, std::string (), nd, false);
+  EnableAsciiImpl (stream, std::string (), nd, false);
 }
 
 //
@@ -509,7 +566,33 @@ AsciiTraceHelperForDevice::EnableAsciiImpl (
   bool explicitFilename)
 {
   Ptr<NetDevice> nd = Names::Find<NetDevice> (ndName);
+  EnableAsciiImpl (stream, prefix, nd, explicitFilename);
+}
+
+//
+// Private API
+//
+void
+AsciiTraceHelperForDevice::EnableAsciiImpl (
+  Ptr<OutputStreamWrapper> stream,
+  std::string prefix,
+  Ptr<NetDevice> nd,
+  bool explicitFilename)
+{
+  // Only the streams created by CreateFileStream get the filter: those
+  // passed in may be shared with other helpers
+  g_asciiFilter = m_traceFilter;
   EnableAsciiInternal (stream, prefix, nd, explicitFilename);
+  g_asciiFilter = 0;
+}
+
+//
+// Public API
+//
+void
+AsciiTraceHelperForDevice::SetAsciiFilter (Ptr<TraceFilter> filter)
+{
+  m_traceFilter = filter;
 }
 
 //
@@ -539,7 +622,7 @@ AsciiTraceHelperForDevice::EnableAsciiImpl (Ptr<OutputStreamWrapper> stream, std
   for (NetDeviceContainer::Iterator i = d.Begin (); i != d.End (); ++i)
     {
       Ptr<NetDevice> dev = *i;
-      EnableAsciiInternal (stream, prefix, dev, false);
+      EnableAsciiImpl (stream, prefix, dev, false);
     }
 }
 
@@ -645,7 +728,7 @@ AsciiTraceHelperForDevice::EnableAsciiImpl (
 
       Ptr<NetDevice> nd = node->GetDevice (deviceid);
 
-      EnableAsciiInternal (stream, prefix, nd, explicitFilename);
+      EnableAsciiImpl (stream, prefix, nd, explicitFilename);
       return;
     }
 }
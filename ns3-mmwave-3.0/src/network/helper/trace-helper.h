@@ -25,6 +25,7 @@
 #include "ns3/simulator.h"
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/output-stream-wrapper.h"
+#include "ns3/trace-filter.h"
 
 namespace ns3 {
 
@@ -632,6 +633,20 @@ public:
    * @param promiscuous If true capture all possible packets available at the device.
    */
   void EnablePcapAll (std::string prefix, bool promiscuous = false);
+
+  /**
+   * @brief Set the filter of the pcap files created by the following calls
+   * to EnablePcap.
+   *
+   * The filter selects the packets written to the files (see TraceFilter);
+   * it is shared by all the files, and so is its budget.
+   *
+   * @param filter the filter, or null to write all the packets
+   */
+  void SetPcapFilter (Ptr<TraceFilter> filter);
+
+private:
+  Ptr<TraceFilter> m_traceFilter; //!< Filter of the pcap files
 };
 
 /**
@@ -798,6 +813,20 @@ public:
    */
   void EnableAscii (Ptr<OutputStreamWrapper> stream, uint32_t nodeid, uint32_t deviceid);
 
+  /**
+   * @brief Set the filter of the ascii traces enabled by the following calls
+   * to EnableAscii.
+   *
+   * The filter selects the packets written by the default sinks of the
+   * AsciiTraceHelper (see TraceFilter); it is shared by all the traces, and
+   * so is its budget.  It is set on the files created by EnableAscii, not
+   * on the streams passed to it, which may be shared with other helpers:
+   * set their filter with OutputStreamWrapper::SetFilter.
+   *
+   * @param filter the filter, or null to write all the packets
+   */
+  void SetAsciiFilter (Ptr<TraceFilter> filter);
+
 private:
   /**
    * @brief Enable ascii trace output on the device specified by a global
@@ -863,6 +892,8 @@ private:
    * @param explicitFilename Treat the prefix as an explicit filename if true
    */
   void EnableAsciiImpl (Ptr<OutputStreamWrapper> stream, std::string prefix, Ptr<NetDevice> nd, bool explicitFilename);
+
+  Ptr<TraceFilter> m_traceFilter; //!< Filter of the ascii traces
 };
 
 } // namespace ns3
@@ -24,6 +24,7 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
+#include "size-class-pool.h"
 
 #define BUFFER_FREE_LIST 1
 
@@ -38,9 +39,10 @@ namespace ns3 {
  * automatically adjusted to hold any data prepended
  * or appended by the user. Its implementation is optimized
  * to ensure that the number of buffer resizes is minimized,
- * by creating new Buffers of the maximum size ever used.
- * The correct maximum size is learned at runtime during use by 
- * recording the maximum size of each packet.
+ * by creating new Buffers with room for the largest headers ever
+ * added in front of the payload.  The correct size is learned at
+ * runtime during use by recording the headers added to each packet.
+ * The memory comes from a per-thread SizeClassPool.
  *
  * \internal
  * The implementation of the Buffer class uses a COW (Copy On Write)
@@ -642,6 +644,18 @@ private:
    */
   Buffer (uint32_t dataSize, bool initialize);
   ~Buffer ();
+
+  /**
+   * \brief Get the statistics of the pool of buffer data storages
+   * of the calling thread.
+   *
+   * The data storages are allocated from a SizeClassPool, which keeps
+   * the storages freed by each thread, by size class, for its next
+   * allocations.
+   *
+   * \returns the statistics of the pool.
+   */
+  static SizeClassPoolStats GetPoolStats (void);
 private:
   /**
    * This data structure is variable-sized through its last member whose size
@@ -790,18 +804,6 @@ private:
    */
   uint32_t m_end;
 
-#ifdef BUFFER_FREE_LIST
-  /// Container for buffer data
-  typedef std::vector<struct Buffer::Data*> FreeList;
-  /// Local static destructor structure
-  struct LocalStaticDestructor 
-  {
-    ~LocalStaticDestructor ();
-  };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
-#endif
 };
 
 } // namespace ns3
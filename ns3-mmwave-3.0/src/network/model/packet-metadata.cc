@@ -34,19 +34,7 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
-
-PacketMetadata::DataFreeList::~DataFreeList ()
-{
-  NS_LOG_FUNCTION (this);
-  for (iterator i = begin (); i != end (); i++)
-    {
-      PacketMetadata::Deallocate (*i);
-    }
-  PacketMetadata::m_enable = false;
-}
 
 void 
 PacketMetadata::Enable (void)
@@ -570,48 +558,15 @@ struct PacketMetadata::Data *
 PacketMetadata::Create (uint32_t size)
 {
   NS_LOG_FUNCTION (size);
-  NS_LOG_LOGIC ("create size="<<size<<", max="<<m_maxSize);
-  if (size > m_maxSize)
-    {
-      m_maxSize = size;
-    }
-  while (!m_freeList.empty ()) 
-    {
-      struct PacketMetadata::Data *data = m_freeList.back ();
-      m_freeList.pop_back ();
-      if (data->m_size >= size) 
-        {
-          NS_LOG_LOGIC ("create found size="<<data->m_size);
-          data->m_count = 1;
-          return data;
-        }
-      NS_LOG_LOGIC ("create dealloc size="<<data->m_size);
-      PacketMetadata::Deallocate (data);
-    }
-  NS_LOG_LOGIC ("create alloc size="<<m_maxSize);
-  return PacketMetadata::Allocate (m_maxSize);
+  return PacketMetadata::Allocate (size);
 }
 
 void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  if (!m_enable)
-    {
-      PacketMetadata::Deallocate (data);
-      return;
-    } 
-  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
   NS_ASSERT (data->m_count == 0);
-  if (m_freeList.size () > 1000 ||
-      data->m_size < m_maxSize) 
-    {
-      PacketMetadata::Deallocate (data);
-    } 
-  else 
-    {
-      m_freeList.push_back (data);
-    }
+  PacketMetadata::Deallocate (data);
 }
 
 struct PacketMetadata::Data *
@@ -624,9 +579,9 @@ PacketMetadata::Allocate (uint32_t n)
       n = PACKET_METADATA_DATA_M_DATA_SIZE;
     }
   size += n - PACKET_METADATA_DATA_M_DATA_SIZE;
-  uint8_t *buf = new uint8_t [size];
+  uint8_t *buf = SizeClassPool<PacketMetadata>::Allocate (size);
   struct PacketMetadata::Data *data = (struct PacketMetadata::Data *)buf;
-  data->m_size = n;
+  data->m_size = size - sizeof (struct Data) + PACKET_METADATA_DATA_M_DATA_SIZE;
   data->m_count = 1;
   data->m_dirtyEnd = 0;
   return data;
@@ -636,8 +591,44 @@ PacketMetadata::Deallocate (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
   uint8_t *buf = (uint8_t *)data;
-  delete [] buf;
+  SizeClassPool<PacketMetadata>::Deallocate (buf, data->m_size - PACKET_METADATA_DATA_M_DATA_SIZE + sizeof (struct Data));
+}
+
+SizeClassPoolStats
+PacketMetadata::GetPoolStats (void)
+{
+  return SizeClassPool<PacketMetadata>::GetStats ();
+}
+
+#ifdef DISABLE_PACKET_METADATA
+PacketMetadata::ItemIterator
+PacketUidMetadata::BeginItem (Buffer buffer) const
+{
+  static const PacketMetadata empty (0, 0);
+  return empty.BeginItem (buffer);
+}
+
+uint32_t
+PacketUidMetadata::GetSerializedSize (void) const
+{
+  return PacketMetadata (m_packetUid, 0).GetSerializedSize ();
+}
+
+uint32_t
+PacketUidMetadata::Serialize (uint8_t* buffer, uint32_t maxSize) const
+{
+  return PacketMetadata (m_packetUid, 0).Serialize (buffer, maxSize);
+}
+
+uint32_t
+PacketUidMetadata::Deserialize (const uint8_t* buffer, uint32_t size)
+{
+  PacketMetadata metadata (0, 0);
+  uint32_t deserialized = metadata.Deserialize (buffer, size);
+  m_packetUid = metadata.GetUid ();
+  return deserialized;
 }
+#endif /* DISABLE_PACKET_METADATA */
 
 
 PacketMetadata 
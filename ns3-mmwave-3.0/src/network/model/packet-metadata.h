@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <vector>
 #include <limits>
+#include "ns3/network-config.h"
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
@@ -161,6 +162,16 @@ private:
    */
   static void EnableChecking (void);
 
+  /**
+   * \brief Get the statistics of the pool of metadata storages
+   * of the calling thread.
+   *
+   * \returns the statistics of the pool.
+   *
+   * \sa Buffer::GetPoolStats
+   */
+  static SizeClassPoolStats GetPoolStats (void);
+
   /**
    * \brief Constructor
    * \param uid packet uid
@@ -494,16 +505,6 @@ private:
     uint64_t packetUid;
   };
 
-  /**
-   * \brief Class to hold all the metadata
-   */
-  class DataFreeList : public std::vector<struct Data *>
-  {
-public:
-    ~DataFreeList ();
-  };
-
-  friend DataFreeList::~DataFreeList ();
   /// Friend class
   friend class ItemIterator;
 
@@ -661,7 +662,6 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -672,7 +672,6 @@ public:
    */
   static bool m_metadataSkipped;
 
-  static uint32_t m_maxSize; //!< maximum metadata size
   static uint16_t m_chunkUid; //!< Chunk Uid
 
   struct Data *m_data; //!< Metadata storage
@@ -687,6 +686,71 @@ public:
   uint64_t m_packetUid; //!< packet Uid
 };
 
+#ifdef DISABLE_PACKET_METADATA
+/**
+ * \ingroup packet
+ * \brief The metadata of a packet, in builds configured with
+ * --disable-packet-metadata: only the packet uid.
+ *
+ * Packet uses it in place of PacketMetadata.  The methods which record
+ * the operations on a packet do nothing, and are inlined away, so that
+ * packets neither allocate nor copy metadata.
+ */
+class PacketUidMetadata
+{
+public:
+  /**
+   * \brief Constructor
+   * \param uid packet uid
+   * \param size size of the header
+   */
+  PacketUidMetadata (uint64_t uid, uint32_t size)
+    : m_packetUid (uid)
+  {}
+  /** \copydoc PacketMetadata::AddHeader */
+  void AddHeader (Header const &header, uint32_t size) {}
+  /** \copydoc PacketMetadata::RemoveHeader */
+  void RemoveHeader (Header const &header, uint32_t size) {}
+  /** \copydoc PacketMetadata::AddTrailer */
+  void AddTrailer (Trailer const &trailer, uint32_t size) {}
+  /** \copydoc PacketMetadata::RemoveTrailer */
+  void RemoveTrailer (Trailer const &trailer, uint32_t size) {}
+  /** \copydoc PacketMetadata::AddAtEnd */
+  void AddAtEnd (PacketUidMetadata const&o) {}
+  /** \copydoc PacketMetadata::AddPaddingAtEnd */
+  void AddPaddingAtEnd (uint32_t end) {}
+  /** \copydoc PacketMetadata::RemoveAtStart */
+  void RemoveAtStart (uint32_t start) {}
+  /** \copydoc PacketMetadata::RemoveAtEnd */
+  void RemoveAtEnd (uint32_t end) {}
+  /** \copydoc PacketMetadata::CreateFragment */
+  PacketUidMetadata CreateFragment (uint32_t start, uint32_t end) const
+  {
+    return *this;
+  }
+  /** \copydoc PacketMetadata::GetUid */
+  uint64_t GetUid (void) const
+  {
+    return m_packetUid;
+  }
+  /**
+   * \brief Initialize the item iterator to the buffer begin
+   * \param buffer buffer to initialize.
+   * \returns an iterator without items.
+   */
+  PacketMetadata::ItemIterator BeginItem (Buffer buffer) const;
+  /** \copydoc PacketMetadata::GetSerializedSize */
+  uint32_t GetSerializedSize (void) const;
+  /** \copydoc PacketMetadata::Serialize */
+  uint32_t Serialize (uint8_t* buffer, uint32_t maxSize) const;
+  /** \copydoc PacketMetadata::Deserialize */
+  uint32_t Deserialize (const uint8_t* buffer, uint32_t size);
+
+private:
+  uint64_t m_packetUid; //!< packet Uid
+};
+#endif /* DISABLE_PACKET_METADATA */
+
 } // namespace ns3
 
 namespace ns3 {
@@ -20,7 +20,7 @@
 
 /**
 \file   packet-tag-list.cc
-\brief  Implements a linked list of Packet tags, including copy-on-write semantics.
+\brief  Implements the contiguous storage of Packet tags, including copy-on-write semantics.
 */
 
 #include "packet-tag-list.h"
@@ -28,277 +28,169 @@
 #include "tag.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
-#include <cstring>
+#include <algorithm>
+#include <limits>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
-PacketTagList::TagData *
-PacketTagList::CreateTagData (size_t dataSize)
+uint32_t
+PacketTagList::Find (TypeId tid) const
 {
-  NS_ASSERT_MSG (dataSize
-                 < std::numeric_limits<decltype(TagData::size)>::max (),
-                 "Requested TagData size " << dataSize
-                 << " exceeds maximum "
-                 << std::numeric_limits<decltype(TagData::size)>::max () );
-
-  void * p = std::malloc (sizeof (TagData) + dataSize - 1);
-  // The matching frees are in RemoveAll and RemoveWriter
-
-  TagData * tag = new (p) TagData;
-  tag->size = dataSize;
-  return tag;
-}
-
-bool
-PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
-{
-  TypeId tid = tag.GetInstanceTypeId ();
-  NS_LOG_FUNCTION (this << tid);
-  NS_LOG_INFO     ("looking for " << tid);
-
-  // trivial case when list is empty
-  if (m_next == 0)
+  const struct TagData *tags = GetTags ();
+  uint16_t uid = tid.GetUid ();
+  uint32_t i = 0;
+  while (i < m_nTags && tags[i].tid != uid)
     {
-      return false;
+      ++i;
     }
+  return i;
+}
 
-  bool found = false;
-
-  struct TagData ** prevNext = &m_next; // previous node's next pointer
-  struct TagData  * cur      =  m_next; // cursor to current node
-  struct TagData  * it = 0;             // utility
-
-  // Search from the head of the list until we find tid or a merge
-  while (cur != 0)
-    {
-      if (cur->count > 1)
-        {
-          // found merge
-          NS_LOG_INFO ("found initial merge before tid");
-          break;
-        }
-      else if (cur->tid == tid)
-        {
-          NS_LOG_INFO ("found tid before initial merge, calling writer");
-          found = (this->*Writer)(tag, true, cur, prevNext);
-          break;
-        }
-      else
-        {
-          // no merge or tid found yet, move on
-          prevNext = &cur->next;
-          cur      =  cur->next;
-        }
-    }  // while !found && !cow
+void
+PacketTagList::Reallocate (uint32_t nTags, uint32_t dataSize)
+{
+  NS_ASSERT_MSG (dataSize <= std::numeric_limits<decltype(TagData::offset)>::max (),
+                 "Total size of the packet tags " << dataSize
+                 << " exceeds maximum "
+                 << std::numeric_limits<decltype(TagData::offset)>::max ());
 
-  // did we find it or run out of tags?
-  if (cur == 0 || found)
+  bool fitsInline = nTags <= INLINE_TAGS && dataSize <= INLINE_DATA;
+  const struct TagData *tags = GetTags ();
+  const uint8_t *data = GetData ();
+  if (fitsInline)
     {
-      NS_LOG_INFO ("returning after header with found: " << found);
-      return found;
+      // The block is shared: take the tags back inline
+      NS_LOG_INFO ("copying the tags inline");
+      std::memcpy (m_tags, tags, m_nTags * sizeof (TagData));
+      std::memcpy (m_data, data, m_dataSize);
+      ReleaseBlock ();
+      return;
     }
 
-  // From here on out, we have to copy the list
-  // until we find tid, then link past it
+  uint32_t tagCapacity = 2 * std::max (nTags, INLINE_TAGS);
+  uint32_t dataCapacity = 2 * std::max (dataSize, INLINE_DATA);
+  NS_LOG_INFO ("spilling the tags to a block of " << tagCapacity
+               << " tags and " << dataCapacity << " bytes");
+  void *p = std::malloc (sizeof (Block) + tagCapacity * sizeof (TagData) + dataCapacity);
+  // The matching free is in ReleaseBlock
+  Block *block = static_cast<Block *> (p);
+  block->count = 1;
+  block->tagCapacity = tagCapacity;
+  block->dataCapacity = dataCapacity;
+  std::memcpy (GetBlockTags (block), tags, m_nTags * sizeof (TagData));
+  std::memcpy (GetBlockData (block), data, m_dataSize);
+  ReleaseBlock ();
+  m_block = block;
+}
 
-  // Before we do all that work, let's make sure tid really exists
-  for (it = cur; it != 0; it = it->next)
+void
+PacketTagList::RemoveAt (uint32_t i)
+{
+  NS_ASSERT (i < m_nTags);
+  NS_ASSERT (m_block == 0 || m_block->count == 1);
+  struct TagData *tags = const_cast<struct TagData *> (GetTags ());
+  uint8_t *data = const_cast<uint8_t *> (GetData ());
+  uint32_t size = tags[i].size;
+  uint32_t end = tags[i].offset + size;
+  if (end < m_dataSize)
     {
-      if (it->tid == tid)
-        {
-          break;
-        }
+      std::memmove (data + tags[i].offset, data + end, m_dataSize - end);
     }
-  if (it == 0)
+  for (uint32_t j = i + 1; j < m_nTags; ++j)
     {
-      // got to end of list without finding tid
-      NS_LOG_INFO ("tid not found after first merge");
-      return found;
+      tags[j - 1] = tags[j];
+      tags[j - 1].offset -= size;
     }
-
-  // At this point cur is a merge, but untested for tid
-  NS_ASSERT (cur != 0);
-  NS_ASSERT (cur->count > 1);
-
-  /*
-     Walk the remainder of the list, copying, until we find tid
-     As we put a copy of the cur node onto our list,
-     we move the merge point down the list.
-
-     Starting position                  End position
-       T1 is a merge                     T1.count decremented
-                                         T2 is a merge
-                                         T1' is a copy of T1
-
-          other                             other
-               \                                 \
-      Prev  ->  T1  ->  T2  -> ...                T1  ->  T2  -> ...
-           /   /                                         /|
-      pNext cur                         Prev  ->  T1' --/ |
-                                                     /    |
-                                                pNext   cur
-
-     When we reach tid, we link past it, decrement count, and we're done.
-  */
-
-  // Should normally check for null cur pointer,
-  // but since we know tid exists, we'll skip this test
-  while ( /* cur && */ cur->tid != tid)
-    {
-      NS_ASSERT (cur != 0);
-      NS_ASSERT (cur->count > 1);
-      cur->count--;                       // unmerge cur
-      struct TagData * copy = CreateTagData (cur->size);
-      copy->tid = cur->tid;
-      copy->count = 1;
-      copy->size = cur->size;
-      memcpy (copy->data, cur->data, copy->size);
-      copy->next = cur->next;             // merge into tail
-      copy->next->count++;                // mark new merge
-      *prevNext = copy;                   // point prior list at copy
-      prevNext = &copy->next;             // advance
-      cur      =  copy->next;
-    }
-  // Sanity check:
-  NS_ASSERT (cur != 0);                 // cur should be non-zero
-  NS_ASSERT (cur->tid == tid);          // cur->tid should be tid
-  NS_ASSERT (cur->count > 1);           // cur should be a merge
-
-  // link around tid, removing it from our list
-  found = (this->*Writer)(tag, false, cur, prevNext);
-  return found;
-
+  m_nTags--;
+  m_dataSize -= size;
 }
 
 bool
 PacketTagList::Remove (Tag & tag)
 {
-  return COWTraverse (tag, &PacketTagList::RemoveWriter);
-}
-
-// COWWriter implementing Remove
-bool
-PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
-                             struct PacketTagList::TagData  * cur,
-                             struct PacketTagList::TagData ** prevNext)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
-  *prevNext = cur->next;            // link around cur
-
-  if (preMerge)
-    {
-      // found tid before first merge, so delete cur
-      cur->~TagData ();
-      std::free (cur);
-    }
-  else
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t i = Find (tid);
+  if (i == m_nTags)
     {
-      // cur is always a merge at this point
-      // unmerge cur, since we linked around it already
-      cur->count--;
-      if (cur->next != 0)
-        {
-          // there's a next, so make it a merge
-          cur->next->count++;
-        }
+      return false;
     }
-  return found;
+  const struct TagData *cur = GetTags () + i;
+  const uint8_t *data = GetData () + cur->offset;
+  tag.Deserialize (TagBuffer (const_cast<uint8_t *> (data),
+                              const_cast<uint8_t *> (data) + cur->size));
+  PrepareWrite (m_nTags, m_dataSize);
+  RemoveAt (i);
+  return true;
 }
 
 bool
 PacketTagList::Replace (Tag & tag)
 {
-  bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
-  if (!found)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t i = Find (tid);
+  if (i == m_nTags)
     {
       Add (tag);
+      return false;
     }
-  return found;
-}
-
-// COWWriter implementing Replace
-bool
-PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
-                              struct PacketTagList::TagData  * cur,
-                              struct PacketTagList::TagData ** prevNext)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  if (preMerge)
+  uint32_t size = tag.GetSerializedSize ();
+  PrepareWrite (m_nTags, m_dataSize);
+  struct TagData *cur = const_cast<struct TagData *> (GetTags ()) + i;
+  if (cur->size == size)
     {
-      // found tid before first merge, so just rewrite
-      tag.Serialize (TagBuffer (cur->data, cur->data + cur->size));
+      // rewrite in place
+      uint8_t *data = const_cast<uint8_t *> (GetData ()) + cur->offset;
+      tag.Serialize (TagBuffer (data, data + size));
     }
   else
     {
-      // cur is always a merge at this point
-      // need to copy, replace, and link past cur
-      cur->count--;                     // unmerge cur
-      struct TagData * copy = CreateTagData (tag.GetSerializedSize ());
-      copy->tid = tag.GetInstanceTypeId ();
-      copy->count = 1;
-      tag.Serialize (TagBuffer (copy->data, copy->data + copy->size));
-      copy->next = cur->next;           // merge into tail
-      if (copy->next != 0)
-        {
-          copy->next->count++;          // mark new merge
-        }
-      *prevNext = copy;                 // point prior list at copy
+      RemoveAt (i);
+      Add (tag);
     }
-  return found;
+  return true;
 }
 
 void 
 PacketTagList::Add (const Tag &tag) const
 {
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
   // ensure this id was not yet added
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
-    {
-      NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (),
-                     "Error: cannot add the same kind of tag twice.");
-    }
-  struct TagData * head = CreateTagData (tag.GetSerializedSize ());
-  head->count = 1;
-  head->next = 0;
-  head->tid = tag.GetInstanceTypeId ();
-  head->next = m_next;
-  tag.Serialize (TagBuffer (head->data, head->data + head->size));
-
-  const_cast<PacketTagList *> (this)->m_next = head;
+  NS_ASSERT_MSG (Find (tid) == m_nTags,
+                 "Error: cannot add the same kind of tag twice.");
+  PacketTagList *self = const_cast<PacketTagList *> (this);
+  uint32_t size = tag.GetSerializedSize ();
+  self->PrepareWrite (m_nTags + 1, m_dataSize + size);
+  struct TagData *cur = const_cast<struct TagData *> (GetTags ()) + m_nTags;
+  cur->tid = tid.GetUid ();
+  cur->size = size;
+  cur->offset = m_dataSize;
+  uint8_t *data = const_cast<uint8_t *> (GetData ()) + cur->offset;
+  tag.Serialize (TagBuffer (data, data + size));
+  self->m_nTags++;
+  self->m_dataSize += size;
 }
 
 bool
 PacketTagList::Peek (Tag &tag) const
 {
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t i = Find (tid);
+  if (i == m_nTags)
     {
-      if (cur->tid == tid) 
-        {
-          /* found tag */
-          tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
-          return true;
-        }
+      /* no tag found */
+      return false;
     }
-  /* no tag found */
-  return false;
-}
-
-const struct PacketTagList::TagData *
-PacketTagList::Head (void) const
-{
-  return m_next;
+  /* found tag */
+  const struct TagData *cur = GetTags () + i;
+  uint8_t *data = const_cast<uint8_t *> (GetData ()) + cur->offset;
+  tag.Deserialize (TagBuffer (data, data + cur->size));
+  return true;
 }
 
 } /* namespace ns3 */
-
@@ -22,10 +22,12 @@
 
 /**
 \file   packet-tag-list.h
-\brief  Defines a linked list of Packet tags, including copy-on-write semantics.
+\brief  Defines the contiguous storage of Packet tags, including copy-on-write semantics.
 */
 
 #include <stdint.h>
+#include <cstdlib>
+#include <cstring>
 #include <ostream>
 #include "ns3/type-id.h"
 
@@ -43,108 +45,53 @@ class Tag;
  *
  * \internal
  *
- * The implementation of this class is a bit tricky.  Refer to this
- * diagram in the discussion that follows.
+ * Packets usually carry a few small tags, which each layer looks up
+ * by TypeId, and are copied at each layer.  The tags are therefore
+ * stored contiguously, in two arrays:
  *
- * \dot
- *    digraph {
- *        rankdir = "LR";
- *        clusterrank = local;
- *        node [ shape = record, fontname="FreeSans", fontsize="10" ];
- *        oth  [ label="<l> Other branch | <n> next | <c> ..." ];
- *        PTL1 [ label="<l> PacketTagList A | <n> m_next" , shape=Mrecord];
- *        PTL2 [ label="<l> PacketTagList B | <n> m_next" , shape=Mrecord];
- *        oth:n  -> T7:l ;
- *        PTL2:n -> T6:l ;
- *        PTL1:n -> T5:l ;
- *        T1   [ label="<l> T1  | <n> next | <c> count = 1" ];
- *        T2   [ label="<l> T2  | <n> next | <c> count = 1" ];
- *        T3   [ label="<l> T3  | <n> next | <c> count = 2" ];
- *        T4   [ label="<l> T4  | <n> next | <c> count = 1" ];
- *        T5   [ label="<l> T5  | <n> next | <c> count = 2" ];
- *        T6   [ label="<l> T6  | <n> next | <c> count = 1" ];
- *        T7   [ label="<l> T7  | <n> next | <c> count = 1" ];
- *        NULL [ label="0", shape = ellipse ];
- *        subgraph cluster_list {
- *          penwidth = 0;
- *          T6:n -> T5:l ;
- *          T5:n -> T4:l ;
- *          T4:n -> T3:l ;
- *          T7:n -> T3:l ;
- *          T3:n -> T2:l ;
- *          T2:n -> T1:l ;
- *          T1:n -> NULL ;
- *        };
- *      }
- * \enddot
+ *   - an index of TagData entries, one per tag, in the order they were
+ *     added, holding the TypeId uid, size and offset of each tag;
+ *   - the serialized tags, in the same order.
  *
- *   - Tags are stored in serialized form in a tree of TagData
- *     structures. (<tt>T1-T7</tt> in the diagram)
+ * Lookups scan the index, comparing the TypeId uids, without following
+ * pointers or reading the serialized tags.  TagData only holds integers,
+ * so both arrays are copied with memcpy.
  *
- *   - Each TagData points (\c next pointers in the diagram)
- *     toward the root of the tree, which is a null pointer.
- *
- *   - \c count is the number of incoming pointers to this
- *     TagData.  Branch points, where branches merge or join, have
- *     <tt>count \> 1</tt> (\c T3, \c T5); successive links along
- *     a branch have <tt>count = 1</tt> (\c T1, \c T2, \c T4, \c T6, \c T7).
- *
- *   - Each PacketTagList points to a specific TagData,
- *     which is the most recent Tag added to the packet. (<tt>T5-T7</tt>)
- *
- *   - Conceptually, therefore, each Packet has a PacketTagList which
- *     points to a singly-linked list of TagData.
+ * Up to #INLINE_TAGS tags, of at most #INLINE_DATA bytes in total, are
+ * stored in the PacketTagList itself, so that the common cases never
+ * allocate memory.  Larger tag sets spill into a Block, allocated on
+ * the heap and shared by the copies of the list.
  *
  * \par <b> Copy-on-write </b> is implemented as follows:
  *
- *   - #Add prepends the new tag to the list (growing that branch of the tree,
- *     as \c T6). This is a constant time operation, and does not affect
- *     any other #PacketTagList's, hence this is a \c const function.
- *
- *   - Copy constructor (PacketTagList(const PacketTagList & o))
- *     and assignment (#operator=(const PacketTagList & o))
- *     simply join the tree at the same place as the original
- *     PacketTagList \c o, incrementing the \c count.
- *     For assignment, the old branch is deleted, up to
- *     the first branch point, which has its \c count decremented.
- *     (PacketTagList \c B started as a copy of PacketTagList \c A,
- *     before \c T6 was added to \c B).
+ *   - The copy constructor (PacketTagList(const PacketTagList & o))
+ *     and assignment (#operator=(const PacketTagList & o)) copy the
+ *     inline tags, or share the Block of \c o, incrementing its \c count.
  *
- *   - #Remove and #Replace are a little tricky, depending on where the
- *     target tag is found relative to the first branch point:
- *     - \e Target before <em> the first branch point: </em> \n
- *       The target is just dealt with in place (linked around and deleted,
- *       in the case of #Remove; rewritten in the case of #Replace).
- *     - \e Target at or after <em> the first branch point: </em> \n
- *       The portion of the list between the first branch and the target is
- *       shared. This portion is copied before the #Remove or #Replace is
- *       performed.
+ *   - A shared Block is immutable: #Add, #Remove and #Replace first copy
+ *     the tags into storage of their own, inline if they fit there, and
+ *     release the shared Block.  A Block owned by a single list is
+ *     modified in place.
  */
 class PacketTagList 
 {
 public:
   /**
-   * Tree node for sharing serialized tags.
+   * Index entry of a tag.
    *
    * See PacketTagList for a discussion of the data structure.
    *
    * \internal
    * Unfortunately this has to be public, because
-   * PacketTagIterator::Item::GetTag() needs the data and size values.
+   * PacketTagIterator::Item::GetTag() needs the offset and size values.
    * The Item nested class can't be forward declared, so friending isn't
    * possible.
-   *
-   * We use placement new so we can allocate enough room for the Tag
-   * type which will be serialized into data.  See Object::Aggregates
-   * for a similar construction.
    */
   struct TagData
   {
-    struct TagData * next;      /**< Pointer to next in list */
-    uint32_t count;             /**< Number of incoming links */
-    TypeId tid;                 /**< Type of the tag serialized into #data */
-    uint32_t size;              /**< Size of the \c data buffer */
-    uint8_t data[1];            /**< Serialization buffer */
+    uint16_t tid;               /**< Uid of the TypeId of the tag */
+    uint16_t size;              /**< Size of the serialized tag */
+    uint16_t offset;            /**< Offset of the serialized tag in the tag data */
   };  /* struct TagData */
 
   /**
@@ -156,8 +103,7 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * This copies the inline tags of \pname{o}, or shares its Block.
    */
   inline PacketTagList (PacketTagList const &o);
   /**
@@ -166,19 +112,19 @@ public:
    * \param [in] o The PacketTagList to copy.
    * \returns the copied object
    *
-   * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * This makes a light-weight copy by #RemoveAll, then copying the
+   * inline tags of \pname{o}, or sharing its Block.
    */
   inline PacketTagList &operator = (PacketTagList const &o);
   /**
    * Destructor
    *
-   * #RemoveAll's the tags up to the first merge.
+   * Releases the Block, if any.
    */
   inline ~PacketTagList ();
 
   /**
-   * Add a tag to the head of this branch.
+   * Add a tag to the list.
    *
    * \param [in] tag The tag to add
    */
@@ -210,78 +156,88 @@ public:
    */
   bool Peek (Tag &tag) const;
   /**
-   * Remove all tags from this list (up to the first merge).
+   * Remove all tags from this list.
    */
   inline void RemoveAll (void);
   /**
-   * \returns pointer to head of tag list
+   * \returns The number of tags in the list.
+   */
+  inline uint32_t GetNTags (void) const;
+  /**
+   * \returns The index of the tags, of #GetNTags entries, in the order
+   *          they were added.
    */
-  const struct PacketTagList::TagData *Head (void) const;
+  inline const struct PacketTagList::TagData *GetTags (void) const;
+  /**
+   * \returns The serialized tags, at the offsets given by their index entries.
+   */
+  inline const uint8_t *GetData (void) const;
 
 private:
+  /** The number of tags stored in the list itself. */
+  static const uint32_t INLINE_TAGS = 6;
+  /** The total size of the serialized tags stored in the list itself. */
+  static const uint32_t INLINE_DATA = 40;
+
   /**
-   * Allocate and construct a TagData struct, sizing the data area
-   * large enough to serialize dataSize bytes from a Tag.
-   *
-   * \param [in] dataSize The serialized size of the Tag.
-   * \returns The newly constructed TagData object.
+   * Heap storage for the tags which do not fit in the list, shared by
+   * the copies of the list.  The index of the tags follows this header,
+   * then the serialized tags.
    */
-  static
-  TagData * CreateTagData (size_t dataSize);
-  
+  struct Block
+  {
+    uint32_t count;             /**< Number of lists sharing the block */
+    uint32_t tagCapacity;       /**< Number of index entries */
+    uint32_t dataCapacity;      /**< Size of the tag data */
+  };  /* struct Block */
+
   /**
-   * Typedef of method function pointer for copy-on-write operations
-   *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True if operation successful, false otherwise
+   * \param [in] block The block.
+   * \returns The index of the tags in \pname{block}.
    */
-  typedef bool (PacketTagList::*COWWriter)
-    (Tag       & tag, bool         preMerge,
-    struct TagData * cur, struct TagData ** prevNext);
+  static inline TagData *GetBlockTags (Block *block);
   /**
-   * Traverse the list implementing copy-on-write, using \pname{Writer}.
+   * \param [in] block The block.
+   * \returns The serialized tags in \pname{block}.
+   */
+  static inline uint8_t *GetBlockData (Block *block);
+  /**
+   * Release the Block, if any, freeing it if no other list shares it.
+   */
+  inline void ReleaseBlock (void);
+  /**
+   * Find a tag in the index.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] Writer The copy-on-write function to use.
-   * \returns True if \pname{tag} found, false otherwise.
+   * \param [in] tid The TypeId of the tag.
+   * \returns The index entry of the tag, or #GetNTags if not found.
    */
-  bool COWTraverse   (Tag & tag, PacketTagList::COWWriter Writer);
+  uint32_t Find (TypeId tid) const;
   /**
-   * Copy-on-write implementing Remove.
+   * Make sure the list owns its storage and has room for the tags.
    *
-   * \param [in] tag The target tag type to remove.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag will definitely be removed.
+   * \param [in] nTags The number of tags to make room for.
+   * \param [in] dataSize The total size of the serialized tags to make room for.
    */
-  bool RemoveWriter  (Tag & tag, bool preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
+  inline void PrepareWrite (uint32_t nTags, uint32_t dataSize);
   /**
-   * Copy-on-write implementing Replace
+   * Copy the tags out of a shared Block, or into a larger one.
    *
-   * \param [in] tag The target tag type to replace
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *          false otherwise.
-   * \param [in] cur Pointer to the tag
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag value will definitely be replaced.
+   * \param [in] nTags The number of tags to make room for.
+   * \param [in] dataSize The total size of the serialized tags to make room for.
    */
-  bool ReplaceWriter (Tag & tag, bool preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
-
+  void Reallocate (uint32_t nTags, uint32_t dataSize);
   /**
-   * Pointer to first \ref TagData on the list
+   * Remove a tag from the list, which must own its storage.
+   *
+   * \param [in] i The index entry of the tag.
    */
-  struct TagData *m_next;
+  void RemoveAt (uint32_t i);
+
+  uint16_t m_nTags;                     //!< The number of tags
+  uint16_t m_dataSize;                  //!< The total size of the serialized tags
+  Block *m_block;                       //!< The heap storage, or 0 if the tags are inline
+  TagData m_tags[INLINE_TAGS];          //!< The index of the inline tags
+  uint8_t m_data[INLINE_DATA];          //!< The inline serialized tags
 };
 
 } // namespace ns3
@@ -293,16 +249,25 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_nTags (0),
+    m_dataSize (0),
+    m_block (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_nTags (o.m_nTags),
+    m_dataSize (o.m_dataSize),
+    m_block (o.m_block)
 {
-  if (m_next != 0)
+  if (m_block != 0)
     {
-      m_next->count++;
+      m_block->count++;
+    }
+  else if (m_nTags != 0)
+    {
+      std::memcpy (m_tags, o.m_tags, m_nTags * sizeof (TagData));
+      std::memcpy (m_data, o.m_data, m_dataSize);
     }
 }
 
@@ -310,48 +275,99 @@ PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (this == &o) 
     {
       return *this;
     }
   RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  m_nTags = o.m_nTags;
+  m_dataSize = o.m_dataSize;
+  m_block = o.m_block;
+  if (m_block != 0) 
+    {
+      m_block->count++;
+    }
+  else if (m_nTags != 0)
     {
-      m_next->count++;
+      std::memcpy (m_tags, o.m_tags, m_nTags * sizeof (TagData));
+      std::memcpy (m_data, o.m_data, m_dataSize);
     }
   return *this;
 }
 
 PacketTagList::~PacketTagList ()
 {
-  RemoveAll ();
+  ReleaseBlock ();
 }
 
 void
 PacketTagList::RemoveAll (void)
 {
-  struct TagData *prev = 0;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  ReleaseBlock ();
+  m_nTags = 0;
+  m_dataSize = 0;
+}
+
+uint32_t
+PacketTagList::GetNTags (void) const
+{
+  return m_nTags;
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::GetTags (void) const
+{
+  return m_block != 0 ? GetBlockTags (m_block) : m_tags;
+}
+
+const uint8_t *
+PacketTagList::GetData (void) const
+{
+  return m_block != 0 ? GetBlockData (m_block) : m_data;
+}
+
+PacketTagList::TagData *
+PacketTagList::GetBlockTags (Block *block)
+{
+  return reinterpret_cast<TagData *> (block + 1);
+}
+
+uint8_t *
+PacketTagList::GetBlockData (Block *block)
+{
+  return reinterpret_cast<uint8_t *> (GetBlockTags (block) + block->tagCapacity);
+}
+
+void
+PacketTagList::PrepareWrite (uint32_t nTags, uint32_t dataSize)
+{
+  if (m_block == 0)
     {
-      cur->count--;
-      if (cur->count > 0) 
+      if (nTags <= INLINE_TAGS && dataSize <= INLINE_DATA)
         {
-          break;
+          return;
         }
-      if (prev != 0) 
-        {
-          prev->~TagData ();
-          std::free (prev);
-        }
-      prev = cur;
     }
-  if (prev != 0) 
+  else if (m_block->count == 1
+           && nTags <= m_block->tagCapacity && dataSize <= m_block->dataCapacity)
     {
-      prev->~TagData ();
-      std::free (prev);
+      return;
+    }
+  Reallocate (nTags, dataSize);
+}
+
+void
+PacketTagList::ReleaseBlock (void)
+{
+  if (m_block != 0)
+    {
+      m_block->count--;
+      if (m_block->count == 0)
+        {
+          std::free (m_block);
+        }
+      m_block = 0;
     }
-  m_next = 0;
 }
 
 } // namespace ns3
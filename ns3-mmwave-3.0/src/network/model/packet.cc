@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include <string>
+#include <vector>
 #include <cstdarg>
 
 namespace ns3 {
@@ -29,6 +30,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
 uint32_t Packet::m_globalUid = 0;
+bool Packet::m_virtualHeaders = false;
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -81,8 +83,10 @@ ByteTagIterator::ByteTagIterator (ByteTagList::Iterator i)
 }
 
 
-PacketTagIterator::PacketTagIterator (const struct PacketTagList::TagData *head)
-  : m_current (head)
+PacketTagIterator::PacketTagIterator (const PacketTagList &list)
+  : m_tags (list.GetTags ()),
+    m_data (list.GetData ()),
+    m_current (list.GetNTags ())
 {
 }
 bool
@@ -94,26 +98,28 @@ PacketTagIterator::Item
 PacketTagIterator::Next (void)
 {
   NS_ASSERT (HasNext ());
-  const struct PacketTagList::TagData *prev = m_current;
-  m_current = m_current->next;
-  return PacketTagIterator::Item (prev);
+  m_current--;
+  return PacketTagIterator::Item (m_tags + m_current, m_data);
 }
 
-PacketTagIterator::Item::Item (const struct PacketTagList::TagData *data)
-  : m_data (data)
+PacketTagIterator::Item::Item (const struct PacketTagList::TagData *tag, const uint8_t *data)
+  : m_tag (tag),
+    m_data (data)
 {
 }
 TypeId
 PacketTagIterator::Item::GetTypeId (void) const
 {
-  return m_data->tid;
+  TypeId tid;
+  tid.SetUid (m_tag->tid);
+  return tid;
 }
 void
 PacketTagIterator::Item::GetTag (Tag &tag) const
 {
-  NS_ASSERT (tag.GetInstanceTypeId () == m_data->tid);
-  tag.Deserialize (TagBuffer ((uint8_t*)m_data->data,
-                              (uint8_t*)m_data->data + m_data->size));
+  NS_ASSERT (tag.GetInstanceTypeId ().GetUid () == m_tag->tid);
+  uint8_t *start = (uint8_t*)m_data + m_tag->offset;
+  tag.Deserialize (TagBuffer (start, start + m_tag->size));
 }
 
 
@@ -137,7 +143,10 @@ Packet::Packet ()
      * global UID
      */
     m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_headers (0),
+    m_headersSize (0),
+    m_peekedHeader (0)
 {
   m_globalUid++;
 }
@@ -146,7 +155,10 @@ Packet::Packet (const Packet &o)
   : m_buffer (o.m_buffer),
     m_byteTagList (o.m_byteTagList),
     m_packetTagList (o.m_packetTagList),
-    m_metadata (o.m_metadata)
+    m_metadata (o.m_metadata),
+    m_headers (o.m_headers),
+    m_headersSize (o.m_headersSize),
+    m_peekedHeader (o.m_peekedHeader)
 {
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy ()
     : m_nixVector = 0;
@@ -163,6 +175,9 @@ Packet::operator = (const Packet &o)
   m_byteTagList = o.m_byteTagList;
   m_packetTagList = o.m_packetTagList;
   m_metadata = o.m_metadata;
+  m_headers = o.m_headers;
+  m_headersSize = o.m_headersSize;
+  m_peekedHeader = o.m_peekedHeader;
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy () 
     : m_nixVector = 0;
   return *this;
@@ -179,7 +194,10 @@ Packet::Packet (uint32_t size)
      * global UID
      */
     m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_headers (0),
+    m_headersSize (0),
+    m_peekedHeader (0)
 {
   m_globalUid++;
 }
@@ -188,7 +206,10 @@ Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
     m_byteTagList (),
     m_packetTagList (),
     m_metadata (0,0),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_headers (0),
+    m_headersSize (0),
+    m_peekedHeader (0)
 {
   NS_ASSERT (magic);
   Deserialize (buffer, size);
@@ -205,7 +226,10 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * global UID
      */
     m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_headers (0),
+    m_headersSize (0),
+    m_peekedHeader (0)
 {
   m_globalUid++;
   m_buffer.AddAtStart (size);
@@ -214,12 +238,15 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
 }
 
 Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList, 
-                const PacketTagList &packetTagList, const PacketMetadata &metadata)
+                const PacketTagList &packetTagList, const Metadata &metadata)
   : m_buffer (buffer),
     m_byteTagList (byteTagList),
     m_packetTagList (packetTagList),
     m_metadata (metadata),
-    m_nixVector (0)
+    m_nixVector (0),
+    m_headers (0),
+    m_headersSize (0),
+    m_peekedHeader (0)
 {
 }
 
@@ -227,12 +254,17 @@ Ptr<Packet>
 Packet::CreateFragment (uint32_t start, uint32_t length) const
 {
   NS_LOG_FUNCTION (this << start << length);
+  Materialize ();
   Buffer buffer = m_buffer.CreateFragment (start, length);
+#ifdef DISABLE_PACKET_METADATA
+  ByteTagList byteTagList;
+#else
   ByteTagList byteTagList = m_byteTagList;
   byteTagList.Adjust (-start);
+#endif
   NS_ASSERT (m_buffer.GetSize () >= start + length);
   uint32_t end = m_buffer.GetSize () - (start + length);
-  PacketMetadata metadata = m_metadata.CreateFragment (start, end);
+  Metadata metadata = m_metadata.CreateFragment (start, end);
   // again, call the constructor directly rather than
   // through Create because it is private.
   Ptr<Packet> ret = Ptr<Packet> (new Packet (buffer, byteTagList, m_packetTagList, metadata), false);
@@ -252,43 +284,135 @@ Packet::GetNixVector (void) const
   return m_nixVector;
 } 
 
+Packet::HeaderHolder::~HeaderHolder ()
+{
+}
+
+void
+Packet::PushHeader (Ptr<HeaderHolder> holder)
+{
+  const Header &header = holder->GetHeader ();
+  uint32_t size = header.GetSerializedSize ();
+  NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+  holder->m_next = m_headers;
+  holder->m_size = size;
+  m_headers = holder;
+  m_peekedHeader = 0;
+  m_headersSize += size;
+#ifndef DISABLE_PACKET_METADATA
+  m_byteTagList.Adjust (size);
+  m_byteTagList.AddAtStart (size);
+#endif
+  m_metadata.AddHeader (header, size);
+}
+
+uint32_t
+Packet::PopHeader (void)
+{
+  const Header &header = m_headers->GetHeader ();
+  uint32_t size = m_headers->m_size;
+  NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+#ifndef DISABLE_PACKET_METADATA
+  m_byteTagList.Adjust (-size);
+#endif
+  m_metadata.RemoveHeader (header, size);
+  m_headers = m_headers->m_next;
+  m_headersSize -= size;
+  return size;
+}
+
+uint32_t
+Packet::RemovePeekedHeader (void)
+{
+  const Header &header = m_peekedHeader->GetHeader ();
+  uint32_t size = m_peekedHeader->m_size;
+  NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+  m_buffer.RemoveAtStart (size);
+#ifndef DISABLE_PACKET_METADATA
+  m_byteTagList.Adjust (-size);
+#endif
+  m_metadata.RemoveHeader (header, size);
+  m_peekedHeader = 0;
+  return size;
+}
+
+void
+Packet::Materialize (void) const
+{
+  if (m_headers == 0)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_headersSize);
+  // Serialize from the last header, as the headers may read the bytes
+  // after them, e.g. to compute a checksum.
+  std::vector<const HeaderHolder *> headers;
+  for (const HeaderHolder *holder = PeekPointer (m_headers); holder != 0;
+       holder = PeekPointer (holder->m_next))
+    {
+      headers.push_back (holder);
+    }
+  for (std::vector<const HeaderHolder *>::const_reverse_iterator i = headers.rbegin ();
+       i != headers.rend (); ++i)
+    {
+      m_buffer.AddAtStart ((*i)->m_size);
+      (*i)->GetHeader ().Serialize (m_buffer.Begin ());
+    }
+  m_headers = 0;
+  m_headersSize = 0;
+  m_peekedHeader = 0;
+}
+
 void
 Packet::AddHeader (const Header &header)
 {
   uint32_t size = header.GetSerializedSize ();
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
+  Materialize ();
+  m_peekedHeader = 0;
   m_buffer.AddAtStart (size);
+#ifndef DISABLE_PACKET_METADATA
   m_byteTagList.Adjust (size);
   m_byteTagList.AddAtStart (size);
+#endif
   header.Serialize (m_buffer.Begin ());
   m_metadata.AddHeader (header, size);
 }
 uint32_t
 Packet::RemoveHeader (Header &header, uint32_t size)
 {
+  Materialize ();
+  m_peekedHeader = 0;
   Buffer::Iterator end;
   end = m_buffer.Begin ();
   end.Next (size);
   uint32_t deserialized = header.Deserialize (m_buffer.Begin (), end);
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
   m_buffer.RemoveAtStart (deserialized);
+#ifndef DISABLE_PACKET_METADATA
   m_byteTagList.Adjust (-deserialized);
+#endif
   m_metadata.RemoveHeader (header, deserialized);
   return deserialized;
 }
 uint32_t
 Packet::RemoveHeader (Header &header)
 {
+  Materialize ();
+  m_peekedHeader = 0;
   uint32_t deserialized = header.Deserialize (m_buffer.Begin ());
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
   m_buffer.RemoveAtStart (deserialized);
+#ifndef DISABLE_PACKET_METADATA
   m_byteTagList.Adjust (-deserialized);
+#endif
   m_metadata.RemoveHeader (header, deserialized);
   return deserialized;
 }
 uint32_t
 Packet::PeekHeader (Header &header) const
 {
+  Materialize ();
   uint32_t deserialized = header.Deserialize (m_buffer.Begin ());
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << deserialized);
   return deserialized;
@@ -296,6 +420,7 @@ Packet::PeekHeader (Header &header) const
 uint32_t
 Packet::PeekHeader (Header &header, uint32_t size) const
 {
+  Materialize ();
   Buffer::Iterator end;
   end = m_buffer.Begin ();
   end.Next (size);
@@ -308,7 +433,10 @@ Packet::AddTrailer (const Trailer &trailer)
 {
   uint32_t size = trailer.GetSerializedSize ();
   NS_LOG_FUNCTION (this << trailer.GetInstanceTypeId ().GetName () << size);
+  m_peekedHeader = 0;
+#ifndef DISABLE_PACKET_METADATA
   m_byteTagList.AddAtEnd (GetSize ());
+#endif
   m_buffer.AddAtEnd (size);
   Buffer::Iterator end = m_buffer.End ();
   trailer.Serialize (end);
@@ -317,6 +445,8 @@ Packet::AddTrailer (const Trailer &trailer)
 uint32_t
 Packet::RemoveTrailer (Trailer &trailer)
 {
+  Materialize ();
+  m_peekedHeader = 0;
   uint32_t deserialized = trailer.Deserialize (m_buffer.End ());
   NS_LOG_FUNCTION (this << trailer.GetInstanceTypeId ().GetName () << deserialized);
   m_buffer.RemoveAtEnd (deserialized);
@@ -326,6 +456,7 @@ Packet::RemoveTrailer (Trailer &trailer)
 uint32_t
 Packet::PeekTrailer (Trailer &trailer)
 {
+  Materialize ();
   uint32_t deserialized = trailer.Deserialize (m_buffer.End ());
   NS_LOG_FUNCTION (this << trailer.GetInstanceTypeId ().GetName () << deserialized);
   return deserialized;
@@ -335,11 +466,15 @@ void
 Packet::AddAtEnd (Ptr<const Packet> packet)
 {
   NS_LOG_FUNCTION (this << packet << packet->GetSize ());
+  m_peekedHeader = 0;
+#ifndef DISABLE_PACKET_METADATA
   m_byteTagList.AddAtEnd (GetSize ());
   ByteTagList copy = packet->m_byteTagList;
   copy.AddAtStart (0);
   copy.Adjust (GetSize ());
   m_byteTagList.Add (copy);
+#endif
+  packet->Materialize ();
   m_buffer.AddAtEnd (packet->m_buffer);
   m_metadata.AddAtEnd (packet->m_metadata);
 }
@@ -347,7 +482,10 @@ void
 Packet::AddPaddingAtEnd (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  m_peekedHeader = 0;
+#ifndef DISABLE_PACKET_METADATA
   m_byteTagList.AddAtEnd (GetSize ());
+#endif
   m_buffer.AddAtEnd (size);
   m_metadata.AddPaddingAtEnd (size);
 }
@@ -355,6 +493,11 @@ void
 Packet::RemoveAtEnd (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  m_peekedHeader = 0;
+  if (size > m_buffer.GetSize ())
+    {
+      Materialize ();
+    }
   m_buffer.RemoveAtEnd (size);
   m_metadata.RemoveAtEnd (size);
 }
@@ -362,8 +505,12 @@ void
 Packet::RemoveAtStart (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  Materialize ();
+  m_peekedHeader = 0;
   m_buffer.RemoveAtStart (size);
+#ifndef DISABLE_PACKET_METADATA
   m_byteTagList.Adjust (-size);
+#endif
   m_metadata.RemoveAtStart (size);
 }
 
@@ -377,12 +524,14 @@ Packet::RemoveAllByteTags (void)
 uint32_t 
 Packet::CopyData (uint8_t *buffer, uint32_t size) const
 {
+  Materialize ();
   return m_buffer.CopyData (buffer, size);
 }
 
 void
 Packet::CopyData (std::ostream *os, uint32_t size) const
 {
+  Materialize ();
   return m_buffer.CopyData (os, size);
 }
 
@@ -433,6 +582,7 @@ Packet::ToString() const
 void 
 Packet::Print (std::ostream &os) const
 {
+  Materialize ();
   PacketMetadata::ItemIterator i = m_metadata.BeginItem (m_buffer);
   while (i.HasNext ())
     {
@@ -565,6 +715,7 @@ Packet::Print (std::ostream &os) const
 PacketMetadata::ItemIterator 
 Packet::BeginItem (void) const
 {
+  Materialize ();
   return m_metadata.BeginItem (m_buffer);
 }
 
@@ -572,18 +723,47 @@ void
 Packet::EnablePrinting (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+#ifdef DISABLE_PACKET_METADATA
+  NS_LOG_WARN ("Packet metadata is disabled in this build");
+#else
   PacketMetadata::Enable ();
+#endif
 }
 
 void
 Packet::EnableChecking (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+#ifdef DISABLE_PACKET_METADATA
+  NS_LOG_WARN ("Packet metadata is disabled in this build");
+#else
   PacketMetadata::EnableChecking ();
+#endif
+}
+
+void
+Packet::EnableVirtualHeaders (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_virtualHeaders = true;
+}
+
+void
+Packet::DisableVirtualHeaders (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_virtualHeaders = false;
+}
+
+bool
+Packet::AreVirtualHeadersEnabled (void)
+{
+  return m_virtualHeaders;
 }
 
 uint32_t Packet::GetSerializedSize (void) const
 {
+  Materialize ();
   uint32_t size = 0;
 
   if (m_nixVector)
@@ -627,6 +807,7 @@ uint32_t Packet::GetSerializedSize (void) const
 uint32_t 
 Packet::Serialize (uint8_t* buffer, uint32_t maxSize) const
 {
+  Materialize ();
   uint32_t* p = reinterpret_cast<uint32_t *> (buffer);
   uint32_t size = 0;
 
@@ -920,7 +1101,7 @@ Packet::PrintPacketTags (std::ostream &os) const
 PacketTagIterator 
 Packet::GetPacketTagIterator (void) const
 {
-  return PacketTagIterator (m_packetTagList.Head ());
+  return PacketTagIterator (m_packetTagList);
 }
 
 std::ostream& operator<< (std::ostream& os, const Packet &packet)
@@ -21,6 +21,9 @@
 #define PACKET_H
 
 #include <stdint.h>
+#include <typeinfo>
+#include <type_traits>
+#include "ns3/network-config.h"
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -126,7 +129,8 @@ private:
  * \ingroup packet
  * \brief Iterator over the set of packet tags in a packet
  *
- * This is a java-style iterator.
+ * This is a java-style iterator.  It visits the most recently added tags
+ * first, and is invalidated by adding, removing or replacing packet tags.
  */
 class PacketTagIterator
 {
@@ -157,8 +161,9 @@ private:
      * Constructor
      * \param data the data to copy.
      */
-    Item (const struct PacketTagList::TagData *data);
-    const struct PacketTagList::TagData *m_data; //!< the tag data
+    Item (const struct PacketTagList::TagData *tag, const uint8_t *data);
+    const struct PacketTagList::TagData *m_tag; //!< the index entry of the tag
+    const uint8_t *m_data; //!< the serialized tags
   };
   /**
    * \returns true if calling Next is safe, false otherwise.
@@ -173,10 +178,12 @@ private:
   friend class Packet;
   /**
    * Constructor
-   * \param head head of the items
+   * \param list the tags of the packet
    */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
-  const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
+  PacketTagIterator (const PacketTagList &list);
+  const struct PacketTagList::TagData *m_tags;  //!< the index of the tags in a packet
+  const uint8_t *m_data;  //!< the serialized tags in a packet
+  uint32_t m_current;  //!< number of tags left, in the order opposite to insertion
 };
 
 /**
@@ -199,7 +206,10 @@ private:
  * output from Packet::Print. If you wish to only enable
  * checking of metadata, and do not need any printing capability, you can
  * call Packet::EnableChecking: its runtime cost is lower than
- * Packet::EnablePrinting.
+ * Packet::EnablePrinting.  Builds configured with
+ * --disable-packet-metadata compile the metadata out of Packet: packets
+ * only keep their uid, and byte tags stay on the bytes they were added
+ * to, without following headers, fragments or concatenations.
  *
  * - The set of tags contain simulation-specific information which cannot
  * be stored in the packet byte buffer because the protocol headers or trailers
@@ -230,6 +240,19 @@ private:
  */
 class Packet : public SimpleRefCount<Packet>
 {
+  /**
+   * \brief Check if AddHeader can keep a copy of a header of type \p T.
+   * \tparam T The type of the header.
+   */
+  template <typename T>
+  struct IsCopyableHeader
+  {
+    /** \c true if \p T is a header which can be copied and assigned. */
+    static const bool value = std::is_base_of<Header, T>::value
+      && std::is_copy_constructible<T>::value
+      && std::is_copy_assignable<T>::value;
+  };
+
 public:
 
   /**
@@ -356,6 +379,52 @@ public:
    * \returns the number of bytes read from the packet.
    */
   uint32_t PeekHeader (Header &header, uint32_t size) const;
+  /**
+   * \brief Add header to this packet.
+   *
+   * This overload is selected for the headers which can be copied.
+   * When virtual headers are enabled, it stores a copy of the header
+   * in the packet, and only serializes it when the bytes of the
+   * packet are needed; otherwise it behaves as AddHeader (const Header &).
+   *
+   * \tparam T \explicit The type of the header.
+   * \param header a reference to the header to add to this packet.
+   *
+   * \sa EnableVirtualHeaders
+   */
+  template <typename T>
+  typename std::enable_if<IsCopyableHeader<T>::value>::type
+  AddHeader (const T &header);
+  /**
+   * \brief Remove the header from the packet.
+   *
+   * If the first header of the packet is a copy of a \p T header which was
+   * not serialized yet, or was deserialized by the last PeekHeader, this
+   * assigns it to \p header; otherwise this behaves as
+   * RemoveHeader (Header &).
+   *
+   * \tparam T \explicit The type of the header.
+   * \param header a reference to the header to remove from the packet.
+   * \returns the number of bytes removed from the packet.
+   */
+  template <typename T>
+  typename std::enable_if<IsCopyableHeader<T>::value, uint32_t>::type
+  RemoveHeader (T &header);
+  /**
+   * \brief Read, but do _not_ remove, the header of the packet.
+   *
+   * If the first header of the packet is a copy of a \p T header which was
+   * not serialized yet, or was deserialized by the last PeekHeader, this
+   * assigns it to \p header; otherwise this behaves as PeekHeader (Header &),
+   * and keeps a copy of the header when virtual headers are enabled.
+   *
+   * \tparam T \explicit The type of the header.
+   * \param header a reference to the header to read from the packet.
+   * \returns the number of bytes read from the packet.
+   */
+  template <typename T>
+  typename std::enable_if<IsCopyableHeader<T>::value, uint32_t>::type
+  PeekHeader (T &header) const;
   /**
    * \brief Add trailer to this packet.
    *
@@ -517,6 +586,9 @@ public:
    * want to be able the Packet::Print method, 
    * you need to invoke this method at least once during the 
    * simulation setup and before any packet is created.
+   *
+   * In builds configured with --disable-packet-metadata, packets
+   * keep no metadata, and this does nothing.
    */
   static void EnablePrinting (void);
   /**
@@ -528,8 +600,46 @@ public:
    * when you remove a header from a packet, this same header
    * was actually present at the front of the packet. These
    * errors will be detected and will abort the program.
+   *
+   * In builds configured with --disable-packet-metadata, packets
+   * keep no metadata, and this does nothing.
    */
   static void EnableChecking (void);
+  /**
+   * \brief Enable virtual headers.
+   *
+   * By default, AddHeader serializes each header in the packet buffer,
+   * and RemoveHeader deserializes it again.  When virtual headers are
+   * enabled, AddHeader keeps a copy of the header in the packet instead,
+   * which RemoveHeader and PeekHeader hand back when they are called with
+   * a header of the same type.  The headers are only serialized in the
+   * buffer when its bytes are needed: CopyData, Print, CreateFragment,
+   * Serialize, trailers, or a header read with another type, e.g.
+   * when writing pcap traces.
+   *
+   * PeekHeader also keeps a copy of the last header it deserialized, until
+   * the packet is modified, so that a packet forwarded from layer to layer
+   * is deserialized once by the next PeekHeader or RemoveHeader of the
+   * same type, in the packet or in its copies.
+   *
+   * This suits simulations which do not look at the bytes of the packets.
+   * The copies are not deserialized, so the fields which a header computes
+   * while serializing or deserializing, such as checksums, are not set.
+   */
+  static void EnableVirtualHeaders (void);
+  /**
+   * \brief Disable virtual headers, the default.
+   *
+   * The packets which already hold header copies keep them, and still
+   * hand them back.
+   *
+   * \sa EnableVirtualHeaders
+   */
+  static void DisableVirtualHeaders (void);
+  /**
+   * \returns \c true if virtual headers are enabled.
+   */
+  static bool AreVirtualHeadersEnabled (void);
 
   /**
    * \brief Returns number of bytes required for packet
@@ -761,6 +871,14 @@ public:
     
   
 private:
+#ifdef DISABLE_PACKET_METADATA
+  /// The metadata of the packets: the uid only
+  typedef PacketUidMetadata Metadata;
+#else
+  /// The metadata of the packets
+  typedef PacketMetadata Metadata;
+#endif
+
   /**
    * \brief Constructor
    * \param buffer the packet buffer
@@ -769,7 +887,7 @@ private:
    * \param metadata the packet's metadata
    */
   Packet (const Buffer &buffer, const ByteTagList &byteTagList, 
-          const PacketTagList &packetTagList, const PacketMetadata &metadata);
+          const PacketTagList &packetTagList, const Metadata &metadata);
 
   /**
    * \brief Deserializes a packet.
@@ -779,15 +897,98 @@ private:
    */
   uint32_t Deserialize (uint8_t const*buffer, uint32_t size);
 
-  Buffer m_buffer;                //!< the packet buffer (it's actual contents)
+  /**
+   * \brief A copy of a header which is not serialized in the buffer yet.
+   *
+   * The headers of a packet which are not serialized form a stack, from
+   * the first header of the packet.  The holders are never modified, so
+   * the copies of a packet share them.
+   */
+  class HeaderHolder : public SimpleRefCount<HeaderHolder>
+  {
+public:
+    virtual ~HeaderHolder ();
+    /**
+     * \returns the header.
+     */
+    virtual const Header & GetHeader (void) const = 0;
+
+    Ptr<const HeaderHolder> m_next; //!< the header after this one, if not serialized
+    uint32_t m_size;                //!< the serialized size of the header
+  };
+  /**
+   * \brief A copy of a header of type \p T.
+   * \tparam T The type of the header.
+   */
+  template <typename T>
+  class HeaderHolderImpl : public HeaderHolder
+  {
+public:
+    /**
+     * Constructor.
+     * \param [in] header The header to copy.
+     */
+    HeaderHolderImpl (const T &header)
+      : m_header (header)
+    {}
+    virtual const Header & GetHeader (void) const
+    {
+      return m_header;
+    }
+
+    T m_header; //!< the copy of the header
+  };
+
+  /**
+   * \brief Add a header copy at the start of the packet.
+   * \param holder the header copy
+   */
+  void PushHeader (Ptr<HeaderHolder> holder);
+  /**
+   * \brief Remove the first header copy of the packet.
+   * \returns the size of the header.
+   */
+  uint32_t PopHeader (void);
+  /**
+   * \brief Remove the first header of the buffer, whose
+   * deserialized copy is m_peekedHeader.
+   * \returns the size of the header.
+   */
+  uint32_t RemovePeekedHeader (void);
+  /**
+   * \brief Serialize the header copies in the buffer.
+   */
+  void Materialize (void) const;
+  /**
+   * \brief Get the copy of a header, if it has the type of \p header.
+   * \tparam T The type of the header.
+   * \param holder the header copy, or 0
+   * \param header the header to assign the copy to
+   * \returns the copy, or 0 if \p holder has another type.
+   */
+  template <typename T>
+  static const T * GetHeaderCopy (const Ptr<const HeaderHolder> &holder, const T &header);
+
+  mutable Buffer m_buffer;        //!< the packet buffer (it's actual contents)
   ByteTagList m_byteTagList;      //!< the ByteTag list
   PacketTagList m_packetTagList;  //!< the packet's Tag list
-  PacketMetadata m_metadata;      //!< the packet's metadata
+  Metadata m_metadata;            //!< the packet's metadata
 
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+  /** The header copies which are not serialized in the buffer yet. */
+  mutable Ptr<const HeaderHolder> m_headers;
+  /** The total size of the header copies. */
+  mutable uint32_t m_headersSize;
+  /**
+   * The last header read by PeekHeader from the start of the buffer,
+   * until the buffer is modified.
+   */
+  mutable Ptr<const HeaderHolder> m_peekedHeader;
+
   static uint32_t m_globalUid; //!< Global counter of packets Uid
+  static bool m_virtualHeaders; //!< Whether AddHeader keeps header copies
 };
 
 /**
@@ -851,7 +1052,77 @@ namespace ns3 {
 uint32_t 
 Packet::GetSize (void) const
 {
-  return m_buffer.GetSize ();
+  return m_buffer.GetSize () + m_headersSize;
+}
+
+template <typename T>
+typename std::enable_if<Packet::IsCopyableHeader<T>::value>::type
+Packet::AddHeader (const T &header)
+{
+  if (!m_virtualHeaders)
+    {
+      AddHeader (static_cast<const Header &> (header));
+      return;
+    }
+  PushHeader (Create<HeaderHolderImpl<T> > (header));
+}
+
+template <typename T>
+const T *
+Packet::GetHeaderCopy (const Ptr<const HeaderHolder> &holder, const T &header)
+{
+  if (holder != 0
+      && typeid (holder->GetHeader ()) == typeid (T)
+      && typeid (header) == typeid (T))
+    {
+      return &static_cast<const HeaderHolderImpl<T> *> (PeekPointer (holder))->m_header;
+    }
+  return 0;
+}
+
+template <typename T>
+typename std::enable_if<Packet::IsCopyableHeader<T>::value, uint32_t>::type
+Packet::RemoveHeader (T &header)
+{
+  const T *copy = GetHeaderCopy (m_headers, header);
+  if (copy != 0)
+    {
+      header = *copy;
+      return PopHeader ();
+    }
+  copy = GetHeaderCopy (m_peekedHeader, header);
+  if (copy != 0)
+    {
+      header = *copy;
+      return RemovePeekedHeader ();
+    }
+  return RemoveHeader (static_cast<Header &> (header));
+}
+
+template <typename T>
+typename std::enable_if<Packet::IsCopyableHeader<T>::value, uint32_t>::type
+Packet::PeekHeader (T &header) const
+{
+  const T *copy = GetHeaderCopy (m_headers, header);
+  if (copy != 0)
+    {
+      header = *copy;
+      return m_headers->m_size;
+    }
+  copy = GetHeaderCopy (m_peekedHeader, header);
+  if (copy != 0)
+    {
+      header = *copy;
+      return m_peekedHeader->m_size;
+    }
+  uint32_t size = PeekHeader (static_cast<Header &> (header));
+  if (m_virtualHeaders && typeid (header) == typeid (T))
+    {
+      Ptr<HeaderHolder> peeked = Create<HeaderHolderImpl<T> > (header);
+      peeked->m_size = size;
+      m_peekedHeader = peeked;
+    }
+  return size;
 }
 
 } // namespace ns3
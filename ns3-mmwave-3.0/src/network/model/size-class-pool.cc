@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "size-class-pool.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <cstring>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup packet
+ * ns3::SizeClassPoolCache implementation.
+ */
+
+/* A slot holds DESTROYED once the thread destroyed its cache, so that
+ * the blocks deallocated later, e.g. from static destructors, are
+ * freed rather than re-creating a cache nobody would free.
+ */
+#define DESTROYED (reinterpret_cast<ns3::SizeClassPoolCache *> (~(uintptr_t) 0))
+
+namespace {
+
+/**
+ * \ingroup packet
+ * \brief The caches created by a thread, destroyed when it exits.
+ */
+struct ThreadCaches
+{
+  ~ThreadCaches ()
+  {
+    for (std::vector<ns3::SizeClassPoolCache *>::iterator i = caches.begin ();
+         i != caches.end (); ++i)
+      {
+        delete *i;
+      }
+  }
+  std::vector<ns3::SizeClassPoolCache *> caches; //!< The caches
+};
+
+} // unnamed namespace
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SizeClassPool");
+
+SizeClassPoolCache::SizeClassPoolCache (SizeClassPoolCache **slot)
+  : m_slot (slot)
+{
+  NS_LOG_FUNCTION (this << slot);
+  for (uint32_t i = 0; i < N_CLASSES; ++i)
+    {
+      m_free[i] = 0;
+      m_nFree[i] = 0;
+    }
+  std::memset (&m_stats, 0, sizeof (m_stats));
+}
+
+SizeClassPoolCache::~SizeClassPoolCache ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < N_CLASSES; ++i)
+    {
+      while (m_free[i] != 0)
+        {
+          FreeBlock *block = m_free[i];
+          m_free[i] = block->next;
+          delete [] reinterpret_cast<uint8_t *> (block);
+        }
+    }
+  *m_slot = DESTROYED;
+}
+
+SizeClassPoolCache *
+SizeClassPoolCache::Get (SizeClassPoolCache **slot)
+{
+  SizeClassPoolCache *cache = *slot;
+  if (cache == DESTROYED)
+    {
+      return 0;
+    }
+  if (cache == 0)
+    {
+      static thread_local ThreadCaches threadCaches;
+      cache = new SizeClassPoolCache (slot);
+      threadCaches.caches.push_back (cache);
+      *slot = cache;
+    }
+  return cache;
+}
+
+uint8_t *
+SizeClassPoolCache::Allocate (SizeClassPoolCache **slot, uint32_t &size)
+{
+  SizeClassPoolCache *cache = Get (slot);
+  uint32_t c = 0;
+  uint32_t classSize = MIN_SIZE;
+  while (classSize < size && c < N_CLASSES)
+    {
+      classSize <<= 1;
+      ++c;
+    }
+  if (cache == 0)
+    {
+      return new uint8_t [size];
+    }
+  ++cache->m_stats.allocations;
+  if (c == N_CLASSES)
+    {
+      return new uint8_t [size];
+    }
+  size = classSize;
+  FreeBlock *block = cache->m_free[c];
+  if (block != 0)
+    {
+      cache->m_free[c] = block->next;
+      --cache->m_nFree[c];
+      ++cache->m_stats.hits;
+      --cache->m_stats.cachedBlocks;
+      cache->m_stats.cachedBytes -= size;
+      return reinterpret_cast<uint8_t *> (block);
+    }
+  return new uint8_t [size];
+}
+
+void
+SizeClassPoolCache::Deallocate (SizeClassPoolCache **slot, uint8_t *block, uint32_t size)
+{
+  SizeClassPoolCache *cache = Get (slot);
+  if (cache == 0)
+    {
+      delete [] block;
+      return;
+    }
+  ++cache->m_stats.deallocations;
+  uint32_t c = 0;
+  uint32_t classSize = MIN_SIZE;
+  while (classSize < size && c < N_CLASSES)
+    {
+      classSize <<= 1;
+      ++c;
+    }
+  if (c == N_CLASSES
+      || classSize != size
+      || (cache->m_nFree[c] + 1) * classSize > MAX_CACHED_BYTES)
+    {
+      ++cache->m_stats.releases;
+      delete [] block;
+      return;
+    }
+  FreeBlock *free = reinterpret_cast<FreeBlock *> (block);
+  free->next = cache->m_free[c];
+  cache->m_free[c] = free;
+  ++cache->m_nFree[c];
+  ++cache->m_stats.cachedBlocks;
+  cache->m_stats.cachedBytes += size;
+}
+
+SizeClassPoolStats
+SizeClassPoolCache::GetStats (SizeClassPoolCache * const *slot)
+{
+  SizeClassPoolStats stats;
+  if (*slot == 0 || *slot == DESTROYED)
+    {
+      std::memset (&stats, 0, sizeof (stats));
+      return stats;
+    }
+  return (*slot)->m_stats;
+}
+
+} // namespace ns3
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIZE_CLASS_POOL_H
+#define SIZE_CLASS_POOL_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ * \brief Statistics of a SizeClassPool, in one thread.
+ */
+struct SizeClassPoolStats
+{
+  uint64_t allocations;   //!< Number of blocks allocated
+  uint64_t hits;          //!< Number of allocations served from the pool
+  uint64_t deallocations; //!< Number of blocks deallocated
+  uint64_t releases;      //!< Number of deallocated blocks freed rather than kept
+  uint64_t cachedBlocks;  //!< Number of free blocks kept by the pool
+  uint64_t cachedBytes;   //!< Total size of the free blocks kept by the pool
+};
+
+/**
+ * \ingroup packet
+ * \brief The free blocks of a SizeClassPool, in one thread.
+ *
+ * This is the implementation of SizeClassPool, which holds a pointer to
+ * the cache of each thread.
+ */
+class SizeClassPoolCache
+{
+public:
+  /**
+   * Allocate a block from the cache of the calling thread.
+   * \param [in,out] slot The pointer to the cache of the calling thread,
+   *        created on first use.
+   * \param [in,out] size The requested size, rounded up to the size
+   *        of the block.
+   * \returns The block.
+   */
+  static uint8_t * Allocate (SizeClassPoolCache **slot, uint32_t &size);
+  /**
+   * Return a block to the cache of the calling thread.
+   * \param [in,out] slot The pointer to the cache of the calling thread.
+   * \param [in] block The block.
+   * \param [in] size The size of the block, as returned by Allocate.
+   */
+  static void Deallocate (SizeClassPoolCache **slot, uint8_t *block, uint32_t size);
+  /**
+   * Get the statistics of the cache of the calling thread.
+   * \param [in] slot The pointer to the cache of the calling thread.
+   * \returns The statistics, all zero if the cache was not created.
+   */
+  static SizeClassPoolStats GetStats (SizeClassPoolCache * const *slot);
+
+  /**
+   * Destructor; frees the blocks of the cache.
+   */
+  ~SizeClassPoolCache ();
+
+private:
+  /**
+   * Constructor.
+   * \param [in] slot The pointer to this cache.
+   */
+  SizeClassPoolCache (SizeClassPoolCache **slot);
+  /**
+   * Get the cache of the calling thread, and create it if needed.
+   * \param [in,out] slot The pointer to the cache of the calling thread.
+   * \returns The cache, or 0 after the calling thread destroyed it.
+   */
+  static SizeClassPoolCache * Get (SizeClassPoolCache **slot);
+
+  /** A free block, linked to the next one of its size class. */
+  struct FreeBlock
+  {
+    FreeBlock *next; //!< The next free block
+  };
+
+  /** The size of the smallest class. */
+  static const uint32_t MIN_SIZE = 64;
+  /** The number of size classes, of sizes MIN_SIZE * 2^i. */
+  static const uint32_t N_CLASSES = 11;
+  /** The total size of the free blocks kept for each class. */
+  static const uint32_t MAX_CACHED_BYTES = 4 * 1024 * 1024;
+
+  SizeClassPoolCache **m_slot;         //!< The pointer to this cache
+  FreeBlock *m_free[N_CLASSES];        //!< The free blocks of each class
+  uint32_t m_nFree[N_CLASSES];         //!< The number of free blocks of each class
+  SizeClassPoolStats m_stats;          //!< The statistics
+};
+
+/**
+ * \ingroup packet
+ * \brief A per-thread pool of memory blocks, in power of two size classes.
+ *
+ * Each thread keeps the blocks it deallocates, by size class, from 64
+ * bytes to 64 KiB, and allocates from them first, without locks.  A block
+ * may be deallocated by another thread than the one which allocated it;
+ * it then joins the pool of that thread.  Larger blocks are not pooled.
+ * The blocks kept by a thread are freed when the thread exits.
+ *
+ * Allocate rounds the requested size up to the size of the block, so
+ * that the caller can use the extra bytes, and must pass that size
+ * back to Deallocate.
+ *
+ * \tparam T \explicit The user of the pool; each type has its own pool
+ *         and statistics.
+ */
+template <typename T>
+class SizeClassPool
+{
+public:
+  /**
+   * Allocate a block.
+   * \param [in,out] size The requested size, rounded up to the size
+   *        of the block.
+   * \returns The block.
+   */
+  static uint8_t * Allocate (uint32_t &size)
+  {
+    return SizeClassPoolCache::Allocate (&t_cache, size);
+  }
+  /**
+   * Deallocate a block.
+   * \param [in] block The block.
+   * \param [in] size The size of the block, as returned by Allocate.
+   */
+  static void Deallocate (uint8_t *block, uint32_t size)
+  {
+    SizeClassPoolCache::Deallocate (&t_cache, block, size);
+  }
+  /**
+   * Get the statistics of the pool of the calling thread.
+   * \returns The statistics.
+   */
+  static SizeClassPoolStats GetStats (void)
+  {
+    return SizeClassPoolCache::GetStats (&t_cache);
+  }
+
+private:
+  /** The cache of the calling thread. */
+  static thread_local SizeClassPoolCache *t_cache;
+};
+
+template <typename T>
+thread_local SizeClassPoolCache *SizeClassPool<T>::t_cache = 0;
+
+} // namespace ns3
+
+#endif /* SIZE_CLASS_POOL_H */
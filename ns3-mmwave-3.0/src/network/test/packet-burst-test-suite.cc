@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/packet-burst.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PacketBurst accessors test
+ */
+class PacketBurstTestCase : public TestCase
+{
+public:
+  PacketBurstTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+PacketBurstTestCase::PacketBurstTestCase ()
+  : TestCase ("Check the PacketBurst accessors")
+{}
+
+void
+PacketBurstTestCase::DoRun (void)
+{
+  Ptr<PacketBurst> burst = CreateObject<PacketBurst> ();
+  Ptr<Packet> packets[3] = { Create<Packet> (10), Create<Packet> (20), Create<Packet> (30) };
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      burst->AddPacket (packets[i]);
+    }
+  burst->AddPacket (0);
+  NS_TEST_ASSERT_MSG_EQ (burst->GetNPackets (), 3, "Null packets should not be added");
+  NS_TEST_EXPECT_MSG_EQ (burst->GetSize (), 60, "Wrong burst size");
+
+  uint32_t i = 0;
+  for (const Ptr<Packet> &packet : burst->GetPackets ())
+    {
+      NS_TEST_EXPECT_MSG_EQ (packet, packets[i], "Packets not kept in order");
+      ++i;
+    }
+  NS_TEST_EXPECT_MSG_EQ ((burst->Begin () + 3 == burst->End ()), true, "Wrong iterators");
+
+  Ptr<PacketBurst> copy = burst->Copy ();
+  NS_TEST_EXPECT_MSG_EQ (copy->GetNPackets (), 3, "Wrong number of copied packets");
+  NS_TEST_EXPECT_MSG_NE (copy->GetPackets ().front (), packets[0], "Packets not copied");
+  NS_TEST_EXPECT_MSG_EQ (copy->GetSize (), 60, "Wrong size of the copy");
+
+  std::vector<Ptr<Packet> > taken = burst->TakePackets ();
+  NS_TEST_EXPECT_MSG_EQ (burst->GetNPackets (), 0, "Packets not removed from the burst");
+  NS_TEST_EXPECT_MSG_EQ (burst->GetSize (), 0, "Packets not removed from the burst");
+  NS_TEST_ASSERT_MSG_EQ (taken.size (), 3, "Wrong number of packets taken");
+  NS_TEST_EXPECT_MSG_EQ (taken[2], packets[2], "Packets taken out of order");
+  NS_TEST_EXPECT_MSG_EQ (copy->GetNPackets (), 3, "Taking the packets changed the copy");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PacketBurst TestSuite
+ */
+class PacketBurstTestSuite : public TestSuite
+{
+public:
+  PacketBurstTestSuite ();
+};
+
+PacketBurstTestSuite::PacketBurstTestSuite ()
+  : TestSuite ("packet-burst", UNIT)
+{
+  AddTestCase (new PacketBurstTestCase, TestCase::QUICK);
+}
+
+static PacketBurstTestSuite g_packetBurstTestSuite; //!< Static variable for test initialization
@@ -18,8 +18,11 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "ns3/packet.h"
+#include "ns3/packet-binary-trace.h"
 #include "ns3/packet-tag-list.h"
+#include "ns3/binary-trace-recorder.h"
 #include "ns3/test.h"
+#include "ns3/traced-callback.h"
 #include "ns3/unused.h"
 #include <limits>     // std:numeric_limits
 #include <string>
@@ -973,6 +976,36 @@ PacketTagListTest::DoRun (void)
 #   undef RemoveCheck
   }  // Removal
 
+  { // Tag sets larger than the inline storage
+    std::cout << GetName () << "check large tag sets" << std::endl;
+    ALargeTestTag large;
+    PacketTagList ptl = ref;
+    ptl.Add (large);
+    PacketTagList cpy = ptl;  // shares the storage of ptl
+    cpy.Remove (t1);
+    CheckRefList (ref, "large, orig");
+    CheckRefList (ptl, "large, shared");
+    CheckRefList (cpy, "large, copy", 1);
+    NS_TEST_EXPECT_MSG_EQ (ref.Peek (large), false, "large, orig");
+    NS_TEST_EXPECT_MSG_EQ (ptl.Peek (large), true, "large, shared");
+    NS_TEST_EXPECT_MSG_EQ (cpy.Peek (large), true, "large, copy");
+    cpy.Remove (large);
+    cpy.Remove (t2);
+    CheckRef (cpy, t3, "large, small copy");
+    NS_TEST_EXPECT_MSG_EQ (ptl.Peek (large), true, "large, shared after copy removal");
+
+    // Packet tags are iterated from the most recent one
+    Ptr<Packet> p = Create<Packet> ();
+    p->AddPacketTag (t1);
+    p->AddPacketTag (large);
+    p->AddPacketTag (t2);
+    PacketTagIterator i = p->GetPacketTagIterator ();
+    NS_TEST_EXPECT_MSG_EQ (i.Next ().GetTypeId (), t2.GetTypeId (), "iteration order");
+    NS_TEST_EXPECT_MSG_EQ (i.Next ().GetTypeId (), large.GetTypeId (), "iteration order");
+    NS_TEST_EXPECT_MSG_EQ (i.Next ().GetTypeId (), t1.GetTypeId (), "iteration order");
+    NS_TEST_EXPECT_MSG_EQ (i.HasNext (), false, "iteration end");
+  }
+
   { // Replace
 
     std::cout << GetName () << "check replacing each tag" << std::endl;
@@ -1035,6 +1068,301 @@ PacketTagListTest::DoRun (void)
     
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief An object with packet trace sources.
+ *
+ * \note Class internal to packet-test-suite.cc
+ */
+class PacketTraceSourceObject : public Object
+{
+public:
+  /**
+   * \brief Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("PacketTraceSourceObject")
+      .SetParent<Object> ()
+      .AddTraceSource ("Tx", "A packet trace source.",
+                       MakeTraceSourceAccessor (&PacketTraceSourceObject::m_tx),
+                       "ns3::Packet::TracedCallback")
+      .AddTraceSource ("RxMac", "A packet and address trace source.",
+                       MakeTraceSourceAccessor (&PacketTraceSourceObject::m_rxMac),
+                       "ns3::Packet::Mac48AddressTracedCallback")
+    ;
+    return tid;
+  }
+  TracedCallback<Ptr<const Packet> > m_tx;                 //!< Tx trace source
+  TracedCallback<Ptr<const Packet>, Mac48Address> m_rxMac; //!< RxMac trace source
+};
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Packet binary trace recording test
+ */
+class PacketBinaryTraceTest : public TestCase
+{
+public:
+  PacketBinaryTraceTest ();
+private:
+  virtual void DoRun (void);
+};
+
+PacketBinaryTraceTest::PacketBinaryTraceTest ()
+  : TestCase ("Record packet trace sources with BinaryTraceRecorder")
+{}
+
+void
+PacketBinaryTraceTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("packet-binary-trace.bin");
+  Ptr<PacketTraceSourceObject> object = CreateObject<PacketTraceSourceObject> ();
+  BinaryTraceRecorder recorder;
+  recorder.Open (filename);
+  NS_TEST_ASSERT_MSG_EQ (recorder.Record (object, "Tx", "Tx"), true, "Recorded Tx");
+  NS_TEST_ASSERT_MSG_EQ (recorder.Record (object, "RxMac", "RxMac"), true, "Recorded RxMac");
+
+  Ptr<Packet> packet = Create<Packet> (100);
+  Mac48Address address ("00:01:02:03:04:05");
+  object->m_tx (packet);
+  object->m_rxMac (packet, address);
+  recorder.Close ();
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to open the trace file");
+  BinaryTraceReader::Record record;
+  NS_TEST_ASSERT_MSG_EQ (reader.Next (record), true, "Missing the Tx record");
+  NS_TEST_ASSERT_MSG_EQ (record.GetSource (), 0, "Tx record source");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<uint64_t> (), packet->GetUid (), "Tx packet uid");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<uint32_t> (), 100, "Tx packet size");
+  NS_TEST_ASSERT_MSG_EQ (reader.Next (record), true, "Missing the RxMac record");
+  NS_TEST_ASSERT_MSG_EQ (record.GetSource (), 1, "RxMac record source");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<uint64_t> (), packet->GetUid (), "RxMac packet uid");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<uint32_t> (), 100, "RxMac packet size");
+  NS_TEST_ASSERT_MSG_EQ (record.Read<Mac48Address> (), address, "RxMac address");
+  NS_TEST_ASSERT_MSG_EQ (reader.Next (record), false, "Unexpected record");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Header with a value, which counts its deserializations.
+ *
+ * \note Class internal to packet-test-suite.cc
+ */
+class VirtualTestHeader : public Header
+{
+public:
+  /**
+   * Constructor.
+   * \param value The value of the header.
+   */
+  VirtualTestHeader (uint16_t value = 0)
+    : m_value (value)
+  {}
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("VirtualTestHeader")
+      .SetParent<Header> ()
+      .SetGroupName ("Network")
+      .HideFromDocumentation ()
+      .AddConstructor<VirtualTestHeader> ()
+    ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const
+  {
+    return GetTypeId ();
+  }
+  virtual uint32_t GetSerializedSize (void) const
+  {
+    return 2;
+  }
+  virtual void Serialize (Buffer::Iterator iter) const
+  {
+    iter.WriteHtonU16 (m_value);
+  }
+  virtual uint32_t Deserialize (Buffer::Iterator iter)
+  {
+    ++m_nDeserialized;
+    m_value = iter.ReadNtohU16 ();
+    return 2;
+  }
+  virtual void Print (std::ostream &os) const
+  {
+    os << m_value;
+  }
+
+  uint16_t m_value;               //!< The value
+  static uint32_t m_nDeserialized; //!< The number of deserializations
+};
+
+uint32_t VirtualTestHeader::m_nDeserialized = 0;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Packet virtual headers test
+ */
+class PacketVirtualHeadersTest : public TestCase
+{
+public:
+  PacketVirtualHeadersTest ();
+private:
+  virtual void DoRun (void);
+};
+
+PacketVirtualHeadersTest::PacketVirtualHeadersTest ()
+  : TestCase ("Check header copies with Packet::EnableVirtualHeaders")
+{}
+
+void
+PacketVirtualHeadersTest::DoRun (void)
+{
+  // The mode is global: restore it for the other tests
+  bool virtualHeaders = Packet::AreVirtualHeadersEnabled ();
+  Packet::EnableVirtualHeaders ();
+  VirtualTestHeader::m_nDeserialized = 0;
+
+  Ptr<Packet> p = Create<Packet> (10);
+  p->AddByteTag (ATestTag<1> ());
+  p->AddHeader (VirtualTestHeader (5));
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 12, "Wrong size with a header copy");
+  ByteTagIterator::Item item = p->GetByteTagIterator ().Next ();
+  NS_TEST_EXPECT_MSG_EQ (item.GetStart (), 2, "The byte tag did not move");
+  NS_TEST_EXPECT_MSG_EQ (item.GetEnd (), 12, "The byte tag did not move");
+
+  VirtualTestHeader header;
+  NS_TEST_EXPECT_MSG_EQ (p->PeekHeader (header), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 5, "Wrong peeked header");
+  NS_TEST_EXPECT_MSG_EQ (p->RemoveHeader (header), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 5, "Wrong removed header");
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 10, "Wrong size without the header");
+  item = p->GetByteTagIterator ().Next ();
+  NS_TEST_EXPECT_MSG_EQ (item.GetStart (), 0, "The byte tag did not move back");
+  NS_TEST_EXPECT_MSG_EQ (item.GetEnd (), 10, "The byte tag did not move back");
+  NS_TEST_EXPECT_MSG_EQ (VirtualTestHeader::m_nDeserialized, 0, "The header was deserialized");
+
+  // The copies of a packet share the header copies
+  p->AddHeader (VirtualTestHeader (7));
+  Ptr<Packet> copy = p->Copy ();
+  copy->AddHeader (VirtualTestHeader (9));
+  NS_TEST_EXPECT_MSG_EQ (copy->GetSize (), 14, "Wrong size with two header copies");
+
+  // Reading the bytes serializes the headers
+  uint8_t bytes[14];
+  NS_TEST_EXPECT_MSG_EQ (copy->CopyData (bytes, 14), 14, "Wrong number of bytes");
+  NS_TEST_EXPECT_MSG_EQ (bytes[1], 9, "Wrong first header bytes");
+  NS_TEST_EXPECT_MSG_EQ (bytes[3], 7, "Wrong second header bytes");
+  NS_TEST_EXPECT_MSG_EQ (copy->GetSize (), 14, "Wrong size after serializing");
+  NS_TEST_EXPECT_MSG_EQ (copy->RemoveHeader (header), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 9, "Wrong serialized header");
+  NS_TEST_EXPECT_MSG_EQ (VirtualTestHeader::m_nDeserialized, 1, "The header was not deserialized");
+
+  NS_TEST_EXPECT_MSG_EQ (p->RemoveHeader (header), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 7, "Wrong header in the original packet");
+  NS_TEST_EXPECT_MSG_EQ (VirtualTestHeader::m_nDeserialized, 1, "The header was deserialized");
+
+  // A header of another type reads the serialized bytes
+  p->AddHeader (VirtualTestHeader (0x0202));
+  ATestHeader<2> other;
+  NS_TEST_EXPECT_MSG_EQ (p->RemoveHeader (other), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (other.m_error, false, "Wrong bytes for another header type");
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 10, "Wrong size after removing the header");
+
+  // Disabled, the headers are serialized again, and the copies still work
+  p->AddHeader (VirtualTestHeader (11));
+  Packet::DisableVirtualHeaders ();
+  NS_TEST_EXPECT_MSG_EQ (Packet::AreVirtualHeadersEnabled (), false, "Virtual headers not disabled");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekHeader (header), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 11, "Wrong header copy");
+  NS_TEST_EXPECT_MSG_EQ (VirtualTestHeader::m_nDeserialized, 1, "The header copy was deserialized");
+  p->AddHeader (VirtualTestHeader (13));
+  NS_TEST_EXPECT_MSG_EQ (p->RemoveHeader (header), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 13, "Wrong serialized header");
+  NS_TEST_EXPECT_MSG_EQ (VirtualTestHeader::m_nDeserialized, 2, "The header was not serialized");
+  NS_TEST_EXPECT_MSG_EQ (p->RemoveHeader (header), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 11, "Wrong header under the serialized one");
+
+  if (virtualHeaders)
+    {
+      Packet::EnableVirtualHeaders ();
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Packet peeked header cache test
+ */
+class PacketPeekedHeaderTest : public TestCase
+{
+public:
+  PacketPeekedHeaderTest ();
+private:
+  virtual void DoRun (void);
+};
+
+PacketPeekedHeaderTest::PacketPeekedHeaderTest ()
+  : TestCase ("Check the copy of the last header read by PeekHeader")
+{}
+
+void
+PacketPeekedHeaderTest::DoRun (void)
+{
+  // The mode is global: restore it for the other tests
+  bool virtualHeaders = Packet::AreVirtualHeadersEnabled ();
+  Packet::EnableVirtualHeaders ();
+  VirtualTestHeader::m_nDeserialized = 0;
+
+  // A header added as a Header is serialized
+  Ptr<Packet> p = Create<Packet> (10);
+  VirtualTestHeader added (3);
+  p->AddHeader (static_cast<const Header &> (added));
+
+  VirtualTestHeader header;
+  NS_TEST_EXPECT_MSG_EQ (p->PeekHeader (header), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 3, "Wrong peeked header");
+  NS_TEST_EXPECT_MSG_EQ (VirtualTestHeader::m_nDeserialized, 1, "The header was not deserialized");
+
+  // Reading it again, in the packet or in a copy, uses the copy
+  VirtualTestHeader again;
+  NS_TEST_EXPECT_MSG_EQ (p->PeekHeader (again), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (again.m_value, 3, "Wrong header peeked again");
+  Ptr<Packet> copy = p->Copy ();
+  NS_TEST_EXPECT_MSG_EQ (copy->RemoveHeader (again), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (again.m_value, 3, "Wrong header removed from the copy");
+  NS_TEST_EXPECT_MSG_EQ (copy->GetSize (), 10, "Wrong size after removing the header");
+  NS_TEST_EXPECT_MSG_EQ (VirtualTestHeader::m_nDeserialized, 1, "The header was deserialized again");
+
+  // Writes discard the copy
+  p->AddPaddingAtEnd (1);
+  NS_TEST_EXPECT_MSG_EQ (p->PeekHeader (header), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (VirtualTestHeader::m_nDeserialized, 2, "The copy was not discarded");
+  p->RemoveAtStart (1);
+  NS_TEST_EXPECT_MSG_EQ (p->PeekHeader (header), 2, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (header.m_value, 3 << 8, "The copy was not discarded");
+  NS_TEST_EXPECT_MSG_EQ (VirtualTestHeader::m_nDeserialized, 3, "The copy was not discarded");
+
+  if (!virtualHeaders)
+    {
+      Packet::DisableVirtualHeaders ();
+    }
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1050,8 +1378,14 @@ public:
 PacketTestSuite::PacketTestSuite ()
   : TestSuite ("packet", UNIT)
 {
+#ifndef DISABLE_PACKET_METADATA
+  // Checks that byte tags follow the headers, fragments and concatenations
   AddTestCase (new PacketTest, TestCase::QUICK);
+#endif
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketBinaryTraceTest, TestCase::QUICK);
+  AddTestCase (new PacketVirtualHeadersTest, TestCase::QUICK);
+  AddTestCase (new PacketPeekedHeaderTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,290 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/pcap-file.h"
+#include "ns3/trace-helper.h"
+#include "ns3/pcap-reader.h"
+#include "ns3/pcap-replay-application.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/packet-socket-helper.h"
+#include "ns3/packet-socket-address.h"
+#include "ns3/mac48-address.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include <unistd.h>
+#include <vector>
+
+using namespace ns3;
+
+/// Number of records of the test file.
+static const uint32_t N_RECORDS = 7;
+/// Capture times of the records, in microseconds.
+static const uint32_t g_times[N_RECORDS] = { 0, 1000, 2500, 2500, 7000, 10000, 10001 };
+/// Lengths of the Ethernet frames of the records.
+static const uint32_t g_sizes[N_RECORDS] = { 60, 100, 1500, 14, 200, 80, 90 };
+/// Snap length of the test file.
+static const uint32_t SNAPLEN = 128;
+
+/**
+ * Write the test file, of Ethernet frames of IPv4 packets.
+ * \param filename The name of the file.
+ * \param swapMode Whether to write the file in the other byte order.
+ * \param nanosecMode Whether to write nanosecond timestamps.
+ */
+static void
+WriteTestFile (std::string const &filename, bool swapMode, bool nanosecMode)
+{
+  PcapFile f;
+  f.Open (filename, std::ios::out);
+  f.Init (PcapHelper::DLT_EN10MB, SNAPLEN, 0, swapMode, nanosecMode);
+  uint8_t frame[1500];
+  for (uint32_t i = 0; i < sizeof (frame); ++i)
+    {
+      frame[i] = i & 0xff;
+    }
+  // A destination other than the receiver, and IPv4
+  Mac48Address ("00:00:00:00:00:99").CopyTo (frame);
+  frame[12] = 0x08;
+  frame[13] = 0x00;
+  for (uint32_t i = 0; i < N_RECORDS; ++i)
+    {
+      uint32_t subsec = nanosecMode ? g_times[i] * 1000 : g_times[i];
+      f.Write (10, subsec, frame, g_sizes[i]);
+    }
+  f.Close ();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PcapReader test: the records read through the memory mapping.
+ */
+class PcapReaderTestCase : public TestCase
+{
+public:
+  PcapReaderTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Read the test file.
+   * \param swapMode Whether the file has the other byte order.
+   * \param nanosecMode Whether the file has nanosecond timestamps.
+   */
+  void CheckFile (bool swapMode, bool nanosecMode);
+};
+
+PcapReaderTestCase::PcapReaderTestCase ()
+  : TestCase ("Check that PcapReader reads the records of pcap files")
+{}
+
+void
+PcapReaderTestCase::CheckFile (bool swapMode, bool nanosecMode)
+{
+  std::string filename = CreateTempDirFilename ("reader.pcap");
+  WriteTestFile (filename, swapMode, nanosecMode);
+
+  PcapReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot open " << filename);
+  NS_TEST_EXPECT_MSG_EQ (reader.GetDataLinkType (), PcapHelper::DLT_EN10MB, "Wrong data link type");
+  NS_TEST_EXPECT_MSG_EQ (reader.GetSnapLen (), SNAPLEN, "Wrong snap length");
+  NS_TEST_EXPECT_MSG_EQ (reader.IsNanoSecMode (), nanosecMode, "Wrong timestamp resolution");
+  for (uint32_t pass = 0; pass < 2; ++pass)
+    {
+      PcapReader::Record record;
+      for (uint32_t i = 0; i < N_RECORDS; ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (reader.Next (record), true, "Missing record " << i);
+          NS_TEST_EXPECT_MSG_EQ (record.time, 10000000000ULL + g_times[i] * 1000ULL, "Wrong time of record " << i);
+          NS_TEST_EXPECT_MSG_EQ (record.origLen, g_sizes[i], "Wrong length of record " << i);
+          NS_TEST_EXPECT_MSG_EQ (record.inclLen, std::min (g_sizes[i], SNAPLEN), "Wrong captured length of record " << i);
+          NS_TEST_EXPECT_MSG_EQ ((uint32_t) record.data[12], 0x08, "Wrong bytes of record " << i);
+          if (record.inclLen > 14)
+            {
+              NS_TEST_EXPECT_MSG_EQ ((uint32_t) record.data[record.inclLen - 1], ((record.inclLen - 1) & 0xff),
+                                     "Wrong bytes of record " << i);
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (reader.Next (record), false, "Record after the end of the file");
+      reader.Rewind ();
+    }
+  reader.Close ();
+
+  // A truncated last record is not read
+  NS_TEST_ASSERT_MSG_EQ (truncate (filename.c_str (), 24 + N_RECORDS * 16 + 60 + 100 + 128 + 14 + 128 + 80 + 89), 0,
+                         "Cannot truncate " << filename);
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot open " << filename);
+  uint32_t n = 0;
+  PcapReader::Record record;
+  while (reader.Next (record))
+    {
+      ++n;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, N_RECORDS - 1, "Truncated record read");
+}
+
+void
+PcapReaderTestCase::DoRun (void)
+{
+  CheckFile (false, false);
+  CheckFile (true, false);
+  CheckFile (false, true);
+
+  PcapReader reader;
+  NS_TEST_EXPECT_MSG_EQ (reader.Open (CreateTempDirFilename ("no-such-file.pcap")), false,
+                         "Opened a missing file");
+  NS_TEST_EXPECT_MSG_EQ (reader.IsOpen (), false, "Opened a missing file");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PcapReplayApplication test: the packets replayed to a NetDevice
+ * or to a PacketSocket, at the recorded times.
+ */
+class PcapReplayTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param toDevice Whether to send the packets to the NetDevice rather
+   *        than to a socket.
+   */
+  PcapReplayTestCase (bool toDevice);
+private:
+  virtual void DoRun (void);
+  /**
+   * Receive a packet.
+   * \param device The receiving device.
+   * \param packet The packet.
+   * \param protocol The protocol number.
+   * \param from The source address.
+   * \param to The destination address.
+   * \param type The packet type.
+   */
+  void Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                const Address &from, const Address &to, NetDevice::PacketType type);
+
+  bool m_toDevice;                    //!< Whether the packets are sent to the NetDevice
+  std::vector<Time> m_times;          //!< Reception times
+  std::vector<Ptr<Packet> > m_packets; //!< Received packets
+};
+
+PcapReplayTestCase::PcapReplayTestCase (bool toDevice)
+  : TestCase (std::string ("Check that PcapReplayApplication replays a pcap file to ")
+              + (toDevice ? "a NetDevice" : "a socket")),
+    m_toDevice (toDevice)
+{}
+
+void
+PcapReplayTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                             const Address &from, const Address &to, NetDevice::PacketType type)
+{
+  NS_TEST_EXPECT_MSG_EQ (protocol, 0x0800, "Wrong protocol number");
+  m_times.push_back (Simulator::Now ());
+  m_packets.push_back (packet->Copy ());
+}
+
+void
+PcapReplayTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("replay.pcap");
+  WriteTestFile (filename, false, false);
+
+  Ptr<Node> sender = CreateObject<Node> ();
+  Ptr<Node> receiver = CreateObject<Node> ();
+  NodeContainer nodes (sender, receiver);
+  SimpleNetDeviceHelper helper;
+  NetDeviceContainer devices = helper.Install (nodes);
+  receiver->RegisterProtocolHandler (MakeCallback (&PcapReplayTestCase::Receive, this),
+                                     0x0800, devices.Get (1));
+
+  Ptr<PcapReplayApplication> app = CreateObject<PcapReplayApplication> ();
+  app->SetAttribute ("File", StringValue (filename));
+  app->SetAttribute ("Speed", DoubleValue (2));
+  app->SetAttribute ("BatchSize", UintegerValue (3));
+  if (m_toDevice)
+    {
+      app->SetAttribute ("Remote", AddressValue (devices.Get (1)->GetAddress ()));
+      app->SetDevice (devices.Get (0));
+    }
+  else
+    {
+      PacketSocketHelper packetSocket;
+      packetSocket.Install (sender);
+      PacketSocketAddress remote;
+      remote.SetSingleDevice (devices.Get (0)->GetIfIndex ());
+      remote.SetPhysicalAddress (devices.Get (1)->GetAddress ());
+      remote.SetProtocol (0x0800);
+      app->SetAttribute ("Remote", AddressValue (remote));
+      app->SetAttribute ("HeaderSize", UintegerValue (14));
+    }
+  sender->AddApplication (app);
+  app->SetStartTime (Seconds (1));
+  app->SetStopTime (Seconds (1.004));
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // The stop time cancels the last two records.  The receiver only
+  // gets the packets sent to its address, rather than to the recorded one.
+  uint32_t n = N_RECORDS - 2;
+  NS_TEST_EXPECT_MSG_EQ (app->GetSent (), n, "Wrong number of packets sent");
+  NS_TEST_ASSERT_MSG_EQ (m_packets.size (), n, "Wrong number of packets received");
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_times[i], Seconds (1) + NanoSeconds (g_times[i] * 500),
+                             "Wrong time of packet " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_packets[i]->GetSize (), g_sizes[i] - 14, "Wrong size of packet " << i);
+      uint8_t bytes[1500];
+      m_packets[i]->CopyData (bytes, sizeof (bytes));
+      uint32_t captured = std::min (g_sizes[i], SNAPLEN) - 14;
+      for (uint32_t j = 0; j < m_packets[i]->GetSize (); ++j)
+        {
+          uint8_t expected = j < captured ? (j + 14) & 0xff : 0;
+          NS_TEST_ASSERT_MSG_EQ ((uint32_t) bytes[j], (uint32_t) expected,
+                                 "Wrong byte " << j << " of packet " << i);
+        }
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PcapReader and PcapReplayApplication TestSuite
+ */
+class PcapReplayTestSuite : public TestSuite
+{
+public:
+  PcapReplayTestSuite ();
+};
+
+PcapReplayTestSuite::PcapReplayTestSuite ()
+  : TestSuite ("pcap-replay", UNIT)
+{
+  AddTestCase (new PcapReaderTestCase, TestCase::QUICK);
+  AddTestCase (new PcapReplayTestCase (true), TestCase::QUICK);
+  AddTestCase (new PcapReplayTestCase (false), TestCase::QUICK);
+}
+
+static PcapReplayTestSuite g_pcapReplayTestSuite; //!< Static variable for test initialization
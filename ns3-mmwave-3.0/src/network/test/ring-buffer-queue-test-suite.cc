@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ring-buffer-queue.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/data-rate.h"
+#include <deque>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * RingBufferQueue unit tests: FIFO order across the wrap around and the
+ * growth of the ring buffer.
+ */
+class RingBufferQueueOrderTestCase : public TestCase
+{
+public:
+  RingBufferQueueOrderTestCase ();
+  virtual void DoRun (void);
+};
+
+RingBufferQueueOrderTestCase::RingBufferQueueOrderTestCase ()
+  : TestCase ("Check the FIFO order of the ring buffer queue")
+{
+}
+
+void
+RingBufferQueueOrderTestCase::DoRun (void)
+{
+  Ptr<RingBufferQueue<Packet> > queue = CreateObject<RingBufferQueue<Packet> > ();
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("MaxSize", StringValue ("1000p")), true,
+                         "Verify that we can actually set the attribute");
+  NS_TEST_EXPECT_MSG_EQ ((queue->Dequeue () == 0), true, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ ((queue->Peek () == 0), true, "The queue should be empty");
+
+  // Fill and drain the queue in waves of growing, then shrinking, sizes
+  std::deque<Ptr<Packet> > expected;
+  for (uint32_t wave = 0; wave < 40; ++wave)
+    {
+      uint32_t n = wave < 20 ? 7 * wave + 1 : 7 * (40 - wave);
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          Ptr<Packet> p = Create<Packet> (i);
+          NS_TEST_ASSERT_MSG_EQ (queue->Enqueue (p), true, "The queue should not be full");
+          expected.push_back (p);
+        }
+      NS_TEST_ASSERT_MSG_EQ (queue->GetNPackets (), expected.size (), "Wrong number of packets");
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (queue->GetCapacity (), expected.size (), "The ring buffer is too small");
+      uint32_t m = n - n / 4 + wave % 3;
+      for (uint32_t i = 0; i < m && !expected.empty (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (queue->Peek (), expected.front (), "Wrong packet at the head");
+          Ptr<Packet> p = queue->Dequeue ();
+          NS_TEST_ASSERT_MSG_EQ (p->GetUid (), expected.front ()->GetUid (), "Wrong packet order");
+          expected.pop_front ();
+        }
+    }
+  uint32_t capacity = queue->GetCapacity ();
+  NS_TEST_EXPECT_MSG_EQ ((capacity & (capacity - 1)), 0, "The capacity should be a power of two");
+  NS_TEST_EXPECT_MSG_LT (capacity, 2 * 1000, "The ring buffer should not exceed twice the maximum size");
+  while (!expected.empty ())
+    {
+      Ptr<Packet> p = queue->Dequeue ();
+      NS_TEST_ASSERT_MSG_EQ ((p != 0), true, "Missing packet");
+      NS_TEST_ASSERT_MSG_EQ (p->GetUid (), expected.front ()->GetUid (), "Wrong packet order");
+      expected.pop_front ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ ((queue->Dequeue () == 0), true, "There are really no packets in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "There should be no bytes in there");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * RingBufferQueue unit tests: limits in bytes, statistics and traces.
+ */
+class RingBufferQueueLimitTestCase : public TestCase
+{
+public:
+  RingBufferQueueLimitTestCase ();
+  virtual void DoRun (void);
+};
+
+RingBufferQueueLimitTestCase::RingBufferQueueLimitTestCase ()
+  : TestCase ("Check the limits, the statistics and the traces of the ring buffer queue")
+{
+}
+
+/**
+ * Count the fired trace
+ * \param counter the counter of the trace
+ * \param item the item
+ */
+static void
+Count (uint32_t *counter, Ptr<const Packet> item)
+{
+  (*counter)++;
+}
+
+void
+RingBufferQueueLimitTestCase::DoRun (void)
+{
+  Ptr<RingBufferQueue<Packet> > queue = CreateObject<RingBufferQueue<Packet> > ();
+  queue->SetMaxSize (QueueSize ("1000B"));
+
+  uint32_t enqueued = 0;
+  uint32_t dequeued = 0;
+  uint32_t dropped = 0;
+  queue->TraceConnectWithoutContext ("Enqueue", MakeBoundCallback (&Count, &enqueued));
+  queue->TraceConnectWithoutContext ("Dequeue", MakeBoundCallback (&Count, &dequeued));
+  queue->TraceConnectWithoutContext ("Drop", MakeBoundCallback (&Count, &dropped));
+
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<Packet> (300)), true, "The packet should fit");
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<Packet> (300)), true, "The packet should fit");
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<Packet> (500)), false, "The packet should be dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<Packet> (400)), true, "The packet should fit");
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<Packet> (1)), false, "The packet should be dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 3, "There should be three packets in there");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 1000, "There should be 1000 bytes in there");
+
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue ()->GetSize (), 300, "Wrong packet dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove ()->GetSize (), 300, "Wrong packet removed");
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<Packet> (600)), true, "The packet should fit");
+  queue->Flush ();
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The queue should be empty");
+
+  NS_TEST_EXPECT_MSG_EQ (enqueued, 4, "Wrong number of Enqueue traces");
+  NS_TEST_EXPECT_MSG_EQ (dequeued, 4, "Wrong number of Dequeue traces");
+  NS_TEST_EXPECT_MSG_EQ (dropped, 5, "Wrong number of Drop traces");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalReceivedPackets (), 4, "Wrong number of received packets");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalReceivedBytes (), 1600, "Wrong number of received bytes");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPacketsBeforeEnqueue (), 2, "Wrong number of packets dropped before enqueue");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedBytesBeforeEnqueue (), 501, "Wrong number of bytes dropped before enqueue");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPacketsAfterDequeue (), 3, "Wrong number of packets dropped after dequeue");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedBytesAfterDequeue (), 1300, "Wrong number of bytes dropped after dequeue");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * RingBufferQueue as the transmit queue of a NetDevice.
+ */
+class RingBufferQueueDeviceTestCase : public TestCase
+{
+public:
+  RingBufferQueueDeviceTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Receive a packet
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the source address
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  std::vector<uint32_t> m_received; //!< The sizes of the received packets
+};
+
+RingBufferQueueDeviceTestCase::RingBufferQueueDeviceTestCase ()
+  : TestCase ("Check the ring buffer queue as the transmit queue of a NetDevice")
+{
+}
+
+bool
+RingBufferQueueDeviceTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                        uint16_t protocol, const Address &from)
+{
+  m_received.push_back (packet->GetSize ());
+  return true;
+}
+
+void
+RingBufferQueueDeviceTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper helper;
+  helper.SetQueue ("ns3::RingBufferQueue", "MaxSize", StringValue ("50p"));
+  helper.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("1Mbps")));
+  NetDeviceContainer devices = helper.Install (nodes);
+  devices.Get (1)->SetReceiveCallback (MakeCallback (&RingBufferQueueDeviceTestCase::Receive, this));
+
+  PointerValue ptr;
+  devices.Get (0)->GetAttribute ("TxQueue", ptr);
+  Ptr<RingBufferQueue<Packet> > queue = ptr.Get<RingBufferQueue<Packet> > ();
+  NS_TEST_ASSERT_MSG_NE (queue, 0, "The transmit queue should be a RingBufferQueue");
+
+  // The first packet is sent at once, and the others queued
+  for (uint32_t i = 0; i < 40; ++i)
+    {
+      devices.Get (0)->Send (Create<Packet> (100 + i), devices.Get (1)->GetAddress (), 0x0800);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 40, "Wrong number of received packets");
+  for (uint32_t i = 0; i < m_received.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_received[i], 100 + i, "Wrong packet order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalReceivedPackets (), 40, "Wrong number of enqueued packets");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The queue should be empty");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief RingBuffer Queue TestSuite
+ */
+class RingBufferQueueTestSuite : public TestSuite
+{
+public:
+  RingBufferQueueTestSuite ()
+    : TestSuite ("ring-buffer-queue", UNIT)
+  {
+    AddTestCase (new RingBufferQueueOrderTestCase (), TestCase::QUICK);
+    AddTestCase (new RingBufferQueueLimitTestCase (), TestCase::QUICK);
+    AddTestCase (new RingBufferQueueDeviceTestCase (), TestCase::QUICK);
+  }
+};
+
+static RingBufferQueueTestSuite g_ringBufferQueueTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/size-class-pool.h"
+#include "ns3/buffer.h"
+#include <thread>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Tag type for the pool under test.
+ */
+struct PoolTestTag
+{};
+
+/// The pool under test.
+typedef SizeClassPool<PoolTestTag> TestPool;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief SizeClassPool size classes, reuse and statistics test
+ */
+class SizeClassPoolTestCase : public TestCase
+{
+public:
+  SizeClassPoolTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+SizeClassPoolTestCase::SizeClassPoolTestCase ()
+  : TestCase ("Check SizeClassPool size classes, reuse and statistics")
+{}
+
+void
+SizeClassPoolTestCase::DoRun (void)
+{
+  uint32_t size = 100;
+  uint8_t *block = TestPool::Allocate (size);
+  NS_TEST_ASSERT_MSG_EQ (size, 128, "Size not rounded up to its class");
+  TestPool::Deallocate (block, size);
+
+  uint32_t size2 = 90;
+  uint8_t *block2 = TestPool::Allocate (size2);
+  NS_TEST_EXPECT_MSG_EQ (size2, 128, "Size not rounded up to its class");
+  NS_TEST_EXPECT_MSG_EQ ((block2 == block), true, "Free block not reused");
+
+  // Other classes do not take the block
+  uint32_t ackSize = 40;
+  uint8_t *ack = TestPool::Allocate (ackSize);
+  NS_TEST_EXPECT_MSG_EQ (ackSize, 64, "Wrong smallest class");
+  uint32_t jumboSize = 9000;
+  uint8_t *jumbo = TestPool::Allocate (jumboSize);
+  NS_TEST_EXPECT_MSG_EQ (jumboSize, 16384, "Wrong class for a jumbo frame");
+  uint32_t hugeSize = 100000;
+  uint8_t *huge = TestPool::Allocate (hugeSize);
+  NS_TEST_EXPECT_MSG_EQ (hugeSize, 100000, "Blocks larger than the classes are not rounded");
+
+  SizeClassPoolStats stats = TestPool::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.allocations, 5, "Wrong number of allocations");
+  NS_TEST_EXPECT_MSG_EQ (stats.hits, 1, "Wrong number of hits");
+  NS_TEST_EXPECT_MSG_EQ (stats.cachedBlocks, 0, "Wrong number of free blocks");
+
+  TestPool::Deallocate (block2, size2);
+  TestPool::Deallocate (ack, ackSize);
+  TestPool::Deallocate (jumbo, jumboSize);
+  TestPool::Deallocate (huge, hugeSize);
+  stats = TestPool::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.deallocations, 5, "Wrong number of deallocations");
+  NS_TEST_EXPECT_MSG_EQ (stats.releases, 1, "Only the huge block should be freed");
+  NS_TEST_EXPECT_MSG_EQ (stats.cachedBlocks, 3, "Wrong number of free blocks");
+  NS_TEST_EXPECT_MSG_EQ (stats.cachedBytes, 128 + 64 + 16384, "Wrong size of the free blocks");
+
+  // Each thread has its own pool
+  SizeClassPoolStats threadStats;
+  std::thread thread ([&threadStats] ()
+    {
+      uint32_t threadSize = 100;
+      uint8_t *threadBlock = TestPool::Allocate (threadSize);
+      TestPool::Deallocate (threadBlock, threadSize);
+      threadStats = TestPool::GetStats ();
+    });
+  thread.join ();
+  NS_TEST_EXPECT_MSG_EQ (threadStats.allocations, 1, "Wrong number of allocations in the thread");
+  NS_TEST_EXPECT_MSG_EQ (threadStats.hits, 0, "The thread used the pool of another thread");
+  NS_TEST_EXPECT_MSG_EQ (threadStats.cachedBlocks, 1, "Wrong number of free blocks in the thread");
+  NS_TEST_EXPECT_MSG_EQ (TestPool::GetStats ().allocations, 5, "The thread used the pool of another thread");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Buffer data pool test
+ */
+class BufferPoolTestCase : public TestCase
+{
+public:
+  BufferPoolTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+BufferPoolTestCase::BufferPoolTestCase ()
+  : TestCase ("Check the reuse of buffer data of mixed sizes")
+{}
+
+void
+BufferPoolTestCase::DoRun (void)
+{
+  const uint32_t sizes[] = { 40, 1500, 9000 };
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Buffer buffer;
+      buffer.AddAtStart (sizes[i]);
+    }
+  SizeClassPoolStats before = Buffer::GetPoolStats ();
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Buffer buffer;
+      buffer.AddAtStart (sizes[i]);
+      buffer.Begin ().WriteU8 (1);
+    }
+  SizeClassPoolStats after = Buffer::GetPoolStats ();
+  NS_TEST_EXPECT_MSG_GT (after.allocations, before.allocations, "No buffer data allocated");
+  NS_TEST_EXPECT_MSG_EQ (after.hits - before.hits, after.allocations - before.allocations,
+                         "Buffer data allocated outside of the pool");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief SizeClassPool TestSuite
+ */
+class SizeClassPoolTestSuite : public TestSuite
+{
+public:
+  SizeClassPoolTestSuite ();
+};
+
+SizeClassPoolTestSuite::SizeClassPoolTestSuite ()
+  : TestSuite ("size-class-pool", UNIT)
+{
+  AddTestCase (new SizeClassPoolTestCase, TestCase::QUICK);
+  AddTestCase (new BufferPoolTestCase, TestCase::QUICK);
+}
+
+static SizeClassPoolTestSuite g_sizeClassPoolTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,510 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/trace-filter.h"
+#include "ns3/trace-helper.h"
+#include "ns3/pcap-reader.h"
+#include "ns3/pcap-file-wrapper.h"
+#include "ns3/radiotap-header.h"
+#include "ns3/flow-id-tag.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/queue.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * TraceFilter unit tests: sampling, flow ids and flow callback.
+ */
+class TraceFilterSamplingTestCase : public TestCase
+{
+public:
+  TraceFilterSamplingTestCase ();
+  virtual void DoRun (void);
+};
+
+TraceFilterSamplingTestCase::TraceFilterSamplingTestCase ()
+  : TestCase ("Check the sampling and the flow ids of the trace filter")
+{
+}
+
+/**
+ * Select the packets of even size
+ * \param packet the packet
+ * \return true if the size of the packet is even
+ */
+static bool
+IsEven (Ptr<const Packet> packet)
+{
+  return packet->GetSize () % 2 == 0;
+}
+
+void
+TraceFilterSamplingTestCase::DoRun (void)
+{
+  Ptr<TraceFilter> filter = CreateObject<TraceFilter> ();
+  Ptr<Packet> p = Create<Packet> (10);
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (p), true, "Without criteria, all the packets are accepted");
+
+  filter->SetAttribute ("Sampling", UintegerValue (4));
+  std::vector<Ptr<Packet> > packets;
+  uint32_t accepted = 0;
+  for (uint32_t i = 0; i < 10000; ++i)
+    {
+      packets.push_back (Create<Packet> (10));
+      accepted += filter->Accept (packets.back ());
+    }
+  NS_TEST_EXPECT_MSG_GT (accepted, 2250, "Too few packets sampled");
+  NS_TEST_EXPECT_MSG_LT (accepted, 2750, "Too many packets sampled");
+  // A packet, or a copy of it, is sampled at every event
+  uint32_t again = 0;
+  for (uint32_t i = 0; i < packets.size (); ++i)
+    {
+      again += filter->Accept (packets[i]->Copy ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (again, accepted, "The same packets should be sampled");
+  NS_TEST_EXPECT_MSG_EQ (filter->GetAccepted (), 1 + 2 * accepted, "Wrong number of accepted packets");
+  NS_TEST_EXPECT_MSG_EQ (filter->GetRejected (), 2 * (10000 - accepted), "Wrong number of rejected packets");
+
+  // Flow ids, in byte or packet tags, and the flow callback
+  filter = CreateObject<TraceFilter> ();
+  filter->AddFlowId (2);
+  filter->AddFlowId (5);
+  Ptr<Packet> untagged = Create<Packet> (11);
+  Ptr<Packet> byteTagged = Create<Packet> (11);
+  byteTagged->AddByteTag (FlowIdTag (5));
+  Ptr<Packet> packetTagged = Create<Packet> (11);
+  packetTagged->AddPacketTag (FlowIdTag (2));
+  Ptr<Packet> otherFlow = Create<Packet> (11);
+  otherFlow->AddByteTag (FlowIdTag (3));
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (untagged), false, "A packet without flow id should be rejected");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (byteTagged), true, "The flow id of the byte tag should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (packetTagged), true, "The flow id of the packet tag should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (otherFlow), false, "Another flow id should be rejected");
+
+  filter->SetFlowFilter (MakeCallback (&IsEven));
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (Create<Packet> (12)), true, "The flow callback should accept the packet");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (untagged), false, "No flow should accept the packet");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * TraceFilter unit tests: 5-tuples, across data link types.
+ */
+class TraceFilterFiveTupleTestCase : public TestCase
+{
+public:
+  TraceFilterFiveTupleTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Build an IPv4 packet with its transport ports
+   * \param link the link layer header
+   * \param source the source address
+   * \param destination the destination address
+   * \param protocol the IP protocol number
+   * \param sourcePort the source port
+   * \param destinationPort the destination port
+   * \param options the length of the IPv4 options, a multiple of 4
+   * \param fragmentOffset the fragment offset, in units of 8 bytes
+   * \return the packet
+   */
+  static Ptr<Packet> MakePacket (const std::vector<uint8_t> &link, const char *source, const char *destination,
+                                 uint8_t protocol, uint16_t sourcePort, uint16_t destinationPort,
+                                 uint32_t options = 0, uint16_t fragmentOffset = 0);
+};
+
+TraceFilterFiveTupleTestCase::TraceFilterFiveTupleTestCase ()
+  : TestCase ("Check the 5-tuples of the trace filter")
+{
+}
+
+Ptr<Packet>
+TraceFilterFiveTupleTestCase::MakePacket (const std::vector<uint8_t> &link, const char *source, const char *destination,
+                                          uint8_t protocol, uint16_t sourcePort, uint16_t destinationPort,
+                                          uint32_t options, uint16_t fragmentOffset)
+{
+  std::vector<uint8_t> data (link);
+  uint32_t ip = data.size ();
+  data.resize (ip + 20 + options + 8, 0);
+  data[ip] = 0x40 | ((20 + options) / 4);
+  data[ip + 2] = (data.size () - ip) >> 8;
+  data[ip + 3] = (data.size () - ip) & 0xff;
+  data[ip + 6] = fragmentOffset >> 8;
+  data[ip + 7] = fragmentOffset & 0xff;
+  data[ip + 8] = 64;
+  data[ip + 9] = protocol;
+  Ipv4Address (source).Serialize (&data[ip + 12]);
+  Ipv4Address (destination).Serialize (&data[ip + 16]);
+  uint32_t transport = ip + 20 + options;
+  data[transport] = sourcePort >> 8;
+  data[transport + 1] = sourcePort & 0xff;
+  data[transport + 2] = destinationPort >> 8;
+  data[transport + 3] = destinationPort & 0xff;
+  return Create<Packet> (&data[0], data.size ());
+}
+
+void
+TraceFilterFiveTupleTestCase::DoRun (void)
+{
+  Ptr<TraceFilter> filter = CreateObject<TraceFilter> ();
+  TraceFilter::FiveTuple udp;
+  udp.source = Ipv4Address ("10.1.1.1");
+  udp.protocol = 17;
+  udp.destinationPort = 9;
+  filter->AddFiveTuple (udp);
+  TraceFilter::FiveTuple host;
+  host.destination = Ipv4Address ("10.2.2.2");
+  filter->AddFiveTuple (host);
+
+  const uint8_t mac[12] = { 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 2 };
+  std::vector<uint8_t> ethernet (mac, mac + 12);
+  ethernet.push_back (0x08);
+  ethernet.push_back (0x00);
+  std::vector<uint8_t> vlan (mac, mac + 12);
+  const uint8_t vlanType[6] = { 0x81, 0x00, 0x00, 0x05, 0x08, 0x00 };
+  vlan.insert (vlan.end (), vlanType, vlanType + 6);
+  std::vector<uint8_t> llc (mac, mac + 12);
+  const uint8_t llcType[10] = { 0x00, 0x40, 0xaa, 0xaa, 0x03, 0x00, 0x00, 0x00, 0x08, 0x00 };
+  llc.insert (llc.end (), llcType, llcType + 10);
+  std::vector<uint8_t> ipv6 (mac, mac + 12);
+  ipv6.push_back (0x86);
+  ipv6.push_back (0xdd);
+  const uint8_t pppType[4] = { 0xff, 0x03, 0x00, 0x21 };
+  std::vector<uint8_t> ppp (pppType, pppType + 4);
+  std::vector<uint8_t> pppShort (pppType + 2, pppType + 4);
+  std::vector<uint8_t> raw;
+  // 802.11 data frames to the DS, followed by an LLC/SNAP header
+  const uint8_t snap[8] = { 0xaa, 0xaa, 0x03, 0x00, 0x00, 0x00, 0x08, 0x00 };
+  std::vector<uint8_t> wifi (24, 0);
+  wifi[0] = 0x08;
+  wifi[1] = 0x01;
+  wifi.insert (wifi.end (), snap, snap + 8);
+  std::vector<uint8_t> qosWifi (26, 0);
+  qosWifi[0] = 0x88;
+  qosWifi[1] = 0x01;
+  qosWifi.insert (qosWifi.end (), snap, snap + 8);
+  std::vector<uint8_t> protectedWifi (wifi);
+  protectedWifi[1] |= 0x40;
+  RadiotapHeader radiotap;
+  radiotap.SetTsft (1000);
+  radiotap.SetFrameFlags (RadiotapHeader::FRAME_FLAG_NONE);
+  radiotap.SetRate (12);
+  radiotap.SetChannelFrequencyAndFlags (5180, RadiotapHeader::CHANNEL_FLAG_OFDM);
+  radiotap.SetAntennaSignalPower (-50);
+  radiotap.SetAntennaNoisePower (-90);
+
+  uint32_t en10mb = PcapHelper::DLT_EN10MB;
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (ethernet, "10.1.1.1", "10.3.3.3", 17, 1000, 9), en10mb), true,
+                         "The UDP flow should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (ethernet, "10.1.1.1", "10.3.3.3", 17, 1000, 10), en10mb), false,
+                         "The destination port should not match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (ethernet, "10.1.1.1", "10.3.3.3", 6, 1000, 9), en10mb), false,
+                         "The protocol should not match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (ethernet, "10.1.1.4", "10.3.3.3", 17, 1000, 9), en10mb), false,
+                         "The source should not match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (ethernet, "10.1.1.4", "10.2.2.2", 6, 1, 2), en10mb), true,
+                         "The destination should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (ethernet, "10.1.1.1", "10.3.3.3", 17, 1000, 9, 8), en10mb), true,
+                         "The ports should be found after the IPv4 options");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (ethernet, "10.1.1.1", "10.3.3.3", 17, 1000, 9, 0, 100), en10mb), false,
+                         "The ports of a fragment should not be read");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (vlan, "10.1.1.1", "10.3.3.3", 17, 1000, 9), en10mb), true,
+                         "The VLAN tag should be skipped");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (llc, "10.1.1.1", "10.3.3.3", 17, 1000, 9), en10mb), true,
+                         "The LLC/SNAP header should be skipped");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (ipv6, "10.1.1.1", "10.2.2.2", 17, 1000, 9), en10mb), false,
+                         "A packet which is not IPv4 should not match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (ppp, "10.1.1.1", "10.3.3.3", 17, 1000, 9), PcapHelper::DLT_PPP), true,
+                         "The PPP header should be skipped");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (pppShort, "10.1.1.1", "10.3.3.3", 17, 1000, 9), PcapHelper::DLT_PPP), true,
+                         "The compressed PPP header should be skipped");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (raw, "10.1.1.1", "10.3.3.3", 17, 1000, 9), PcapHelper::DLT_RAW), true,
+                         "The raw IPv4 packet should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (raw, "10.1.1.1", "10.3.3.3", 17, 1000, 9), en10mb), false,
+                         "The raw IPv4 packet should not be read as an Ethernet frame");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (Create<Packet> (20), en10mb), false, "An empty frame should not match");
+  uint32_t ieee80211 = PcapHelper::DLT_IEEE802_11;
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (wifi, "10.1.1.1", "10.3.3.3", 17, 1000, 9), ieee80211), true,
+                         "The 802.11 and LLC/SNAP headers should be skipped");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (qosWifi, "10.1.1.1", "10.3.3.3", 17, 1000, 9), ieee80211), true,
+                         "The QoS control field should be skipped");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (protectedWifi, "10.1.1.1", "10.3.3.3", 17, 1000, 9), ieee80211), false,
+                         "A protected frame should not match");
+
+  // The radiotap header written before the packet is skipped
+  uint32_t radio = PcapHelper::DLT_IEEE802_11_RADIO;
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (qosWifi, "10.1.1.1", "10.3.3.3", 17, 1000, 9), radiotap, radio), true,
+                         "The radiotap header should be skipped");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (qosWifi, "10.1.1.1", "10.3.3.3", 17, 1000, 10), radiotap, radio), false,
+                         "The destination port after the radiotap header should not match");
+  Ptr<Packet> withRadiotap = MakePacket (wifi, "10.1.1.4", "10.2.2.2", 6, 1, 2);
+  withRadiotap->AddHeader (radiotap);
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (withRadiotap, radio), true,
+                         "The radiotap header in the packet should be skipped");
+
+  Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  file->SetAttribute ("Filter", PointerValue (filter));
+  file->Open (CreateTempDirFilename ("radiotap.pcap"), std::ios::out);
+  file->Init (radio);
+  uint64_t accepted = filter->GetAccepted ();
+  file->Write (Seconds (1), radiotap, MakePacket (wifi, "10.1.1.1", "10.3.3.3", 17, 1000, 9));
+  NS_TEST_EXPECT_MSG_EQ (filter->GetAccepted (), accepted + 1,
+                         "The pcap file should match the packets written after a radiotap header");
+  file->Close ();
+
+  // Ascii traces use the data link type of the filter
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (ethernet, "10.1.1.1", "10.3.3.3", 17, 1000, 9)), true,
+                         "The default data link type should be Ethernet");
+  filter->SetAttribute ("DataLinkType", UintegerValue (PcapHelper::DLT_RAW));
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (MakePacket (raw, "10.1.1.1", "10.3.3.3", 17, 1000, 9)), true,
+                         "The data link type should be raw IPv4");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * TraceFilter unit tests: budget per second of simulated time.
+ */
+class TraceFilterBudgetTestCase : public TestCase
+{
+public:
+  TraceFilterBudgetTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Ask the filter about a new packet
+   * \param filter the filter
+   */
+  void Accept (Ptr<TraceFilter> filter);
+
+  std::vector<uint32_t> m_accepted; //!< Accepted packets in each second
+};
+
+TraceFilterBudgetTestCase::TraceFilterBudgetTestCase ()
+  : TestCase ("Check the budget of the trace filter")
+{
+}
+
+void
+TraceFilterBudgetTestCase::Accept (Ptr<TraceFilter> filter)
+{
+  uint32_t second = Simulator::Now ().GetSeconds ();
+  m_accepted.resize (second + 1, 0);
+  m_accepted[second] += filter->Accept (Create<Packet> (10));
+}
+
+void
+TraceFilterBudgetTestCase::DoRun (void)
+{
+  // The events of a packet, and of its copies, are charged once
+  Ptr<TraceFilter> filter = CreateObject<TraceFilter> ();
+  filter->SetAttribute ("Budget", UintegerValue (2));
+  Ptr<Packet> first = Create<Packet> (10);
+  Ptr<Packet> second = Create<Packet> (10);
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (first), true, "The first packet should be accepted");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (second), true, "The second packet should be accepted");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (first), true, "Another event of a packet should be accepted");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (second->Copy ()), true, "A copy of a packet should be accepted");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (Create<Packet> (10)), false, "A third packet should be rejected");
+  // A budget lowered below the packets already traced rejects the new ones
+  filter->SetAttribute ("Budget", UintegerValue (1));
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (first), true, "Another event of a packet should be accepted");
+  NS_TEST_EXPECT_MSG_EQ (filter->Accept (Create<Packet> (10)), false, "A new packet should be rejected");
+
+  filter = CreateObject<TraceFilter> ();
+  filter->SetAttribute ("Budget", UintegerValue (4));
+  // 10 packets per second during the first two seconds, 2 in the third
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      Simulator::Schedule (MilliSeconds (100 * i), &TraceFilterBudgetTestCase::Accept, this, filter);
+    }
+  Simulator::Schedule (MilliSeconds (2100), &TraceFilterBudgetTestCase::Accept, this, filter);
+  Simulator::Schedule (MilliSeconds (2900), &TraceFilterBudgetTestCase::Accept, this, filter);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_accepted.size (), 3, "Wrong number of seconds");
+  NS_TEST_EXPECT_MSG_EQ (m_accepted[0], 4, "The budget should limit the first second");
+  NS_TEST_EXPECT_MSG_EQ (m_accepted[1], 4, "The budget should be renewed in the second second");
+  NS_TEST_EXPECT_MSG_EQ (m_accepted[2], 2, "The packets within the budget should be accepted");
+  NS_TEST_EXPECT_MSG_EQ (filter->GetRejected (), 12, "Wrong number of rejected packets");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * A helper tracing the transmit queue of SimpleNetDevices.
+ */
+class TraceFilterTestHelper : public PcapHelperForDevice,
+                              public AsciiTraceHelperForDevice
+{
+private:
+  virtual void EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
+  {
+    PcapHelper pcapHelper;
+    Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (prefix, std::ios::out, PcapHelper::DLT_EN10MB);
+    pcapHelper.HookDefaultSink<Queue<Packet> > (GetQueue (nd), "Enqueue", file);
+  }
+
+  virtual void EnableAsciiInternal (Ptr<OutputStreamWrapper> stream, std::string prefix,
+                                    Ptr<NetDevice> nd, bool explicitFilename)
+  {
+    AsciiTraceHelper asciiTraceHelper;
+    if (stream == 0)
+      {
+        stream = asciiTraceHelper.CreateFileStream (prefix);
+      }
+    asciiTraceHelper.HookDefaultEnqueueSinkWithoutContext<Queue<Packet> > (GetQueue (nd), "Enqueue", stream);
+  }
+
+  /**
+   * \param nd the device
+   * \return the transmit queue of the device
+   */
+  static Ptr<Queue<Packet> > GetQueue (Ptr<NetDevice> nd)
+  {
+    PointerValue ptr;
+    nd->GetAttribute ("TxQueue", ptr);
+    return ptr.Get<Queue<Packet> > ();
+  }
+};
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * TraceFilter set on the pcap and ascii traces of a device helper.
+ */
+class TraceFilterHelperTestCase : public TestCase
+{
+public:
+  TraceFilterHelperTestCase ();
+  virtual void DoRun (void);
+};
+
+TraceFilterHelperTestCase::TraceFilterHelperTestCase ()
+  : TestCase ("Check the trace filter of the pcap and ascii traces of a device helper")
+{
+}
+
+void
+TraceFilterHelperTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+
+  Ptr<TraceFilter> filter = CreateObject<TraceFilter> ();
+  filter->AddFlowId (1);
+  std::string pcapFilename = CreateTempDirFilename ("filtered.pcap");
+  std::string asciiFilename = CreateTempDirFilename ("filtered.tr");
+  std::string allFilename = CreateTempDirFilename ("all.tr");
+  TraceFilterTestHelper helper;
+  helper.SetPcapFilter (filter);
+  helper.EnablePcap (pcapFilename, devices.Get (0), false, true);
+  helper.SetAsciiFilter (filter);
+  helper.EnableAscii (asciiFilename, devices.Get (0), true);
+  // The streams passed in, which may be shared, keep their own filter
+  Ptr<OutputStreamWrapper> shared = Create<OutputStreamWrapper> (CreateTempDirFilename ("shared.tr"),
+                                                                 std::ios::out);
+  helper.EnableAscii (shared, devices.Get (0));
+  NS_TEST_EXPECT_MSG_EQ (shared->GetFilter (), 0, "The filter was set on a stream passed in");
+  // Traces enabled without a filter write all the packets
+  helper.SetAsciiFilter (0);
+  helper.EnableAscii (allFilename, devices.Get (0), true);
+
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      Ptr<Packet> p = Create<Packet> (100 + i);
+      p->AddByteTag (FlowIdTag (i % 2));
+      devices.Get (0)->Send (p, devices.Get (1)->GetAddress (), 0x0800);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  // Release the devices, and so the files hooked to their queue
+  devices = NetDeviceContainer ();
+  nodes = NodeContainer ();
+  NS_TEST_EXPECT_MSG_EQ (filter->GetAccepted (), 20, "Each packet should be accepted by both traces");
+  NS_TEST_EXPECT_MSG_EQ (filter->GetRejected (), 20, "Each packet should be rejected by both traces");
+
+  PcapReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (pcapFilename), true, "Cannot open " << pcapFilename);
+  PcapReader::Record record;
+  uint32_t records = 0;
+  while (reader.Next (record))
+    {
+      NS_TEST_EXPECT_MSG_EQ (record.origLen, 101 + 2 * records, "Wrong packet written");
+      ++records;
+    }
+  reader.Close ();
+  NS_TEST_EXPECT_MSG_EQ (records, 10, "Only the packets of flow 1 should be written");
+
+  std::ifstream ascii (asciiFilename.c_str ());
+  std::string line;
+  uint32_t lines = 0;
+  while (std::getline (ascii, line))
+    {
+      ++lines;
+    }
+  NS_TEST_EXPECT_MSG_EQ (lines, 10, "Only the packets of flow 1 should be printed");
+  std::ifstream all (allFilename.c_str ());
+  lines = 0;
+  while (std::getline (all, line))
+    {
+      ++lines;
+    }
+  NS_TEST_EXPECT_MSG_EQ (lines, 20, "All the packets should be printed");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief TraceFilter TestSuite
+ */
+class TraceFilterTestSuite : public TestSuite
+{
+public:
+  TraceFilterTestSuite ()
+    : TestSuite ("trace-filter", UNIT)
+  {
+    AddTestCase (new TraceFilterSamplingTestCase (), TestCase::QUICK);
+    AddTestCase (new TraceFilterFiveTupleTestCase (), TestCase::QUICK);
+    AddTestCase (new TraceFilterBudgetTestCase (), TestCase::QUICK);
+    AddTestCase (new TraceFilterHelperTestCase (), TestCase::QUICK);
+  }
+};
+
+static TraceFilterTestSuite g_traceFilterTestSuite; //!< Static variable for test initialization
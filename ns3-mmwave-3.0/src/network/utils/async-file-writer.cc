@@ -0,0 +1,308 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-writer.h"
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/network-config.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <limits>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif /* HAVE_ZLIB */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsyncFileWriter");
+
+/** The size of the stdio or zlib buffer of the file. */
+static const uint32_t FILE_BUFFER_SIZE = 256 * 1024;
+
+AsyncFileWriter::AsyncFileWriter ()
+  : m_ring (0),
+    m_size (0),
+    m_compression (NONE),
+    m_file (0),
+    m_reserved (0),
+    m_head (0),
+    m_tail (0),
+    m_sleeping (false),
+    m_stop (false),
+    m_fail (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AsyncFileWriter::~AsyncFileWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+AsyncFileWriter::IsSupported (Compression compression)
+{
+#ifdef HAVE_ZLIB
+  return true;
+#else
+  return compression == NONE;
+#endif /* HAVE_ZLIB */
+}
+
+uint32_t
+AsyncFileWriter::GetMinBufferSize (uint32_t maxRecordSize)
+{
+  uint64_t size = 4 * (static_cast<uint64_t> (maxRecordSize) + sizeof (RecordSize));
+  return std::min<uint64_t> (size, std::numeric_limits<uint32_t>::max ());
+}
+
+bool
+AsyncFileWriter::Open (std::string const &filename, Compression compression, uint32_t bufferSize)
+{
+  NS_LOG_FUNCTION (this << filename << compression << bufferSize);
+  NS_ASSERT_MSG (!IsOpen (), "AsyncFileWriter::Open(): File already open");
+  NS_ASSERT_MSG (IsSupported (compression), "AsyncFileWriter::Open(): Compression not supported by this build");
+  NS_ABORT_MSG_IF (bufferSize < GetMinBufferSize (1),
+                   "AsyncFileWriter::Open(): Ring buffer of " << bufferSize << " bytes too small");
+  m_compression = compression;
+  m_fail = false;
+  if (compression == NONE)
+    {
+      std::FILE *file = std::fopen (filename.c_str (), "wb");
+      if (file != 0)
+        {
+          std::setvbuf (file, 0, _IOFBF, FILE_BUFFER_SIZE);
+        }
+      m_file = file;
+    }
+#ifdef HAVE_ZLIB
+  else
+    {
+      gzFile file = gzopen (filename.c_str (), "wb");
+      if (file != 0)
+        {
+          gzbuffer (file, FILE_BUFFER_SIZE);
+        }
+      m_file = file;
+    }
+#endif /* HAVE_ZLIB */
+  if (m_file == 0)
+    {
+      m_fail = true;
+      return false;
+    }
+
+  m_size = bufferSize;
+  m_ring = new uint8_t [m_size];
+  m_reserved = 0;
+  m_head = 0;
+  m_tail = 0;
+  m_stop = false;
+  m_thread = std::thread (&AsyncFileWriter::Run, this);
+  return true;
+}
+
+void
+AsyncFileWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsOpen ())
+    {
+      return;
+    }
+  m_stop = true;
+  Wake ();
+  m_thread.join ();
+
+  int status = 0;
+  if (m_compression == NONE)
+    {
+      status = std::fclose (static_cast<std::FILE *> (m_file));
+    }
+#ifdef HAVE_ZLIB
+  else
+    {
+      status = gzclose (static_cast<gzFile> (m_file));
+    }
+#endif /* HAVE_ZLIB */
+  if (status != 0)
+    {
+      m_fail = true;
+    }
+  m_file = 0;
+  delete [] m_ring;
+  m_ring = 0;
+}
+
+bool
+AsyncFileWriter::IsOpen (void) const
+{
+  return m_file != 0;
+}
+
+bool
+AsyncFileWriter::Fail (void) const
+{
+  return m_fail;
+}
+
+uint32_t
+AsyncFileWriter::GetMaxRecordSize (void) const
+{
+  return m_size / 4 - sizeof (RecordSize);
+}
+
+uint8_t *
+AsyncFileWriter::Reserve (uint32_t size)
+{
+  NS_ASSERT_MSG (IsOpen (), "AsyncFileWriter::Reserve(): File not open");
+  // A larger record could wait forever for the space left unused at the
+  // end of the ring
+  NS_ABORT_MSG_IF (size > GetMaxRecordSize (),
+                   "AsyncFileWriter::Reserve(): Record of " << size << " bytes larger than the "
+                   << GetMaxRecordSize () << " bytes allowed by a ring of " << m_size << " bytes");
+  uint64_t head = m_head.load (std::memory_order_relaxed);
+  uint32_t index = head % m_size;
+  uint32_t toEnd = m_size - index;
+  uint64_t start = head;
+  if (toEnd < sizeof (RecordSize) + size)
+    {
+      // The record does not fit before the end of the ring: leave the
+      // end unused, and start from the beginning of the ring.
+      start += toEnd;
+    }
+  uint64_t end = start + sizeof (RecordSize) + size;
+  while (end - m_tail.load (std::memory_order_acquire) > m_size)
+    {
+      Wake ();
+      std::this_thread::yield ();
+    }
+  if (start != head && toEnd >= sizeof (RecordSize))
+    {
+      RecordSize wrap = WRAP;
+      std::memcpy (m_ring + index, &wrap, sizeof (wrap));
+    }
+  RecordSize recordSize = size;
+  uint8_t *record = m_ring + start % m_size;
+  std::memcpy (record, &recordSize, sizeof (recordSize));
+  m_reserved = end;
+  return record + sizeof (RecordSize);
+}
+
+void
+AsyncFileWriter::Commit (void)
+{
+  m_head.store (m_reserved, std::memory_order_release);
+  if (m_sleeping.load (std::memory_order_relaxed))
+    {
+      Wake ();
+    }
+}
+
+void
+AsyncFileWriter::Write (const uint8_t *data, uint32_t size)
+{
+  std::memcpy (Reserve (size), data, size);
+  Commit ();
+}
+
+void
+AsyncFileWriter::Wake (void)
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_wake.notify_one ();
+}
+
+void
+AsyncFileWriter::Run (void)
+{
+  uint64_t tail = m_tail.load (std::memory_order_relaxed);
+  while (true)
+    {
+      uint64_t head = m_head.load (std::memory_order_acquire);
+      if (tail == head)
+        {
+          if (m_stop)
+            {
+              // Close was called after the last Commit.
+              if (m_head.load (std::memory_order_acquire) == tail)
+                {
+                  break;
+                }
+              continue;
+            }
+          // The timeout bounds the delay of a wake up missed by Commit,
+          // which does not lock the mutex unless this thread sleeps.
+          std::unique_lock<std::mutex> lock (m_mutex);
+          m_sleeping = true;
+          if (m_head.load (std::memory_order_acquire) == tail && !m_stop)
+            {
+              m_wake.wait_for (lock, std::chrono::milliseconds (10));
+            }
+          m_sleeping = false;
+          continue;
+        }
+      while (tail != head)
+        {
+          uint32_t index = tail % m_size;
+          uint32_t toEnd = m_size - index;
+          RecordSize size = WRAP;
+          if (toEnd >= sizeof (RecordSize))
+            {
+              std::memcpy (&size, m_ring + index, sizeof (size));
+            }
+          if (size == WRAP)
+            {
+              tail += toEnd;
+              continue;
+            }
+          WriteFile (m_ring + index + sizeof (RecordSize), size);
+          tail += sizeof (RecordSize) + size;
+          m_tail.store (tail, std::memory_order_release);
+        }
+      m_tail.store (tail, std::memory_order_release);
+    }
+}
+
+void
+AsyncFileWriter::WriteFile (const uint8_t *data, uint32_t size)
+{
+  if (size == 0)
+    {
+      return;
+    }
+  bool ok = false;
+  if (m_compression == NONE)
+    {
+      ok = std::fwrite (data, 1, size, static_cast<std::FILE *> (m_file)) == size;
+    }
+#ifdef HAVE_ZLIB
+  else
+    {
+      ok = gzwrite (static_cast<gzFile> (m_file), data, size) == static_cast<int> (size);
+    }
+#endif /* HAVE_ZLIB */
+  if (!ok)
+    {
+      m_fail = true;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <string>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace ns3 {
+
+/**
+ * \brief Write a file from a background thread.
+ *
+ * The records to write are appended to a ring buffer, without locks,
+ * and a background thread writes them to the file, optionally
+ * compressed, so that the writing thread only copies the bytes of each
+ * record into the ring.  When the ring is full, the writing thread
+ * waits for the background thread to free enough space.
+ *
+ * A record is written in place:
+ * \code
+ *   uint8_t *record = writer.Reserve (size);
+ *   // fill the size bytes of the record
+ *   writer.Commit ();
+ * \endcode
+ *
+ * There must be a single writing thread.  Close, or the destructor,
+ * waits until all the records are written.
+ *
+ * The records are at most a quarter of the ring, so that a record
+ * which does not fit before its end always fits from its beginning;
+ * GetMinBufferSize gives the size of the ring for the largest record.
+ *
+ * Like PcapFile, this is used as part of the test framework, so it does
+ * not use ns-3 objects.
+ */
+class AsyncFileWriter
+{
+public:
+  /** The compression of the file. */
+  enum Compression
+  {
+    NONE, //!< Not compressed
+    GZIP  //!< Compressed with zlib, in the gzip format
+  };
+
+  /** Default size of the ring buffer, in bytes. */
+  static const uint32_t BUFFER_SIZE_DEFAULT = 1024 * 1024;
+
+  AsyncFileWriter ();
+  /** Destructor; closes the file. */
+  ~AsyncFileWriter ();
+
+  /**
+   * Check if a compression is supported by this build.
+   * \param [in] compression The compression.
+   * \returns \c true if files can be written with \p compression.
+   */
+  static bool IsSupported (Compression compression);
+
+  /**
+   * Get the smallest ring buffer for records up to a size.
+   * \param [in] maxRecordSize The size of the largest record, in bytes.
+   * \returns The size of the ring buffer, in bytes.
+   */
+  static uint32_t GetMinBufferSize (uint32_t maxRecordSize);
+
+  /**
+   * Create the file, and start the background thread.
+   *
+   * The file is always truncated: there is no append mode.
+   *
+   * \param [in] filename The name of the file.
+   * \param [in] compression The compression of the file.
+   * \param [in] bufferSize The size of the ring buffer, in bytes,
+   *        at least GetMinBufferSize (1).
+   * \returns \c false if the file could not be created.
+   */
+  bool Open (std::string const &filename, Compression compression = NONE,
+             uint32_t bufferSize = BUFFER_SIZE_DEFAULT);
+  /**
+   * Write the pending records, stop the background thread and close
+   * the file.
+   */
+  void Close (void);
+  /**
+   * \returns \c true if the file is open.
+   */
+  bool IsOpen (void) const;
+  /**
+   * \returns \c true if the file could not be created or written.
+   */
+  bool Fail (void) const;
+  /**
+   * \returns The size of the largest record Reserve accepts in the open
+   *          file: a quarter of the ring buffer, less the size prefix
+   *          of the record.
+   */
+  uint32_t GetMaxRecordSize (void) const;
+
+  /**
+   * Reserve a record at the end of the ring buffer.
+   *
+   * Waits until the ring has enough space.  The record is written to
+   * the file once committed.  Aborts if the record is larger than
+   * GetMaxRecordSize, for which the ring would never have enough space.
+   *
+   * \param [in] size The size of the record.
+   * \returns The bytes of the record.
+   */
+  uint8_t * Reserve (uint32_t size);
+  /**
+   * Commit the last reserved record, to be written to the file.
+   */
+  void Commit (void);
+  /**
+   * Write a record.
+   * \param [in] data The bytes of the record.
+   * \param [in] size The size of the record.
+   */
+  void Write (const uint8_t *data, uint32_t size);
+
+private:
+  /** The background thread: write the records committed to the ring. */
+  void Run (void);
+  /**
+   * Write bytes to the file.
+   * \param [in] data The bytes.
+   * \param [in] size The number of bytes.
+   */
+  void WriteFile (const uint8_t *data, uint32_t size);
+  /** Wake the background thread up, if it sleeps. */
+  void Wake (void);
+
+  /** The size prefix of the records. */
+  typedef uint32_t RecordSize;
+  /** The record size marking the unused end of the ring. */
+  static const RecordSize WRAP = 0xffffffff;
+
+  uint8_t *m_ring;                   //!< The ring buffer
+  uint32_t m_size;                   //!< The size of the ring buffer
+  Compression m_compression;         //!< The compression of the file
+  void *m_file;                      //!< The FILE or gzFile
+  std::thread m_thread;              //!< The background thread
+  uint64_t m_reserved;               //!< The end of the reserved record
+
+  // The positions only grow; the position in the ring is their value
+  // modulo its size.
+  std::atomic<uint64_t> m_head;      //!< The end of the committed records
+  std::atomic<uint64_t> m_tail;      //!< The end of the records written to the file
+  std::atomic<bool> m_sleeping;      //!< \c true if the background thread sleeps
+  std::atomic<bool> m_stop;          //!< \c true when the file is closed
+  std::atomic<bool> m_fail;          //!< \c true when a write failed
+  std::mutex m_mutex;                //!< The mutex of m_wake
+  std::condition_variable m_wake;    //!< Wakes the background thread up
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_WRITER_H */
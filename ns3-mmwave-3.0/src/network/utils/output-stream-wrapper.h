@@ -23,6 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "trace-filter.h"
 
 namespace ns3 {
 
@@ -92,9 +93,23 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * Set the filter of the packets written to the stream by the default
+   * sinks of the AsciiTraceHelper.
+   *
+   * \param filter the filter, or null to write all the packets
+   */
+  void SetFilter (Ptr<TraceFilter> filter);
+
+  /**
+   * \returns the filter of the packets written to the stream, if any
+   */
+  Ptr<TraceFilter> GetFilter (void) const;
+
 private:
   std::ostream *m_ostream; //!< The output stream
   bool m_destroyable; //!< Can be destroyed
+  Ptr<TraceFilter> m_filter; //!< Filter of the written packets, if any
 };
 
 } // namespace ns3
@@ -0,0 +1,42 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-binary-trace.h"
+#include "ns3/binary-trace-recorder.h"
+
+/**
+ * \file
+ * \ingroup packet
+ * Registration of the Packet trace source signatures
+ * with BinaryTraceRecorder.
+ */
+
+namespace ns3 {
+
+/** Packet::TracedCallback signature registration. */
+static BinaryTraceSignature<Ptr<const Packet> >
+  g_packetTracedCallback ("ns3::Packet::TracedCallback");
+/** Packet::SizeTracedCallback signature registration. */
+static BinaryTraceSignature<uint32_t, uint32_t>
+  g_packetSizeTracedCallback ("ns3::Packet::SizeTracedCallback");
+/** Packet::SinrTracedCallback signature registration. */
+static BinaryTraceSignature<Ptr<const Packet>, double>
+  g_packetSinrTracedCallback ("ns3::Packet::SinrTracedCallback");
+/** Packet::Mac48AddressTracedCallback signature registration. */
+static BinaryTraceSignature<Ptr<const Packet>, Mac48Address>
+  g_packetMac48AddressTracedCallback ("ns3::Packet::Mac48AddressTracedCallback");
+
+} // namespace ns3
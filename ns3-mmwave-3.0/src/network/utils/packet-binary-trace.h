@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_BINARY_TRACE_H
+#define PACKET_BINARY_TRACE_H
+
+#include "ns3/binary-trace-file.h"
+#include "ns3/mac48-address.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+/**
+ * \file
+ * \ingroup packet
+ * BinaryTraceEncoder specializations for packets and Mac48Address.
+ *
+ * The Packet::TracedCallback, Packet::SizeTracedCallback,
+ * Packet::SinrTracedCallback and Packet::Mac48AddressTracedCallback
+ * signatures are registered with BinaryTraceRecorder.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ * BinaryTraceEncoder for packets, encoded as their uid (uint64_t)
+ * followed by their size (uint32_t).  Read them back as these two values.
+ */
+template <>
+struct BinaryTraceEncoder<Ptr<const Packet> >
+{
+  /** The size of an encoded value. */
+  static const uint32_t SIZE = sizeof (uint64_t) + sizeof (uint32_t);
+  /**
+   * Encode a packet.
+   * \param [out] buffer The SIZE bytes to write to.
+   * \param [in] packet The packet.
+   */
+  static void Write (uint8_t *buffer, const Ptr<const Packet> &packet)
+  {
+    BinaryTraceEncoder<uint64_t>::Write (buffer, packet->GetUid ());
+    BinaryTraceEncoder<uint32_t>::Write (buffer + sizeof (uint64_t), packet->GetSize ());
+  }
+};
+
+/**
+ * \ingroup packet
+ * BinaryTraceEncoder for Mac48Address, encoded as its 6 bytes.
+ */
+template <>
+struct BinaryTraceEncoder<Mac48Address>
+{
+  /** The size of an encoded value. */
+  static const uint32_t SIZE = 6;
+  /**
+   * Encode an address.
+   * \param [out] buffer The SIZE bytes to write to.
+   * \param [in] address The address.
+   */
+  static void Write (uint8_t *buffer, const Mac48Address &address)
+  {
+    address.CopyTo (buffer);
+  }
+  /**
+   * Decode an address.
+   * \param [in] buffer The SIZE bytes to read from.
+   * \returns The address.
+   */
+  static Mac48Address Read (const uint8_t *buffer)
+  {
+    Mac48Address address;
+    address.CopyFrom (buffer);
+    return address;
+  }
+};
+
+} // namespace ns3
+
+#endif /* PACKET_BINARY_TRACE_H */
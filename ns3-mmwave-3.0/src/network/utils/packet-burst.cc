@@ -19,7 +19,7 @@
  */
 
 #include <stdint.h>
-#include <list>
+#include <vector>
 #include "ns3/packet.h"
 #include "packet-burst.h"
 #include "ns3/log.h"
@@ -49,7 +49,7 @@ PacketBurst::PacketBurst (void)
 PacketBurst::~PacketBurst (void)
 {
   NS_LOG_FUNCTION (this);
-  for (std::list<Ptr<Packet> >::const_iterator iter = m_packets.begin (); iter
+  for (Iterator iter = m_packets.begin (); iter
        != m_packets.end (); ++iter)
     {
       (*iter)->Unref ();
@@ -69,7 +69,8 @@ Ptr<PacketBurst> PacketBurst::Copy (void) const
   NS_LOG_FUNCTION (this);
   Ptr<PacketBurst> burst = Create<PacketBurst> ();
 
-  for (std::list<Ptr<Packet> >::const_iterator iter = m_packets.begin (); iter
+  burst->m_packets.reserve (m_packets.size ());
+  for (Iterator iter = m_packets.begin (); iter
        != m_packets.end (); ++iter)
     {
       Ptr<Packet> packet = (*iter)->Copy ();
@@ -88,13 +89,22 @@ PacketBurst::AddPacket (Ptr<Packet> packet)
     }
 }
 
-std::list<Ptr<Packet> >
+const std::vector<Ptr<Packet> > &
 PacketBurst::GetPackets (void) const
 {
   NS_LOG_FUNCTION (this);
   return m_packets;
 }
 
+std::vector<Ptr<Packet> >
+PacketBurst::TakePackets (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Ptr<Packet> > packets;
+  packets.swap (m_packets);
+  return packets;
+}
+
 uint32_t
 PacketBurst::GetNPackets (void) const
 {
@@ -107,23 +117,22 @@ PacketBurst::GetSize (void) const
 {
   NS_LOG_FUNCTION (this);
   uint32_t size = 0;
-  for (std::list<Ptr<Packet> >::const_iterator iter = m_packets.begin (); iter
+  for (Iterator iter = m_packets.begin (); iter
        != m_packets.end (); ++iter)
     {
-      Ptr<Packet> packet = *iter;
-      size += packet->GetSize ();
+      size += (*iter)->GetSize ();
     }
   return size;
 }
 
-std::list<Ptr<Packet> >::const_iterator
+PacketBurst::Iterator
 PacketBurst::Begin (void) const
 {
   NS_LOG_FUNCTION (this);
   return m_packets.begin ();
 }
 
-std::list<Ptr<Packet> >::const_iterator
+PacketBurst::Iterator
 PacketBurst::End (void) const
 {
   NS_LOG_FUNCTION (this);
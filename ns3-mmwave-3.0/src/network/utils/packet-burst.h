@@ -22,19 +22,31 @@
 #define PACKET_BURST_H
 
 #include <stdint.h>
-#include <list>
+#include <vector>
 #include "ns3/object.h"
+#include "ns3/packet.h"
 
 namespace ns3 {
 
-class Packet;
-
 /**
  * \brief this class implement a burst as a list of packets
+ *
+ * The packets are stored contiguously, so that adding them only allocates
+ * when the storage grows, and they can be iterated, or moved out of the
+ * burst, without copying their pointers:
+ * \code
+ *   for (const Ptr<Packet> &packet : burst->GetPackets ())
+ *     {
+ *       ...
+ *     }
+ * \endcode
  */
 class PacketBurst : public Object
 {
 public:
+  /// Packet burst container iterator
+  typedef std::vector<Ptr<Packet> >::const_iterator Iterator;
+
   /**
    * \brief Get the type ID.
    * \return the object TypeId
@@ -52,9 +64,14 @@ public:
    */
   void AddPacket (Ptr<Packet> packet);
   /**
-   * \return the list of packet of this burst
+   * \return the packets of this burst, which are not copied
+   */
+  const std::vector<Ptr<Packet> > & GetPackets (void) const;
+  /**
+   * \brief Remove all the packets of this burst, without copying them
+   * \return the packets of this burst
    */
-  std::list<Ptr<Packet> > GetPackets (void) const;
+  std::vector<Ptr<Packet> > TakePackets (void);
   /**
    * \return the number of packet in the burst
    */
@@ -68,12 +85,12 @@ public:
    * \brief Returns an iterator to the begin of the burst
    * \return iterator to the burst list start
    */
-  std::list<Ptr<Packet> >::const_iterator Begin (void) const;
+  Iterator Begin (void) const;
   /**
    * \brief Returns an iterator to the end of the burst
    * \return iterator to the burst list end
    */
-  std::list<Ptr<Packet> >::const_iterator End (void) const;
+  Iterator End (void) const;
 
   /**
    * TracedCallback signature for Ptr<PacketBurst>
@@ -85,7 +102,7 @@ public:
   
 private:
   void DoDispose (void);
-  std::list<Ptr<Packet> > m_packets; //!< the list of packets in the burst
+  std::vector<Ptr<Packet> > m_packets; //!< the list of packets in the burst
 };
 } // namespace ns3
 
@@ -19,6 +19,9 @@
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/pointer.h"
+#include "ns3/abort.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
@@ -46,6 +49,29 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("AsyncWrite",
+                   "Whether the file is written from a background thread, so that "
+                   "writing a packet only copies it to a ring buffer.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asyncWrite),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Compression",
+                   "The compression of the file; requires AsyncWrite.",
+                   EnumValue (AsyncFileWriter::NONE),
+                   MakeEnumAccessor (&PcapFileWrapper::m_compression),
+                   MakeEnumChecker (AsyncFileWriter::NONE, "None",
+                                    AsyncFileWriter::GZIP, "Gzip"))
+    .AddAttribute ("AsyncBufferSize",
+                   "The size in bytes of the ring buffer of the background thread, "
+                   "which holds at least four records of the snap length.",
+                   UintegerValue (AsyncFileWriter::BUFFER_SIZE_DEFAULT),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_asyncBufferSize),
+                   MakeUintegerChecker<uint32_t> (512 * 1024))
+    .AddAttribute ("Filter",
+                   "The filter of the written packets, or null to write all of them.",
+                   PointerValue (),
+                   MakePointerAccessor (&PcapFileWrapper::m_filter),
+                   MakePointerChecker<TraceFilter> ())
   ;
   return tid;
 }
@@ -93,6 +119,15 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  if (m_asyncWrite)
+    {
+      m_file.SetAsyncWrite (m_compression, m_asyncBufferSize);
+    }
+  else
+    {
+      NS_ABORT_MSG_IF (m_compression != AsyncFileWriter::NONE,
+                       "PcapFileWrapper::Open(): Compression requires AsyncWrite");
+    }
   m_file.Open (filename, mode);
 }
 
@@ -119,6 +154,10 @@ void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_filter != 0 && !m_filter->Accept (p, m_file.GetDataLinkType ()))
+    {
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -139,6 +178,10 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_filter != 0 && !m_filter->Accept (p, header, m_file.GetDataLinkType ()))
+    {
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "trace-filter.h"
 
 namespace ns3 {
 
@@ -112,6 +113,9 @@ public:
   /**
    * \brief Write the next packet to file
    * 
+   * The packet is not written if the `Filter' attribute is set and the
+   * filter rejects it.
+   *
    * \param t Packet timestamp as ns3::Time.
    * \param p Packet to write to the pcap file.
    * 
@@ -124,6 +128,10 @@ public:
    * It is the case that adding a header to a packet prior to writing it to a
    * file must trigger a deep copy in the Packet.  By providing the header
    * separately, we can avoid that copy.
+   *
+   * The packet is not written if the `Filter' attribute is set and the
+   * filter rejects it.  The header is taken as the link layer header, so
+   * the filter looks for the IPv4 header at the start of the packet.
    * 
    * \param t Packet timestamp as ns3::Time.
    * \param header The Header to prepend to the packet.
@@ -224,6 +232,10 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  bool     m_asyncWrite; //!< Write from a background thread
+  AsyncFileWriter::Compression m_compression; //!< Compression of the file
+  uint32_t m_asyncBufferSize; //!< Ring buffer size of the background writer
+  Ptr<TraceFilter> m_filter; //!< Filter of the written packets, if any
 };
 
 } // namespace ns3
@@ -24,6 +24,7 @@
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
 #include "ns3/fatal-impl.h"
+#include "ns3/abort.h"
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
@@ -47,10 +48,16 @@ const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; /**< Looks this way if byte swappi
 const uint16_t VERSION_MAJOR = 2;             /**< Major version of supported pcap file format */
 const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pcap file format */
 
+const uint32_t FILE_HEADER_SIZE = 24;         /**< Size of the pcap file header */
+const uint32_t RECORD_HEADER_SIZE = 16;       /**< Size of the pcap record header */
+
 PcapFile::PcapFile ()
   : m_file (),
     m_swapMode (false),
-    m_nanosecMode (false)
+    m_nanosecMode (false),
+    m_async (false),
+    m_compression (AsyncFileWriter::NONE),
+    m_bufferSize (AsyncFileWriter::BUFFER_SIZE_DEFAULT)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file); 
@@ -68,7 +75,7 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_file.fail ();
+  return m_file.fail () || m_writer.Fail ();
 }
 bool 
 PcapFile::Eof (void) const
@@ -88,6 +95,11 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer.IsOpen ())
+    {
+      m_writer.Close ();
+      return;
+    }
   m_file.close ();
 }
 
@@ -202,12 +214,6 @@ void
 PcapFile::WriteFileHeader (void)
 {
   NS_LOG_FUNCTION (this);
-  //
-  // If we're initializing the file, we need to write the pcap file header
-  // at the start of the file.
-  //
-  m_file.seekp (0, std::ios::beg);
- 
   //
   // We have the ability to write out the pcap file header in a foreign endian
   // format, so we need a temp place to swap on the way out.
@@ -234,13 +240,27 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  uint8_t buffer[FILE_HEADER_SIZE];
+  std::memcpy (buffer, &headerOut->m_magicNumber, 4);
+  std::memcpy (buffer + 4, &headerOut->m_versionMajor, 2);
+  std::memcpy (buffer + 6, &headerOut->m_versionMinor, 2);
+  std::memcpy (buffer + 8, &headerOut->m_zone, 4);
+  std::memcpy (buffer + 12, &headerOut->m_sigFigs, 4);
+  std::memcpy (buffer + 16, &headerOut->m_snapLen, 4);
+  std::memcpy (buffer + 20, &headerOut->m_type, 4);
+
+  if (m_writer.IsOpen ())
+    {
+      m_writer.Write (buffer, FILE_HEADER_SIZE);
+      return;
+    }
+
+  //
+  // If we're initializing the file, we need to write the pcap file header
+  // at the start of the file.
+  //
+  m_file.seekp (0, std::ios::beg);
+  m_file.write ((const char *)buffer, FILE_HEADER_SIZE);
 }
 
 void
@@ -333,6 +353,17 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
   mode |= std::ios::binary;
 
   m_filename=filename;
+  if (m_async && (mode & std::ios::in) == 0)
+    {
+      // The file header would be written again in the middle of the file
+      NS_ABORT_MSG_IF ((mode & std::ios::app) != 0,
+                       "PcapFile::Open(): Append mode is not supported with SetAsyncWrite");
+      if (!m_writer.Open (filename, m_compression, m_bufferSize))
+        {
+          m_file.setstate (std::ios::failbit);
+        }
+      return;
+    }
   m_file.open (filename.c_str (), mode);
   if (mode & std::ios::in)
     {
@@ -341,6 +372,24 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
     }
 }
 
+void
+PcapFile::SetAsyncWrite (AsyncFileWriter::Compression compression, uint32_t bufferSize)
+{
+  NS_LOG_FUNCTION (this << compression << bufferSize);
+  NS_ABORT_MSG_UNLESS (AsyncFileWriter::IsSupported (compression),
+                       "PcapFile::SetAsyncWrite(): Compression not supported, ns-3 was built without zlib");
+  m_async = true;
+  m_compression = compression;
+  uint32_t minBufferSize = AsyncFileWriter::GetMinBufferSize (RECORD_HEADER_SIZE + SNAPLEN_DEFAULT);
+  if (bufferSize < minBufferSize)
+    {
+      NS_LOG_WARN ("Raising the ring buffer size from " << bufferSize
+                   << " to " << minBufferSize << " bytes");
+      bufferSize = minBufferSize;
+    }
+  m_bufferSize = bufferSize;
+}
+
 void
 PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrection, bool swapMode, bool nanosecMode)
 {
@@ -368,6 +417,9 @@ PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrect
   m_fileHeader.m_sigFigs = 0;
   m_fileHeader.m_snapLen = snapLen;
   m_fileHeader.m_type = dataLinkType;
+  NS_ABORT_MSG_IF (m_writer.IsOpen () && snapLen > m_writer.GetMaxRecordSize () - RECORD_HEADER_SIZE,
+                   "PcapFile::Init(): Snap length " << snapLen << " too large for a ring buffer of "
+                   << m_bufferSize << " bytes");
 
   //
   // We use pcap files for regression testing.  We do byte-for-byte comparisons
@@ -407,6 +459,17 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
+  uint8_t buffer[RECORD_HEADER_SIZE];
+  SerializePacketHeader (buffer, tsSec, tsUsec, inclLen, totalLen);
+  m_file.write ((const char *)buffer, RECORD_HEADER_SIZE);
+  NS_BUILD_DEBUG(m_file.flush());
+  return inclLen;
+}
+
+void
+PcapFile::SerializePacketHeader (uint8_t *buffer, uint32_t tsSec, uint32_t tsUsec,
+                                 uint32_t inclLen, uint32_t totalLen)
+{
   PcapRecordHeader header;
   header.m_tsSec = tsSec;
   header.m_tsUsec = tsUsec;
@@ -422,18 +485,37 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
-  NS_BUILD_DEBUG(m_file.flush());
-  return inclLen;
+  std::memcpy (buffer, &header.m_tsSec, 4);
+  std::memcpy (buffer + 4, &header.m_tsUsec, 4);
+  std::memcpy (buffer + 8, &header.m_inclLen, 4);
+  std::memcpy (buffer + 12, &header.m_origLen, 4);
+}
+
+uint8_t *
+PcapFile::ReservePacket (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t &inclLen)
+{
+  //
+  // Truncate to the snap length first, so that only the bytes kept in
+  // the file are copied to the ring buffer.
+  //
+  inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
+  uint8_t *record = m_writer.Reserve (RECORD_HEADER_SIZE + inclLen);
+  SerializePacketHeader (record, tsSec, tsUsec, inclLen, totalLen);
+  return record + RECORD_HEADER_SIZE;
 }
 
 void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
+  if (m_writer.IsOpen ())
+    {
+      uint32_t inclLen;
+      uint8_t *record = ReservePacket (tsSec, tsUsec, totalLen, inclLen);
+      std::memcpy (record, data, inclLen);
+      m_writer.Commit ();
+      return;
+    }
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
   m_file.write ((const char *)data, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
@@ -443,6 +525,14 @@ void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
+  if (m_writer.IsOpen ())
+    {
+      uint32_t inclLen;
+      uint8_t *record = ReservePacket (tsSec, tsUsec, p->GetSize (), inclLen);
+      p->CopyData (record, inclLen);
+      m_writer.Commit ();
+      return;
+    }
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
   p->CopyData (&m_file, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
@@ -454,11 +544,23 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &header << p);
   uint32_t headerSize = header.GetSerializedSize ();
   uint32_t totalSize = headerSize + p->GetSize ();
-  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalSize);
 
   Buffer headerBuffer;
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
+
+  if (m_writer.IsOpen ())
+    {
+      uint32_t inclLen;
+      uint8_t *record = ReservePacket (tsSec, tsUsec, totalSize, inclLen);
+      uint32_t toCopy = std::min (headerSize, inclLen);
+      headerBuffer.CopyData (record, toCopy);
+      p->CopyData (record + toCopy, inclLen - toCopy);
+      m_writer.Commit ();
+      return;
+    }
+
+  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalSize);
   uint32_t toCopy = std::min (headerSize, inclLen);
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
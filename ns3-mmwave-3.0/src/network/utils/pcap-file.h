@@ -25,6 +25,7 @@
 #include <fstream>
 #include <stdint.h>
 #include "ns3/ptr.h"
+#include "async-file-writer.h"
 
 namespace ns3 {
 
@@ -80,6 +81,26 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * \brief Write the file from a background thread.
+   *
+   * Applies to the files opened afterwards for writing only; files opened
+   * for reading are not affected.  Write then only copies the record,
+   * truncated to the snap length, into the ring buffer of an
+   * AsyncFileWriter, whose thread writes it to the file, compressed if
+   * requested.  The file is complete once closed.
+   *
+   * The ring buffer holds at least four records of the default snap
+   * length: a smaller \p bufferSize is raised to that.  Init aborts if
+   * the snap length of the file does not fit in the ring, and Open
+   * aborts in append mode, which asynchronous files do not support.
+   *
+   * \param compression The compression of the file.
+   * \param bufferSize The size of the ring buffer, in bytes.
+   */
+  void SetAsyncWrite (AsyncFileWriter::Compression compression = AsyncFileWriter::NONE,
+                      uint32_t bufferSize = AsyncFileWriter::BUFFER_SIZE_DEFAULT);
+
   /**
    * Close the underlying file.
    */
@@ -360,6 +381,27 @@ private:
    * \returns the length of the packet to write in the Pcap file
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+  /**
+   * \brief Serialize a Pcap packet header
+   *
+   * \param buffer The 16 bytes of the header
+   * \param tsSec Time stamp (seconds part)
+   * \param tsUsec Time stamp (microseconds part)
+   * \param inclLen length of the packet written in the Pcap file
+   * \param totalLen total packet length
+   */
+  void SerializePacketHeader (uint8_t *buffer, uint32_t tsSec, uint32_t tsUsec,
+                              uint32_t inclLen, uint32_t totalLen);
+  /**
+   * \brief Reserve the record of a packet in the AsyncFileWriter
+   *
+   * \param tsSec Time stamp (seconds part)
+   * \param tsUsec Time stamp (microseconds part)
+   * \param totalLen total packet length
+   * \param inclLen [out] length of the packet to write in the Pcap file
+   * \returns the bytes of the packet in the record, after its header
+   */
+  uint8_t * ReservePacket (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t &inclLen);
 
   /**
    * \brief Read and verify a Pcap file header
@@ -371,6 +413,10 @@ private:
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
+  bool m_async;                 //!< write from a background thread
+  AsyncFileWriter::Compression m_compression; //!< compression of asynchronous files
+  uint32_t m_bufferSize;        //!< ring buffer size of asynchronous files
+  AsyncFileWriter m_writer;     //!< writer of asynchronous files
 };
 
 } // namespace ns3
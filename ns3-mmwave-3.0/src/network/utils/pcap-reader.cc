@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "pcap-reader.h"
+#include "ns3/log.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapReader");
+
+const uint32_t MAGIC = 0xa1b2c3d4;            /**< Magic number identifying standard pcap file format */
+const uint32_t SWAPPED_MAGIC = 0xd4c3b2a1;    /**< Looks this way if byte swapping is required */
+
+const uint32_t NS_MAGIC = 0xa1b23c4d;         /**< Magic number identifying nanosec resolution pcap file format */
+const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; /**< Looks this way if byte swapping is required */
+
+const uint32_t FILE_HEADER_SIZE = 24;         /**< Size of the pcap file header */
+const uint32_t RECORD_HEADER_SIZE = 16;       /**< Size of the pcap record header */
+
+PcapReader::PcapReader ()
+  : m_data (0),
+    m_size (0),
+    m_offset (0),
+    m_swapMode (false),
+    m_nanosecMode (false),
+    m_snapLen (0),
+    m_type (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapReader::~PcapReader ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+PcapReader::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd == -1)
+    {
+      NS_LOG_WARN ("Unable to open " << filename << ": " << std::strerror (errno));
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0
+      || st.st_size < static_cast<off_t> (FILE_HEADER_SIZE))
+    {
+      NS_LOG_WARN ("Not a pcap file: " << filename);
+      close (fd);
+      return false;
+    }
+  void *data = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Unable to map " << filename << ": " << std::strerror (errno));
+      return false;
+    }
+  madvise (data, st.st_size, MADV_SEQUENTIAL);
+  m_data = static_cast<const uint8_t *> (data);
+  m_size = st.st_size;
+
+  uint32_t magic;
+  std::memcpy (&magic, m_data, sizeof (magic));
+  if (magic != MAGIC && magic != SWAPPED_MAGIC
+      && magic != NS_MAGIC && magic != NS_SWAPPED_MAGIC)
+    {
+      NS_LOG_WARN ("Not a pcap file: " << filename);
+      Close ();
+      return false;
+    }
+  m_swapMode = (magic == SWAPPED_MAGIC || magic == NS_SWAPPED_MAGIC);
+  m_nanosecMode = (magic == NS_MAGIC || magic == NS_SWAPPED_MAGIC);
+  m_snapLen = ReadU32 (m_data + 16);
+  m_type = ReadU32 (m_data + 20);
+  m_offset = FILE_HEADER_SIZE;
+  return true;
+}
+
+void
+PcapReader::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+      munmap (const_cast<uint8_t *> (m_data), m_size);
+      m_data = 0;
+    }
+  m_size = 0;
+  m_offset = 0;
+}
+
+bool
+PcapReader::IsOpen (void) const
+{
+  return m_data != 0;
+}
+
+bool
+PcapReader::Next (Record &record)
+{
+  if (m_offset + RECORD_HEADER_SIZE > m_size)
+    {
+      return false;
+    }
+  const uint8_t *header = m_data + m_offset;
+  uint32_t inclLen = ReadU32 (header + 8);
+  if (m_offset + RECORD_HEADER_SIZE + inclLen > m_size)
+    {
+      NS_LOG_WARN ("Truncated record at offset " << m_offset);
+      return false;
+    }
+  uint64_t subsec = ReadU32 (header + 4);
+  record.time = ReadU32 (header) * UINT64_C (1000000000) + (m_nanosecMode ? subsec : subsec * 1000);
+  record.inclLen = inclLen;
+  record.origLen = ReadU32 (header + 12);
+  record.data = header + RECORD_HEADER_SIZE;
+  m_offset += RECORD_HEADER_SIZE + inclLen;
+  return true;
+}
+
+void
+PcapReader::Rewind (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+      m_offset = FILE_HEADER_SIZE;
+    }
+}
+
+uint32_t
+PcapReader::GetDataLinkType (void) const
+{
+  return m_type;
+}
+
+uint32_t
+PcapReader::GetSnapLen (void) const
+{
+  return m_snapLen;
+}
+
+bool
+PcapReader::IsNanoSecMode (void) const
+{
+  return m_nanosecMode;
+}
+
+uint32_t
+PcapReader::ReadU32 (const uint8_t *data) const
+{
+  uint32_t value;
+  std::memcpy (&value, data, sizeof (value));
+  if (m_swapMode)
+    {
+      value = ((value >> 24) & 0x000000ff) | ((value >> 8) & 0x0000ff00)
+        | ((value << 8) & 0x00ff0000) | ((value << 24) & 0xff000000);
+    }
+  return value;
+}
+
+} // namespace ns3
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_READER_H
+#define PCAP_READER_H
+
+#include <string>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Read a pcap file through a memory mapping.
+ *
+ * Unlike PcapFile::Read, which copies each record out of an iostream,
+ * the records read by Next point into the mapped file, so that reading
+ * a record only decodes its header.  Files written in the byte order
+ * of another host, and with nanosecond timestamps, are supported.
+ */
+class PcapReader
+{
+public:
+  /** A packet record. */
+  struct Record
+  {
+    uint64_t time;         //!< Timestamp, in nanoseconds
+    uint32_t inclLen;      //!< Number of bytes captured
+    uint32_t origLen;      //!< Length of the packet on the wire
+    const uint8_t *data;   //!< The captured bytes, in the mapped file
+  };
+
+  /** Constructor. */
+  PcapReader ();
+  /** Destructor; closes the file. */
+  ~PcapReader ();
+
+  /**
+   * Open a file.
+   * \param [in] filename The file name.
+   * \returns \c true if the file could be mapped and has a valid pcap header.
+   */
+  bool Open (std::string const &filename);
+  /** Close the file. */
+  void Close (void);
+  /**
+   * \returns \c true if a file is open.
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * Read the next record.
+   *
+   * The record refers to the mapped file, and is valid until Close.
+   *
+   * \param [out] record The record.
+   * \returns \c false at the end of the file, or on a truncated record.
+   */
+  bool Next (Record &record);
+  /** Restart from the first record. */
+  void Rewind (void);
+
+  /**
+   * \returns The data link type of the file.
+   */
+  uint32_t GetDataLinkType (void) const;
+  /**
+   * \returns The maximum length of the captured packets.
+   */
+  uint32_t GetSnapLen (void) const;
+  /**
+   * \returns \c true if the timestamps of the file have a nanosecond resolution.
+   */
+  bool IsNanoSecMode (void) const;
+
+private:
+  /**
+   * Decode a 32 bit field of the file.
+   * \param [in] data The bytes of the field.
+   * \returns The value of the field.
+   */
+  uint32_t ReadU32 (const uint8_t *data) const;
+
+  const uint8_t *m_data;  //!< The mapped file
+  uint64_t m_size;        //!< The size of the file
+  uint64_t m_offset;      //!< The offset of the next record
+  bool m_swapMode;        //!< Whether the file has the other byte order
+  bool m_nanosecMode;     //!< Whether the timestamps are in nanoseconds
+  uint32_t m_snapLen;     //!< The maximum length of the captured packets
+  uint32_t m_type;        //!< The data link type
+};
+
+} // namespace ns3
+
+#endif /* PCAP_READER_H */
@@ -0,0 +1,318 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/socket-factory.h"
+#include "ns3/packet-socket-factory.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/mac48-address.h"
+#include "ns3/net-device.h"
+#include "ns3/packet.h"
+#include "ns3/trace-helper.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/abort.h"
+#include "pcap-replay-application.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapReplayApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (PcapReplayApplication);
+
+TypeId
+PcapReplayApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PcapReplayApplication")
+    .SetParent<Application> ()
+    .SetGroupName("Network")
+    .AddConstructor<PcapReplayApplication> ()
+    .AddAttribute ("File",
+                   "The pcap file to replay.",
+                   StringValue (""),
+                   MakeStringAccessor (&PcapReplayApplication::m_filename),
+                   MakeStringChecker ())
+    .AddAttribute ("Protocol",
+                   "The type of the socket factory, when the packets are sent to a socket.",
+                   TypeIdValue (PacketSocketFactory::GetTypeId ()),
+                   MakeTypeIdAccessor (&PcapReplayApplication::m_tid),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("Remote",
+                   "The destination of the packets, whatever their recorded destination.",
+                   AddressValue (),
+                   MakeAddressAccessor (&PcapReplayApplication::m_remote),
+                   MakeAddressChecker ())
+    .AddAttribute ("HeaderSize",
+                   "The number of bytes stripped from each record sent to the socket "
+                   "(the headers the socket adds again).",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapReplayApplication::m_headerSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Speed",
+                   "The replay speed: the recorded times between the packets are divided by it.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&PcapReplayApplication::m_speed),
+                   MakeDoubleChecker<double> (1e-9))
+    .AddAttribute ("BatchSize",
+                   "The number of records whose transmissions are scheduled at once.",
+                   UintegerValue (256),
+                   MakeUintegerAccessor (&PcapReplayApplication::m_batchSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Tx", "A packet has been sent",
+                     MakeTraceSourceAccessor (&PcapReplayApplication::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+PcapReplayApplication::PcapReplayApplication ()
+  : m_firstTime (0),
+    m_next (0),
+    m_sent (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapReplayApplication::~PcapReplayApplication ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PcapReplayApplication::SetDevice (Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  m_device = device;
+}
+
+uint64_t
+PcapReplayApplication::GetSent (void) const
+{
+  return m_sent;
+}
+
+void
+PcapReplayApplication::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = 0;
+  m_device = 0;
+  m_reader.Close ();
+  Application::DoDispose ();
+}
+
+void
+PcapReplayApplication::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_reader.Open (m_filename))
+    {
+      NS_FATAL_ERROR ("PcapReplayApplication: cannot read the pcap file \"" << m_filename << "\"");
+    }
+
+  if (m_device != 0)
+    {
+      switch (m_reader.GetDataLinkType ())
+        {
+        case PcapHelper::DLT_EN10MB:
+        case PcapHelper::DLT_LINUX_SLL:
+        case PcapHelper::DLT_PPP:
+        case PcapHelper::DLT_RAW:
+          break;
+        default:
+          NS_FATAL_ERROR ("PcapReplayApplication: cannot send the records of data link type "
+                          << m_reader.GetDataLinkType () << " to a NetDevice");
+        }
+    }
+  else if (m_socket == 0)
+    {
+      m_socket = Socket::CreateSocket (GetNode (), m_tid);
+      int ret = Inet6SocketAddress::IsMatchingType (m_remote) ? m_socket->Bind6 () : m_socket->Bind ();
+      if (ret == -1)
+        {
+          NS_FATAL_ERROR ("PcapReplayApplication: failed to bind the socket");
+        }
+      m_socket->Connect (m_remote);
+      m_socket->ShutdownRecv ();
+    }
+
+  PcapReader::Record first;
+  if (!m_reader.Next (first))
+    {
+      NS_LOG_WARN ("No record in " << m_filename);
+      return;
+    }
+  m_reader.Rewind ();
+  m_firstTime = first.time;
+  m_replayStart = Simulator::Now ();
+  ScheduleBatch ();
+}
+
+void
+PcapReplayApplication::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = m_next; i < m_events.size (); ++i)
+    {
+      Simulator::Cancel (m_events[i]);
+    }
+  m_events.clear ();
+  m_batch.clear ();
+  m_next = 0;
+  m_reader.Close ();
+  if (m_socket != 0)
+    {
+      m_socket->Close ();
+      m_socket = 0;
+    }
+}
+
+void
+PcapReplayApplication::ScheduleBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_batch.clear ();
+  m_next = 0;
+  std::vector<Time> delays;
+  Time now = Simulator::Now ();
+  Time last = now;
+  PcapReader::Record record;
+  while (m_batch.size () < m_batchSize && m_reader.Next (record))
+    {
+      m_batch.push_back (record);
+      int64_t offset = record.time > m_firstTime ? record.time - m_firstTime : 0;
+      Time at = m_replayStart + NanoSeconds (static_cast<int64_t> (offset / m_speed));
+      // The events must run in the order of the records, even if the
+      // capture is not sorted by time.
+      last = std::max (last, at);
+      delays.push_back (last - now);
+    }
+  if (m_batch.empty ())
+    {
+      m_events.clear ();
+      return;
+    }
+  m_events = Simulator::ScheduleBatch (delays, &PcapReplayApplication::SendNext, this);
+}
+
+void
+PcapReplayApplication::SendNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  const PcapReader::Record &record = m_batch[m_next++];
+  if (m_device != 0)
+    {
+      if (SendToDevice (record))
+        {
+          ++m_sent;
+        }
+    }
+  else
+    {
+      Ptr<Packet> packet = MakePacket (record, m_headerSize);
+      m_txTrace (packet);
+      m_socket->Send (packet);
+      ++m_sent;
+    }
+  if (m_next == m_batch.size ())
+    {
+      ScheduleBatch ();
+    }
+}
+
+bool
+PcapReplayApplication::SendToDevice (const PcapReader::Record &record)
+{
+  const uint8_t *data = record.data;
+  uint32_t length = record.inclLen;
+  uint32_t skip = 0;
+  uint16_t protocol = 0;
+  Address destination = m_remote;
+  switch (m_reader.GetDataLinkType ())
+    {
+    case PcapHelper::DLT_EN10MB:
+      skip = 14;
+      if (length >= skip)
+        {
+          protocol = (data[12] << 8) | data[13];
+          if (destination.IsInvalid ())
+            {
+              Mac48Address mac;
+              mac.CopyFrom (data);
+              destination = mac;
+            }
+        }
+      break;
+    case PcapHelper::DLT_LINUX_SLL:
+      skip = 16;
+      if (length >= skip)
+        {
+          protocol = (data[14] << 8) | data[15];
+        }
+      break;
+    case PcapHelper::DLT_PPP:
+      // The address and control fields are optional
+      skip = (length >= 2 && data[0] == 0xff && data[1] == 0x03) ? 4 : 2;
+      if (length >= skip)
+        {
+          uint16_t pppProtocol = (data[skip - 2] << 8) | data[skip - 1];
+          protocol = pppProtocol == 0x0021 ? 0x0800 : pppProtocol == 0x0057 ? 0x86dd : 0;
+        }
+      break;
+    case PcapHelper::DLT_RAW:
+      if (length >= 1)
+        {
+          uint8_t version = data[0] >> 4;
+          protocol = version == 4 ? 0x0800 : version == 6 ? 0x86dd : 0;
+        }
+      break;
+    }
+  if (length < skip || protocol == 0)
+    {
+      NS_LOG_WARN ("Record of unknown protocol, or truncated link layer header");
+      return false;
+    }
+  if (destination.IsInvalid ())
+    {
+      destination = m_device->GetBroadcast ();
+    }
+  Ptr<Packet> packet = MakePacket (record, skip);
+  m_txTrace (packet);
+  m_device->Send (packet, destination, protocol);
+  return true;
+}
+
+Ptr<Packet>
+PcapReplayApplication::MakePacket (const PcapReader::Record &record, uint32_t skip) const
+{
+  uint32_t size = record.origLen > skip ? record.origLen - skip : 0;
+  uint32_t captured = record.inclLen > skip ? record.inclLen - skip : 0;
+  captured = std::min (captured, size);
+  Ptr<Packet> packet = Create<Packet> (record.data + skip, captured);
+  if (size > captured)
+    {
+      // The bytes beyond the snap length were not captured: zero-filled
+      packet->AddAtEnd (Create<Packet> (size - captured));
+    }
+  return packet;
+}
+
+} // namespace ns3
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_REPLAY_APPLICATION_H
+#define PCAP_REPLAY_APPLICATION_H
+
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/address.h"
+#include "ns3/traced-callback.h"
+#include "pcap-reader.h"
+#include <vector>
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+class NetDevice;
+
+/**
+ * \ingroup socket
+ *
+ * \brief Replay the packets of a pcap file.
+ *
+ * Each record of the file (attribute `File') is sent at the time it
+ * was captured, relative to the first record and to the start of the
+ * application, divided by the `Speed' factor.  The packets have the
+ * length of the captured packets on the wire, and carry their captured
+ * bytes, padded with zeros when the capture was truncated to its snap
+ * length.
+ *
+ * The packets are sent either:
+ * - through a socket of the `Protocol' factory, connected to `Remote'.
+ *   The first `HeaderSize' bytes of each record, e.g. 42 for UDP over
+ *   IPv4 over Ethernet, are stripped, since the socket adds its own
+ *   headers;
+ * - or, if SetDevice was called, directly to the NetDevice.  The link
+ *   layer header of the record is then stripped according to the data
+ *   link type of the file (Ethernet, Linux cooked, PPP or raw IP), and
+ *   gives the protocol number.  The destination is `Remote' if set,
+ *   else the destination of Ethernet frames, else the broadcast address.
+ *
+ * So the packets of the file are sent to `Remote' whatever their
+ * recorded addresses.
+ *
+ * The file is read through a PcapReader, and the send events are
+ * scheduled `BatchSize' records at a time with Simulator::ScheduleBatch;
+ * the bytes of a packet are only copied out of the file when it is sent.
+ */
+class PcapReplayApplication : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PcapReplayApplication ();
+
+  virtual ~PcapReplayApplication ();
+
+  /**
+   * \brief Send the packets directly to a NetDevice rather than to a socket.
+   * \param device The NetDevice, of the node of this application.
+   */
+  void SetDevice (Ptr<NetDevice> device);
+
+  /**
+   * \brief Get the number of packets sent.
+   * \return the number of packets sent
+   */
+  uint64_t GetSent (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * \brief Read the next batch of records and schedule their transmissions.
+   */
+  void ScheduleBatch (void);
+  /**
+   * \brief Send the packet of the next scheduled record.
+   */
+  void SendNext (void);
+  /**
+   * \brief Send a record to the NetDevice.
+   * \param record The record.
+   * \return false if the record could not be decoded
+   */
+  bool SendToDevice (const PcapReader::Record &record);
+  /**
+   * \brief Build the packet of a record.
+   * \param record The record.
+   * \param skip The number of leading bytes of the record to strip.
+   * \return the packet
+   */
+  Ptr<Packet> MakePacket (const PcapReader::Record &record, uint32_t skip) const;
+
+  std::string m_filename;      //!< Pcap file name
+  TypeId m_tid;                //!< Type of the socket factory
+  Address m_remote;            //!< Destination address
+  uint32_t m_headerSize;       //!< Bytes stripped from the records sent to the socket
+  double m_speed;              //!< Replay speed factor
+  uint32_t m_batchSize;        //!< Number of records scheduled at once
+
+  PcapReader m_reader;         //!< Pcap file reader
+  Ptr<Socket> m_socket;        //!< Socket
+  Ptr<NetDevice> m_device;     //!< NetDevice, if the packets are sent directly to it
+  uint64_t m_firstTime;        //!< Timestamp of the first record, in nanoseconds
+  Time m_replayStart;          //!< Time of the transmission of the first record
+  std::vector<PcapReader::Record> m_batch; //!< Records of the current batch
+  std::vector<EventId> m_events;           //!< Send events of the current batch
+  uint32_t m_next;             //!< Index of the next record of the batch
+  uint64_t m_sent;             //!< Number of packets sent
+
+  /// Traced Callback: sent packets.
+  TracedCallback<Ptr<const Packet> > m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* PCAP_REPLAY_APPLICATION_H */
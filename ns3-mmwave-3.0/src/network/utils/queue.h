@@ -398,6 +398,36 @@ protected:
    */
   Ptr<const Item> DoPeek (ConstIterator pos) const;
 
+  /**
+   * \brief Admit an item which fits in the queue, or drop it
+   *
+   * If the item does not fit, it is dropped with DropBeforeEnqueue, which
+   * fires the Drop traces.  Subclasses which store their items in a
+   * container of their own, rather than through DoEnqueue, call this
+   * method before storing an item, and NotifyEnqueue after storing it.
+   *
+   * \param item the item to enqueue
+   * \return true if the item fits, false if it has been dropped.
+   */
+  bool AdmitOrDrop (Ptr<Item> item);
+
+  /**
+   * \brief Count an item stored in the queue, and fire the Enqueue trace
+   * \param item the item enqueued
+   */
+  void NotifyEnqueue (Ptr<Item> item);
+
+  /**
+   * \brief Count an item taken out of the queue, and fire the Dequeue trace
+   *
+   * Subclasses which store their items in a container of their own call
+   * this method for the items they dequeue, followed by DropAfterDequeue
+   * for the items they remove.
+   *
+   * \param item the item dequeued
+   */
+  void NotifyDequeue (Ptr<Item> item);
+
   /**
    * \brief Drop a packet before enqueue
    * \param item item that was dropped
@@ -483,24 +513,14 @@ Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item)
 {
   NS_LOG_FUNCTION (this << item);
 
-  if (GetCurrentSize () + item > GetMaxSize ())
+  if (!AdmitOrDrop (item))
     {
-      NS_LOG_LOGIC ("Queue full -- dropping pkt");
-      DropBeforeEnqueue (item);
       return false;
     }
 
   m_packets.insert (pos, item);
 
-  uint32_t size = item->GetSize ();
-  m_nBytes += size;
-  m_nTotalReceivedBytes += size;
-
-  m_nPackets++;
-  m_nTotalReceivedPackets++;
-
-  NS_LOG_LOGIC ("m_traceEnqueue (p)");
-  m_traceEnqueue (item);
+  NotifyEnqueue (item);
 
   return true;
 }
@@ -522,14 +542,7 @@ Queue<Item>::DoDequeue (ConstIterator pos)
 
   if (item != 0)
     {
-      NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
-      NS_ASSERT (m_nPackets.Get () > 0);
-
-      m_nBytes -= item->GetSize ();
-      m_nPackets--;
-
-      NS_LOG_LOGIC ("m_traceDequeue (p)");
-      m_traceDequeue (item);
+      NotifyDequeue (item);
     }
   return item;
 }
@@ -551,21 +564,56 @@ Queue<Item>::DoRemove (ConstIterator pos)
 
   if (item != 0)
     {
-      NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
-      NS_ASSERT (m_nPackets.Get () > 0);
-
-      m_nBytes -= item->GetSize ();
-      m_nPackets--;
-
       // packets are first dequeued and then dropped
-      NS_LOG_LOGIC ("m_traceDequeue (p)");
-      m_traceDequeue (item);
+      NotifyDequeue (item);
 
       DropAfterDequeue (item);
     }
   return item;
 }
 
+template <typename Item>
+bool
+Queue<Item>::AdmitOrDrop (Ptr<Item> item)
+{
+  if (GetCurrentSize () + item > GetMaxSize ())
+    {
+      NS_LOG_LOGIC ("Queue full -- dropping pkt");
+      DropBeforeEnqueue (item);
+      return false;
+    }
+  return true;
+}
+
+template <typename Item>
+void
+Queue<Item>::NotifyEnqueue (Ptr<Item> item)
+{
+  uint32_t size = item->GetSize ();
+  m_nBytes += size;
+  m_nTotalReceivedBytes += size;
+
+  m_nPackets++;
+  m_nTotalReceivedPackets++;
+
+  NS_LOG_LOGIC ("m_traceEnqueue (p)");
+  m_traceEnqueue (item);
+}
+
+template <typename Item>
+void
+Queue<Item>::NotifyDequeue (Ptr<Item> item)
+{
+  NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
+  NS_ASSERT (m_nPackets.Get () > 0);
+
+  m_nBytes -= item->GetSize ();
+  m_nPackets--;
+
+  NS_LOG_LOGIC ("m_traceDequeue (p)");
+  m_traceDequeue (item);
+}
+
 template <typename Item>
 void
 Queue<Item>::Flush (void)
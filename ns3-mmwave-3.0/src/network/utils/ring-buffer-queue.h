@@ -0,0 +1,272 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RING_BUFFER_QUEUE_H
+#define RING_BUFFER_QUEUE_H
+
+#include "ns3/queue.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup queue
+ *
+ * \brief A FIFO packet queue stored in a ring buffer, that drops tail-end
+ * packets on overflow
+ *
+ * RingBufferQueue behaves as DropTailQueue: it has the same MaxSize
+ * attribute, in packets or in bytes, the same trace sources and the
+ * same statistics. But its items are stored in a circular array, which
+ * doubles when it is full, rather than in a list, so that enqueuing and
+ * dequeuing an item neither allocates nor frees memory once the array
+ * has reached the size of the queue.
+ *
+ * It can replace the DropTailQueue of a NetDevice, e.g.
+ *
+ * \code
+ *   PointToPointHelper p2p;
+ *   p2p.SetQueue ("ns3::RingBufferQueue", "MaxSize", StringValue ("1000p"));
+ * \endcode
+ */
+template <typename Item>
+class RingBufferQueue : public Queue<Item>
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief RingBufferQueue Constructor
+   *
+   * Creates a queue with a maximum size of 100 packets by default
+   */
+  RingBufferQueue ();
+
+  virtual ~RingBufferQueue ();
+
+  virtual bool Enqueue (Ptr<Item> item);
+  virtual Ptr<Item> Dequeue (void);
+  virtual Ptr<Item> Remove (void);
+  virtual Ptr<const Item> Peek (void) const;
+
+  /**
+   * \return the number of items the ring buffer can hold before it grows
+   */
+  uint32_t GetCapacity (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  using Queue<Item>::AdmitOrDrop;
+  using Queue<Item>::NotifyEnqueue;
+  using Queue<Item>::NotifyDequeue;
+  using Queue<Item>::DropAfterDequeue;
+
+  /**
+   * \brief Take the item at the head of the ring buffer
+   * \return the item
+   */
+  Ptr<Item> Pop (void);
+
+  /**
+   * \brief Double the size of the ring buffer
+   */
+  void Grow (void);
+
+  std::vector<Ptr<Item> > m_ring; //!< the items, in a power of two number of slots
+  uint32_t m_head;                //!< the number of items ever taken out of the ring
+  uint32_t m_tail;                //!< the number of items ever stored in the ring
+
+  NS_LOG_TEMPLATE_DECLARE;        //!< redefinition of the log component
+};
+
+
+/**
+ * Implementation of the templates declared above.
+ */
+
+template <typename Item>
+TypeId
+RingBufferQueue<Item>::GetTypeId (void)
+{
+  static TypeId tid = TypeId (("ns3::RingBufferQueue<" + GetTypeParamName<RingBufferQueue<Item> > () + ">").c_str ())
+    .SetParent<Queue<Item> > ()
+    .SetGroupName ("Network")
+    .template AddConstructor<RingBufferQueue<Item> > ()
+    .AddAttribute ("MaxSize",
+                   "The max queue size",
+                   QueueSizeValue (QueueSize ("100p")),
+                   MakeQueueSizeAccessor (&QueueBase::SetMaxSize,
+                                          &QueueBase::GetMaxSize),
+                   MakeQueueSizeChecker ())
+  ;
+  return tid;
+}
+
+template <typename Item>
+RingBufferQueue<Item>::RingBufferQueue () :
+  Queue<Item> (),
+  m_head (0),
+  m_tail (0),
+  NS_LOG_TEMPLATE_DEFINE ("RingBufferQueue")
+{
+  NS_LOG_FUNCTION (this);
+}
+
+template <typename Item>
+RingBufferQueue<Item>::~RingBufferQueue ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+template <typename Item>
+void
+RingBufferQueue<Item>::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_ring.clear ();
+  m_head = 0;
+  m_tail = 0;
+  Queue<Item>::DoDispose ();
+}
+
+template <typename Item>
+bool
+RingBufferQueue<Item>::Enqueue (Ptr<Item> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  if (!AdmitOrDrop (item))
+    {
+      return false;
+    }
+  if (m_tail - m_head == m_ring.size ())
+    {
+      Grow ();
+    }
+  m_ring[m_tail++ & (m_ring.size () - 1)] = item;
+
+  NotifyEnqueue (item);
+
+  return true;
+}
+
+template <typename Item>
+Ptr<Item>
+RingBufferQueue<Item>::Dequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_head == m_tail)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+  Ptr<Item> item = Pop ();
+  NotifyDequeue (item);
+
+  NS_LOG_LOGIC ("Popped " << item);
+
+  return item;
+}
+
+template <typename Item>
+Ptr<Item>
+RingBufferQueue<Item>::Remove (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_head == m_tail)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+  Ptr<Item> item = Pop ();
+  // packets are first dequeued and then dropped
+  NotifyDequeue (item);
+  DropAfterDequeue (item);
+
+  NS_LOG_LOGIC ("Removed " << item);
+
+  return item;
+}
+
+template <typename Item>
+Ptr<const Item>
+RingBufferQueue<Item>::Peek (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_head == m_tail)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+  return m_ring[m_head & (m_ring.size () - 1)];
+}
+
+template <typename Item>
+uint32_t
+RingBufferQueue<Item>::GetCapacity (void) const
+{
+  return m_ring.size ();
+}
+
+template <typename Item>
+Ptr<Item>
+RingBufferQueue<Item>::Pop (void)
+{
+  Ptr<Item> &slot = m_ring[m_head++ & (m_ring.size () - 1)];
+  Ptr<Item> item = slot;
+  slot = 0;
+  return item;
+}
+
+template <typename Item>
+void
+RingBufferQueue<Item>::Grow (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t size = m_ring.empty () ? 16 : 2 * m_ring.size ();
+  std::vector<Ptr<Item> > ring (size);
+  uint32_t n = 0;
+  while (m_head != m_tail)
+    {
+      ring[n++] = Pop ();
+    }
+  m_ring.swap (ring);
+  m_head = 0;
+  m_tail = n;
+}
+
+// The following explicit template instantiation declarations prevent all the
+// translation units including this header file to implicitly instantiate the
+// RingBufferQueue<Packet> class and the RingBufferQueue<QueueDiscItem> class.
+// The unique instances of these classes are explicitly created through the
+// macros NS_OBJECT_TEMPLATE_CLASS_DEFINE (RingBufferQueue,Packet) and
+// NS_OBJECT_TEMPLATE_CLASS_DEFINE (RingBufferQueue,QueueDiscItem), which are
+// included in ring-buffer-queue.cc
+extern template class RingBufferQueue<Packet>;
+extern template class RingBufferQueue<QueueDiscItem>;
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_QUEUE_H */
@@ -0,0 +1,370 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "trace-filter.h"
+#include "flow-id-tag.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/trace-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceFilter");
+
+NS_OBJECT_ENSURE_REGISTERED (TraceFilter);
+
+/**
+ * \brief Find the IPv4 header of an 802.11 frame.
+ * \param [in] data The first bytes of the packet.
+ * \param [in] size The number of bytes in data.
+ * \param [in,out] offset The offset of the 802.11 header, then of the IPv4 header.
+ * \returns \c true if the frame is an unencrypted data frame carrying
+ *          an IPv4 packet after an LLC/SNAP header.
+ */
+static bool
+FindIpv4HeaderIn80211 (const uint8_t *data, uint32_t size, uint32_t &offset)
+{
+  if (size < offset + 24)
+    {
+      return false;
+    }
+  uint8_t type = (data[offset] >> 2) & 0x03;
+  uint8_t subtype = (data[offset] >> 4) & 0x0f;
+  uint8_t flags = data[offset + 1];
+  // Data frames with a payload, not protected
+  if (type != 2 || (subtype & 0x04) != 0 || (flags & 0x40) != 0)
+    {
+      return false;
+    }
+  uint32_t headerLength = 24;
+  if ((flags & 0x03) == 0x03)
+    {
+      // To and from DS: fourth address
+      headerLength += 6;
+    }
+  if ((subtype & 0x08) != 0)
+    {
+      // QoS control, whose A-MSDU present bit is not supported
+      if (size < offset + headerLength + 2 || (data[offset + headerLength] & 0x80) != 0)
+        {
+          return false;
+        }
+      headerLength += (flags & 0x80) != 0 ? 6 : 2;
+    }
+  offset += headerLength;
+  if (size < offset + 8 || data[offset] != 0xaa || data[offset + 1] != 0xaa)
+    {
+      return false;
+    }
+  uint16_t etherType = (data[offset + 6] << 8) | data[offset + 7];
+  offset += 8;
+  return etherType == 0x0800;
+}
+
+/**
+ * \brief Find the IPv4 header of a packet.
+ * \param [in] data The first bytes of the packet.
+ * \param [in] size The number of bytes in data.
+ * \param [in] dataLinkType The data link type of the packet.
+ * \param [out] offset The offset of the IPv4 header.
+ * \returns \c true if the link layer header announces an IPv4 packet.
+ */
+static bool
+FindIpv4Header (const uint8_t *data, uint32_t size, uint32_t dataLinkType, uint32_t &offset)
+{
+  uint16_t type;
+  switch (dataLinkType)
+    {
+    case PcapHelper::DLT_EN10MB:
+      offset = 12;
+      if (size >= offset + 2 && data[offset] == 0x81 && data[offset + 1] == 0x00)
+        {
+          // 802.1Q tag
+          offset += 4;
+        }
+      if (size < offset + 2)
+        {
+          return false;
+        }
+      type = (data[offset] << 8) | data[offset + 1];
+      offset += 2;
+      if (type <= 1500)
+        {
+          // 802.3 length, followed by an LLC/SNAP header
+          if (size < offset + 8 || data[offset] != 0xaa || data[offset + 1] != 0xaa)
+            {
+              return false;
+            }
+          type = (data[offset + 6] << 8) | data[offset + 7];
+          offset += 8;
+        }
+      return type == 0x0800;
+    case PcapHelper::DLT_PPP:
+      // The address and control fields are optional
+      offset = (size >= 2 && data[0] == 0xff && data[1] == 0x03) ? 4 : 2;
+      return size >= offset && data[offset - 2] == 0x00 && data[offset - 1] == 0x21;
+    case PcapHelper::DLT_LINUX_SLL:
+      offset = 16;
+      return size >= offset && data[14] == 0x08 && data[15] == 0x00;
+    case PcapHelper::DLT_RAW:
+      offset = 0;
+      return true;
+    case PcapHelper::DLT_IEEE802_11:
+      offset = 0;
+      return FindIpv4HeaderIn80211 (data, size, offset);
+    case PcapHelper::DLT_IEEE802_11_RADIO:
+      // The length of the radiotap header is little endian
+      if (size < 4)
+        {
+          return false;
+        }
+      offset = data[2] | (data[3] << 8);
+      return FindIpv4HeaderIn80211 (data, size, offset);
+    case PcapHelper::DLT_NULL:
+      // AF_INET, in the byte order of the host which wrote the file
+      offset = 4;
+      return size >= offset && (data[0] == 2 || data[3] == 2);
+    default:
+      return false;
+    }
+}
+
+TypeId
+TraceFilter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceFilter")
+    .SetParent<Object> ()
+    .SetGroupName ("Network")
+    .AddConstructor<TraceFilter> ()
+    .AddAttribute ("Sampling",
+                   "Trace 1 in this number of packets, selected by their uid.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TraceFilter::m_sampling),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Budget",
+                   "The maximum number of packets, counted once by uid, traced per second "
+                   "of simulated time, or 0 for no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TraceFilter::m_budget),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("DataLinkType",
+                   "The data link type (a pcap DLT value) of the packets of ascii "
+                   "traces, to find their IPv4 header.",
+                   UintegerValue (PcapHelper::DLT_EN10MB),
+                   MakeUintegerAccessor (&TraceFilter::m_dataLinkType),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+TraceFilter::FiveTuple::FiveTuple ()
+  : source (Ipv4Address::GetAny ()),
+    destination (Ipv4Address::GetAny ()),
+    protocol (0),
+    sourcePort (0),
+    destinationPort (0)
+{
+}
+
+TraceFilter::TraceFilter ()
+  : m_second (-1),
+    m_accepted (0),
+    m_rejected (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TraceFilter::~TraceFilter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TraceFilter::AddFlowId (uint32_t flowId)
+{
+  NS_LOG_FUNCTION (this << flowId);
+  m_flowIds.push_back (flowId);
+}
+
+void
+TraceFilter::AddFiveTuple (const FiveTuple &tuple)
+{
+  NS_LOG_FUNCTION (this << tuple.source << tuple.destination << (uint32_t) tuple.protocol
+                        << tuple.sourcePort << tuple.destinationPort);
+  m_fiveTuples.push_back (tuple);
+}
+
+void
+TraceFilter::SetFlowFilter (Callback<bool, Ptr<const Packet> > filter)
+{
+  NS_LOG_FUNCTION (this);
+  m_flowFilter = filter;
+}
+
+bool
+TraceFilter::Accept (Ptr<const Packet> packet)
+{
+  return Accept (packet, m_dataLinkType);
+}
+
+bool
+TraceFilter::Accept (Ptr<const Packet> packet, uint32_t dataLinkType)
+{
+  return DoAccept (packet, 0, dataLinkType);
+}
+
+bool
+TraceFilter::Accept (Ptr<const Packet> packet, const Header &header, uint32_t dataLinkType)
+{
+  return DoAccept (packet, &header, dataLinkType);
+}
+
+bool
+TraceFilter::DoAccept (Ptr<const Packet> packet, const Header *header, uint32_t dataLinkType)
+{
+  NS_LOG_FUNCTION (this << packet << header << dataLinkType);
+
+  // Fibonacci hashing of the uid: the high bits are evenly spread
+  if (m_sampling > 1
+      && ((packet->GetUid () * UINT64_C (0x9e3779b97f4a7c15)) >> 32) % m_sampling != 0)
+    {
+      ++m_rejected;
+      return false;
+    }
+  if (!MatchFlows (packet, header, dataLinkType))
+    {
+      ++m_rejected;
+      return false;
+    }
+  if (m_budget > 0)
+    {
+      int64_t second = Simulator::Now ().GetNanoSeconds () / 1000000000;
+      if (second != m_second)
+        {
+          m_second = second;
+          m_secondUids.clear ();
+        }
+      // The other events of the packets already traced are free
+      if (m_secondUids.count (packet->GetUid ()) == 0)
+        {
+          if (m_secondUids.size () >= m_budget)
+            {
+              NS_LOG_LOGIC ("Budget exhausted");
+              ++m_rejected;
+              return false;
+            }
+          m_secondUids.insert (packet->GetUid ());
+        }
+    }
+  ++m_accepted;
+  return true;
+}
+
+uint64_t
+TraceFilter::GetAccepted (void) const
+{
+  return m_accepted;
+}
+
+uint64_t
+TraceFilter::GetRejected (void) const
+{
+  return m_rejected;
+}
+
+bool
+TraceFilter::MatchFlows (Ptr<const Packet> packet, const Header *header, uint32_t dataLinkType) const
+{
+  if (m_flowIds.empty () && m_fiveTuples.empty () && m_flowFilter.IsNull ())
+    {
+      return true;
+    }
+  if (!m_flowIds.empty ())
+    {
+      FlowIdTag tag;
+      if (packet->PeekPacketTag (tag) || packet->FindFirstMatchingByteTag (tag))
+        {
+          for (std::vector<uint32_t>::const_iterator i = m_flowIds.begin (); i != m_flowIds.end (); ++i)
+            {
+              if (*i == tag.GetFlowId ())
+                {
+                  return true;
+                }
+            }
+        }
+    }
+  if (!m_fiveTuples.empty () && MatchFiveTuples (packet, header, dataLinkType))
+    {
+      return true;
+    }
+  return !m_flowFilter.IsNull () && m_flowFilter (packet);
+}
+
+bool
+TraceFilter::MatchFiveTuples (Ptr<const Packet> packet, const Header *header, uint32_t dataLinkType) const
+{
+  // Enough for a radiotap and an 802.11 header with LLC/SNAP, an IPv4
+  // header with options, and the ports
+  uint8_t data[192];
+  uint32_t size = 0;
+  if (header != 0)
+    {
+      Buffer buffer;
+      buffer.AddAtStart (header->GetSerializedSize ());
+      header->Serialize (buffer.Begin ());
+      size = buffer.CopyData (data, sizeof (data));
+    }
+  size += packet->CopyData (data + size, sizeof (data) - size);
+  uint32_t ip;
+  if (!FindIpv4Header (data, size, dataLinkType, ip)
+      || size < ip + 20 || (data[ip] >> 4) != 4)
+    {
+      return false;
+    }
+  uint32_t headerLength = (data[ip] & 0x0f) * 4;
+  uint8_t protocol = data[ip + 9];
+  Ipv4Address source = Ipv4Address::Deserialize (data + ip + 12);
+  Ipv4Address destination = Ipv4Address::Deserialize (data + ip + 16);
+  uint16_t sourcePort = 0;
+  uint16_t destinationPort = 0;
+  // Only the first fragment has the ports
+  bool firstFragment = (data[ip + 6] & 0x1f) == 0 && data[ip + 7] == 0;
+  if ((protocol == 6 || protocol == 17) && firstFragment && size >= ip + headerLength + 4)
+    {
+      const uint8_t *ports = data + ip + headerLength;
+      sourcePort = (ports[0] << 8) | ports[1];
+      destinationPort = (ports[2] << 8) | ports[3];
+    }
+
+  for (std::vector<FiveTuple>::const_iterator i = m_fiveTuples.begin (); i != m_fiveTuples.end (); ++i)
+    {
+      if ((i->source == Ipv4Address::GetAny () || i->source == source)
+          && (i->destination == Ipv4Address::GetAny () || i->destination == destination)
+          && (i->protocol == 0 || i->protocol == protocol)
+          && (i->sourcePort == 0 || i->sourcePort == sourcePort)
+          && (i->destinationPort == 0 || i->destinationPort == destinationPort))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+} // namespace ns3
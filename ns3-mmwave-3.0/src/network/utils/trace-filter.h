@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_FILTER_H
+#define TRACE_FILTER_H
+
+#include "ns3/object.h"
+#include "ns3/callback.h"
+#include "ns3/ptr.h"
+#include "ns3/ipv4-address.h"
+#include <unordered_set>
+#include <vector>
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \ingroup network
+ *
+ * \brief Select the packets written to pcap and ascii traces.
+ *
+ * A filter attached to a PcapFileWrapper or to an OutputStreamWrapper
+ * (see PcapHelperForDevice::SetPcapFilter and
+ * AsciiTraceHelperForDevice::SetAsciiFilter) is asked about each packet
+ * before the packet is printed or copied to the trace.  A packet is
+ * traced if all of the following hold:
+ *
+ * - sampling: the packet is one of the 1 in `Sampling' packets selected
+ *   by a hash of its uid.  Since the uid of a packet does not change
+ *   along its path, the same packets are sampled by all the traces,
+ *   and all the events (enqueue, dequeue, receive) of a sampled packet
+ *   are traced;
+ * - flows: if flows were added, the packet belongs to one of them: it
+ *   has one of the flow ids added with AddFlowId (in a FlowIdTag), or
+ *   its IPv4 header and TCP or UDP ports match one of the 5-tuples added
+ *   with AddFiveTuple, or the callback set with SetFlowFilter returns
+ *   true;
+ * - budget: less than `Budget' packets were traced in the current
+ *   second of simulated time.  The budget is charged once per packet,
+ *   by uid, in each second: all the events of an admitted packet in the
+ *   same second are traced.  The budget is shared by all the traces the
+ *   filter is attached to.
+ *
+ * Finding the IPv4 header of a packet copies its first bytes, up to
+ * the transport ports, to the stack, rather than the packet.  The link
+ * layer header is skipped according to the data link type of the pcap
+ * file (Ethernet with optional VLAN tag and LLC/SNAP, PPP, Linux
+ * cooked, raw IP, BSD loopback, or 802.11 data frames with LLC/SNAP,
+ * optionally after a radiotap header); ascii traces, which have no data
+ * link type, use the `DataLinkType' attribute.  The header written
+ * before the packet by PcapFileWrapper::Write (Time, const Header &,
+ * Ptr<const Packet>) is serialized ahead of the packet.  Encrypted
+ * 802.11 frames and A-MSDUs never match a 5-tuple.
+ */
+class TraceFilter : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief A flow, identified by the fields of its IPv4 and transport headers.
+   *
+   * The fields left to their default value (any address, protocol or
+   * port 0) match any packet.
+   */
+  struct FiveTuple
+  {
+    FiveTuple ();
+
+    Ipv4Address source;          //!< Source address
+    Ipv4Address destination;     //!< Destination address
+    uint8_t protocol;            //!< IP protocol number, e.g. 6 for TCP, 17 for UDP
+    uint16_t sourcePort;         //!< Source port
+    uint16_t destinationPort;    //!< Destination port
+  };
+
+  TraceFilter ();
+  virtual ~TraceFilter ();
+
+  /**
+   * \brief Trace the packets of a flow id.
+   * \param flowId the flow id, of the FlowIdTag of the packets
+   */
+  void AddFlowId (uint32_t flowId);
+
+  /**
+   * \brief Trace the packets of a 5-tuple.
+   * \param tuple the 5-tuple
+   */
+  void AddFiveTuple (const FiveTuple &tuple);
+
+  /**
+   * \brief Trace the packets for which a callback returns true.
+   * \param filter the callback
+   */
+  void SetFlowFilter (Callback<bool, Ptr<const Packet> > filter);
+
+  /**
+   * \brief Decide whether to trace a packet of an ascii trace.
+   * \param packet the packet
+   * \return true if the packet should be traced
+   */
+  bool Accept (Ptr<const Packet> packet);
+
+  /**
+   * \brief Decide whether to trace a packet of a pcap file.
+   * \param packet the packet
+   * \param dataLinkType the data link type of the packet
+   * \return true if the packet should be traced
+   */
+  bool Accept (Ptr<const Packet> packet, uint32_t dataLinkType);
+
+  /**
+   * \brief Decide whether to trace a packet of a pcap file, written
+   * after a header.
+   * \param packet the packet
+   * \param header the header written before the packet, e.g. a radiotap header
+   * \param dataLinkType the data link type of the header and packet
+   * \return true if the packet should be traced
+   */
+  bool Accept (Ptr<const Packet> packet, const Header &header, uint32_t dataLinkType);
+
+  /**
+   * \return the number of calls to Accept which accepted the packet
+   */
+  uint64_t GetAccepted (void) const;
+
+  /**
+   * \return the number of calls to Accept which rejected the packet
+   */
+  uint64_t GetRejected (void) const;
+
+private:
+  /**
+   * \brief Decide whether to trace a packet.
+   * \param packet the packet
+   * \param header the header written before the packet, or 0
+   * \param dataLinkType the data link type of the header and packet
+   * \return true if the packet should be traced
+   */
+  bool DoAccept (Ptr<const Packet> packet, const Header *header, uint32_t dataLinkType);
+
+  /**
+   * \brief Check whether a packet belongs to one of the flows.
+   * \param packet the packet
+   * \param header the header written before the packet, or 0
+   * \param dataLinkType the data link type of the header and packet
+   * \return true if the packet belongs to one of the flows
+   */
+  bool MatchFlows (Ptr<const Packet> packet, const Header *header, uint32_t dataLinkType) const;
+
+  /**
+   * \brief Check whether a packet matches one of the 5-tuples.
+   * \param packet the packet
+   * \param header the header written before the packet, or 0
+   * \param dataLinkType the data link type of the header and packet
+   * \return true if the packet matches one of the 5-tuples
+   */
+  bool MatchFiveTuples (Ptr<const Packet> packet, const Header *header, uint32_t dataLinkType) const;
+
+  uint32_t m_sampling;                 //!< Trace 1 in m_sampling packets
+  uint32_t m_budget;                   //!< Maximum packets per second, 0 for none
+  uint32_t m_dataLinkType;             //!< Data link type of the ascii traces
+  std::vector<uint32_t> m_flowIds;     //!< Flow ids to trace
+  std::vector<FiveTuple> m_fiveTuples; //!< 5-tuples to trace
+  Callback<bool, Ptr<const Packet> > m_flowFilter; //!< Flow callback
+  int64_t m_second;                    //!< Current second of the budget
+  std::unordered_set<uint64_t> m_secondUids; //!< Uids of the packets traced in the current second
+  uint64_t m_accepted;                 //!< Number of accepted packets
+  uint64_t m_rejected;                 //!< Number of rejected packets
+};
+
+} // namespace ns3
+
+#endif /* TRACE_FILTER_H */
@@ -0,0 +1,639 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "replication-runner.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/simulator-snapshot.h"
+#include "ns3/data-calculator.h"
+#include "ns3/data-output-interface.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReplicationRunner");
+
+namespace replication {
+
+/** The kinds of calculator outputs. */
+enum OutputType
+{
+  STATISTIC,  //!< OutputStatistic
+  INT,        //!< OutputSingleton of an int
+  UINT32,     //!< OutputSingleton of a uint32_t
+  DOUBLE,     //!< OutputSingleton of a double
+  STRING,     //!< OutputSingleton of a string
+  TIME        //!< OutputSingleton of a Time
+};
+
+/** The header of the shared memory of a replication. */
+struct OutputHeader
+{
+  uint32_t complete;  //!< 1 if the outputs were written, else 0
+  uint32_t size;      //!< The size of the outputs
+};
+
+/** Write values one after the other into a buffer. */
+class Writer
+{
+public:
+  /**
+   * Constructor.
+   * \param [out] buffer The buffer.
+   * \param [in] size The size of the buffer.
+   */
+  Writer (uint8_t *buffer, uint32_t size)
+    : m_buffer (buffer),
+      m_size (size),
+      m_offset (0),
+      m_overflow (false)
+  {}
+  /**
+   * Write bytes.
+   * \param [in] data The bytes.
+   * \param [in] size The number of bytes.
+   */
+  void Write (const void *data, uint32_t size)
+  {
+    if (m_overflow || size > m_size - m_offset)
+      {
+        m_overflow = true;
+        return;
+      }
+    std::memcpy (m_buffer + m_offset, data, size);
+    m_offset += size;
+  }
+  /**
+   * Write a value.
+   * \tparam T \deduced The type of the value.
+   * \param [in] value The value.
+   */
+  template <typename T>
+  void Write (T value)
+  {
+    Write (&value, sizeof (value));
+  }
+  /**
+   * Write a string.
+   * \param [in] value The string.
+   */
+  void WriteString (const std::string &value)
+  {
+    Write<uint32_t> (value.size ());
+    Write (value.data (), value.size ());
+  }
+  /**
+   * Get the number of bytes written.
+   * \returns The size.
+   */
+  uint32_t GetSize (void) const
+  {
+    return m_offset;
+  }
+  /**
+   * Check if the buffer was too small.
+   * \returns \c true if some values were not written.
+   */
+  bool IsOverflow (void) const
+  {
+    return m_overflow;
+  }
+
+private:
+  uint8_t *m_buffer;   //!< The buffer.
+  uint32_t m_size;     //!< The size of the buffer.
+  uint32_t m_offset;   //!< The write position.
+  bool m_overflow;     //!< Whether the buffer was too small.
+};
+
+/** Read the values written by a Writer. */
+class Reader
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] buffer The buffer.
+   * \param [in] size The size of the written values.
+   */
+  Reader (const uint8_t *buffer, uint32_t size)
+    : m_buffer (buffer),
+      m_size (size),
+      m_offset (0)
+  {}
+  /**
+   * Read a value.
+   * \tparam T \explicit The type of the value.
+   * \returns The value.
+   */
+  template <typename T>
+  T Read (void)
+  {
+    T value;
+    NS_ABORT_MSG_IF (sizeof (value) > m_size - m_offset, "Truncated replication outputs");
+    std::memcpy (&value, m_buffer + m_offset, sizeof (value));
+    m_offset += sizeof (value);
+    return value;
+  }
+  /**
+   * Read a string.
+   * \returns The string.
+   */
+  std::string ReadString (void)
+  {
+    uint32_t size = Read<uint32_t> ();
+    NS_ABORT_MSG_IF (size > m_size - m_offset, "Truncated replication outputs");
+    std::string value (reinterpret_cast<const char *> (m_buffer + m_offset), size);
+    m_offset += size;
+    return value;
+  }
+
+private:
+  const uint8_t *m_buffer;   //!< The buffer.
+  uint32_t m_size;           //!< The size of the written values.
+  uint32_t m_offset;         //!< The read position.
+};
+
+/** A StatisticalSummary holding the values of another. */
+class Summary : public StatisticalSummary
+{
+public:
+  long count;       //!< The count.
+  double sum;       //!< The sum.
+  double sqrSum;    //!< The sum of squares.
+  double min;       //!< The minimum.
+  double max;       //!< The maximum.
+  double mean;      //!< The mean.
+  double stddev;    //!< The standard deviation.
+  double variance;  //!< The variance.
+
+  // Inherited
+  virtual long getCount () const
+  {
+    return count;
+  }
+  virtual double getSum () const
+  {
+    return sum;
+  }
+  virtual double getSqrSum () const
+  {
+    return sqrSum;
+  }
+  virtual double getMin () const
+  {
+    return min;
+  }
+  virtual double getMax () const
+  {
+    return max;
+  }
+  virtual double getMean () const
+  {
+    return mean;
+  }
+  virtual double getStddev () const
+  {
+    return stddev;
+  }
+  virtual double getVariance () const
+  {
+    return variance;
+  }
+};
+
+/** A DataOutputCallback writing the outputs of a calculator. */
+class WriterCallback : public DataOutputCallback
+{
+public:
+  /**
+   * Constructor.
+   * \param [in,out] writer The writer.
+   */
+  WriterCallback (Writer &writer)
+    : m_writer (writer),
+      m_count (0)
+  {}
+  /**
+   * Get the number of outputs written.
+   * \returns The number of outputs.
+   */
+  uint32_t GetCount (void) const
+  {
+    return m_count;
+  }
+
+  // Inherited
+  virtual void OutputStatistic (std::string key, std::string variable,
+                                const StatisticalSummary *statSum)
+  {
+    WriteHeader (STATISTIC, key, variable);
+    m_writer.Write<int64_t> (statSum->getCount ());
+    m_writer.Write (statSum->getSum ());
+    m_writer.Write (statSum->getSqrSum ());
+    m_writer.Write (statSum->getMin ());
+    m_writer.Write (statSum->getMax ());
+    m_writer.Write (statSum->getMean ());
+    m_writer.Write (statSum->getStddev ());
+    m_writer.Write (statSum->getVariance ());
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, int val)
+  {
+    WriteHeader (INT, key, variable);
+    m_writer.Write<int64_t> (val);
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, uint32_t val)
+  {
+    WriteHeader (UINT32, key, variable);
+    m_writer.Write (val);
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, double val)
+  {
+    WriteHeader (DOUBLE, key, variable);
+    m_writer.Write (val);
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, std::string val)
+  {
+    WriteHeader (STRING, key, variable);
+    m_writer.WriteString (val);
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, Time val)
+  {
+    WriteHeader (TIME, key, variable);
+    m_writer.Write (val.GetTimeStep ());
+  }
+
+private:
+  /**
+   * Write the start of an output.
+   * \param [in] type The kind of output.
+   * \param [in] key The key.
+   * \param [in] variable The variable.
+   */
+  void WriteHeader (enum OutputType type, const std::string &key, const std::string &variable)
+  {
+    m_writer.Write<uint8_t> (type);
+    m_writer.WriteString (key);
+    m_writer.WriteString (variable);
+    ++m_count;
+  }
+
+  Writer &m_writer;    //!< The writer.
+  uint32_t m_count;    //!< The number of outputs written.
+};
+
+/** A DataCalculator replaying the outputs of a replication. */
+class ReplayCalculator : public DataCalculator
+{
+public:
+  /**
+   * Read the outputs of a calculator.
+   * \param [in,out] reader The reader.
+   * \param [in] count The number of outputs.
+   */
+  void Read (Reader &reader, uint32_t count)
+  {
+    for (uint32_t i = 0; i < count; ++i)
+      {
+        Entry entry;
+        entry.type = static_cast<enum OutputType> (reader.Read<uint8_t> ());
+        entry.key = reader.ReadString ();
+        entry.variable = reader.ReadString ();
+        switch (entry.type)
+          {
+          case STATISTIC:
+            entry.summary.count = reader.Read<int64_t> ();
+            entry.summary.sum = reader.Read<double> ();
+            entry.summary.sqrSum = reader.Read<double> ();
+            entry.summary.min = reader.Read<double> ();
+            entry.summary.max = reader.Read<double> ();
+            entry.summary.mean = reader.Read<double> ();
+            entry.summary.stddev = reader.Read<double> ();
+            entry.summary.variance = reader.Read<double> ();
+            break;
+          case INT:
+            entry.integer = reader.Read<int64_t> ();
+            break;
+          case UINT32:
+            entry.integer = reader.Read<uint32_t> ();
+            break;
+          case DOUBLE:
+            entry.real = reader.Read<double> ();
+            break;
+          case STRING:
+            entry.text = reader.ReadString ();
+            break;
+          case TIME:
+            entry.integer = reader.Read<int64_t> ();
+            break;
+          default:
+            NS_FATAL_ERROR ("Unknown replication output type " << entry.type);
+          }
+        m_entries.push_back (entry);
+      }
+  }
+
+  // Inherited
+  virtual void Output (DataOutputCallback &callback) const
+  {
+    for (std::vector<Entry>::const_iterator i = m_entries.begin ();
+         i != m_entries.end (); ++i)
+      {
+        switch (i->type)
+          {
+          case STATISTIC:
+            callback.OutputStatistic (i->key, i->variable, &i->summary);
+            break;
+          case INT:
+            callback.OutputSingleton (i->key, i->variable, static_cast<int> (i->integer));
+            break;
+          case UINT32:
+            callback.OutputSingleton (i->key, i->variable, static_cast<uint32_t> (i->integer));
+            break;
+          case DOUBLE:
+            callback.OutputSingleton (i->key, i->variable, i->real);
+            break;
+          case STRING:
+            callback.OutputSingleton (i->key, i->variable, i->text);
+            break;
+          case TIME:
+            callback.OutputSingleton (i->key, i->variable, TimeStep (i->integer));
+            break;
+          }
+      }
+  }
+
+private:
+  /** A recorded output. */
+  struct Entry
+  {
+    enum OutputType type;   //!< The kind of output.
+    std::string key;        //!< The key.
+    std::string variable;   //!< The variable.
+    Summary summary;        //!< The value of a STATISTIC.
+    int64_t integer;        //!< The value of an INT, UINT32 or TIME.
+    double real;            //!< The value of a DOUBLE.
+    std::string text;       //!< The value of a STRING.
+  };
+  /** The recorded outputs. */
+  std::vector<Entry> m_entries;
+};
+
+/**
+ * Write the labels, metadata and calculator outputs of a DataCollector.
+ * \param [in] collector The DataCollector.
+ * \param [in,out] writer The writer.
+ */
+void
+WriteCollector (DataCollector &collector, Writer &writer)
+{
+  writer.WriteString (collector.GetExperimentLabel ());
+  writer.WriteString (collector.GetStrategyLabel ());
+  writer.WriteString (collector.GetInputLabel ());
+  writer.WriteString (collector.GetRunLabel ());
+  writer.WriteString (collector.GetDescription ());
+
+  uint32_t nMetadata = std::distance (collector.MetadataBegin (), collector.MetadataEnd ());
+  writer.Write (nMetadata);
+  for (MetadataList::iterator i = collector.MetadataBegin ();
+       i != collector.MetadataEnd (); ++i)
+    {
+      writer.WriteString (i->first);
+      writer.WriteString (i->second);
+    }
+
+  uint32_t nCalculators = std::distance (collector.DataCalculatorBegin (),
+                                         collector.DataCalculatorEnd ());
+  writer.Write (nCalculators);
+  for (DataCalculatorList::iterator i = collector.DataCalculatorBegin ();
+       i != collector.DataCalculatorEnd (); ++i)
+    {
+      writer.WriteString ((*i)->GetKey ());
+      writer.WriteString ((*i)->GetContext ());
+      writer.Write<uint8_t> ((*i)->GetEnabled ());
+      // The number of outputs is known after writing them
+      Writer outputs (0, 0);
+      WriterCallback counter (outputs);
+      (*i)->Output (counter);
+      writer.Write (counter.GetCount ());
+      WriterCallback callback (writer);
+      (*i)->Output (callback);
+    }
+}
+
+/**
+ * Read the DataCollector written by WriteCollector.
+ * \param [in,out] reader The reader.
+ * \returns The DataCollector.
+ */
+Ptr<DataCollector>
+ReadCollector (Reader &reader)
+{
+  Ptr<DataCollector> collector = CreateObject<DataCollector> ();
+  std::string experiment = reader.ReadString ();
+  std::string strategy = reader.ReadString ();
+  std::string input = reader.ReadString ();
+  std::string run = reader.ReadString ();
+  std::string description = reader.ReadString ();
+  collector->DescribeRun (experiment, strategy, input, run, description);
+
+  uint32_t nMetadata = reader.Read<uint32_t> ();
+  for (uint32_t i = 0; i < nMetadata; ++i)
+    {
+      std::string key = reader.ReadString ();
+      collector->AddMetadata (key, reader.ReadString ());
+    }
+
+  uint32_t nCalculators = reader.Read<uint32_t> ();
+  for (uint32_t i = 0; i < nCalculators; ++i)
+    {
+      Ptr<ReplayCalculator> calculator = CreateObject<ReplayCalculator> ();
+      calculator->SetKey (reader.ReadString ());
+      calculator->SetContext (reader.ReadString ());
+      if (!reader.Read<uint8_t> ())
+        {
+          calculator->Disable ();
+        }
+      calculator->Read (reader, reader.Read<uint32_t> ());
+      collector->AddDataCalculator (calculator);
+    }
+  return collector;
+}
+
+} // namespace replication
+
+
+ReplicationRunner::ReplicationRunner ()
+  : m_jobs (1),
+    m_firstRun (0),
+    m_outputSize (64 * 1024)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ReplicationRunner::SetDataCollector (Ptr<DataCollector> collector)
+{
+  NS_LOG_FUNCTION (this << collector);
+  m_collector = collector;
+}
+
+void
+ReplicationRunner::SetJobs (uint32_t jobs)
+{
+  NS_LOG_FUNCTION (this << jobs);
+  NS_ABORT_MSG_IF (jobs == 0, "ReplicationRunner needs at least one job");
+  m_jobs = jobs;
+}
+
+void
+ReplicationRunner::SetFirstRun (uint64_t run)
+{
+  NS_LOG_FUNCTION (this << run);
+  m_firstRun = run;
+}
+
+void
+ReplicationRunner::SetOutputSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ABORT_MSG_IF (size <= sizeof (replication::OutputHeader),
+                   "ReplicationRunner output size too small");
+  m_outputSize = size;
+}
+
+uint32_t
+ReplicationRunner::Run (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  if (m_firstRun == 0)
+    {
+      m_firstRun = RngSeedManager::GetRun () + 1;
+    }
+  m_results.clear ();
+
+  // Shared with the workers, which only touch their own pages
+  std::size_t size = static_cast<std::size_t> (n) * m_outputSize;
+  uint8_t *outputs = 0;
+  if (size != 0)
+    {
+      void *data = mmap (0, size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+      NS_ABORT_MSG_IF (data == MAP_FAILED, "Unable to map the replication outputs: "
+                       << std::strerror (errno));
+      outputs = static_cast<uint8_t *> (data);
+    }
+
+  uint32_t replication = SimulatorSnapshot::Branch (n, m_jobs);
+  if (replication < n)
+    {
+      RunReplication (replication, outputs + static_cast<std::size_t> (replication) * m_outputSize);
+    }
+
+  uint32_t succeeded = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      const uint8_t *output = outputs + static_cast<std::size_t> (i) * m_outputSize;
+      replication::OutputHeader header;
+      std::memcpy (&header, output, sizeof (header));
+      Ptr<DataCollector> collector;
+      if (header.complete)
+        {
+          ++succeeded;
+          if (m_collector != 0)
+            {
+              replication::Reader reader (output + sizeof (header), header.size);
+              collector = replication::ReadCollector (reader);
+            }
+        }
+      else
+        {
+          NS_LOG_WARN ("Replication " << i << " (run " << m_firstRun + i << ") failed");
+        }
+      m_results.push_back (collector);
+    }
+  if (outputs != 0)
+    {
+      munmap (outputs, size);
+    }
+  // The next replications do not reuse these run numbers
+  m_firstRun += n;
+  return succeeded;
+}
+
+void
+ReplicationRunner::RunReplication (uint32_t replication, uint8_t *output)
+{
+  NS_LOG_FUNCTION (this << replication);
+  uint64_t run = m_firstRun + replication;
+  RngSeedManager::SetRun (run);
+  RandomVariableStream::Reseed ();
+  if (m_collector != 0)
+    {
+      std::ostringstream runLabel;
+      runLabel << run;
+      m_collector->DescribeRun (m_collector->GetExperimentLabel (),
+                                m_collector->GetStrategyLabel (),
+                                m_collector->GetInputLabel (),
+                                runLabel.str (),
+                                m_collector->GetDescription ());
+    }
+
+  Simulator::Run ();
+
+  replication::OutputHeader header;
+  header.complete = 1;
+  header.size = 0;
+  if (m_collector != 0)
+    {
+      replication::Writer writer (output + sizeof (header), m_outputSize - sizeof (header));
+      replication::WriteCollector (*m_collector, writer);
+      if (writer.IsOverflow ())
+        {
+          NS_LOG_WARN ("The outputs of replication " << replication
+                       << " do not fit in " << m_outputSize << " bytes");
+          header.complete = 0;
+        }
+      header.size = writer.GetSize ();
+    }
+  std::memcpy (output, &header, sizeof (header));
+
+  Simulator::Destroy ();
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::fflush (0);
+  _exit (header.complete ? 0 : 1);
+}
+
+Ptr<DataCollector>
+ReplicationRunner::GetDataCollector (uint32_t replication) const
+{
+  NS_LOG_FUNCTION (this << replication);
+  NS_ASSERT_MSG (replication < m_results.size (), "Unknown replication " << replication);
+  return m_results[replication];
+}
+
+} // namespace ns3
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/data-collector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup stats
+ * \brief Run independent replications of a simulation in parallel,
+ * from a topology built once.
+ *
+ * Run forks a worker process for each replication, with
+ * SimulatorSnapshot::Branch, so the workers share the topology built
+ * by the calling process.  Each worker sets its run number, restarts
+ * the random variable streams with RandomVariableStream::Reseed, runs
+ * the simulation, and writes the outputs of the calculators of its
+ * DataCollector to shared memory.  The calling process then reads them
+ * back as a DataCollector per replication, which can be written with
+ * any DataOutputInterface.
+ *
+ * \code
+ *   Ptr<DataCollector> collector = CreateObject<DataCollector> ();
+ *   collector->DescribeRun ("sweep", "tcp", "load 0.8", "");
+ *   collector->AddDataCalculator (delayStats);
+ *   // build the topology, connect delayStats
+ *
+ *   ReplicationRunner runner;
+ *   runner.SetDataCollector (collector);
+ *   runner.SetJobs (8);
+ *   runner.Run (100);
+ *   for (uint32_t i = 0; i < 100; ++i)
+ *     {
+ *       Ptr<DataCollector> results = runner.GetDataCollector (i);
+ *       if (results != 0)
+ *         {
+ *           output->Output (*results);
+ *         }
+ *     }
+ * \endcode
+ *
+ * The streams restart at the start of their substream for the new run,
+ * so the values drawn while building the topology are not repeated;
+ * a replication is independent of the others, but does not draw the same
+ * values as a program started with its run number.
+ */
+class ReplicationRunner
+{
+public:
+  /** Constructor. */
+  ReplicationRunner ();
+
+  /**
+   * Set the DataCollector to collect from each replication.
+   * \param [in] collector The DataCollector.
+   */
+  void SetDataCollector (Ptr<DataCollector> collector);
+  /**
+   * Set the number of replications to run at once; the default is 1.
+   * \param [in] jobs The number of worker processes.
+   */
+  void SetJobs (uint32_t jobs);
+  /**
+   * Set the run number of the first replication; the
+   * default is RngSeedManager::GetRun () + 1.
+   * \param [in] run The run number.
+   */
+  void SetFirstRun (uint64_t run);
+  /**
+   * Set the size of the shared memory for the outputs of each
+   * replication; the default is 64 KiB.
+   * \param [in] size The size in bytes.
+   */
+  void SetOutputSize (uint32_t size);
+
+  /**
+   * Run the replications, and wait for all of them.
+   *
+   * Replication \c i uses the run number of the first replication
+   * plus \c i.  The first replication of the next Run uses the run
+   * number after the last one of this Run.
+   *
+   * \param [in] n The number of replications.
+   * \returns The number of replications which succeeded.
+   */
+  uint32_t Run (uint32_t n);
+
+  /**
+   * Get the outputs of a replication.
+   *
+   * \param [in] replication The index of the replication.
+   * \returns A DataCollector with the labels, metadata and calculator
+   *          outputs of the replication, or 0 if it failed, or if its
+   *          outputs did not fit the shared memory.
+   */
+  Ptr<DataCollector> GetDataCollector (uint32_t replication) const;
+
+private:
+  /**
+   * Run a replication, in its worker process.
+   * \param [in] replication The index of the replication.
+   * \param [in,out] output The shared memory for the outputs.
+   */
+  void RunReplication (uint32_t replication, uint8_t *output);
+
+  /** The DataCollector of the replications. */
+  Ptr<DataCollector> m_collector;
+  /** The number of replications to run at once. */
+  uint32_t m_jobs;
+  /** The run number of the next replication, or 0 for the default. */
+  uint64_t m_firstRun;
+  /** The size of the shared memory for each replication. */
+  uint32_t m_outputSize;
+  /** The outputs of the replications of the last Run. */
+  std::vector<Ptr<DataCollector> > m_results;
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_RUNNER_H */
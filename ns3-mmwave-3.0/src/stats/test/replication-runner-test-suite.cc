@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/basic-data-calculators.h"
+#include "ns3/data-collector.h"
+#include "ns3/data-output-interface.h"
+#include "ns3/replication-runner.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Collect the outputs of the calculators of a DataCollector.
+// ===========================================================================
+
+class CollectingCallback : public DataOutputCallback
+{
+public:
+  long count;
+  double sum;
+  double min;
+  double max;
+  uint32_t counter;
+
+  virtual void OutputStatistic (std::string key, std::string variable,
+                                const StatisticalSummary *statSum)
+  {
+    count = statSum->getCount ();
+    sum = statSum->getSum ();
+    min = statSum->getMin ();
+    max = statSum->getMax ();
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, int val)
+  {}
+  virtual void OutputSingleton (std::string key, std::string variable, uint32_t val)
+  {
+    counter = val;
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, double val)
+  {}
+  virtual void OutputSingleton (std::string key, std::string variable, std::string val)
+  {}
+  virtual void OutputSingleton (std::string key, std::string variable, Time val)
+  {}
+};
+
+// ===========================================================================
+// Run replications of a simulation drawing random values.
+// ===========================================================================
+
+class ReplicationRunnerTestCase : public TestCase
+{
+public:
+  ReplicationRunnerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  void Draw (void);
+
+  Ptr<UniformRandomVariable> m_rng;
+  Ptr<MinMaxAvgTotalCalculator<double> > m_values;
+  Ptr<CounterCalculator<> > m_draws;
+};
+
+static const uint32_t N_DRAWS = 10;
+
+ReplicationRunnerTestCase::ReplicationRunnerTestCase ()
+  : TestCase ("Check ReplicationRunner outputs and run numbers")
+{}
+
+void
+ReplicationRunnerTestCase::Draw (void)
+{
+  m_values->Update (m_rng->GetValue ());
+  m_draws->Update ();
+}
+
+void
+ReplicationRunnerTestCase::DoRun (void)
+{
+  uint64_t originalRun = RngSeedManager::GetRun ();
+
+  m_rng = CreateObject<UniformRandomVariable> ();
+  m_values = CreateObject<MinMaxAvgTotalCalculator<double> > ();
+  m_values->SetKey ("value");
+  m_draws = CreateObject<CounterCalculator<> > ();
+  m_draws->SetKey ("draws");
+  Ptr<DataCollector> collector = CreateObject<DataCollector> ();
+  collector->DescribeRun ("experiment", "strategy", "input", "0");
+  collector->AddMetadata ("topology", "built once");
+  collector->AddDataCalculator (m_values);
+  collector->AddDataCalculator (m_draws);
+  for (uint32_t i = 0; i < N_DRAWS; ++i)
+    {
+      Simulator::Schedule (Seconds (i + 1), &ReplicationRunnerTestCase::Draw, this);
+    }
+
+  const uint32_t n = 4;
+  ReplicationRunner runner;
+  runner.SetDataCollector (collector);
+  runner.SetJobs (2);
+  runner.SetFirstRun (7);
+  NS_TEST_ASSERT_MSG_EQ (runner.Run (n), n, "Some replications failed");
+
+  double previousSum = -1;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Ptr<DataCollector> results = runner.GetDataCollector (i);
+      NS_TEST_ASSERT_MSG_NE (results, 0, "No outputs for replication " << i);
+      std::ostringstream run;
+      run << 7 + i;
+      NS_TEST_ASSERT_MSG_EQ (results->GetRunLabel (), run.str (), "Wrong run label");
+      NS_TEST_ASSERT_MSG_EQ (results->GetExperimentLabel (), "experiment", "Wrong experiment");
+      NS_TEST_ASSERT_MSG_EQ (results->MetadataBegin ()->second, "built once", "Wrong metadata");
+
+      CollectingCallback callback;
+      for (DataCalculatorList::iterator c = results->DataCalculatorBegin ();
+           c != results->DataCalculatorEnd (); ++c)
+        {
+          (*c)->Output (callback);
+        }
+      NS_TEST_ASSERT_MSG_EQ (callback.count, N_DRAWS, "Wrong statistic count");
+      NS_TEST_ASSERT_MSG_EQ (callback.counter, N_DRAWS, "Wrong counter");
+
+      // The replication drew the first values of its run
+      RngSeedManager::SetRun (7 + i);
+      RandomVariableStream::Reseed ();
+      double sum = 0;
+      double min = 1;
+      double max = 0;
+      for (uint32_t j = 0; j < N_DRAWS; ++j)
+        {
+          double value = m_rng->GetValue ();
+          sum += value;
+          min = std::min (min, value);
+          max = std::max (max, value);
+        }
+      NS_TEST_ASSERT_MSG_EQ (callback.sum, sum, "Wrong values in replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (callback.min, min, "Wrong minimum in replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (callback.max, max, "Wrong maximum in replication " << i);
+      NS_TEST_ASSERT_MSG_NE (sum, previousSum, "Replications drew the same values");
+      previousSum = sum;
+    }
+
+  // The next replications continue after the runs already used
+  NS_TEST_ASSERT_MSG_EQ (runner.Run (1), 1, "The replication failed");
+  std::ostringstream nextRun;
+  nextRun << 7 + n;
+  NS_TEST_ASSERT_MSG_EQ (runner.GetDataCollector (0)->GetRunLabel (), nextRun.str (),
+                         "Run number reused");
+
+  // Outputs which do not fit the shared memory are a failure
+  runner.SetOutputSize (16);
+  NS_TEST_ASSERT_MSG_EQ (runner.Run (2), 0, "Truncated outputs not reported");
+  NS_TEST_ASSERT_MSG_EQ (runner.GetDataCollector (0), 0, "Truncated outputs returned");
+
+  RngSeedManager::SetRun (originalRun);
+  RandomVariableStream::Reseed ();
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// Test suite
+// ===========================================================================
+
+class ReplicationRunnerTestSuite : public TestSuite
+{
+public:
+  ReplicationRunnerTestSuite ();
+};
+
+ReplicationRunnerTestSuite::ReplicationRunnerTestSuite ()
+  : TestSuite ("replication-runner", UNIT)
+{
+  AddTestCase (new ReplicationRunnerTestCase, TestCase::QUICK);
+}
+
+static ReplicationRunnerTestSuite replicationRunnerTestSuite;
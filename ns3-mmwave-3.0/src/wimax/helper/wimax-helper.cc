@@ -587,8 +587,7 @@ WimaxHelper::EnableAsciiInternal (Ptr<OutputStreamWrapper> stream,
 static void PcapSniffTxRxEvent (Ptr<PcapFileWrapper> file,
                                 Ptr<const PacketBurst> burst)
 {
-  std::list<Ptr<Packet> > packets = burst->GetPackets ();
-  for (std::list<Ptr<Packet> >::iterator iter = packets.begin (); iter != packets.end (); ++iter)
+  for (PacketBurst::Iterator iter = burst->Begin (); iter != burst->End (); ++iter)
     {
       Ptr<Packet> p = (*iter)->Copy ();
       WimaxMacToMacHeader m2m (p->GetSize ());
@@ -486,10 +486,8 @@ SimpleOfdmWimaxPhy::ConvertBurstToBits (Ptr<const PacketBurst> burst)
 {
   bvec buffer (burst->GetSize () * 8, 0);
 
-  std::list<Ptr<Packet> > packets = burst->GetPackets ();
-
   uint32_t j = 0;
-  for (std::list<Ptr<Packet> >::iterator iter = packets.begin (); iter != packets.end (); ++iter)
+  for (PacketBurst::Iterator iter = burst->Begin (); iter != burst->End (); ++iter)
     {
       Ptr<Packet> packet = *iter;
       uint8_t *pstart = (uint8_t*) std::malloc (packet->GetSize ());
@@ -21,6 +21,10 @@
 // This program can be used to benchmark packet serialization/deserialization
 // operations using Headers and Tags, for various numbers of packets 'n'
 // Sample usage:  ./waf --run 'bench-packets --n=10000'
+//
+// To compare the per-packet cost with and without the packet metadata,
+// run it in a build configured with --disable-packet-metadata, and in
+// one without.
 
 #include "ns3/command-line.h"
 #include "ns3/system-wall-clock-ms.h"
@@ -328,6 +332,38 @@ benchByteTags (uint32_t n)
     }
 }
 
+static void
+benchPacketTags (uint32_t n)
+{
+  BenchTag<1> priority;
+  BenchTag<4> flowId;
+  BenchTag<8> bearer;
+  BenchTag<12> pdu;
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      // Each layer copies the packet, adds a tag and looks up the
+      // tags of the layers above
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddPacketTag (priority);
+      p->AddPacketTag (flowId);
+      Ptr<Packet> q = p->Copy ();
+      q->AddPacketTag (bearer);
+      q->PeekPacketTag (priority);
+      q->PeekPacketTag (flowId);
+      Ptr<Packet> r = q->Copy ();
+      r->AddPacketTag (pdu);
+      r->PeekPacketTag (bearer);
+      r->PeekPacketTag (flowId);
+
+      // and the receiving side removes them
+      r->RemovePacketTag (pdu);
+      r->RemovePacketTag (bearer);
+      r->PeekPacketTag (flowId);
+      r->RemovePacketTag (priority);
+    }
+}
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -351,8 +387,10 @@ runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char con
   double ps = n;
   ps *= 1000;
   ps /= minDelay;
+  double nsPerPacket = minDelay * 1e6 / n;
   std::cout << ps << " packets/s"
-            << " (" << minDelay << " ms elapsed)\t"
+            << " (" << minDelay << " ms elapsed, "
+            << nsPerPacket << " ns/packet)\t"
             << name
             << std::endl;
 }
@@ -376,7 +414,17 @@ int main (int argc, char *argv[])
         "by command-line argument --n=(number of packets)" << std::endl;
       exit (1);
     }
+  if (enablePrinting)
+    {
+      Packet::EnablePrinting ();
+    }
   std::cout << "Running bench-packets with n=" << n << std::endl;
+#ifdef DISABLE_PACKET_METADATA
+  std::cout << "Packet metadata: compiled out (--disable-packet-metadata)" << std::endl;
+#else
+  std::cout << "Packet metadata: compiled in, "
+            << (enablePrinting ? "enabled" : "disabled") << std::endl;
+#endif
   std::cout << "All tests begin by adding UDP and IPv4 headers." << std::endl;
 
   runBench (&benchA, n, minIterations, "Copy packet, remove headers");
@@ -385,6 +433,7 @@ int main (int argc, char *argv[])
   runBench (&benchD, n, minIterations, "Intermixed add/remove headers and tags");
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
+  runBench (&benchPacketTags, n, minIterations, "Packet tags through the layers");
 
   return 0;
 }
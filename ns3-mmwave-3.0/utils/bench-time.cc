@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/**
+ * Micro-benchmark of int64x64_t arithmetic and Time conversions.
+ *
+ * The int64x64_t implementation is chosen when configuring, so compare
+ * the implementations by running this program after each of
+ * \code
+ *   ./waf configure --int64x64=int128
+ *   ./waf configure --int64x64=cairo
+ *   ./waf configure --int64x64=double
+ * \endcode
+ */
+
+/** Sink for the benchmark results, so they are not optimized away. */
+volatile double g_sink = 0;
+
+/** Width of the output columns. */
+const int g_fwidth = 14;
+
+/** Operands of the benchmarks, in seconds. */
+std::vector<double> g_values;
+
+/**
+ * Time a benchmark, and print its rate.
+ *
+ * \tparam F \deduced The benchmark function type.
+ * \param [in] name The name of the benchmark.
+ * \param [in] count The number of operations to time.
+ * \param [in] f The benchmark, called with the index of an operand.
+ */
+template <typename F>
+void
+Bench (std::string name, uint32_t count, F f)
+{
+  SystemWallClockMs time;
+  const std::size_t n = g_values.size ();
+  double sum = 0;
+  time.Start ();
+  for (uint32_t i = 0; i < count; ++i)
+    {
+      sum += f (i % n);
+    }
+  double elapsed = time.End () / 1000.0;
+  g_sink = g_sink + sum;
+  std::cout << std::left << std::setw (2 * g_fwidth) << name
+            << std::right << std::setw (g_fwidth) << elapsed
+            << std::setw (g_fwidth) << (elapsed > 0 ? count / elapsed : 0)
+            << std::setw (g_fwidth) << elapsed / count * 1e9
+            << std::endl;
+}
+
+/**
+ * Run the benchmarks.
+ *
+ * This runs as an event, as Time values are only cheap to construct
+ * once Simulator::Run has stopped recording them for SetResolution.
+ *
+ * \param [in] count The number of operations per benchmark.
+ */
+void
+RunBenchmarks (uint32_t count)
+{
+  std::string impl;
+  switch (int64x64_t::implementation)
+    {
+    case int64x64_t::int128_impl: impl = "int128"; break;
+    case int64x64_t::cairo_impl:  impl = "cairo";  break;
+    case int64x64_t::ld_impl:     impl = "double"; break;
+    }
+  std::cout << "int64x64_t implementation: " << impl << std::endl;
+  std::cout << "operations: " << count << std::endl;
+  std::cout << std::endl;
+
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  std::vector<Time> times;
+  std::vector<int64x64_t> fixed;
+  for (uint32_t i = 0; i < 1024; ++i)
+    {
+      double value = rng->GetValue (0, 100);
+      g_values.push_back (value);
+      times.push_back (Seconds (value));
+      fixed.push_back (int64x64_t (value));
+    }
+  const std::size_t n = g_values.size ();
+
+  std::cout << std::left << std::setw (2 * g_fwidth) << "Benchmark"
+            << std::right << std::setw (g_fwidth) << "Time (s)"
+            << std::setw (g_fwidth) << "Rate (op/s)"
+            << std::setw (g_fwidth) << "Per (ns/op)"
+            << std::endl;
+
+  Bench ("int64x64 +", count, [&] (std::size_t i)
+         { return (fixed[i] + fixed[(i + 1) % n]).GetHigh (); });
+  Bench ("int64x64 *", count, [&] (std::size_t i)
+         { return (fixed[i] * fixed[(i + 1) % n]).GetHigh (); });
+  Bench ("int64x64 /", count, [&] (std::size_t i)
+         { return (fixed[i] / (fixed[(i + 1) % n] + 1)).GetHigh (); });
+  Bench ("int64x64 (double)", count, [&] (std::size_t i)
+         { return int64x64_t (g_values[i]).GetHigh (); });
+  Bench ("int64x64 GetDouble", count, [&] (std::size_t i)
+         { return fixed[i].GetDouble (); });
+
+  Bench ("Seconds (double)", count, [&] (std::size_t i)
+         { return Seconds (g_values[i]).GetTimeStep (); });
+  Bench ("Seconds (int64x64)", count, [&] (std::size_t i)
+         { return Time::From (int64x64_t (g_values[i]), Time::S).GetTimeStep (); });
+  Bench ("GetSeconds", count, [&] (std::size_t i)
+         { return times[i].GetSeconds (); });
+  Bench ("GetSeconds (int64x64)", count, [&] (std::size_t i)
+         { return times[i].To (Time::S).GetDouble (); });
+  Bench ("Time * int64_t", count, [&] (std::size_t i)
+         { return (times[i] * static_cast<int64_t> (i)).GetTimeStep (); });
+  Bench ("Time * int64x64", count, [&] (std::size_t i)
+         { return (times[i] * fixed[i]).GetTimeStep (); });
+  Bench ("Time / Time", count, [&] (std::size_t i)
+         { return (times[i] / times[(i + 1) % n]).GetDouble (); });
+
+  std::cout << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t count = 10000000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark int64x64_t arithmetic and Time conversions.\n"
+             "\n"
+             "Time::FromDouble and Time::ToDouble take a double fast path;\n"
+             "the \"int64x64\" rows time the int64x64_t conversions\n"
+             "they used before.");
+  cmd.AddValue ("count", "number of operations per benchmark", count);
+  cmd.Parse (argc, argv);
+
+  Simulator::ScheduleNow (&RunBenchmarks, count);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return 0;
+}